@@ -32,6 +32,13 @@ if sys.version_info[:2] < (3, 5):
 else:
 	pass 
 
+# The C kernels are parallelized with OpenMP. Set ULTRA_NO_OPENMP in the 
+# environment to build the serial versions with compilers lacking it. 
+if "ULTRA_NO_OPENMP" in os.environ: 
+	OPENMP_FLAGS = [] 
+else: 
+	OPENMP_FLAGS = ["-fopenmp"] 
+
 package_name = "ultra" 
 base_url = "http://github.com/giganano/ultra" 
 
@@ -80,7 +87,9 @@ def compile_extensions():
 				)) 
 				ext = "%s.%s" % (root[2:].replace('/', '.'), i.split('.')[0]) 
 				files = ["%s/%s" % (root[2:], i)] + c_extensions 
-				setup(ext_modules = cythonize([Extension(ext, files)])) 
+				setup(ext_modules = cythonize([Extension(ext, files, 
+					extra_compile_args = OPENMP_FLAGS + ["-pthread"], 
+					extra_link_args = OPENMP_FLAGS + ["-pthread"])])) 
 			else:
 				continue 
 		
@@ -1,5 +1,5 @@
 
-__all__ = ["dataframe"] 
-from ._dataframe import dataframe 
+__all__ = ["dataframe", "quantile_sketch", "external_sort"] 
+from ._dataframe import dataframe, quantile_sketch, external_sort 
 del _dataframe 
 
@@ -0,0 +1,251 @@
+# cython: language_level=3, boundscheck = False 
+"""
+<--------------- C routine comment headers not duplicated here ---------------> 
+
+The declarations of the C library in src/ which the dataframe extension types 
+call directly. Everything here may be called without holding the GIL. 
+"""
+
+cdef extern from "./src/dataframe.h" nogil: 
+
+	ctypedef struct ARENA: 
+		pass 
+
+	ctypedef struct COLUMN_ENCODING: 
+		int scheme 
+
+	ctypedef struct COLUMN_BUFFER: 
+		void *values 
+		long length 
+		int type 
+		int refcount 
+		unsigned char *validity 
+		COLUMN_ENCODING *encoding 
+		unsigned long version 
+		int writers 
+
+	ctypedef struct DATAFRAME: 
+		COLUMN_BUFFER **columns 
+		long *index 
+		long offset 
+		long num_rows 
+		int num_cols 
+		int max_cols 
+
+	ctypedef struct QUANTILE_SKETCH: 
+		long n 
+		int k 
+
+	ctypedef struct COLUMN_INDEX: 
+		long num_valid 
+
+	ctypedef struct FILE_STREAM: 
+		long chunksize 
+		long num_read 
+
+	ctypedef struct RESERVOIR: 
+		long size 
+
+	enum: 
+		COLUMN_FLOAT64 
+		COLUMN_FLOAT32 
+		COLUMN_INT64 
+		COLUMN_INT32 
+
+	enum: 
+		ENCODING_PLAIN 
+		ENCODING_RLE 
+		ENCODING_FOR 
+		ENCODING_SHUFFLE 
+		ENCODING_AUTO 
+
+	enum: 
+		JOIN_INNER 
+		JOIN_LEFT 
+		JOIN_HASH 
+		JOIN_MERGE 
+		JOIN_AUTO 
+
+	enum: 
+		GROUPBY_HASH 
+		GROUPBY_SORT 
+		GROUPBY_AUTO 
+
+	enum: 
+		CORRELATION_PEARSON 
+		CORRELATION_SPEARMAN 
+		CORRELATION_KENDALL 
+
+	# dataframe_utils.c 
+	DATAFRAME *dataframe_initialize() 
+	void free_dataframe(DATAFRAME *df) 
+
+	# dataframe_views.c 
+	unsigned long column_type_size(int type) 
+	COLUMN_BUFFER *column_buffer_wrap(void *values, long length, int type, 
+		void (*destructor)(void *) noexcept nogil, void *context) 
+	COLUMN_BUFFER *column_buffer_convert(void *data, long length, 
+		long stride, int type) 
+	void column_buffer_retain(COLUMN_BUFFER *buffer) 
+	unsigned long version_stamp() 
+	void column_buffer_release(COLUMN_BUFFER *buffer) 
+	void dataframe_release(DATAFRAME *df) 
+	int dataframe_materialize(DATAFRAME *df) 
+	int dataframe_slice(DATAFRAME source, DATAFRAME *dest, long start, 
+		long stop) 
+	int dataframe_select(DATAFRAME source, DATAFRAME *dest, long *rows, 
+		long num_rows) 
+	int dfcolumn_gather(DATAFRAME df, int column, void *dest) 
+	int dfcolumn_detach(DATAFRAME *df, int column) 
+	bint dfvalid(DATAFRAME df, long row, int column) 
+
+	# dataframe_validity.c 
+	int dfcolumn_mark_invalid(DATAFRAME *df, int column, double *sentinels, 
+		int num_sentinels) 
+	int dfcolumn_validity(DATAFRAME df, int column, int *ptr) 
+	int dfcolumn_count_valid(DATAFRAME df, int column, long *ptr) 
+
+	# dataframe_encoding.c 
+	int dfcolumn_encode(DATAFRAME *df, int column, int scheme) 
+	unsigned long column_buffer_nbytes(COLUMN_BUFFER *buffer) 
+
+	# dataframe_io.c 
+	int populate_from_file(DATAFRAME *df, char *file, char comment, 
+		int *columns, int num_cols, int *types) 
+
+	# dataframe_stream.c 
+	FILE_STREAM *stream_initialize(char *file, char comment, int *columns, 
+		int num_cols, int *types, long chunksize) 
+	void free_stream(FILE_STREAM *s) 
+	int stream_next(FILE_STREAM *s, DATAFRAME *dest) 
+
+	# dataframe_subs.c 
+	int dfcolumn_get(DATAFRAME df, int column, double *ptr) 
+	int dfrow_get(DATAFRAME df, long row, double *ptr) 
+	int dfcolumns_new(DATAFRAME *df, double *arr, int num_new) 
+	int dfcolumn_adopt(DATAFRAME *df, COLUMN_BUFFER *buffer, int column) 
+	int dfcolumn_min(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_max(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_sum(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_mean(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_median(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_std(DATAFRAME df, int column, double *ptr) 
+	int dfcolumn_scatter(DATAFRAME df, int column, double fraction, 
+		double *ptr) 
+	int dfcolumn_quantiles(DATAFRAME df, int column, double *fractions, 
+		int num_fractions, double *ptr) 
+
+	# dataframe_sieve.c 
+	int sieve(DATAFRAME source, DATAFRAME *dest, int column, double value, 
+		int relational_code) 
+	int sieve_integer(DATAFRAME source, DATAFRAME *dest, int column, 
+		long long value, int relational_code) 
+
+	# dataframe_sorting.c 
+	int dfcolumn_order(DATAFRAME *df, int column) 
+	int dfcolumns_order(DATAFRAME *df, int *columns, int *descending, 
+		int num_keys) 
+	int dfcolumns_argsort(DATAFRAME df, int *columns, int *descending, 
+		int num_keys, long *order) 
+	int dfcolumn_bin(DATAFRAME source, DATAFRAME *dest, int column, 
+		double *edges) 
+	int hist(DATAFRAME df, int column, double *binspace, long num_bins, 
+		long *counts) 
+	int histdd(DATAFRAME df, int *columns, int ndim, double **binspaces, 
+		long *num_bins, int weights, int *mask, int cumulative, double *sums, 
+		double *sums2) 
+	int dfcolumn_equal_number_partition(DATAFRAME df, int column, 
+		int num_subs, DATAFRAME *dests) 
+
+	# dataframe_join.c 
+	int dfjoin_rows(DATAFRAME left, int lcolumn, DATAFRAME right, 
+		int rcolumn, int how, int strategy, COLUMN_BUFFER **lrows, 
+		COLUMN_BUFFER **rrows) 
+	int dataframe_join(DATAFRAME left, DATAFRAME right, 
+		COLUMN_BUFFER *lrows, COLUMN_BUFFER *rrows, int rcolumn, 
+		DATAFRAME *dest) 
+
+	# dataframe_groupby.c 
+	int dfgroup(DATAFRAME df, int *columns, int num_keys, int strategy, 
+		long *groups, long *num_groups, long **first) 
+	int dfgroup_keys(DATAFRAME df, int *columns, int num_keys, 
+		long *first, long num_groups, DATAFRAME *dest) 
+
+	# dataframe_statistics.c 
+	int binned_statistic(DATAFRAME df, int xcolumn, int ycolumn, 
+		double *binspace, long num_bins, int *stats, double *fractions, 
+		int num_stats, double *results) 
+	int group_statistic(DATAFRAME df, long *groups, long num_groups, 
+		int column, int *stats, double *fractions, int num_stats, 
+		double *results) 
+
+	# dataframe_index.c 
+	COLUMN_INDEX *column_index_initialize(DATAFRAME df, int column) 
+	void free_column_index(COLUMN_INDEX *idx) 
+	int column_index_current(DATAFRAME df, int column, COLUMN_INDEX *idx) 
+	int dfcolumn_rank(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+		double value, long *counts) 
+	int indexed_sieve(DATAFRAME source, DATAFRAME *dest, int column, 
+		COLUMN_INDEX *idx, double value, long long *integer, 
+		int relational_code) 
+	int indexed_bin(DATAFRAME source, DATAFRAME *dest, int column, 
+		COLUMN_INDEX *idx, double *bin) 
+
+	# dataframe_sketch.c 
+	QUANTILE_SKETCH *sketch_initialize(int k, unsigned long seed) 
+	void free_sketch(QUANTILE_SKETCH *s) 
+	int sketch_update_array(QUANTILE_SKETCH *s, double *arr, long length) 
+	int sketch_merge(QUANTILE_SKETCH *dest, QUANTILE_SKETCH *source) 
+	int sketch_quantiles(QUANTILE_SKETCH *s, double *fractions, 
+		int num_fractions, double *ptr) 
+	int dfcolumn_sketch(DATAFRAME df, int column, QUANTILE_SKETCH *s) 
+	int sketch_from_file(QUANTILE_SKETCH **sketches, char *file, 
+		char comment, int *columns, int num_cols) 
+
+
+	# dataframe_external.c 
+	ctypedef int (*ROW_SINK)(double *rows, long n, int num_cols, 
+		void *state) noexcept nogil 
+	int external_sort_rows(char **files, int num_files, char comment, 
+		int *columns, int num_cols, int *integers, int key, int descending, 
+		unsigned long budget, char *tmpdir, ROW_SINK sink, void *state, 
+		long *num_rows) 
+	int external_sort_to_file(char **files, int num_files, char comment, 
+		int *columns, int num_cols, int *integers, int key, int descending, 
+		unsigned long budget, char *tmpdir, char *output, int binary, 
+		long *num_rows) 
+
+	# dataframe_sampling.c 
+	int dfcolumn_top(DATAFRAME df, int column, long k, int largest, 
+		long *rows, long *num_rows) 
+	int dataframe_sample(DATAFRAME df, long k, int weights, 
+		unsigned long seed, long *rows, long *num_rows) 
+	RESERVOIR *top_reservoir_initialize(long k, int num_cols, int *types, 
+		int column, int largest) 
+	RESERVOIR *sample_reservoir_initialize(long k, int num_cols, 
+		int *types, int weights, unsigned long seed) 
+	void free_reservoir(RESERVOIR *r) 
+	int reservoir_update(RESERVOIR *r, DATAFRAME df) 
+	void reservoir_rows(RESERVOIR *r, DATAFRAME *dest) 
+
+	# dataframe_resampling.c 
+	int dfcolumn_bootstrap(DATAFRAME df, int column, int *stats, 
+		double *fractions, int num_stats, long num_resamples, 
+		unsigned long seed, double *replicates, double *estimates, 
+		double *errors) 
+	int dfcolumn_jackknife(DATAFRAME df, int column, long *groups, 
+		long num_groups, int *stats, double *fractions, int num_stats, 
+		double *replicates, double *estimates, double *errors) 
+	int dataframe_subboxes(DATAFRAME df, int *columns, int num_dims, 
+		long *divisions, double *lower, double *upper, long *groups) 
+
+	# dataframe_conditional.c 
+	int dfcolumn_conditional_percentile(DATAFRAME df, int xcolumn, 
+		int ycolumn, double *binspace, long num_bins, long window, 
+		double *results) 
+
+	# dataframe_correlation.c 
+	int dataframe_correlations(DATAFRAME df, int *columns, int num_cols, 
+		int *methods, int num_methods, long num_resamples, 
+		unsigned long seed, double *results, double *errors, 
+		long *num_rows) 
@@ -4,7 +4,6 @@ This code wraps the dataframe source code implemented in c in src/.
 """
 
 # Python functions 
-from .._globals import _DIRECTORY_ 
 from .._globals import _VERSION_ERROR_ 
 import math as m 
 import warnings 
@@ -12,6 +11,7 @@ import numbers
 import inspect 
 import sys 
 import os 
+from array import array as _array 
 try: 
 	ModuleNotFoundError 
 except NameError: 
@@ -31,76 +31,429 @@ if sys.version_info[:2] < (3, 5):
 else: 
 	pass 
 
-# C functions 
-from ctypes import * 
-from libc.stdlib cimport malloc, free 
-clib = cdll.LoadLibrary("%sdataframe/src/dataframe.so" % (_DIRECTORY_)) 
+# C functions, declared in _dataframe.pxd 
+from libc.stdlib cimport malloc, calloc, free 
+from libc.string cimport memset, memcpy 
+from cpython.buffer cimport PyBUF_WRITABLE, PyBUF_FORMAT, PyBUF_RECORDS_RO 
+from cpython.buffer cimport PyObject_CheckBuffer, PyObject_GetBuffer 
+from cpython.buffer cimport PyBuffer_Release 
 
-# cdef extern from "./src/dataframe.h": 
-# 	ctypedef struct DATAFRAME: 
-# 		pass 
-# 	DATAFRAME *dataframe_initialize() 
-# 	DATAFRAME **dataframe_array_initialize(int n) 
+cdef class _column_export: 
 
-# cdef DATAFRAME **get_dataframe_array(int n): 
-# 	return dataframe_array_initialize(n) 
+	"""
+	Exposes the values of a dataframe column through the buffer protocol, such 
+	that NumPy arrays and memoryviews can share the memory the C library 
+	stores them in. The export holds a reference to the column buffer, so the 
+	memory stays valid even if the dataframe later replaces the buffer or is 
+	deleted. A writable export counts itself among the buffer's writers for 
+	as long as it exists, and gives the buffer a new version when taken and 
+	when released, so that no index of the column is trusted in between. 
+	""" 
+
+	cdef COLUMN_BUFFER *_buffer 
+	cdef char *_data 
+	cdef Py_ssize_t _shape[1] 
+	cdef Py_ssize_t _strides[1] 
+	cdef bint _readonly 
+
+	@staticmethod 
+	cdef _column_export wrap(COLUMN_BUFFER *buffer, long offset, long length, 
+		bint readonly): 
+		cdef _column_export export = _column_export.__new__(_column_export) 
+		export._buffer = buffer 
+		column_buffer_retain(buffer) 
+		export._strides[0] = column_type_size(buffer.type) 
+		export._data = <char *> buffer.values + offset * export._strides[0] 
+		export._shape[0] = length 
+		export._readonly = readonly 
+		if not readonly: 
+			buffer.writers += 1 
+			buffer.version = version_stamp() 
+		else: 
+			pass 
+		return export 
+
+	def __dealloc__(self): 
+		if self._buffer is not NULL: 
+			if not self._readonly: 
+				self._buffer.writers -= 1 
+				self._buffer.version = version_stamp() 
+			else: 
+				pass 
+			column_buffer_release(self._buffer) 
+		else: 
+			pass 
+
+	def __getbuffer__(self, Py_buffer *view, int flags): 
+		if flags & PyBUF_WRITABLE and self._readonly: 
+			raise BufferError("Column was exported read-only.") 
+		else: 
+			pass 
+		view.buf = self._data 
+		view.obj = self 
+		view.len = self._shape[0] * self._strides[0] 
+		view.readonly = self._readonly 
+		view.itemsize = self._strides[0] 
+		if flags & PyBUF_FORMAT: 
+			view.format = _EXPORT_FORMATS_[self._buffer.type] 
+		else: 
+			view.format = NULL 
+		view.ndim = 1 
+		view.shape = self._shape 
+		view.strides = self._strides 
+		view.suboffsets = NULL 
+		view.internal = NULL 
+
+	def __releasebuffer__(self, Py_buffer *view): 
+		pass 
+
+# The buffer protocol formats of the types in the C library, by COLUMN_* code 
+cdef char *_EXPORT_FORMATS_[4] 
+_EXPORT_FORMATS_[COLUMN_FLOAT64] = "d" 
+_EXPORT_FORMATS_[COLUMN_FLOAT32] = "f" 
+_EXPORT_FORMATS_[COLUMN_INT64] = "q" 
+_EXPORT_FORMATS_[COLUMN_INT32] = "i" 
+
+cdef class _column_index: 
+
+	"""
+	Owns a sorted index of a dataframe column (see dataframe.create_index). 
+	"""
+
+	cdef COLUMN_INDEX *_index 
+
+	def __dealloc__(self): 
+		if self._index is not NULL: 
+			free_column_index(self._index) 
+		else: 
+			pass 
+
+# The array.array typecodes and names of the types, by COLUMN_* code 
+_TYPECODES_ = { 
+	COLUMN_FLOAT64: "d", 
+	COLUMN_FLOAT32: "f", 
+	COLUMN_INT64: "q", 
+	COLUMN_INT32: "i" 
+} 
+_TYPE_NAMES_ = { 
+	COLUMN_FLOAT64: "float64", 
+	COLUMN_FLOAT32: "float32", 
+	COLUMN_INT64: "int64", 
+	COLUMN_INT32: "int32" 
+} 
+
+# The JOIN_* codes of the kinds of joins and their strategies, by name 
+_JOIN_HOWS_ = { 
+	"inner": JOIN_INNER, 
+	"left": JOIN_LEFT 
+} 
+_JOIN_STRATEGIES_ = { 
+	"hash": JOIN_HASH, 
+	"merge": JOIN_MERGE, 
+	"auto": JOIN_AUTO 
+} 
+
+# The GROUPBY_* codes of the group-by strategies, by name 
+_GROUPBY_STRATEGIES_ = { 
+	"hash": GROUPBY_HASH, 
+	"sort": GROUPBY_SORT, 
+	"auto": GROUPBY_AUTO 
+} 
+
+# The CORRELATION_* codes of the correlation coefficients, by name 
+_CORRELATIONS_ = {
+	"pearson": CORRELATION_PEARSON, 
+	"spearman": CORRELATION_SPEARMAN, 
+	"kendall": CORRELATION_KENDALL 
+} 
+
+# The BINNED_* codes of the statistics within bins or groups, by name 
+_STATISTICS_ = { 
+	"count": 0, 
+	"sum": 1, 
+	"mean": 2, 
+	"std": 3, 
+	"min": 4, 
+	"max": 5, 
+	"median": 6 
+} 
+
+# The ENCODING_* codes of the column encodings, by name 
+_ENCODINGS_ = { 
+	"plain": ENCODING_PLAIN, 
+	"rle": ENCODING_RLE, 
+	"for": ENCODING_FOR, 
+	"shuffle": ENCODING_SHUFFLE, 
+	"auto": ENCODING_AUTO 
+} 
+
+cdef void _release_buffer_view(void *view) noexcept nogil: 
+	# The destructor of column buffers wrapping memory owned by Python objects 
+	with gil: 
+		PyBuffer_Release(<Py_buffer *> view) 
+	free(view) 
 
-# cpdef mirrorDATAFRAME(DATAFRAME df): 
-# 	x = __dataframe() 
-# 	x.data = df.data 
-# 	x.num_rows = df.num_rows 
-# 	x.num_cols = df.num_cols 
-# 	return x 
+# The element formats which can be ingested, and their types in the C library 
+_INGEST_FORMATS_ = { 
+	"d": (COLUMN_FLOAT64, sizeof(double)), 
+	"f": (COLUMN_FLOAT32, sizeof(float)), 
+	"q": (COLUMN_INT64, sizeof(long long)), 
+	"l": (COLUMN_INT64, sizeof(long long)), 
+	"i": (COLUMN_INT32, sizeof(int)) 
+} 
 
-class __dataframe(Structure): 
+cdef COLUMN_BUFFER *_ingest_column(object obj) except? NULL: 
 	"""
-	Wraps the C structure version of the dataframe 
+	Build a column buffer from a one-dimensional object supporting the buffer 
+	protocol (e.g. a NumPy array or an array.array) of float64, float32, 
+	int64, or int32 values. The column keeps the type of the values. 
+	Contiguous memory is referenced without copying, with the object kept 
+	alive for as long as the buffer exists; strided memory is copied in a 
+	single pass in C. A writable object referenced this way counts among the 
+	buffer's writers, since its values can change under any index of them. 
+
+	Parameters 
+	========== 
+	obj :: object 
+		The object to build the column buffer from 
+
+	Returns 
+	======= 
+	The column buffer, holding one reference; NULL if the object doesn't 
+	support the buffer protocol, or its shape or type of values isn't 
+	supported. 
+	""" 
+	if not PyObject_CheckBuffer(obj): return NULL 
+	cdef Py_buffer *view = <Py_buffer *> malloc(sizeof(Py_buffer)) 
+	cdef COLUMN_BUFFER *buffer = NULL 
+	cdef int code 
+	try: 
+		PyObject_GetBuffer(obj, view, PyBUF_RECORDS_RO) 
+	except BufferError: 
+		free(view) 
+		return NULL 
+	fmt = view.format.decode() if view.format is not NULL else "B" 
+	if fmt[:1] in ["@", "="] or (fmt[:1] == "<" and sys.byteorder == "little"): 
+		fmt = fmt[1:] 
+	else: 
+		pass 
+	if (view.ndim != 1 or fmt not in _INGEST_FORMATS_.keys() or 
+		view.itemsize != _INGEST_FORMATS_[fmt][1]): 
+		PyBuffer_Release(view) 
+		free(view) 
+		return NULL 
+	else: 
+		code = _INGEST_FORMATS_[fmt][0] 
+	if view.strides[0] == view.itemsize: 
+		# Reference the memory; the view is released with the buffer 
+		buffer = column_buffer_wrap(view.buf, view.shape[0], code, 
+			_release_buffer_view, view) 
+		if buffer is not NULL and not view.readonly: buffer.writers += 1 
+	else: 
+		with nogil: 
+			buffer = column_buffer_convert(view.buf, view.shape[0], 
+				view.strides[0], code) 
+		PyBuffer_Release(view) 
+		free(view) 
+	return buffer 
+
+def _copy_array_like_object(arg, name): 
+	"""
+	Takes an array like object and returns a copy of it as a native python 
+	list. 
+
+	Parameters 
+	========== 
+	arg :: array-like 
+		Some sort of array-like object. 
+	name :: str 
+		The name of the object, for exception raising purposes 
+
+	Returns 
+	======= 
+	A copy of the object in a python list 
+	"""
+	if "numpy" in sys.modules and isinstance(arg, _np.ndarray): 
+		# Turn a numpy array into a list 
+		copy = arg.tolist()[:] 
+	elif "pandas" in sys.modules and isinstance(arg, _pd.DataFrame): 
+		# Turn a pandas DataFrame into a list 
+		copy = [i[0] for i in arg.values.tolist()][:] 
+	elif type(arg) in [list, tuple]: 
+		# pull a copy if it's native python 
+		copy = arg[:] 
+	else: 
+		raise TypeError("""\
+Argument %s must be an array-like object. Got: %s""" % (name, type(arg))) 
+
+	return copy 
+
+def _statistic_codes(stats): 
+	"""
+	The BINNED_* codes of a list of statistics, each a name in _STATISTICS_ 
+	or a percentile, along with the fraction of each percentile, as 
+	array.arrays for the C routines. 
+	""" 
+	if not isinstance(stats, list): 
+		raise TypeError("stats must be of type list. Got: %s" % (type(stats))) 
+	else: 
+		pass 
+	c_stats = len(stats) * [0] 
+	fractions = len(stats) * [0.] 
+	for i in range(len(stats)): 
+		if isinstance(stats[i], str): 
+			if stats[i].lower() in _STATISTICS_.keys(): 
+				c_stats[i] = _STATISTICS_[stats[i].lower()] 
+			else: 
+				raise ValueError("Unrecognized statistic: %s" % (stats[i])) 
+		elif isinstance(stats[i], numbers.Number): 
+			if 0 <= stats[i] <= 100: 
+				c_stats[i] = 7 
+				fractions[i] = stats[i] / 100 
+			else: 
+				raise ValueError("Percentiles must be between 0 and 100.") 
+		else: 
+			raise TypeError("""Statistic must be of type str or a real number. \
+Got: %s""" % (type(stats[i]))) 
+	return _array('i', c_stats), _array('d', fractions) 
+
+def _resampled(estimates, errors, values, n, replicates): 
+	"""
+	The results of dataframe.bootstrap and dataframe.jackknife: lists of the 
+	estimates and errors of each statistic, and if replicates is True, one 
+	list per statistic of its value in each of the n resamples. 
+	""" 
+	num_stats = len(estimates) 
+	if replicates: 
+		return list(estimates), list(errors), [[values[j * num_stats + i] for 
+			j in range(n)] for i in range(num_stats)] 
+	else: 
+		return list(estimates), list(errors) 
+
+def _zeros(typecode, n): 
 	"""
-	_fields_ = [
-		("data", POINTER(POINTER(c_double))), 
-		("num_rows", c_long), 
-		("num_cols", c_int) 
-	] 
+	An array.array of a given type holding n zeroes, for the C routines to 
+	fill. 
+	""" 
+	return _array(typecode, [0]) * n 
+
+# Pointers to the values of array.arrays; NULL for empty ones 
+cdef inline double *_doubles(double[::1] arr): 
+	return &arr[0] if arr.shape[0] else NULL 
+
+cdef inline long *_longs(long[::1] arr): 
+	return &arr[0] if arr.shape[0] else NULL 
+
+cdef inline int *_ints(int[::1] arr): 
+	return &arr[0] if arr.shape[0] else NULL 
 
-class dataframe(object): 
+cdef inline void *_bytes(unsigned char[::1] arr): 
+	return &arr[0] if arr.shape[0] else NULL 
+
+# Declared here for dataframe.sketch, dataframe.groupby and dataframe.stream 
+cdef class quantile_sketch 
+cdef class dataframe_groups 
+cdef class dataframe_stream 
+
+cdef class dataframe: 
 
 	"""
 	A case-insensitive data storage object with analysis subroutines written 
-	in C. 
+	in C. The C routines are called directly, and all of the heavy ones run 
+	without holding the GIL, so different threads may operate on dataframes 
+	at the same time. A single dataframe should not be modified from one 
+	thread while another uses it. 
 	""" 
 
-	def __init__(self, arg, **kwargs): 
-		self.__mirror = __dataframe() 
+	# The C structure version of the dataframe, the column labels, and the 
+	# sorted indexes of the indexed columns by label 
+	cdef DATAFRAME *_df 
+	cdef tuple _labels 
+	cdef dict _indexes 
+
+	def __cinit__(self, *args, **kwargs): 
+		self._df = dataframe_initialize() 
+		self._labels = tuple() 
+		self._indexes = {} 
+
+	def __dealloc__(self): 
+		# Release this dataframe's references to its column buffers 
+		if self._df is not NULL: 
+			with nogil: 
+				free_dataframe(self._df) 
+		else: 
+			pass 
+
+	def __init__(self, arg, sentinels = None, encodings = None, **kwargs): 
 		if isinstance(arg, str):
 			self.__populate_from_file(arg, **kwargs) 
-		elif isinstance(arg, __dataframe): 
-			self.__mirror = arg 
-			if "labels" in kwargs.keys(): 
-				self.__labels = kwargs["labels"]  
-			else: 
-				raise SystemError("Internal Error") 
+		elif isinstance(arg, dict): 
+			# Columns from array-like objects; NumPy arrays aren't copied 
+			self.add_columns(arg) 
 		else: 
 			raise TypeError("dataframe.__init__ got invalid type: %s" % (
 				type(arg))) 
+		if sentinels is None: 
+			pass 
+		elif isinstance(sentinels, dict): 
+			# e.g. {"pid": [-1], "mvir": [0, -99]} 
+			for key in sentinels.keys(): 
+				self.mark_missing(key, sentinels[key]) 
+		else: 
+			raise TypeError("sentinels must be of type dict. Got: %s" % ( 
+				type(sentinels))) 
+		if encodings is None: 
+			pass 
+		elif isinstance(encodings, dict): 
+			# e.g. {"scale": "rle", "id": "for"} 
+			for key in encodings.keys(): 
+				self.encode(key, encodings[key]) 
+		else: 
+			raise TypeError("encodings must be of type dict. Got: %s" % ( 
+				type(encodings))) 
+
+	@staticmethod 
+	cdef dataframe _wrap(DATAFRAME df, tuple labels): 
+		"""
+		Build a dataframe taking over the references held by a C structure 
+		filled by the C library. 
+		""" 
+		cdef dataframe result = dataframe.__new__(dataframe) 
+		result._df[0] = df 
+		result._labels = labels 
+		return result 
 
 	def __call__(self, key): 
 		return self.__getitem__(key) 
 
 	def __getitem__(self, key): 
+		cdef int column, status 
+		cdef void *ptr 
 		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				return [self.__mirror.data[i][self.__labels.index(
-					key.lower())] for i in range(self.__mirror.num_rows)] 
+			if key.lower() in self._labels: 
+				# In the column's own type, so integers come back as ints 
+				column = self._labels.index(key.lower()) 
+				x = _zeros(_TYPECODES_[self._df.columns[column].type], 
+					self._df.num_rows) 
+				ptr = _bytes(memoryview(x).cast("B")) 
+				with nogil: 
+					status = dfcolumn_gather(self._df[0], column, ptr) 
+				if status: 
+					raise SystemError("Internal Error") 
+				elif self._df.columns[column].validity is not NULL: 
+					# Missing values come back as None 
+					valid = self.__validity(column) 
+					return [v if ok else None for v, ok in zip(x, valid)] 
+				else: 
+					return x.tolist() 
 			else: 
 				raise KeyError("Unrecognized key: %s" % (key)) 
 		elif isinstance(key, numbers.Number) and key % 1 == 0: 
-			if 0 <= key < self.__mirror.num_rows: 
-				return [self.__mirror.data[key][i] for i in range(
-					self.__mirror.num_cols)] 
-			elif -1 * self.__mirror.num_rows < key < 0: 
-				key = -1 * key - 1 # The row number to return 
-				return [self.__mirror.data[key][i] for i in range(
-					self.__mirror.num_cols)] 
+			if 0 <= key < self._df.num_rows: 
+				return self.__row(int(key)) 
+			elif -1 * self._df.num_rows <= key < 0: 
+				# The row number to return 
+				return self.__row(int(self._df.num_rows + key)) 
 			else: 
 				raise ValueError("Key index out of range. Got: %d." % (key)) 
 		else: 
@@ -108,70 +461,253 @@ class dataframe(object):
 Got: %s""" % (type(key))) 
 
 	def __setitem__(self, key, value): 
+		cdef COLUMN_BUFFER *buffer 
 		if isinstance(key, str): 
-			copy = self.__copy_array_like_object(value, "to __setitem__") 
-			if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
-				if len(copy) == self.__mirror.num_rows: 
-					ptr = self.__mirror.num_rows * c_double 
-					if key.lower() in self.__labels: 
-						if clib.dfcolumn_modify(
-							byref(self.__mirror), 
-							ptr(*copy[:]), 
-							c_int(self.__labels.index(key.lower()))
-						): 
-							raise SystemError("Internal Error.") 
-						else: 
-							pass 
-					else: 
-						if clib.dfcolumn_new(
-							byref(self.__mirror), 
-							ptr(*copy)
-						): 
-							raise SystemError("Internal Error.") 
-						else: 
-							self.__labels = (*self.__labels, key.lower()) 
-				else: 
-					raise ValueError("""Array length mismath. Got: %d. \
-Must be: %d""" % (len(copy), self.__mirror.num_rows)) 
+			buffer = self._ingest(value, "to __setitem__") 
+			if key.lower() in self._labels: 
+				self._indexes.pop(key.lower(), None) 
+				self._adopt(buffer, self._labels.index(key.lower())) 
 			else: 
-				raise TypeError("Non-numerical value detected.") 
+				self._adopt(buffer, self._df.num_cols) 
+				self._labels = (*self._labels, key.lower()) 
 		else: 
 			raise TypeError("Dataframe keys must be of type str. Got: %s" % (
 				type(key))) 
 
+	def array(self, key, writable = False): 
+		"""
+		Obtain a column of the data as a NumPy array (or a memoryview if NumPy 
+		is not installed) sharing the memory the dataframe stores it in. This 
+		takes constant time regardless of the length of the dataframe. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column 
+		writable :: bool [default :: False] 
+			Whether or not the array may be written to. Writes go straight to 
+			the dataframe's memory: the dataframe is first given its own copy 
+			of the column if it shares it with other dataframes, so they are 
+			unaffected. 
+
+		Returns 
+		======= 
+		arr :: numpy.ndarray [or memoryview] 
+			The values in the column, of the column's type (see dtype) 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+
+		Notes 
+		===== 
+		The array remains valid for as long as it exists, even after the 
+		dataframe is deleted. It stops reflecting the dataframe once the 
+		column is reassigned, or, for a writable array, once the dataframe 
+		shares the column with a new view and is written to. Taking a 
+		writable array of an indexed column drops its index (see 
+		create_index), and while the array exists the column is scanned 
+		rather than indexed, as writes through it can't be seen; an index 
+		created in the meantime is rebuilt once the array is deleted. A 
+		dataframe resulting from a sieve or a sort of its rows is first 
+		given its own compact copy of its columns, after which arrays are 
+		again taken in constant time. An encoded column (see encode) is 
+		first decoded, and stays decoded. 
+		""" 
+		cdef int status = 0 
+		cdef int column = self.__column_index(key) 
+		if self._df.columns[column].encoding is not NULL: 
+			# Encoded values can't be shared as an array 
+			with nogil: 
+				status = dfcolumn_encode(self._df, column, ENCODING_PLAIN) 
+		else: 
+			pass 
+		if self._df.index is not NULL and not status: 
+			# The rows of a selection aren't contiguous in memory 
+			with nogil: 
+				status = dataframe_materialize(self._df) 
+		else: 
+			pass 
+		if writable and not status: 
+			# Writes through the array can't be seen by an index 
+			self._indexes.pop(self._labels[column], None) 
+			with nogil: 
+				status = dfcolumn_detach(self._df, column) 
+		else: 
+			pass 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			pass 
+		export = _column_export.wrap(self._df.columns[column], 
+			self._df.offset, self._df.num_rows, not writable) 
+		if "numpy" in sys.modules: 
+			return _np.asarray(export) 
+		else: 
+			return memoryview(export) 
+
+	def add_columns(self, columns): 
+		"""
+		Add several new columns to the dataframe at once. This is faster than 
+		adding them one at a time with item assignment. 
+
+		Parameters 
+		========== 
+		columns :: dict 
+			The labels of the new columns [case-insensitive] as keys, and their 
+			values as array-like objects as long as the dataframe. Values 
+			supporting the buffer protocol (e.g. NumPy arrays) of type 
+			float64, float32, int64, or int32 keep their type. Contiguous 
+			ones are referenced without copying, and strided ones are copied 
+			in C; any other values are copied as float64. 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: columns is not a dict 
+			:: Any label is not of type str 
+			:: Any value is non-numerical 
+		KeyError :: 
+			:: Any label is already in use, or used twice 
+		ValueError :: 
+			:: Any array is not as long as the dataframe 
+
+		Notes 
+		===== 
+		The columns are added in the order of the keys. Every value is 
+		checked before any of them is added, so if one raises an exception 
+		the dataframe is left as it was. 
+
+		The dataframe never writes to an array it references: it takes its 
+		own copy of the column before modifying it. Until it does, changes 
+		made to the array itself are visible in the dataframe. Because they 
+		can be made at any time, a column referencing a writable array is 
+		scanned rather than looked up in an index (see create_index); pass 
+		a read-only array (e.g. after arr.setflags(write = False)) to keep 
+		the index in use. 
+		""" 
+		if not isinstance(columns, dict): 
+			raise TypeError("columns must be of type dict. Got: %s" % ( 
+				type(columns))) 
+		else: 
+			pass 
+		# Every value is ingested and checked before the dataframe changes: 
+		# list-like values are copied into one array for dfcolumns_new, and 
+		# the others are turned into column buffers to adopt afterwards. 
+		order = [] 
+		labels = [] 
+		values = [] 
+		buffered = [] 
+		cdef long length = self._df.num_rows if self._df.num_cols else -1 
+		cdef int j, start = self._df.num_cols, num_buffers = 0 
+		cdef COLUMN_BUFFER **buffers = <COLUMN_BUFFER **> malloc( 
+			max(len(columns), 1) * sizeof(COLUMN_BUFFER *)) 
+		try: 
+			for key in columns.keys(): 
+				if not isinstance(key, str): 
+					raise TypeError("Dataframe keys must be of type str. Got: %s" % ( 
+						type(key))) 
+				elif key.lower() in self._labels or key.lower() in order: 
+					raise KeyError("Key already in use: %s" % (key)) 
+				elif PyObject_CheckBuffer(columns[key]) or not self._df.num_cols: 
+					# An empty dataframe takes its number of rows from the first 
+					buffers[num_buffers] = self._ingest(columns[key], "column") 
+					num_buffers += 1 
+					if length == -1: 
+						length = buffers[num_buffers - 1].length 
+					elif buffers[num_buffers - 1].length != length: 
+						raise ValueError("""Array length mismatch. Got: %d. \
+Must be: %d""" % (buffers[num_buffers - 1].length, length)) 
+					else: 
+						pass 
+					buffered.append(key.lower()) 
+				else: 
+					copy = _copy_array_like_object(columns[key], "column") 
+					if not all(map(lambda x: isinstance(x, numbers.Number), 
+						copy)): 
+						raise TypeError("Non-numerical value detected.") 
+					elif len(copy) != length: 
+						raise ValueError("""Array length mismatch. Got: %d. \
+Must be: %d""" % (len(copy), length)) 
+					else: 
+						labels.append(key.lower()) 
+						values.extend(copy) 
+				order.append(key.lower()) 
+		except: 
+			for j in range(num_buffers): 
+				column_buffer_release(buffers[j]) 
+			free(buffers) 
+			raise 
+
+		values = _array('d', values) 
+		cdef double *ptr = _doubles(values) 
+		cdef int num_new = len(labels), status = 0 
+		if num_new: 
+			with nogil: 
+				status = dfcolumns_new(self._df, ptr, num_new) 
+		else: 
+			pass 
+		for j in range(num_buffers): 
+			if status: 
+				column_buffer_release(buffers[j]) 
+			else: 
+				with nogil: 
+					status = dfcolumn_adopt(self._df, buffers[j], 
+						self._df.num_cols) 
+				if status: column_buffer_release(buffers[j]) 
+		if status: 
+			free(buffers) 
+			raise SystemError("Internal Error.") 
+		else: 
+			pass 
+
+		# Put the new columns in the order of the keys 
+		placed = [*labels, *buffered] 
+		for j in range(len(order)): 
+			buffers[j] = self._df.columns[start + placed.index(order[j])] 
+		for j in range(len(order)): 
+			self._df.columns[start + j] = buffers[j] 
+		free(buffers) 
+		self._labels = (*self._labels, *order) 
+
 	def __repr__(self): 
 		rep = ["dataframe{\n", "\t\t"] 
-		for i in self.__labels: 
+		for i in self._labels: 
 			rep[1] += "%s\t\t" % (i) 
 		rep[1] += "\n" 
 		rep.append("\t\t") 
-		for i in self.__labels: 
+		for i in self._labels: 
 			for j in range(len(i)): 
 				rep[2] += "=" 
 			rep[2] += "\t\t"
 		rep[2] += "\n" 
-		if self.__mirror.num_rows > 15: 
+		if self._df.num_rows > 15: 
 			for i in range(5): 
 				rep.append("%12s ::\t" % (i)) 
-				for j in range(len(self.__labels)): 
-					rep[-1] += "%e\t" % (self.__mirror.data[i][j]) 
+				row = self.__row(i) 
+				for j in range(len(self._labels)): 
+					rep[-1] += "%e\t" % (row[j]) 
 				rep[-1] += "\n" 
 			rep.append("\t...\t") 
-			for i in range(len(self.__labels)): 
+			for i in range(len(self._labels)): 
 				rep[-1] += "...\t\t" 
 			rep[-1] += "\n" 
 			for i in range(5)[::-1]: 
-				rep.append("%12s ::\t" % (self.__mirror.num_rows - i - 1)) 
-				for j in range(len(self.__labels)): 
-					rep[-1] += "%e\t" % (
-						self.__mirror.data[self.__mirror.num_rows - i - 1][j]) 
+				rep.append("%12s ::\t" % (self._df.num_rows - i - 1)) 
+				row = self.__row(self._df.num_rows - i - 1) 
+				for j in range(len(self._labels)): 
+					rep[-1] += "%e\t" % (row[j]) 
 				rep[-1] += "\n" 
 			rep.append("}") 
 		else: 
-			for i in range(self.__mirrow.num_rows): 
+			for i in range(self._df.num_rows): 
 				rep.append("%12s ::\t" % (i)) 
-				for j in range(len(self.__labels)): 
-					rep[-1] += "%e\t" % (self.__mirror.data[i][j]) 
+				row = self.__row(i) 
+				for j in range(len(self._labels)): 
+					rep[-1] += "%e\t" % (row[j]) 
 				rep[-1] += "\n" 
 			rep.append("}") 
 		return "".join(rep) 
@@ -191,9 +727,36 @@ Must be: %d""" % (len(copy), self.__mirror.num_rows))
 		"""
 		return exc_value == None 
 
-	def __del__(self): 
-		del self.__mirror 
-		del self.__labels 
+	def __row(self, row): 
+		"""
+		Obtain a copy of a given row of the data as a list. 
+		""" 
+		cdef int status 
+		cdef long c_row = row 
+		x = _zeros('d', self._df.num_cols) 
+		cdef double *ptr = _doubles(x) 
+		with nogil: 
+			status = dfrow_get(self._df[0], c_row, ptr) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return [x[j] if dfvalid(self._df[0], c_row, j) else None for j in 
+				range(self._df.num_cols)] 
+
+	def __validity(self, column): 
+		"""
+		Obtain whether or not each row of a given column number is valid as 
+		an array.array of 1s and 0s. 
+		""" 
+		cdef int c_column = column, status 
+		x = _zeros('i', self._df.num_rows) 
+		cdef int *ptr = _ints(x) 
+		with nogil: 
+			status = dfcolumn_validity(self._df[0], c_column, ptr) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return x 
 
 	@property 
 	def size(self): 
@@ -202,73 +765,59 @@ Must be: %d""" % (len(copy), self.__mirror.num_rows))
 		as the first component of a tuple and the dimensionality of the data 
 		as the second component of a tuple. 
 		""" 
-		return (self.__mirror.num_rows, self.__mirror.num_cols) 
+		return (self._df.num_rows, self._df.num_cols) 
 
-	def keys(self): 
+	def dtype(self, key): 
 		"""
-		Obtain the dataframe keys in their lower-case format 
+		The type the values of a given column are stored as. Columns built 
+		from NumPy arrays or array.arrays keep their type, so e.g. int64 
+		halo IDs are stored and compared exactly, and float32 columns take 
+		half the memory; columns built from lists are float64. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column 
 
 		Returns 
 		======= 
-		keys :: list [elements of type str]
-			The strings which serve as case-insensitive dataframe keys 
-		"""
-		return self.__labels 
+		dtype :: str 
+			Either "float64", "float32", "int64", or "int32" 
 
-	def __populate_from_file(self, filename, columns = None, labels = None, 
-		comment = '#'): 
-		"""
-		Populate the dataframe with data stored in a given file. 
-		"""	
-		if not isinstance(filename, str): 
-			raise TypeError("filename must be of type str. Got: %s" % (
-				type(filename))) 
-		elif not isinstance(columns, list): 
-			raise TypeError("""\
-Keyword arg columns must be of type list. Got: %s""" % (type(columns))) 
-		elif not isinstance(labels, list): 
-			raise TypeError("""\
-Keyword arg labels must be of type list. Got: %s""" % (type(labels))) 
-		elif not all(map(lambda x: isinstance(x, numbers.Number), columns)): 
-			raise TypeError("Non-numerical value detected in columns.") 
-		elif not all(map(lambda x: isinstance(x, str), labels)): 
-			raise TypeError("Non-string object detected in labels.") 
-		elif not all(map(lambda x: x % 1 == 0, columns)): 
-			raise ValueError("Columns must contain only int-like numbers.") 
-		elif not os.path.exists(filename): 
-			raise IOError("File not found: %s" % (filename)) 
-		else: 
-			if len(columns) == len(labels): 
-				columns = [int(i) for i in columns] 
-				ptr = len(columns) * c_int 
-				if clib.populate_from_file(
-					byref(self.__mirror), 
-					filename.encode("latin-1"), 
-					comment.encode("latin-1"), 
-					ptr(*columns[:]), 
-					c_int(len(columns)) 
-				):
-					raise IOError("Error reading file: %s" % (filename)) 
-				else: 
-					self.__labels = tuple([i.lower() for i in labels])  
-			else: 
-				raise ValueError("""\
-Keyword args columns and labels must be of equal length. columns: %d \
-labels: %d""" % (len(columns), len(labels))) 
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+		""" 
+		return _TYPE_NAMES_[self._df.columns[self.__column_index(key)].type] 
 
-	def min(self, key): 
+	def encode(self, key, scheme = "auto"): 
 		"""
-		Determine the minimum value of a given quantity in the data. 
+		Compress a given column in memory. Much of a halo catalog compresses 
+		well: the scale factor is the same for every halo in a snapshot, IDs 
+		are integers in a narrow range, and flags take only a few values. 
+		Encoded columns are read like any other, and statistics, sieves, and 
+		histograms of run-length encoded columns take one step per run 
+		rather than per row. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the minimum value of 
+			The label for the column 
+		scheme :: str [case-insensitive] [default :: "auto"] 
+			The encoding: 
 
-		Returns 
-		======= 
-		minimum :: float 
-			The minimum value itself 
+			- "rle": Run-length; runs of equal values are stored once 
+			- "for": Frame of reference; integers are stored as offsets 
+			  from the smallest, packed into as few bits as they need 
+			- "shuffle": Byte k of every value is stored together, and 
+			  bytes which are the same for every value are stored once 
+			- "auto": The smallest of the above, if any is smaller than 
+			  the plain values, though run-length wins outright when it 
+			  takes an eighth of the memory or less 
+			- "plain": No encoding; decodes the column 
 
 		Raises 
 		====== 
@@ -276,37 +825,47 @@ labels: %d""" % (len(columns), len(labels)))
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
 			:: key is not of type str 
-		"""
-		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_min(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x 
-				): 
-					raise SystemError("Internal Error") 
-				else:
-					return x[0] 
+			:: scheme is not of type str 
+		ValueError :: 
+			:: scheme is not recognized 
+			:: scheme is "for" and the column is not of an integer type 
+
+		Notes 
+		===== 
+		The whole column is encoded, including rows other dataframes view 
+		but this one doesn't. Other dataframes sharing the column are 
+		unaffected. Taking the column with the array function decodes it. 
+		""" 
+		cdef int column = self.__column_index(key), c_scheme, status 
+		if isinstance(scheme, str): 
+			if scheme.lower() in _ENCODINGS_.keys(): 
+				c_scheme = _ENCODINGS_[scheme.lower()] 
 			else: 
-				raise KeyError("Unrecognized key: %s" % (key)) 
+				raise ValueError("Unrecognized encoding: %s" % (scheme)) 
 		else: 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+			raise TypeError("scheme must be of type str. Got: %s" % ( 
+				type(scheme))) 
+		with nogil: 
+			status = dfcolumn_encode(self._df, column, c_scheme) 
+		if status: 
+			raise ValueError("Encoding %s does not apply to a column of type %s." % ( 
+				scheme, self.dtype(key))) 
+		else: 
+			pass 
 
-	def max(self, key): 
+	def encoding(self, key): 
 		"""
-		Determine the maximum value of a given quantity in the data. 
+		The encoding a given column is stored with (see encode). 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the maximum value of 
+			The label for the column 
 
 		Returns 
 		======= 
-		maximum :: float 
-			The maximum value itself 
+		scheme :: str 
+			Either "plain", "rle", "for", or "shuffle" 
 
 		Raises 
 		====== 
@@ -315,75 +874,54 @@ labels: %d""" % (len(columns), len(labels)))
 		TypeError :: 
 			:: key is not of type str 
 		""" 
-		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_max(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x
-				): 
-					raise SystemError("Internal Error") 
-				else: 
-					return x[0] 
-			else: 
-				raise KeyError("Unrecognized key: %s" % (key)) 
-		else: 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
-
+		cdef COLUMN_BUFFER *buffer = self._df.columns[self.__column_index(key)] 
+		cdef int scheme = (buffer.encoding.scheme if buffer.encoding is not 
+			NULL else ENCODING_PLAIN) 
+		for name in _ENCODINGS_.keys(): 
+			if _ENCODINGS_[name] == scheme: return name 
+		raise SystemError("Internal Error") 
 
-	def sum(self, key): 
+	def nbytes(self, key): 
 		"""
-		Determine the sum of a given quantity for all data points. 
+		The number of bytes the values of a given column take in memory, 
+		encoded or not. This is the whole column, including rows other 
+		dataframes view but this one doesn't, and excludes the bitmap of 
+		missing values. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the sum of 
+			The label for the column 
 
 		Returns 
 		======= 
-		total :: float 
-			The maximum value itself 
+		nbytes :: int 
+			The number of bytes 
 
 		Raises 
 		====== 
 		KeyError :: 
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
-			:: key is not of type str
+			:: key is not of type str 
 		""" 
-		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_sum(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x
-				): 
-					raise SystemError("Internal Error") 
-				else: 
-					return x[0] 
-			else: 
-				raise KeyError("Unrecognized key: %s" % (key)) 
-		else: 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+		return column_buffer_nbytes( 
+			self._df.columns[self.__column_index(key)]) 
 
-	def mean(self, key): 
+	def mark_missing(self, key, sentinels): 
 		"""
-		Determine the arithmetic mean of a given quantity for all data points. 
+		Mark the values in a given column equal to any of a set of sentinels 
+		as missing. Halo catalogs use these for quantities that don't apply 
+		or weren't measured (e.g. pid = -1 for host halos). Every statistic, 
+		sieve, sort, and histogram skips missing values, so they don't need 
+		to be filtered out first. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the mean of 
-
-		Returns 
-		======= 
-		avg :: float 
-			The arithmetic mean of that quantity across all data points. 
+			The label for the column 
+		sentinels :: real number or array-like [elements are real numbers] 
+			The values which mean missing. A NaN marks NaNs missing. 
 
 		Raises 
 		====== 
@@ -391,37 +929,48 @@ labels: %d""" % (len(columns), len(labels)))
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
 			:: key is not of type str 
-		"""	
-		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_mean(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x
-				): 
-					raise SystemError("Internal Error") 
-				else: 
-					return x[0] 
+			:: sentinels are not real numbers 
+
+		Notes 
+		===== 
+		Only the rows this dataframe views are marked. Other dataframes 
+		sharing the column are unaffected. Missing values come back as None 
+		when taking a column or row, while arrays taken with the array 
+		function still hold the sentinels. 
+		""" 
+		cdef int column = self.__column_index(key), num_sentinels, status 
+		cdef double *ptr 
+		if isinstance(sentinels, numbers.Number): 
+			sentinels = [sentinels] 
+		else: 
+			sentinels = _copy_array_like_object(sentinels, "sentinels") 
+		if all(map(lambda x: isinstance(x, numbers.Number), sentinels)): 
+			values = _array('d', sentinels) 
+			ptr = _doubles(values) 
+			num_sentinels = len(values) 
+			with nogil: 
+				status = dfcolumn_mark_invalid(self._df, column, ptr, 
+					num_sentinels) 
+			if status: 
+				raise SystemError("Internal Error") 
 			else: 
-				raise KeyError("Unrecognized key: %s" % (key)) 
+				pass 
 		else: 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+			raise TypeError("Non-numerical value detected in sentinels.") 
 
-	def median(self, key): 
+	def count(self, key): 
 		"""
-		Determine the median of a given quantity for all data points. 
+		The number of values in a given column which aren't missing. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the median of 
+			The label for the column 
 
 		Returns 
 		======= 
-		med :: float 
-			The median value of that quantity across all data points 
+		n :: int 
+			The number of valid values 
 
 		Raises 
 		====== 
@@ -430,37 +979,229 @@ labels: %d""" % (len(columns), len(labels)))
 		TypeError :: 
 			:: key is not of type str 
 		""" 
-		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_median(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x
-				): 
-					raise SystemError("Internal Error") 
-				else: 
-					return x[0] 
+		cdef int column = self.__column_index(key), status 
+		cdef long n 
+		with nogil: 
+			status = dfcolumn_count_valid(self._df[0], column, &n) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return n 
+
+	def keys(self): 
+		"""
+		Obtain the dataframe keys in their lower-case format 
+
+		Returns 
+		======= 
+		keys :: list [elements of type str]
+			The strings which serve as case-insensitive dataframe keys 
+		"""
+		return self._labels 
+
+	def __populate_from_file(self, filename, columns = None, labels = None, 
+		comment = '#', types = None): 
+		"""
+		Populate the dataframe with data stored in a given file. types, if 
+		given, is a list of the type to store each column as ("float64", 
+		"float32", "int64", or "int32"); integer columns are parsed as 
+		integers, so IDs are read exactly. 
+		"""	
+		cdef char *c_filename 
+		cdef char c_comment 
+		cdef int *ptr 
+		cdef int *c_types = NULL 
+		cdef int num_cols, status 
+		if not isinstance(filename, str): 
+			raise TypeError("filename must be of type str. Got: %s" % (
+				type(filename))) 
+		elif not isinstance(columns, list): 
+			raise TypeError("""\
+Keyword arg columns must be of type list. Got: %s""" % (type(columns))) 
+		elif not isinstance(labels, list): 
+			raise TypeError("""\
+Keyword arg labels must be of type list. Got: %s""" % (type(labels))) 
+		elif not all(map(lambda x: isinstance(x, numbers.Number), columns)): 
+			raise TypeError("Non-numerical value detected in columns.") 
+		elif not all(map(lambda x: isinstance(x, str), labels)): 
+			raise TypeError("Non-string object detected in labels.") 
+		elif not all(map(lambda x: x % 1 == 0, columns)): 
+			raise ValueError("Columns must contain only int-like numbers.") 
+		elif types is not None and not (isinstance(types, list) and 
+			len(types) == len(columns)): 
+			raise TypeError("""\
+Keyword arg types must be a list of the same length as columns. Got: %s""" % ( 
+				type(types))) 
+		elif types is not None and not all(map(lambda x: x in 
+			_TYPE_NAMES_.values(), types)): 
+			raise ValueError("Unrecognized type in types: %s" % (types)) 
+		elif not os.path.exists(filename): 
+			raise IOError("File not found: %s" % (filename)) 
+		else: 
+			if len(columns) == len(labels): 
+				c_columns = _array('i', [int(i) for i in columns]) 
+				encoded = filename.encode("latin-1") 
+				c_filename = encoded 
+				c_comment = ord(comment[0]) 
+				ptr = _ints(c_columns) 
+				num_cols = len(columns) 
+				if types is not None: 
+					codes = dict([(v, k) for k, v in _TYPE_NAMES_.items()]) 
+					type_codes = _array('i', [codes[i] for i in types]) 
+					c_types = _ints(type_codes) 
+				else: 
+					pass 
+				with nogil: 
+					status = populate_from_file(self._df, c_filename, 
+						c_comment, ptr, num_cols, c_types) 
+				if status: 
+					raise IOError("Error reading file: %s" % (filename)) 
+				else: 
+					self._labels = tuple([i.lower() for i in labels])  
 			else: 
-				raise KeyError("Unrecognized key: %s" % (key)) 
+				raise ValueError("""\
+Keyword args columns and labels must be of equal length. columns: %d \
+labels: %d""" % (len(columns), len(labels))) 
+
+	@staticmethod 
+	def stream(filename, columns, labels = None, chunksize = 65536, 
+		comment = '#', types = None): 
+		"""
+		Read an hlist or other ASCII file in chunks of rows without reading 
+		the whole file into memory. 
+
+		Parameters 
+		========== 
+		filename :: str 
+			The name of the file 
+		columns :: list [elements are integers] 
+			The column numbers in the file to read 
+		labels :: list [elements are str] [default :: None] 
+			The labels of the columns; defaults to the column numbers as 
+			strings 
+		chunksize :: int [default :: 65536] 
+			The number of rows in each chunk 
+		comment :: char [default :: '#'] 
+			Lines beginning with this character are skipped 
+		types :: list [elements are str] [default :: None] 
+			The type to store each column as ("float64", "float32", "int64", 
+			or "int32"). Integer columns are parsed as integers, so IDs are 
+			read exactly. Defaults to float64 for every column. 
+
+		Returns 
+		======= 
+		chunks :: dataframe_stream 
+			An iterator over the chunks of the file, each a dataframe 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: filename is not of type str 
+			:: columns is not a list of integers 
+			:: labels is not a list of str the length of columns 
+			:: chunksize is not a positive integer 
+			:: types is not a list the length of columns 
+		ValueError :: 
+			:: types contains an unrecognized type 
+		IOError :: 
+			:: The file does not exist or could not be opened 
+			:: A line of the file has too few columns (raised while iterating) 
+
+		Notes 
+		===== 
+		The next chunk is parsed on a separate thread while the current one 
+		is used, and the memory of chunks which are no longer referenced is 
+		reused, so a loop over the chunks runs in the memory of a few 
+		chunks. Chunks which are kept (e.g. appended to a list, or exported 
+		with dataframe.array) stay valid; the stream allocates new memory in 
+		their place. 
+
+		Example 
+		======= 
+		Sum the masses (column 10) of the halos in a tree file: 
+
+		>>> total = 0 
+		>>> for chunk in ultra.dataframe.stream("tree_0_0_0.dat", [1, 10], 
+			labels = ["id", "mvir"], types = ["int64", "float64"]): 
+		...     total += chunk.sum("mvir") 
+		""" 
+		cdef dataframe_stream result 
+		cdef char *c_filename 
+		cdef char c_comment 
+		cdef int *c_cols 
+		cdef int *c_types = NULL 
+		cdef int num_cols 
+		cdef long c_chunksize 
+		if not isinstance(filename, str): 
+			raise TypeError("filename must be of type str. Got: %s" % ( 
+				type(filename))) 
+		elif not isinstance(columns, list) or not all(map(lambda x: 
+			isinstance(x, numbers.Number) and x % 1 == 0 and x >= 0, columns)): 
+			raise TypeError("columns must be a list of non-negative integers.") 
+		elif not isinstance(chunksize, numbers.Number) or chunksize % 1 != 0 or ( 
+			chunksize < 1): 
+			raise TypeError("chunksize must be a positive integer. Got: %s" % ( 
+				str(chunksize))) 
+		elif not isinstance(comment, str): 
+			raise TypeError("comment must be of type str. Got: %s" % ( 
+				type(comment))) 
+		elif types is not None and not (isinstance(types, list) and 
+			len(types) == len(columns)): 
+			raise TypeError("""\
+Keyword arg types must be a list of the same length as columns. Got: %s""" % ( 
+				type(types))) 
+		elif types is not None and not all(map(lambda x: x in 
+			_TYPE_NAMES_.values(), types)): 
+			raise ValueError("Unrecognized type in types: %s" % (types)) 
+		elif not os.path.exists(filename): 
+			raise IOError("File not found: %s" % (filename)) 
 		else: 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+			pass 
+		if labels is None: 
+			labels = [str(int(i)) for i in columns] 
+		elif (not isinstance(labels, list) or len(labels) != len(columns) or 
+			not all(map(lambda x: isinstance(x, str), labels))): 
+			raise TypeError("labels must be a list of str, one per column.") 
+		else: 
+			pass 
 
-	def std(self, key): 
+		result = dataframe_stream.__new__(dataframe_stream) 
+		result._filename = filename 
+		result._labels = tuple([i.lower() for i in labels]) 
+		cols = _array('i', [int(i) for i in columns]) 
+		if types is not None: 
+			codes = dict([(v, k) for k, v in _TYPE_NAMES_.items()]) 
+			type_codes = _array('i', [codes[i] for i in types]) 
+			c_types = _ints(type_codes) 
+		else: 
+			pass 
+		encoded = filename.encode("latin-1") 
+		c_filename = encoded 
+		c_comment = ord(comment[0]) 
+		c_cols = _ints(cols) 
+		num_cols = len(columns) 
+		c_chunksize = chunksize 
+		with nogil: 
+			result._stream = stream_initialize(c_filename, c_comment, c_cols, 
+				num_cols, c_types, c_chunksize) 
+		if result._stream is NULL: 
+			raise IOError("Error opening file: %s" % (filename)) 
+		else: 
+			return result 
+
+	def min(self, key): 
 		"""
-		Determine the standard deviation of a given quantity for all data 
-		points. 
+		Determine the minimum value of a given quantity in the data. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to find the mean of 
+			The label for the quantity to find the minimum value of 
 
 		Returns 
 		======= 
-		dev :: float 
-			The standard deviation of the data 
+		minimum :: float 
+			The minimum value itself 
 
 		Raises 
 		====== 
@@ -469,37 +1210,35 @@ labels: %d""" % (len(columns), len(labels)))
 		TypeError :: 
 			:: key is not of type str 
 		"""
+		cdef int column, status 
+		cdef double x 
 		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				ptr = 1 * c_double 
-				x = ptr(*[0]) 
-				if clib.dfcolumn_std(
-					self.__mirror, 
-					c_int(self.__labels.index(key.lower())), 
-					x
-				): 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_min(self._df[0], column, &x) 
+				if status: 
 					raise SystemError("Internal Error") 
 				else: 
-					return x[0] 
+					return x 
 			else: 
 				raise KeyError("Unrecognized key: %s" % (key)) 
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	def sieve(self, key, relation, value): 
+	def max(self, key): 
 		"""
-		Filter the data based on the values stored in a given column. The 
-		data that pass the filter will be those that satisfy the relation 
-		data[key] relation value 
+		Determine the maximum value of a given quantity in the data. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the quantity to filter based on 
-		relation :: str 
-			Either '>', '>=', '=', '==', '!=', <=', or '<' 
-		value :: real number 
-			A reference value to filter based on 
+			The label for the quantity to find the maximum value of 
+
+		Returns 
+		======= 
+		maximum :: float 
+			The maximum value itself 
 
 		Raises 
 		====== 
@@ -507,183 +1246,111 @@ labels: %d""" % (len(columns), len(labels)))
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
 			:: key is not of type str 
-			:: value is not a real number 
-			:: relation is not of type str 
-		ValueError :: 
-			:: relation is not a valid string 
-		"""	
-		relational_codes = {
-			"<": 		1, 
-			"<=": 		2, 
-			"=": 		3, 
-			"==": 		3, 
-			">=": 		4, 
-			">": 		5, 
-			"!=": 		6 
-		} 
-
+		""" 
+		cdef int column, status 
+		cdef double x 
 		if isinstance(key, str): 
-			if isinstance(value, numbers.Number): 
-				if isinstance(relation, str): 
-					if key.lower() in self.__labels: 
-						if relation in relational_codes.keys(): 
-							mirror = __dataframe() 
-							if clib.sieve(
-								self.__mirror, 
-								byref(mirror), 
-								c_int(self.__labels.index(key.lower())), 
-								c_double(value), 
-								c_int(relational_codes[relation])
-							): 
-								raise SystemError("Internal Error") 
-							else: 
-								return dataframe(mirror, labels = self.__labels) 
-						else: 
-							raise ValueError("Unrecognized relation: %s" % (
-								relation)) 
-					else: 
-						raise KeyError("Unrecognized key: %s" % (key)) 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_max(self._df[0], column, &x) 
+				if status: 
+					raise SystemError("Internal Error") 
 				else: 
-					raise TypeError("relation must be of type str. Got: %s" % (
-						type(relation))) 
+					return x 
 			else: 
-				raise TypeError("value must be a real number. Got: %s" % (
-					type(value))) 
+				raise KeyError("Unrecognized key: %s" % (key)) 
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	def sort(self, key, binspace): 
+
+	def sum(self, key): 
 		"""
-		Sort the dataframe into bins based on the values in a given column. 
+		Determine the sum of a given quantity for all data points. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the column to sort based on 
+			The label for the quantity to find the sum of 
 
 		Returns 
 		======= 
-		frames :: list [elements of type dataframe] 
-			A list of dataframe objects whose elements are those which fall 
-			into the specified bins 
+		total :: float 
+			The maximum value itself 
 
 		Raises 
 		====== 
 		KeyError :: 
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
-			:: An element of binspace is non-numerical 
-			:: key is not of type str 
+			:: key is not of type str
 		""" 
+		cdef int column, status 
+		cdef double x 
 		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				copy = self.__copy_array_like_object(binspace, "binspace") 
-				if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
-					mirrors = (len(copy) - 1) * [None] 
-					for i in range(len(mirrors)): 
-							mirrors[i] = __dataframe()  
-					copy = sorted(copy)[:] 
-					for i in range(len(binspace) - 1): 
-						edges = [binspace[i], binspace[i + 1]] 
-						ptr = 2 * c_double 
-						if clib.dfcolumn_bin(
-							self.__mirror, 
-							byref(mirrors[i]), 
-							c_int(self.__labels.index(key.lower())), 
-							ptr(*edges[:]) 
-						): 
-							raise SystemError("Internal Error") 
-						else: 
-							continue 
-					return [dataframe(i, 
-						labels = self.__labels) for i in mirrors] 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_sum(self._df[0], column, &x) 
+				if status: 
+					raise SystemError("Internal Error") 
 				else: 
-					raise TypeError("Non-numerical value detected in binspace.") 
+					return x 
 			else: 
 				raise KeyError("Unrecognized key: %s" % (key)) 
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	def equal_number_subsamples(self, key, n): 
+	def mean(self, key): 
 		"""
-		Generate equal number bins of the data according to the values stored 
-		in a given column. 
+		Determine the arithmetic mean of a given quantity for all data points. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the column to bin based on 
-		n :: integer 
-			The number of samples to generate 
+			The label for the quantity to find the mean of 
 
 		Returns 
 		======= 
-		sorted :: list 
-			Dataframe objects in a list where each dataframe contains the data 
-			in a given bin. Each dataframe object will be approximately the same 
-			size by design, and they will be sorted from least to greatest 
-			based on the values in the specified column. 
+		avg :: float 
+			The arithmetic mean of that quantity across all data points. 
 
 		Raises 
 		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
 		TypeError :: 
 			:: key is not of type str 
-			:: n is not an integer 
-		ValueError :: 
-			:: n <= 0 
-		KeyError :: 
-			:: key is not recognized by the dataframe 
-		""" 
-		if not isinstance(key, str): 
-			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
-		elif not key.lower() in self.__labels: 
-			raise KeyError("Unrecognized key: %s" % (key)) 
-		elif not (isinstance(n, numbers.Number) and n % 1 == 0) :
-			raise TypeError("Second argument must be an integer. Got: %s" % (
-				type(n))) 
-		elif n <= 0: 
-			raise ValueError("""Second argument must be larger than zero. \
-Got: %d""" % (n)) 
-		else: 
-			pass 
-
-		# cdef DATAFRAME **mirrors = get_dataframe_array(n) 
-		# if clib.equal_number_samples(self.__mirror, mirros, 
-		# 	c_int(self.__labels.index(key.lower())), c_int(n)): 
-		# 	raise SystemError("Internal Error") 
-		# else: 
-		# 	results = [dataframe(mirrorDATAFRAME(mirrors[i][0]), 
-		# 		labels = self.__labels) for i in range(n)] 
-		# 	free(mirrors) 
-		# 	return results 
-
-		dummy = dataframe(self.__mirror, labels = self.__labels) 
-		dummy.order(key) 
-		mirrors = n * [None] 
-		for i in range(n): 
-			mirrors[i] = __dataframe() 
-			if clib.dfcolumn_equal_number_subsample(
-				dummy._dataframe__mirror, 
-				byref(mirrors[i]), 
-				c_int(n), 
-				c_int(i)
-			): 
-				raise SystemError("Internal Error") 
+		"""	
+		cdef int column, status 
+		cdef double x 
+		if isinstance(key, str): 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_mean(self._df[0], column, &x) 
+				if status: 
+					raise SystemError("Internal Error") 
+				else: 
+					return x 
 			else: 
-				continue 
-		del dummy 
-		return [dataframe(i, labels = self.__labels) for i in mirrors] 
-
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	def order(self, key): 
+	def median(self, key): 
 		"""
-		Sort the dataframe in ascending order based on the data in a given 
-		column. 
+		Determine the median of a given quantity for all data points. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the column to sort based on 
+			The label for the quantity to find the median of 
+
+		Returns 
+		======= 
+		med :: float 
+			The median value of that quantity across all data points 
 
 		Raises 
 		====== 
@@ -692,126 +1359,462 @@ Got: %d""" % (n))
 		TypeError :: 
 			:: key is not of type str 
 		""" 
+		cdef int column, status 
+		cdef double x 
 		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				if clib.dfcolumn_order(
-					byref(self.__mirror), 
-					c_int(self.__labels.index(key.lower()))
-				): 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_median(self._df[0], column, &x) 
+				if status: 
 					raise SystemError("Internal Error") 
 				else: 
-					pass 
+					return x 
 			else: 
 				raise KeyError("Unrecognized key: %s" % (key)) 
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	def scatter(self, key, value = 68.2): 
+	def std(self, key): 
 		"""
-		Measure the dispersion in a given column of the data given a percentage 
-		value. 
+		Determine the standard deviation of a given quantity for all data 
+		points. 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The key to the dataframe to measure the scatter for 
-		value :: real number between 0 and 100 
-			The percentile range to measure 
+			The label for the quantity to find the mean of 
 
 		Returns 
 		======= 
-		lower :: real number 
-			A lower bound 
-		upper :: real number 
-			An upper bound 
-		Lower and upper are defined such that the specified percentage of the 
-		data points lie between these values, centered on the median. 
+		dev :: float 
+			The standard deviation of the data 
 
 		Raises 
 		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
 		TypeError :: 
 			:: key is not of type str 
-			:: value is not a real number 
-		ValueError :: 
-			:: value is not between 0 and 100 
-		KeyError :: 
-			:: key is not in the dataframe 
-		""" 
+		"""
+		cdef int column, status 
+		cdef double x 
 		if isinstance(key, str): 
-			if key.lower() in self.__labels: 
-				if isinstance(value, numbers.Number): 
-					if 0 <= value <= 100: 
-						ptr = 2 * c_double 
-						x = ptr(*[0, 0][:]) 
-						if clib.dfcolumn_scatter(
-							self.__mirror, 
-							c_int(self.__labels.index(key.lower())), 
-							c_double(value / 100), 
-							x
-						): 
-							raise SystemError("Internal Error.") 
-						else: 
-							return [x[0], x[1]] 
-					else: 
-						raise ValueError("""Keyword arg 'value' must be between \
-0 and 100. Got: %g""" % (value)) 
+			if key.lower() in self._labels: 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_std(self._df[0], column, &x) 
+				if status: 
+					raise SystemError("Internal Error") 
 				else: 
-					raise TypeError("""Keyword arg 'value' must be a numerical \
-value. Got: %s""" % (type(value))) 
+					return x 
 			else: 
 				raise KeyError("Unrecognized key: %s" % (key)) 
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-
-	def hist(self, key, binspace): 
+	def sieve(self, key, relation, value): 
 		"""
-		Determine counts within a given binspace (i.e. a histogram) of the 
-		data based on the values stored in a given column. 
+		Filter the data based on the values stored in a given column. The 
+		data that pass the filter will be those that satisfy the relation 
+		data[key] relation value 
 
 		Parameters 
 		========== 
 		key :: str [case-insensitive] 
-			The label for the column to histogram 
-		binspace :: array-like [elements are real numbers] 
-			The bin-edges to histogram based on 
+			The label for the quantity to filter based on 
+		relation :: str 
+			Either '>', '>=', '=', '==', '!=', <=', or '<' 
+		value :: real number 
+			A reference value to filter based on. An integer is compared to 
+			the values of an integer column exactly. 
+
+		Notes 
+		===== 
+		If the column is indexed (see create_index), the rows are found in 
+		O(log n + k) time for k rows rather than by a scan, except for !=. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: value is not a real number 
+			:: relation is not of type str 
+		ValueError :: 
+			:: relation is not a valid string 
+		"""	
+		cdef DATAFRAME dest 
+		cdef COLUMN_INDEX *idx 
+		cdef int column, code, status 
+		cdef double c_value 
+		cdef long long c_integer 
+		cdef bint exact 
+		relational_codes = {
+			"<": 		1, 
+			"<=": 		2, 
+			"=": 		3, 
+			"==": 		3, 
+			">=": 		4, 
+			">": 		5, 
+			"!=": 		6 
+		} 
+
+		if isinstance(key, str): 
+			if isinstance(value, numbers.Number): 
+				if isinstance(relation, str): 
+					if key.lower() in self._labels: 
+						if relation in relational_codes.keys(): 
+							column = self._labels.index(key.lower()) 
+							exact = (isinstance(value, numbers.Integral) and 
+								-2**63 <= value < 2**63) 
+							c_value = value 
+							c_integer = value if exact else 0 
+							code = relational_codes[relation] 
+							idx = self._index(column) 
+							memset(&dest, 0, sizeof(DATAFRAME)) 
+							with nogil: 
+								status = indexed_sieve(self._df[0], &dest, 
+									column, idx, c_value, &c_integer if exact 
+									else NULL, code) 
+							if status: 
+								raise SystemError("Internal Error") 
+							else: 
+								return dataframe._wrap(dest, self._labels) 
+						else: 
+							raise ValueError("Unrecognized relation: %s" % (
+								relation)) 
+					else: 
+						raise KeyError("Unrecognized key: %s" % (key)) 
+				else: 
+					raise TypeError("relation must be of type str. Got: %s" % (
+						type(relation))) 
+			else: 
+				raise TypeError("value must be a real number. Got: %s" % (
+					type(value))) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+	def join(self, other, key, other_key = None, how = "inner", 
+		strategy = "auto", suffix = "_right"): 
+		"""
+		Join another dataframe onto this one, pairing each row of this one 
+		with the rows of the other holding the same value in a key column, 
+		as in matching halos to their progenitors (ID with DESC_ID) or 
+		subhalos to their hosts (PID with ID). 
+
+		Parameters 
+		========== 
+		other :: dataframe 
+			The dataframe to join onto this one 
+		key :: str [case-insensitive] 
+			The label for the key column of this dataframe 
+		other_key :: str [case-insensitive] [default :: None] 
+			The label for the key column of the other dataframe. None to 
+			take the same label as key. 
+		how :: str [case-insensitive] [default :: "inner"] 
+			Either "inner" to keep only the rows which match, or "left" to 
+			also keep the rows of this dataframe matching nothing 
+		strategy :: str [case-insensitive] [default :: "auto"] 
+			Either "hash" for a partitioned, parallel hash join, "merge" to 
+			walk both dataframes in step, which needs both to be sorted on 
+			their keys (see order), or "auto" to merge if they are and hash 
+			if not 
+		suffix :: str [default :: "_right"] 
+			A suffix for the labels of the columns of the other dataframe 
+			that this dataframe also has 
 
 		Returns 
 		======= 
-		counts :: list [elements are positive integers] 
-			The number of data points whose value falls within the specified 
-			bin edges 
+		joined :: dataframe 
+			Every column of this dataframe followed by every column of the 
+			other except its key, with a row for each pair of rows. In a 
+			left join, the values of the other's columns are missing (see 
+			count) in the rows matching nothing. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: A key is not recognized by its dataframe 
+		TypeError :: 
+			:: other is not a dataframe 
+			:: key or other_key is not of type str 
+			:: how, strategy, or suffix is not of type str 
+		ValueError :: 
+			:: how or strategy is not recognized 
+			:: strategy is "merge" and a dataframe isn't sorted on its key 
+			:: suffix leaves two columns with the same label 
+
+		Notes 
+		===== 
+		The rows come in order of the row of this dataframe, then of the 
+		row of the other, whichever the strategy. Keys are compared 
+		exactly as integers if both key columns are of integer types (see 
+		dtype), and as doubles if not. Missing values and NaNs match 
+		nothing. 
+		""" 
+		cdef COLUMN_BUFFER *lrows 
+		cdef COLUMN_BUFFER *rrows 
+		cdef DATAFRAME dest 
+		cdef dataframe c_other 
+		cdef int rcolumn, status 
+		if not isinstance(suffix, str): 
+			raise TypeError("suffix must be of type str. Got: %s" % ( 
+				type(suffix))) 
+		else: 
+			pass 
+		self._join_rows(other, key, other_key, how, strategy, &lrows, &rrows) 
+		c_other = other 
+		rcolumn = c_other.__column_index(key if other_key is None else 
+			other_key) 
+		labels = list(self._labels) 
+		for i in range(len(c_other._labels)): 
+			if i == rcolumn: continue 
+			label = c_other._labels[i] 
+			labels.append(label + suffix.lower() if label in self._labels 
+				else label) 
+		if len(set(labels)) < len(labels): 
+			column_buffer_release(lrows) 
+			column_buffer_release(rrows) 
+			raise ValueError("suffix %s leaves duplicate labels." % (suffix)) 
+		else: 
+			pass 
+		memset(&dest, 0, sizeof(DATAFRAME)) 
+		with nogil: 
+			status = dataframe_join(self._df[0], c_other._df[0], lrows, rrows, 
+				rcolumn, &dest) 
+			column_buffer_release(lrows) 
+			column_buffer_release(rrows) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return dataframe._wrap(dest, tuple(labels)) 
+
+	def join_rows(self, other, key, other_key = None, how = "inner", 
+		strategy = "auto"): 
+		"""
+		Pair each row of this dataframe with the rows of another holding the 
+		same value in a key column, as in join, without building the joined 
+		dataframe. 
+
+		Parameters 
+		========== 
+		other :: dataframe 
+			The dataframe to join onto this one 
+		key :: str [case-insensitive] 
+			The label for the key column of this dataframe 
+		other_key :: str [case-insensitive] [default :: None] 
+			The label for the key column of the other dataframe. None to 
+			take the same label as key. 
+		how :: str [case-insensitive] [default :: "inner"] 
+			Either "inner" or "left" (see join) 
+		strategy :: str [case-insensitive] [default :: "auto"] 
+			Either "hash", "merge", or "auto" (see join) 
+
+		Returns 
+		======= 
+		rows :: numpy.ndarray [or memoryview] [int64] 
+			The row of this dataframe in each pair 
+		other_rows :: numpy.ndarray [or memoryview] [int64] 
+			The row of the other dataframe in each pair; -1 for the rows of 
+			this dataframe matching nothing in a left join 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: A key is not recognized by its dataframe 
+		TypeError :: 
+			:: other is not a dataframe 
+			:: key or other_key is not of type str 
+			:: how or strategy is not of type str 
+		ValueError :: 
+			:: how or strategy is not recognized 
+			:: strategy is "merge" and a dataframe isn't sorted on its key 
+		""" 
+		cdef COLUMN_BUFFER *lrows 
+		cdef COLUMN_BUFFER *rrows 
+		self._join_rows(other, key, other_key, how, strategy, &lrows, &rrows) 
+		# The exports hold their own references to the buffers 
+		lexport = _column_export.wrap(lrows, 0, lrows.length, True) 
+		rexport = _column_export.wrap(rrows, 0, rrows.length, True) 
+		column_buffer_release(lrows) 
+		column_buffer_release(rrows) 
+		if "numpy" in sys.modules: 
+			return (_np.asarray(lexport), _np.asarray(rexport)) 
+		else: 
+			return (memoryview(lexport), memoryview(rexport)) 
+
+	cdef int _join_rows(self, other, key, other_key, how, strategy, 
+		COLUMN_BUFFER **lrows, COLUMN_BUFFER **rrows) except -1: 
+		"""
+		Pair the rows of this dataframe and another as in join, putting 
+		buffers of the rows of each into lrows and rrows. 
+		""" 
+		cdef dataframe c_other 
+		cdef int lcolumn, rcolumn, c_how, c_strategy, status 
+		if isinstance(other, dataframe): 
+			c_other = other 
+		else: 
+			raise TypeError("other must be a dataframe. Got: %s" % ( 
+				type(other))) 
+		lcolumn = self.__column_index(key) 
+		rcolumn = c_other.__column_index(key if other_key is None else 
+			other_key) 
+		if isinstance(how, str) and isinstance(strategy, str): 
+			if how.lower() in _JOIN_HOWS_.keys(): 
+				c_how = _JOIN_HOWS_[how.lower()] 
+			else: 
+				raise ValueError("Unrecognized join: %s" % (how)) 
+			if strategy.lower() in _JOIN_STRATEGIES_.keys(): 
+				c_strategy = _JOIN_STRATEGIES_[strategy.lower()] 
+			else: 
+				raise ValueError("Unrecognized strategy: %s" % (strategy)) 
+		else: 
+			raise TypeError("how and strategy must be of type str.") 
+		with nogil: 
+			status = dfjoin_rows(self._df[0], lcolumn, c_other._df[0], 
+				rcolumn, c_how, c_strategy, lrows, rrows) 
+		if status and c_strategy == JOIN_MERGE: 
+			raise ValueError("""A merge join needs both dataframes sorted on \
+their keys.""") 
+		elif status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return 0 
+
+	def groupby(self, keys, strategy = "auto"): 
+		"""
+		Split the rows of the dataframe into groups sharing the values in 
+		one or more key columns, as in the subhalos of each host (PID) or 
+		the halos of each merger tree (TREE_ROOT_ID), to take statistics 
+		within each group (see dataframe_groups.agg). 
+
+		Parameters 
+		========== 
+		keys :: str or list [elements of type str] [case-insensitive] 
+			The label(s) for the key column(s) 
+		strategy :: str [case-insensitive] [default :: "auto"] 
+			Either "hash" to gather the groups into per-thread hash tables 
+			merged at the end, which is fastest when there are few groups, 
+			"sort" to sort the rows on their keys, which is fastest when 
+			most keys are distinct, or "auto" to choose between them based 
+			on the number of distinct keys in a sample of the rows 
+
+		Returns 
+		======= 
+		groups :: dataframe_groups 
+			The groups of the rows 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any key is not recognized by this dataframe 
+		TypeError :: 
+			:: keys is neither a str nor a list of them 
+			:: strategy is not of type str 
+		ValueError :: 
+			:: keys is empty 
+			:: strategy is not recognized 
+
+		Notes 
+		===== 
+		The groups are in ascending order of their keys, whichever the 
+		strategy. Rows missing a key (see count) or holding a NaN in one 
+		are in no group. The groups are of the rows of the dataframe as it 
+		is now; later changes to it do not change them. 
+
+		Example 
+		======= 
+		>>> df.groupby("pid").agg({"mvir": ["count", "sum"]}) 
+		""" 
+		if isinstance(keys, str): keys = [keys] 
+		if not isinstance(keys, list): 
+			raise TypeError("keys must be of type str or list. Got: %s" % ( 
+				type(keys))) 
+		elif not len(keys): 
+			raise ValueError("At least one key is required.") 
+		elif not isinstance(strategy, str): 
+			raise TypeError("strategy must be of type str. Got: %s" % ( 
+				type(strategy))) 
+		elif strategy.lower() not in _GROUPBY_STRATEGIES_.keys(): 
+			raise ValueError("Unrecognized strategy: %s" % (strategy)) 
+		else: 
+			pass 
+		columns = _array('i', [self.__column_index(i) for i in keys]) 
+		cdef dataframe_groups result = dataframe_groups.__new__( 
+			dataframe_groups) 
+		result._labels = self._labels 
+		result._columns = columns 
+		result._groups = _zeros('l', self._df.num_rows) 
+		cdef int c_strategy = _GROUPBY_STRATEGIES_[strategy.lower()] 
+		cdef int num_keys = len(columns), status 
+		cdef int *ptr_columns = _ints(columns) 
+		cdef long *ptr_groups = _longs(result._groups) 
+		with nogil: 
+			# A snapshot, so that e.g. a later order doesn't misalign it 
+			status = dataframe_slice(self._df[0], result._df, 0l, 
+				self._df.num_rows) 
+			if not status: status = dfgroup(result._df[0], ptr_columns, 
+				num_keys, c_strategy, ptr_groups, &result._num_groups, 
+				&result._first) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return result 
+
+	def sort(self, key, binspace): 
+		"""
+		Sort the dataframe into bins based on the values in a given column. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to sort based on 
+
+		Returns 
+		======= 
+		frames :: list [elements of type dataframe] 
+			A list of dataframe objects whose elements are those which fall 
+			into the specified bins 
 
 		Raises 
 		====== 
 		KeyError :: 
 			:: The label is not recognized by this dataframe 
 		TypeError :: 
-			:: Any element of binspace is non-numerical 
+			:: An element of binspace is non-numerical 
 			:: key is not of type str 
-		""" 
+
+		Notes 
+		===== 
+		If the column is indexed (see create_index), the rows in each bin 
+		are found in O(log n + k) time for k rows rather than by a scan. 
+		"""
+		cdef DATAFRAME dest 
+		cdef double edges[2] 
+		cdef COLUMN_INDEX *idx 
+		cdef int column, status 
 		if isinstance(key, str): 
-			# if the key is recognized 
-			if key.lower() in self.__labels: 
-				# Get a copy of the bins and make sure it's all real numbers 
-				copy = self.__copy_array_like_object(binspace, "binspace") 
+			if key.lower() in self._labels: 
+				copy = _copy_array_like_object(binspace, "binspace") 
 				if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
-					# get the counts from C 
-					ptr = (len(binspace) - 1) * c_long 
-					counts = ptr( *((len(binspace) - 1) * [0]) ) 
-					ptr = len(binspace) * c_double 
-					binspace = ptr(*sorted(copy)[:]) 
-					if clib.hist( 
-						self.__mirror, 
-						c_int(self.__labels.index(key.lower())), 
-						binspace, 
-						c_long(len(binspace) - 1l), 
-						counts 
-					): 
-						raise SystemError("Internal Error") 
-					else: 
-						# return the counts 
-						return [counts[i] for i in range(len(binspace) - 1l)] 
+					frames = (len(copy) - 1) * [None] 
+					column = self._labels.index(key.lower()) 
+					idx = self._index(column) 
+					copy = sorted(copy)[:] 
+					for i in range(len(binspace) - 1): 
+						edges[0] = copy[i] 
+						edges[1] = copy[i + 1] 
+						memset(&dest, 0, sizeof(DATAFRAME)) 
+						with nogil: 
+							status = indexed_bin(self._df[0], &dest, column, 
+								idx, edges) 
+						if status: 
+							raise SystemError("Internal Error") 
+						else: 
+							frames[i] = dataframe._wrap(dest, self._labels) 
+					return frames 
 				else: 
 					raise TypeError("Non-numerical value detected in binspace.") 
 			else: 
@@ -819,38 +1822,2363 @@ value. Got: %s""" % (type(value)))
 		else: 
 			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
 
-	@staticmethod 
-	def __copy_array_like_object(arg, name): 
+	def equal_number_subsamples(self, key, n): 
+		"""
+		Generate equal number bins of the data according to the values stored 
+		in a given column. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to bin based on 
+		n :: integer 
+			The number of samples to generate 
+
+		Returns 
+		======= 
+		sorted :: list 
+			Dataframe objects in a list where each dataframe contains the data 
+			in a given bin. Each dataframe object will be approximately the same 
+			size by design, and they will be sorted from least to greatest 
+			based on the values in the specified column. Within each one, the 
+			data keep their original order. 
+
+		Notes 
+		===== 
+		The dataframe is not sorted: the bin edges are found by selection, 
+		and the rows are shared with this dataframe rather than copied. 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: key is not of type str 
+			:: n is not an integer 
+		ValueError :: 
+			:: n <= 0 
+		KeyError :: 
+			:: key is not recognized by the dataframe 
+		""" 
+		if not isinstance(key, str): 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+		elif not key.lower() in self._labels: 
+			raise KeyError("Unrecognized key: %s" % (key)) 
+		elif not (isinstance(n, numbers.Number) and n % 1 == 0) :
+			raise TypeError("Second argument must be an integer. Got: %s" % (
+				type(n))) 
+		elif n <= 0: 
+			raise ValueError("""Second argument must be larger than zero. \
+Got: %d""" % (n)) 
+		else: 
+			pass 
+
+		cdef int column = self._labels.index(key.lower()), num_subs = n 
+		cdef int status 
+		cdef DATAFRAME *dests = <DATAFRAME *> calloc(num_subs, 
+			sizeof(DATAFRAME)) 
+		with nogil: 
+			status = dfcolumn_equal_number_partition(self._df[0], column, 
+				num_subs, dests) 
+		try: 
+			if status: 
+				raise SystemError("Internal Error") 
+			else: 
+				return [dataframe._wrap(dests[i], self._labels) for i in 
+					range(num_subs)] 
+		finally: 
+			free(dests) 
+
+	def order(self, keys, ascending = True): 
 		"""
-		Takes an array like object and returns a copy of it as a native python 
-		list. 
+		Sort the dataframe based on the data in one or more columns. Only 
+		its view of the data is reordered; no column is copied until it is 
+		next read. 
 
 		Parameters 
 		========== 
-		arg :: array-like 
-			Some sort of array-like object. 
-		name :: str 
-			The name of the object, for exception raising purposes 
+		keys :: str or list [elements of type str] [case-insensitive] 
+			The label(s) for the column(s) to sort based on. Rows are 
+			ordered by the first, then those tied in it by the second, and 
+			so on. 
+		ascending :: bool or list [elements of type bool] [default :: True] 
+			Whether to sort on every column, or on each column, in 
+			ascending rather than descending order 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any label is not recognized by this dataframe 
+		TypeError :: 
+			:: keys is neither a str nor a list of them 
+			:: ascending is neither a bool nor a list of them 
+		ValueError :: 
+			:: keys is empty 
+			:: ascending is a list not as long as keys 
+
+		Notes 
+		===== 
+		The sort is stable: rows tied in every column keep their order. 
+		Rows missing a value in a column (see count), or holding a NaN, go 
+		after the others tied with them in the columns before it, whether 
+		ascending or descending. Integer columns are compared exactly. 
+
+		Example 
+		======= 
+		Each merger tree together, from its root back in time: 
+
+		>>> df.order(["tree_root_id", "scale", "id"], 
+			ascending = [True, False, True]) 
+		""" 
+		columns, descending = self.__sort_keys(keys, ascending) 
+		cdef int num_keys = len(columns), status 
+		cdef int *ptr_columns = _ints(columns) 
+		cdef int *ptr_descending = _ints(descending) 
+		with nogil: 
+			status = dfcolumns_order(self._df, ptr_columns, ptr_descending, 
+				num_keys) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			pass 
+
+	def argsort(self, keys, ascending = True): 
+		"""
+		Determine the order of the rows of the dataframe sorted based on the 
+		data in one or more columns, as in order, without reordering it. 
+
+		Parameters 
+		========== 
+		keys :: str or list [elements of type str] [case-insensitive] 
+			The label(s) for the column(s) to sort based on (see order) 
+		ascending :: bool or list [elements of type bool] [default :: True] 
+			Whether to sort on every column, or on each column, in 
+			ascending rather than descending order 
 
 		Returns 
 		======= 
-		A copy of the object in a python list 
+		rows :: numpy.ndarray [or memoryview] [int64] 
+			The row numbers in sorted order 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any label is not recognized by this dataframe 
+		TypeError :: 
+			:: keys is neither a str nor a list of them 
+			:: ascending is neither a bool nor a list of them 
+		ValueError :: 
+			:: keys is empty 
+			:: ascending is a list not as long as keys 
+		""" 
+		columns, descending = self.__sort_keys(keys, ascending) 
+		rows = _zeros('l', self._df.num_rows) 
+		cdef int num_keys = len(columns), status 
+		cdef int *ptr_columns = _ints(columns) 
+		cdef int *ptr_descending = _ints(descending) 
+		cdef long *ptr_rows = _longs(rows) 
+		with nogil: 
+			status = dfcolumns_argsort(self._df[0], ptr_columns, 
+				ptr_descending, num_keys, ptr_rows) 
+		if status: 
+			raise SystemError("Internal Error") 
+		elif "numpy" in sys.modules: 
+			return _np.asarray(rows) 
+		else: 
+			return memoryview(rows) 
+
+	def __sort_keys(self, keys, ascending): 
 		"""
-		if "numpy" in sys.modules and isinstance(arg, _np.ndarray): 
-			# Turn a numpy array into a list 
-			copy = arg.tolist()[:] 
-		elif "pandas" in sys.modules and isinstance(arg, _pd.DataFrame): 
-			# Turn a pandas DataFrame into a list 
-			copy = [i[0] for i in arg.values.tolist()][:] 
-		elif type(arg) in [list, tuple]: 
-			# pull a copy if it's native python 
-			copy = arg[:] 
+		Convert the keys and ascending arguments of order and argsort into 
+		arrays of the column numbers and of whether or not each is sorted 
+		in descending order. 
+		""" 
+		if isinstance(keys, str): keys = [keys] 
+		if not isinstance(keys, list): 
+			raise TypeError("keys must be of type str or list. Got: %s" % ( 
+				type(keys))) 
+		elif not len(keys): 
+			raise ValueError("At least one key is required.") 
 		else: 
-			raise TypeError("""\
-Argument %s must be an array-like object. Got: %s""" % (name, type(arg))) 
+			pass 
+		if isinstance(ascending, bool): ascending = len(keys) * [ascending] 
+		if not isinstance(ascending, list): 
+			raise TypeError("ascending must be of type bool or list. Got: %s" % ( 
+				type(ascending))) 
+		elif len(ascending) != len(keys): 
+			raise ValueError("""ascending must be as long as keys. Got: %d. \
+Must be: %d""" % (len(ascending), len(keys))) 
+		elif not all(map(lambda i: isinstance(i, bool), ascending)): 
+			raise TypeError("Elements of ascending must be of type bool.") 
+		else: 
+			return (_array('i', [self.__column_index(i) for i in keys]), 
+				_array('i', [int(not i) for i in ascending])) 
 
-		return copy 
+	def top(self, key, k, largest = True): 
+		"""
+		Find the k rows with the largest or smallest values in a column, 
+		without sorting the dataframe. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label of the column to rank by 
+		k :: int 
+			The number of rows to find 
+		largest :: bool [default :: True] 
+			Whether to find the largest values rather than the smallest 
 
+		Returns 
+		======= 
+		rows :: dataframe 
+			A view of the rows, best first. It has fewer than k rows if 
+			fewer hold a value. 
 
- 
+		Raises 
+		====== 
+		KeyError :: 
+			:: key is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: k is not a non-negative integer 
+
+		Notes 
+		===== 
+		Each thread keeps a heap of the best k rows of its share of the 
+		dataframe, so this takes one pass and O(k) memory per thread. Rows 
+		missing the value (see count) or holding a NaN are never chosen, and 
+		ties go to the earlier row. 
+
+		Example 
+		======= 
+		The ten most massive halos: 
 
+		>>> df.top("mvir", 10) 
+		""" 
+		cdef DATAFRAME dest 
+		cdef int column = self.__column_index(key), status 
+		cdef int c_largest = bool(largest) 
+		cdef long c_k, n = 0 
+		cdef long *ptr 
+		if not isinstance(k, numbers.Number) or k % 1 != 0 or k < 0: 
+			raise TypeError("k must be a non-negative integer. Got: %s" % ( 
+				str(k))) 
+		else: 
+			c_k = min(k, self._df.num_rows) 
+		rows = _zeros('l', c_k) 
+		ptr = _longs(rows) 
+		memset(&dest, 0, sizeof(DATAFRAME)) 
+		with nogil: 
+			status = dfcolumn_top(self._df[0], column, c_k, c_largest, ptr, &n) 
+			if not status: status = dataframe_select(self._df[0], &dest, 
+				ptr, n) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return dataframe._wrap(dest, self._labels) 
+
+	def sample(self, k, weights = None, seed = 0): 
+		"""
+		Draw a random sample of the rows without replacement. 
+
+		Parameters 
+		========== 
+		k :: int 
+			The number of rows to draw 
+		weights :: str [case-insensitive] [default :: None] 
+			The label of a column of weights, making the probability of 
+			drawing each row proportional to its weight. None to draw every 
+			row with equal probability. 
+		seed :: int [default :: 0] 
+			The seed of the random numbers 
+
+		Returns 
+		======= 
+		rows :: dataframe 
+			A view of the rows drawn, in the order they appear in the 
+			dataframe. It has fewer than k rows if the dataframe has fewer 
+			(with positive weights). 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: weights is not recognized by this dataframe 
+		TypeError :: 
+			:: weights is neither None nor of type str 
+			:: k is not a non-negative integer 
+			:: seed is not a non-negative integer 
+
+		Notes 
+		===== 
+		Each row gets a random key, u^(1 / w) for a weight w and u uniform 
+		on (0, 1), and the k rows with the largest keys are kept 
+		(Efraimidis & Spirakis 2006). The random numbers depend only on the 
+		seed and the row, so a sample is the same for any number of 
+		threads. Rows with a missing, NaN or non-positive weight are never 
+		drawn. 
+		""" 
+		cdef DATAFRAME dest 
+		cdef int column = -1, status 
+		cdef unsigned long c_seed 
+		cdef long c_k, n = 0 
+		cdef long *ptr 
+		if weights is not None: column = self.__column_index(weights) 
+		if not isinstance(k, numbers.Number) or k % 1 != 0 or k < 0: 
+			raise TypeError("k must be a non-negative integer. Got: %s" % ( 
+				str(k))) 
+		elif not isinstance(seed, numbers.Number) or seed % 1 != 0 or seed < 0: 
+			raise TypeError("seed must be a non-negative integer. Got: %s" % ( 
+				str(seed))) 
+		else: 
+			c_k = min(k, self._df.num_rows) 
+			c_seed = seed 
+		rows = _zeros('l', c_k) 
+		ptr = _longs(rows) 
+		memset(&dest, 0, sizeof(DATAFRAME)) 
+		with nogil: 
+			status = dataframe_sample(self._df[0], c_k, column, c_seed, ptr, 
+				&n) 
+			if not status: status = dataframe_select(self._df[0], &dest, 
+				ptr, n) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return dataframe._wrap(dest, self._labels) 
+
+	def create_index(self, key): 
+		"""
+		Index a column of the data, so that sieves (except !=), bins (see 
+		sort), and rank queries on it take O(log n + k) time for k rows 
+		rather than a scan of every row. This pays off when the same column 
+		is queried over and over, e.g. binning a catalog by mass. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to index 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+
+		Notes 
+		===== 
+		The index holds the rows in sorted order of the column, and every 
+		64th value in that order, taking about 8 bytes per row. Reordering 
+		the rows (see order) or modifying the column puts it out of date, in 
+		which case it is rebuilt when it is next used. Writes through a 
+		writable array of the column (see array) can't be seen, so taking 
+		one drops the index, as does reassigning the column, and the column 
+		is scanned instead for as long as the array exists. The same goes 
+		for a writable array the column references (see add_columns). 
+		"""
+		cdef int column = self.__column_index(key) 
+		self._indexes.pop(self._labels[column], None) 
+		self._index(column, True) 
+
+	def drop_index(self, key): 
+		"""
+		Drop the index of a column of the data (see create_index), freeing 
+		its memory. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the indexed column 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The column is not indexed 
+		TypeError :: 
+			:: key is not of type str 
+		"""
+		if not isinstance(key, str): 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+		elif key.lower() in self._indexes.keys(): 
+			del self._indexes[key.lower()] 
+		else: 
+			raise KeyError("Column is not indexed: %s" % (key)) 
+
+	@property 
+	def indexes(self): 
+		"""
+		Type :: list [elements of type str] 
+
+		The labels of the indexed columns (see create_index) 
+		"""
+		return [i for i in self._labels if i in self._indexes.keys()] 
+
+	def rank(self, key, value): 
+		"""
+		Count the values in a given column of the data less than a given 
+		value. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column 
+		value :: real number 
+			The value to count below 
+
+		Returns 
+		======= 
+		rank :: int 
+			The number of values less than value. Missing values and NaNs 
+			are not counted. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: value is not a real number 
+
+		Notes 
+		===== 
+		This takes O(log n) time if the column is indexed (see 
+		create_index), and a scan of the column if not. 
+		"""
+		return self.__rank(key, value)[0] 
+
+	def percentile_of(self, key, value): 
+		"""
+		Determine the percentile of a given value among the values in a 
+		given column of the data, the inverse of dataframe.percentiles. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column 
+		value :: real number 
+			The value to take the percentile of 
+
+		Returns 
+		======= 
+		percentile :: float 
+			The percentage of the values less than value, counting values 
+			equal to it as half below and half above; NaN if the column 
+			holds no values. Missing values and NaNs are not counted. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: value is not a real number 
+
+		Notes 
+		===== 
+		This takes O(log n) time if the column is indexed (see 
+		create_index), and a scan of the column if not. 
+		"""
+		below, through, num_valid = self.__rank(key, value) 
+		if num_valid: 
+			return 50 * (below + through) / num_valid 
+		else: 
+			return float("nan") 
+
+	def __rank(self, key, value): 
+		"""
+		The number of values in a column less than a given value, the number 
+		less than or equal to it, and the number of values, as a tuple. 
+		"""
+		cdef int column = self.__column_index(key), status 
+		cdef long counts[3] 
+		cdef double c_value 
+		if isinstance(value, numbers.Number): 
+			c_value = value 
+		else: 
+			raise TypeError("value must be a real number. Got: %s" % ( 
+				type(value))) 
+		cdef COLUMN_INDEX *idx = self._index(column) 
+		with nogil: 
+			status = dfcolumn_rank(self._df[0], column, idx, c_value, counts) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return (counts[0], counts[1], counts[2]) 
+
+	cdef COLUMN_INDEX *_index(self, int column, bint create = False): 
+		"""
+		The index of a column, rebuilt first if it's out of date, or NULL if 
+		the column isn't indexed and create is False. While writable arrays 
+		of the column exist it can't be kept up to date, and rather than 
+		being rebuilt on every use it's left for the C library to scan. 
+		"""
+		cdef _column_index wrapper 
+		label = self._labels[column] 
+		if self._df.columns[column].writers and not create: 
+			return NULL 
+		elif label in self._indexes.keys(): 
+			wrapper = self._indexes[label] 
+			if column_index_current(self._df[0], column, wrapper._index): 
+				return wrapper._index 
+			else: 
+				pass 
+		elif not create: 
+			return NULL 
+		else: 
+			pass 
+		wrapper = _column_index.__new__(_column_index) 
+		with nogil: 
+			wrapper._index = column_index_initialize(self._df[0], column) 
+		self._indexes[label] = wrapper 
+		return wrapper._index 
+
+	def scatter(self, key, value = 68.2): 
+		"""
+		Measure the dispersion in a given column of the data given a percentage 
+		value. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The key to the dataframe to measure the scatter for 
+		value :: real number between 0 and 100 
+			The percentile range to measure 
+
+		Returns 
+		======= 
+		lower :: real number 
+			A lower bound 
+		upper :: real number 
+			An upper bound 
+		Lower and upper are defined such that the specified percentage of the 
+		data points lie between these values, centered on the median. 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: key is not of type str 
+			:: value is not a real number 
+		ValueError :: 
+			:: value is not between 0 and 100 
+		KeyError :: 
+			:: key is not in the dataframe 
+		""" 
+		cdef double x[2] 
+		cdef double fraction 
+		cdef int column, status 
+		if isinstance(key, str): 
+			if key.lower() in self._labels: 
+				if isinstance(value, numbers.Number): 
+					if 0 <= value <= 100: 
+						column = self._labels.index(key.lower()) 
+						fraction = value / 100 
+						with nogil: 
+							status = dfcolumn_scatter(self._df[0], column, 
+								fraction, x) 
+						if status: 
+							raise SystemError("Internal Error.") 
+						else: 
+							return [x[0], x[1]] 
+					else: 
+						raise ValueError("""Keyword arg 'value' must be between \
+0 and 100. Got: %g""" % (value)) 
+				else: 
+					raise TypeError("""Keyword arg 'value' must be a numerical \
+value. Got: %s""" % (type(value))) 
+			else: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+
+	def percentiles(self, key, values): 
+		"""
+		Determine several percentiles of a given column of the data. All of 
+		them are found in a single selection pass over the column. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to find the percentiles of 
+		values :: array-like [elements are real numbers between 0 and 100] 
+			The percentiles to take 
+
+		Returns 
+		======= 
+		pcts :: list [elements are real numbers] 
+			The value of the data at each percentile. The p'th percentile is 
+			taken as the data point whose rank is the fraction p / 100 of the 
+			number of data points. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: Any element of values is non-numerical 
+		ValueError :: 
+			:: Any element of values is not between 0 and 100 
+		""" 
+		cdef double *c_fractions 
+		cdef double *ptr 
+		cdef int column, num_fractions, status 
+		if isinstance(key, str): 
+			if key.lower() in self._labels: 
+				copy = _copy_array_like_object(values, "values") 
+				if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
+					if all(map(lambda x: 0 <= x <= 100, copy)): 
+						fractions = _array('d', [i / 100 for i in copy]) 
+						x = _zeros('d', len(copy)) 
+						column = self._labels.index(key.lower()) 
+						num_fractions = len(copy) 
+						c_fractions = _doubles(fractions) 
+						ptr = _doubles(x) 
+						with nogil: 
+							status = dfcolumn_quantiles(self._df[0], column, 
+								c_fractions, num_fractions, ptr) 
+						if status: 
+							raise SystemError("Internal Error") 
+						else: 
+							return x.tolist() 
+					else: 
+						raise ValueError("""Percentiles must be between 0 and \
+100.""") 
+				else: 
+					raise TypeError("Non-numerical value detected in values.") 
+			else: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+	def sketch(self, key, k = 200): 
+		"""
+		Build a streaming quantile sketch of a given column of the data. The 
+		column is sketched in parallel, and the result can be merged with 
+		sketches of other dataframes or files. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to sketch 
+		k :: int [default :: 200] 
+			The accuracy parameter of the sketch. See quantile_sketch. 
+
+		Returns 
+		======= 
+		sketch :: quantile_sketch 
+			A sketch of the values in the column 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: key is not of type str 
+			:: k is not an integer 
+		ValueError :: 
+			:: k < 2 
+		""" 
+		cdef quantile_sketch sketch 
+		cdef int column, status 
+		if isinstance(key, str): 
+			if key.lower() in self._labels: 
+				sketch = quantile_sketch(k = k) 
+				column = self._labels.index(key.lower()) 
+				with nogil: 
+					status = dfcolumn_sketch(self._df[0], column, 
+						sketch._sketch) 
+				if status: 
+					raise SystemError("Internal Error") 
+				else: 
+					return sketch 
+			else: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+	def hist(self, key, binspace, weights = None, mask = None, 
+		cumulative = False): 
+		"""
+		Determine counts within a given binspace (i.e. a histogram) of the 
+		data based on the values stored in a given column. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to histogram 
+		binspace :: array-like [elements are real numbers] 
+			The bin-edges to histogram based on 
+		weights :: str [case-insensitive] [default :: None] 
+			The label for a column to weight each data point by 
+		mask :: array-like [elements are booleans] [default :: None] 
+			Which data points to include. Must be as long as the dataframe. 
+		cumulative :: bool [default :: False] 
+			Whether or not to return the cumulative counts 
+
+		Returns 
+		======= 
+		counts :: list [elements are positive integers] 
+			The number of data points whose value falls within the specified 
+			bin edges. With weights, the sum of the weights within them. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: The label is not recognized by this dataframe 
+		TypeError :: 
+			:: Any element of binspace is non-numerical 
+			:: key is not of type str 
+		ValueError :: 
+			:: mask is not as long as the dataframe 
+
+		Notes 
+		===== 
+		See dataframe.histdd for histograms in more than one dimension. 
+		""" 
+		cdef double *c_edges 
+		cdef long *c_counts 
+		cdef long num_bins 
+		cdef int column, status 
+		if weights is not None or mask is not None or cumulative: 
+			return self.histdd([key], [binspace], weights = weights, 
+				mask = mask, cumulative = cumulative) 
+		else: 
+			pass 
+		if isinstance(key, str): 
+			# if the key is recognized 
+			if key.lower() in self._labels: 
+				# Get a copy of the bins and make sure it's all real numbers 
+				copy = _copy_array_like_object(binspace, "binspace") 
+				if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
+					# get the counts from C 
+					counts = _zeros('l', len(copy) - 1) 
+					edges = _array('d', sorted(copy)) 
+					column = self._labels.index(key.lower()) 
+					num_bins = len(copy) - 1 
+					c_edges = _doubles(edges) 
+					c_counts = _longs(counts) 
+					with nogil: 
+						status = hist(self._df[0], column, c_edges, num_bins, 
+							c_counts) 
+					if status: 
+						raise SystemError("Internal Error") 
+					else: 
+						# return the counts 
+						return counts.tolist() 
+				else: 
+					raise TypeError("Non-numerical value detected in binspace.") 
+			else: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+	def histdd(self, keys, binspaces, weights = None, mask = None, 
+		cumulative = False, sumsq = False): 
+		"""
+		Determine counts within a grid of bins in any number of dimensions 
+		(i.e. a multi-dimensional histogram) of the data based on the values 
+		stored in a given set of columns, optionally weighted. 
+
+		Parameters 
+		========== 
+		keys :: list [elements of type str] [case-insensitive] 
+			The labels for the columns to histogram, one per dimension 
+		binspaces :: list [elements are array-like] 
+			The bin-edges along each dimension 
+		weights :: str [case-insensitive] [default :: None] 
+			The label for a column to weight each data point by 
+		mask :: array-like [elements are booleans] [default :: None] 
+			Which data points to include. Must be as long as the dataframe. 
+		cumulative :: bool [default :: False] 
+			Whether or not to return the cumulative counts, i.e. the counts 
+			at or below each bin along every dimension 
+		sumsq :: bool [default :: False] 
+			Whether or not to also return the sum of the squared weights in 
+			each bin (e.g. for error bars on a weighted histogram) 
+
+		Returns 
+		======= 
+		counts :: list 
+			Nested lists (one level per dimension) holding the number of data 
+			points in each bin, or the sum of their weights 
+		counts2 :: list [only if sumsq is True] 
+			The sum of the squared weights in each bin, laid out as counts 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any label is not recognized by this dataframe 
+		TypeError :: 
+			:: keys or binspaces is not a list 
+			:: Any element of a binspace is non-numerical 
+		ValueError :: 
+			:: keys and binspaces are of different lengths 
+			:: Any binspace has fewer than two edges 
+			:: mask is not as long as the dataframe 
+		""" 
+		if not isinstance(keys, list) or not isinstance(binspaces, list): 
+			raise TypeError("keys and binspaces must be of type list.") 
+		elif len(keys) != len(binspaces) or len(keys) == 0: 
+			raise ValueError("""keys and binspaces must be non-empty and of \
+equal length. Got: %d and %d""" % (len(keys), len(binspaces))) 
+		else: 
+			pass 
+		columns = [self.__column_index(i) for i in keys] 
+		edges = [sorted(_copy_array_like_object(i, "binspace")) for i in 
+			binspaces] 
+		if not all([all(map(lambda x: isinstance(x, numbers.Number), i)) for 
+			i in edges]): 
+			raise TypeError("Non-numerical value detected in binspace.") 
+		elif any([len(i) < 2 for i in edges]): 
+			raise ValueError("Each binspace must have at least two edges.") 
+		else: 
+			pass 
+		cdef int c_weights = -1 if weights is None else self.__column_index( 
+			weights) 
+		mask = self.__mask_array(mask) 
+
+		shape = [len(i) - 1 for i in edges] 
+		total = 1 
+		for i in shape: 
+			total *= i 
+		edges = [_array('d', i) for i in edges] 
+		c_columns = _array('i', columns) 
+		c_shape = _array('l', shape) 
+		sums = _zeros('d', total) 
+		sums2 = _zeros('d', total if sumsq else 0) 
+		cdef int ndim = len(columns), c_cumulative = bool(cumulative), status 
+		cdef int *c_mask = _ints(mask) if mask is not None else NULL 
+		cdef double **c_edges = <double **> malloc(ndim * sizeof(double *)) 
+		for i in range(ndim): 
+			c_edges[i] = _doubles(edges[i]) 
+		cdef int *ptr_columns = _ints(c_columns) 
+		cdef long *ptr_shape = _longs(c_shape) 
+		cdef double *ptr_sums = _doubles(sums) 
+		cdef double *ptr_sums2 = _doubles(sums2) 
+		with nogil: 
+			status = histdd(self._df[0], ptr_columns, ndim, c_edges, 
+				ptr_shape, c_weights, c_mask, c_cumulative, ptr_sums, 
+				ptr_sums2) 
+		free(c_edges) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			cast = float if c_weights != -1 else lambda x: int(round(x)) 
+			result = self.__reshape([cast(sums[i]) for i in range(total)], 
+				shape) 
+			if sumsq: 
+				return result, self.__reshape([cast(sums2[i]) for i in range( 
+					total)], shape) 
+			else: 
+				return result 
+
+	def binned_statistic(self, x, y, binspace, stats = ["median"]): 
+		"""
+		Determine summary statistics of the values in one column of the data 
+		within bins of the values in another. The rows are grouped by bin 
+		once, and every statistic of every bin is computed from there, so 
+		this is much faster than sorting the dataframe into each bin in turn. 
+
+		Parameters 
+		========== 
+		x :: str [case-insensitive] 
+			The label for the column to bin based on 
+		y :: str [case-insensitive] 
+			The label for the column to take the statistics of 
+		binspace :: array-like [elements are real numbers] 
+			The bin-edges to bin based on 
+		stats :: list [default :: ["median"]] 
+			The statistics to take. Each element may be any of "count", 
+			"sum", "mean", "std", "min", "max", and "median" 
+			[case-insensitive], or a real number between 0 and 100 to take 
+			that percentile, as in dataframe.percentiles. 
+
+		Returns 
+		======= 
+		values :: list 
+			One list per element of stats, in the same order, holding the 
+			value of that statistic within each bin. Empty bins have a count 
+			and sum of 0 and NaN for everything else. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Either label is not recognized by this dataframe 
+		TypeError :: 
+			:: Any element of binspace is non-numerical 
+			:: stats is not a list 
+			:: Any element of stats is neither a str nor a number 
+		ValueError :: 
+			:: The binspace has fewer than two edges 
+			:: Any element of stats is an unrecognized str 
+			:: Any percentile is not between 0 and 100 
+
+		Example 
+		======= 
+		>>> median, low, high = df.binned_statistic("mvir", "vmax", 
+			[1e10, 1e11, 1e12, 1e13], stats = ["median", 16, 84]) 
+		""" 
+		xcol = self.__column_index(x) 
+		ycol = self.__column_index(y) 
+		edges = sorted(_copy_array_like_object(binspace, "binspace")) 
+		if not all(map(lambda i: isinstance(i, numbers.Number), edges)): 
+			raise TypeError("Non-numerical value detected in binspace.") 
+		elif len(edges) < 2: 
+			raise ValueError("The binspace must have at least two edges.") 
+		elif not isinstance(stats, list): 
+			raise TypeError("stats must be of type list. Got: %s" % ( 
+				type(stats))) 
+		else: 
+			pass 
+		c_stats, fractions = _statistic_codes(stats) 
+
+		edges = _array('d', edges) 
+		results = _zeros('d', (len(edges) - 1) * len(stats)) 
+		cdef int c_xcol = xcol, c_ycol = ycol, num_stats = len(stats), status 
+		cdef long num_bins = len(edges) - 1 
+		cdef double *ptr_edges = _doubles(edges) 
+		cdef int *ptr_stats = _ints(c_stats) 
+		cdef double *ptr_fractions = _doubles(fractions) 
+		cdef double *ptr_results = _doubles(results) 
+		with nogil: 
+			status = binned_statistic(self._df[0], c_xcol, c_ycol, ptr_edges, 
+				num_bins, ptr_stats, ptr_fractions, num_stats, ptr_results) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			values = [[results[j * len(stats) + i] for j in range(num_bins)] 
+				for i in range(len(stats))] 
+			for i in range(len(stats)): 
+				if c_stats[i] == 0: values[i] = [int(j) for j in values[i]] 
+			return values 
+
+	def bootstrap(self, key, stats = ["median"], n = 200, seed = 0, 
+		replicates = False): 
+		"""
+		Estimate the uncertainty on summary statistics of the values in a 
+		column by the bootstrap. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to take the statistics of 
+		stats :: list [default :: ["median"]] 
+			The statistics to take, as in dataframe.binned_statistic 
+		n :: int [default :: 200] 
+			The number of bootstrap resamples 
+		seed :: int [default :: 0] 
+			The seed of the random numbers 
+		replicates :: bool [default :: False] 
+			Whether or not to also return the statistics of each resample 
+
+		Returns 
+		======= 
+		estimates :: list 
+			The value of each statistic, in the same order as stats 
+		errors :: list 
+			The standard deviation of each statistic across the resamples 
+		values :: list [only if replicates is True] 
+			One list per statistic holding its value in each resample 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: key is not recognized by this dataframe 
+		TypeError :: 
+			:: stats is not a list 
+			:: Any element of stats is neither a str nor a number 
+			:: n is not an integer 
+			:: seed is not a non-negative integer 
+		ValueError :: 
+			:: stats is empty 
+			:: Any element of stats is an unrecognized str 
+			:: Any percentile is not between 0 and 100 
+			:: n is less than 2 
+
+		Notes 
+		===== 
+		No resample copies the data. Each weights every value by an 
+		independent Poisson(1) deviate (the Poisson bootstrap), which for 
+		more than a few dozen values is indistinguishable from drawing 
+		them with replacement, and every statistic of a resample is taken 
+		in one pass over the weighted values. Resamples run in parallel, 
+		and the deviates depend only on the seed, the resample and the row 
+		(via a counter-based generator), so the results are the same for 
+		any number of threads. Rows missing the value are left out. 
+
+		Example 
+		======= 
+		>>> (median, std), (dmedian, dstd) = df.bootstrap("vmax", 
+			["median", "std"], n = 500) 
+		""" 
+		column = self.__column_index(key) 
+		c_stats, fractions = _statistic_codes(stats) 
+		if not len(stats): 
+			raise ValueError("At least one statistic is required.") 
+		elif not isinstance(n, numbers.Number) or n % 1 != 0: 
+			raise TypeError("n must be an integer. Got: %s" % (str(n))) 
+		elif n < 2: 
+			raise ValueError("At least two resamples are required.") 
+		elif not isinstance(seed, numbers.Number) or seed % 1 != 0 or seed < 0: 
+			raise TypeError("seed must be a non-negative integer. Got: %s" % ( 
+				str(seed))) 
+		else: 
+			pass 
+		estimates = _zeros('d', len(stats)) 
+		errors = _zeros('d', len(stats)) 
+		values = _zeros('d', n * len(stats)) 
+		cdef int c_column = column, num_stats = len(stats), status 
+		cdef long num_resamples = n 
+		cdef unsigned long c_seed = seed 
+		cdef int *ptr_stats = _ints(c_stats) 
+		cdef double *ptr_fractions = _doubles(fractions) 
+		cdef double *ptr_values = _doubles(values) 
+		cdef double *ptr_estimates = _doubles(estimates) 
+		cdef double *ptr_errors = _doubles(errors) 
+		with nogil: 
+			status = dfcolumn_bootstrap(self._df[0], c_column, ptr_stats, 
+				ptr_fractions, num_stats, num_resamples, c_seed, ptr_values, 
+				ptr_estimates, ptr_errors) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			return _resampled(estimates, errors, values, n, replicates) 
+
+	def jackknife(self, key, stats = ["median"], groups = None, 
+		subboxes = None, divisions = 4, box = None, n = 100, 
+		replicates = False): 
+		"""
+		Estimate the uncertainty on summary statistics of the values in a 
+		column by the delete-one-group jackknife. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label for the column to take the statistics of 
+		stats :: list [default :: ["median"]] 
+			The statistics to take, as in dataframe.binned_statistic 
+		groups :: str [case-insensitive] [default :: None] 
+			The label of a column whose distinct values define the groups 
+			(e.g. a simulation volume or a field on the sky) 
+		subboxes :: list [elements of type str] [default :: None] 
+			The labels of coordinates (e.g. ["x", "y", "z"]) to divide into 
+			a regular grid of sub-boxes, one group per sub-box 
+		divisions :: int or list [default :: 4] 
+			The number of sub-boxes along each coordinate in subboxes, one 
+			for all of them or one per coordinate 
+		box :: list [default :: None] 
+			The [lower, upper] edges of the box along each coordinate in 
+			subboxes, e.g. [[0, 250], [0, 250], [0, 250]] for a periodic 
+			simulation. None to take the range of the values. Rows outside 
+			the box are left out. 
+		n :: int [default :: 100] 
+			The number of groups of consecutive rows to make when neither 
+			groups nor subboxes is given 
+		replicates :: bool [default :: False] 
+			Whether or not to also return the statistics without each group 
+
+		Returns 
+		======= 
+		estimates :: list 
+			The value of each statistic, in the same order as stats 
+		errors :: list 
+			The jackknife standard error of each statistic 
+		values :: list [only if replicates is True] 
+			One list per statistic holding its value without each group; 
+			NaN for groups with no values 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: key, groups or any element of subboxes is not recognized by 
+			this dataframe 
+		TypeError :: 
+			:: stats is not a list 
+			:: Any element of stats is neither a str nor a number 
+			:: subboxes is not a list 
+			:: divisions or n is not an integer (or list of them) 
+			:: box is not a list of [lower, upper] pairs 
+		ValueError :: 
+			:: stats is empty 
+			:: Any element of stats is an unrecognized str 
+			:: Any percentile is not between 0 and 100 
+			:: Both groups and subboxes are given 
+			:: A division or n is less than 1, or any lower edge of the box 
+			is not below its upper edge 
+			:: Fewer than two groups hold values 
+
+		Notes 
+		===== 
+		Every statistic is taken in one pass over the values with each 
+		group left out in turn, without copying them, and groups run in 
+		parallel. With G groups holding values, the error is 
+		sqrt((G - 1) / G * sum((x_g - mean(x_g))^2)), x_g being a statistic 
+		without group g. Rows missing the value or in no group are left out. 
+
+		Example 
+		======= 
+		>>> (median,), (error,) = df.jackknife("vmax", ["median"], 
+			subboxes = ["x", "y", "z"], divisions = 4, 
+			box = 3 * [[0, 250]]) 
+		""" 
+		column = self.__column_index(key) 
+		c_stats, fractions = _statistic_codes(stats) 
+		if not len(stats): 
+			raise ValueError("At least one statistic is required.") 
+		elif groups is not None and subboxes is not None: 
+			raise ValueError("Only one of groups and subboxes may be given.") 
+		else: 
+			pass 
+		cdef DATAFRAME *df = self._df 
+		cdef int status = 0, num_dims, c_strategy = GROUPBY_AUTO 
+		cdef long row, num_groups = 0, num_rows = self._df.num_rows 
+		cdef long *first = NULL 
+		cdef long *ptr_divisions 
+		cdef int *ptr_columns 
+		cdef double *ptr_lower 
+		cdef double *ptr_upper 
+		rows = _zeros('l', num_rows) 
+		cdef long *ptr_rows = _longs(rows) 
+		if groups is not None: 
+			columns = _array('i', [self.__column_index(groups)]) 
+			ptr_columns = _ints(columns) 
+			with nogil: 
+				status = dfgroup(df[0], ptr_columns, 1, c_strategy, ptr_rows, 
+					&num_groups, &first) 
+			free(first) 
+		elif subboxes is not None: 
+			if not isinstance(subboxes, list): 
+				raise TypeError("subboxes must be of type list. Got: %s" % ( 
+					type(subboxes))) 
+			elif not len(subboxes): 
+				raise ValueError("At least one coordinate is required.") 
+			else: 
+				columns = _array('i', [self.__column_index(i) for i in 
+					subboxes]) 
+			if not isinstance(divisions, list): 
+				divisions = len(subboxes) * [divisions] 
+			if len(divisions) != len(subboxes) or not all(map(lambda i: 
+				isinstance(i, numbers.Number) and i % 1 == 0, divisions)): 
+				raise TypeError("""divisions must be an integer or a list of \
+one per coordinate. Got: %s""" % (str(divisions))) 
+			elif not all(map(lambda i: i >= 1, divisions)): 
+				raise ValueError("Divisions must be at least 1.") 
+			else: 
+				divisions = _array('l', divisions) 
+			if box is None: 
+				box = [[self.min(i), self.max(i)] for i in subboxes] 
+			if not isinstance(box, list) or len(box) != len(subboxes) or not ( 
+				all(map(lambda i: isinstance(i, (list, tuple)) and len(i) == 2 
+				and all(map(lambda j: isinstance(j, numbers.Number), i)), 
+				box))): 
+				raise TypeError("""box must be a list of one [lower, upper] \
+pair per coordinate. Got: %s""" % (str(box))) 
+			elif not all(map(lambda i: i[0] < i[1], box)): 
+				raise ValueError("""The lower edges of the box must be below \
+the upper edges.""") 
+			else: 
+				lower = _array('d', [i[0] for i in box]) 
+				upper = _array('d', [i[1] for i in box]) 
+			num_dims = len(subboxes) 
+			num_groups = 1 
+			for i in divisions: num_groups *= i 
+			ptr_columns = _ints(columns) 
+			ptr_divisions = _longs(divisions) 
+			ptr_lower = _doubles(lower) 
+			ptr_upper = _doubles(upper) 
+			with nogil: 
+				status = dataframe_subboxes(df[0], ptr_columns, num_dims, 
+					ptr_divisions, ptr_lower, ptr_upper, ptr_rows) 
+		else: 
+			if not isinstance(n, numbers.Number) or n % 1 != 0: 
+				raise TypeError("n must be an integer. Got: %s" % (str(n))) 
+			elif n < 1: 
+				raise ValueError("n must be at least 1. Got: %d" % (n)) 
+			else: 
+				num_groups = min(n, max(num_rows, 1)) 
+			with nogil: 
+				for row in range(num_rows): 
+					ptr_rows[row] = row * num_groups // num_rows 
+		if status: raise SystemError("Internal Error") 
+
+		estimates = _zeros('d', len(stats)) 
+		errors = _zeros('d', len(stats)) 
+		values = _zeros('d', num_groups * len(stats)) 
+		cdef int c_column = column, num_stats = len(stats) 
+		cdef int *ptr_stats = _ints(c_stats) 
+		cdef double *ptr_fractions = _doubles(fractions) 
+		cdef double *ptr_values = _doubles(values) 
+		cdef double *ptr_estimates = _doubles(estimates) 
+		cdef double *ptr_errors = _doubles(errors) 
+		with nogil: 
+			status = dfcolumn_jackknife(df[0], c_column, ptr_rows, num_groups, 
+				ptr_stats, ptr_fractions, num_stats, ptr_values, ptr_estimates, 
+				ptr_errors) 
+		if status: 
+			raise ValueError("Fewer than two groups hold values.") 
+		else: 
+			return _resampled(estimates, errors, values, num_groups, 
+				replicates) 
+
+	def correlations(self, keys, methods = ["pearson"], n = 0, seed = 0): 
+		"""
+		Determine the correlation matrices of a set of columns. 
+
+		Parameters 
+		========== 
+		keys :: list [elements of type str] [case-insensitive] 
+			The labels of the columns 
+		methods :: list [default :: ["pearson"]] 
+			The correlation coefficients to take, any of "pearson" (r), 
+			"spearman" (rho) and "kendall" (tau-b) [case-insensitive] 
+		n :: int [default :: 0] 
+			The number of bootstrap resamples to estimate the errors from; 
+			0 for no errors 
+		seed :: int [default :: 0] 
+			The seed of the bootstrap's random numbers 
+
+		Returns 
+		======= 
+		matrices :: dict 
+			The matrix of each method, keyed by its name, as a list of one 
+			list per key, in the same order as keys 
+		errors :: dict [only if n is not 0] 
+			The standard deviation of each element across the resamples, 
+			laid out as the matrices 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any key is not recognized by this dataframe 
+		TypeError :: 
+			:: keys or methods is not a list 
+			:: Any method is not of type str 
+			:: n or seed is not a non-negative integer 
+		ValueError :: 
+			:: keys or methods is empty 
+			:: Any method is not recognized 
+			:: n is 1 
+
+		Notes 
+		===== 
+		Only rows holding a value (not NaN) in every column are used. The 
+		values are gathered and each column is sorted once; Spearman's rho 
+		and Kendall's tau both work from those ranks. Pearson's and 
+		Spearman's matrices come from one blocked pass over the rows in 
+		parallel, and Kendall's tau from Knight's O(n log n) merge sort for 
+		each pair of columns, the pairs in parallel. The bootstrap reweights 
+		the rows as dataframe.bootstrap does rather than copying them. 
+		Correlations with a column holding one value throughout are NaN. 
+
+		Example 
+		======= 
+		>>> rho = df.correlations(["spin", "mvir", "vmax"], ["spearman"]) 
+		>>> rho["spearman"][0][1] 
+		-0.12 
+		"""
+		if not isinstance(keys, list): 
+			raise TypeError("keys must be of type list. Got: %s" % ( 
+				type(keys))) 
+		elif not len(keys): 
+			raise ValueError("At least one key is required.") 
+		elif not isinstance(methods, list): 
+			raise TypeError("methods must be of type list. Got: %s" % ( 
+				type(methods))) 
+		elif not len(methods): 
+			raise ValueError("At least one method is required.") 
+		elif not all(map(lambda i: isinstance(i, str), methods)): 
+			raise TypeError("Each method must be of type str.") 
+		elif not all(map(lambda i: i.lower() in _CORRELATIONS_.keys(), 
+			methods)): 
+			raise ValueError("Unrecognized method in: %s" % (str(methods))) 
+		elif not isinstance(n, numbers.Number) or n % 1 != 0 or n < 0: 
+			raise TypeError("n must be a non-negative integer. Got: %s" % ( 
+				str(n))) 
+		elif n == 1: 
+			raise ValueError("At least two resamples are required.") 
+		elif not isinstance(seed, numbers.Number) or seed % 1 != 0 or seed < 0: 
+			raise TypeError("seed must be a non-negative integer. Got: %s" % ( 
+				str(seed))) 
+		else: 
+			pass 
+		columns = _array('i', [self.__column_index(i) for i in keys]) 
+		c_methods = _array('i', [_CORRELATIONS_[i.lower()] for i in methods]) 
+		p = len(keys) 
+		results = _zeros('d', len(methods) * p * p) 
+		errors = _zeros('d', len(methods) * p * p) 
+		cdef int num_cols = p, num_methods = len(methods), status 
+		cdef long num_resamples = n, num_rows 
+		cdef unsigned long c_seed = seed 
+		cdef int *ptr_columns = _ints(columns) 
+		cdef int *ptr_methods = _ints(c_methods) 
+		cdef double *ptr_results = _doubles(results) 
+		cdef double *ptr_errors = _doubles(errors) 
+		with nogil: 
+			status = dataframe_correlations(self._df[0], ptr_columns, 
+				num_cols, ptr_methods, num_methods, num_resamples, c_seed, 
+				ptr_results, ptr_errors, &num_rows) 
+		if status: raise SystemError("Internal Error") 
+		matrices = {} 
+		deviations = {} 
+		for m in range(len(methods)): 
+			start = m * p * p 
+			matrices[methods[m].lower()] = [list(results[start + i * p : 
+				start + (i + 1) * p]) for i in range(p)] 
+			deviations[methods[m].lower()] = [list(errors[start + i * p : 
+				start + (i + 1) * p]) for i in range(p)] 
+		if n: 
+			return matrices, deviations 
+		else: 
+			return matrices 
+
+	def conditional_percentile(self, x, y, binspace = None, window = None): 
+		"""
+		Determine the percentile of each row's value in one column among 
+		those of its neighbours in another, e.g. the spin percentile of each 
+		halo at fixed mass. 
+
+		Parameters 
+		========== 
+		x :: str [case-insensitive] 
+			The label for the column to find neighbours in 
+		y :: str [case-insensitive] 
+			The label for the column to take the percentiles of 
+		binspace :: array-like [elements are real numbers] [default :: None] 
+			The bin-edges in x: each row's neighbours are the rows in the 
+			same bin, as in dataframe.binned_statistic 
+		window :: int [default :: None] 
+			Instead of a binspace, the number of rows nearest in rank in x to 
+			take as each row's neighbours, including itself. The window is 
+			centered on the row, except within half of it of either end. 
+
+		Returns 
+		======= 
+		percentiles :: array-like 
+			The percentile of each row, between 0 and 100; NaN for rows 
+			missing either value, holding a NaN, or outside the binspace. A 
+			NumPy array if NumPy has been imported, otherwise a memoryview. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Either label is not recognized by this dataframe 
+		TypeError :: 
+			:: Any element of binspace is non-numerical 
+			:: window is not an integer 
+		ValueError :: 
+			:: Neither or both of binspace and window is given 
+			:: The binspace has fewer than two edges 
+			:: window is less than 1 
+
+		Notes 
+		===== 
+		The percentile of a value among m neighbours is 100 (l + e / 2) / m, 
+		where l of them are below it and e equal to it, itself included, so 
+		that ties share a percentile and the middle value is at 50. With a 
+		binspace each bin is sorted once, the bins in parallel. With a 
+		window, the rows are sorted on x once and the window slides along 
+		them, a tree of the counts of the values in it updated as rows 
+		enter and leave, so that this takes O(n log n) altogether; chunks of 
+		the rows are handled in parallel. 
+
+		Example 
+		======= 
+		>>> df["spin_pct"] = df.conditional_percentile("mpeak", "spin", 
+			window = 1000) 
+		"""
+		xcol = self.__column_index(x) 
+		ycol = self.__column_index(y) 
+		if (binspace is None) == (window is None): 
+			raise ValueError("Exactly one of binspace and window is required.") 
+		elif binspace is not None: 
+			edges = sorted(_copy_array_like_object(binspace, "binspace")) 
+			if not all(map(lambda i: isinstance(i, numbers.Number), edges)): 
+				raise TypeError("Non-numerical value detected in binspace.") 
+			elif len(edges) < 2: 
+				raise ValueError("The binspace must have at least two edges.") 
+			else: 
+				edges = _array('d', edges) 
+		elif not isinstance(window, numbers.Number) or window % 1 != 0: 
+			raise TypeError("window must be an integer. Got: %s" % ( 
+				str(window))) 
+		elif window < 1: 
+			raise ValueError("window must be at least 1. Got: %d" % (window)) 
+		else: 
+			edges = _array('d') 
+		results = _zeros('d', self._df.num_rows) 
+		cdef int c_xcol = xcol, c_ycol = ycol, status 
+		cdef long num_bins = len(edges) - 1 if len(edges) else 0 
+		cdef long c_window = window if window is not None else 0 
+		cdef double *ptr_edges = _doubles(edges) 
+		cdef double *ptr_results = _doubles(results) 
+		with nogil: 
+			status = dfcolumn_conditional_percentile(self._df[0], c_xcol, 
+				c_ycol, ptr_edges, num_bins, c_window, ptr_results) 
+		if status: 
+			raise SystemError("Internal Error") 
+		elif "numpy" in sys.modules: 
+			return _np.asarray(results) 
+		else: 
+			return memoryview(results) 
+
+	def __column_index(self, key): 
+		"""
+		Obtain the column number of a given label, raising the appropriate 
+		exceptions if it is not a recognized label. 
+		""" 
+		if isinstance(key, str): 
+			if key.lower() in self._labels: 
+				return self._labels.index(key.lower()) 
+			else: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+		else: 
+			raise TypeError("Key must be of type str. Got: %s" % (type(key))) 
+
+	cdef COLUMN_BUFFER *_ingest(self, value, name) except NULL: 
+		"""
+		Build a column buffer from an array-like object, going through the 
+		buffer protocol where possible and otherwise through a native python 
+		copy. 
+		""" 
+		cdef COLUMN_BUFFER *buffer = _ingest_column(value) 
+		if buffer is NULL: 
+			copy = _copy_array_like_object(value, name) 
+			try: 
+				buffer = _ingest_column(_array('d', copy)) 
+			except TypeError: 
+				raise TypeError("Non-numerical value detected.") 
+		else: 
+			pass 
+		return buffer 
+
+	cdef int _adopt(self, COLUMN_BUFFER *buffer, int column) except -1: 
+		"""
+		Put a column buffer built by _ingest into the dataframe at a given 
+		column number, releasing it if its length doesn't match. 
+		""" 
+		cdef int status 
+		with nogil: 
+			status = dfcolumn_adopt(self._df, buffer, column) 
+		if status: 
+			length = buffer.length 
+			column_buffer_release(buffer) 
+			raise ValueError("""Array length mismatch. Got: %d. Must be: \
+%d""" % (length, self._df.num_rows)) 
+		else: 
+			return 0 
+
+	def __mask_array(self, mask): 
+		"""
+		Convert an array-like selection mask into an array of 1s and 0s as 
+		long as the dataframe, or None if mask is None. 
+		""" 
+		if mask is None: 
+			return None 
+		else: 
+			copy = _copy_array_like_object(mask, "mask") 
+			if len(copy) == self._df.num_rows: 
+				return _array('i', [int(bool(i)) for i in copy]) 
+			else: 
+				raise ValueError("""Mask length mismatch. Got: %d. Must be: \
+%d""" % (len(copy), self._df.num_rows)) 
+
+	@staticmethod 
+	def __reshape(flat, shape): 
+		"""
+		Reshape a flat list in row-major order into nested lists of a given 
+		shape. 
+		""" 
+		if len(shape) == 1: 
+			return flat 
+		else: 
+			n = len(flat) // shape[0] 
+			return [dataframe.__reshape(flat[i * n : (i + 1) * n], shape[1:]) 
+				for i in range(shape[0])] 
+
+
+ 
+
+
+cdef class dataframe_groups: 
+
+	"""
+	The groups of the rows of a dataframe sharing the values in one or more 
+	key columns, as from dataframe.groupby. 
+	""" 
+
+	# A view of the grouped rows, the labels of its columns, the column 
+	# numbers of the keys, the group of each row, the number of groups, and 
+	# the first row of each 
+	cdef DATAFRAME *_df 
+	cdef tuple _labels 
+	cdef object _columns 
+	cdef object _groups 
+	cdef long _num_groups 
+	cdef long *_first 
+
+	def __cinit__(self, *args, **kwargs): 
+		self._df = dataframe_initialize() 
+		self._first = NULL 
+
+	def __dealloc__(self): 
+		if self._df is not NULL: 
+			with nogil: 
+				free_dataframe(self._df) 
+		else: 
+			pass 
+		if self._first is not NULL: free(self._first) 
+
+	def __init__(self, *args, **kwargs): 
+		raise TypeError("Groups are made with dataframe.groupby.") 
+
+	def __repr__(self): 
+		return "dataframe_groups{keys = %s, groups = %d}" % (str( 
+			self.keys), self._num_groups) 
+
+	def __str__(self): 
+		return self.__repr__() 
+
+	def __len__(self): 
+		return self._num_groups 
+
+	@property 
+	def keys(self): 
+		"""
+		The labels of the key columns 
+		""" 
+		return [self._labels[i] for i in self._columns] 
+
+	@property 
+	def groups(self): 
+		"""
+		The group number of each row of the dataframe, numbered in 
+		ascending order of the keys; -1 for rows in no group 
+		""" 
+		if "numpy" in sys.modules: 
+			return _np.array(self._groups) 
+		else: 
+			return memoryview(self._groups).toreadonly() 
+
+	def agg(self, stats): 
+		"""
+		Determine summary statistics of columns of the data within each 
+		group. The statistics of each column are taken in one pass over its 
+		rows; the count, sum, mean, std, min, and max are accumulated into 
+		per-thread partial results merged at the end. 
+
+		Parameters 
+		========== 
+		stats :: dict 
+			The labels of the columns [case-insensitive] as keys, and the 
+			statistics to take of each as values, either a str or a list 
+			of them. Each may be any of "count", "sum", "mean", "std", 
+			"min", "max", and "median" [case-insensitive]. 
+
+		Returns 
+		======= 
+		result :: dataframe 
+			The key columns, with a row for each group, followed by a 
+			column for each statistic of each column, labeled by the column 
+			and the statistic joined by an underscore (e.g. "mvir_sum"). 
+			Counts are integers, and a statistic is NaN in a group with no 
+			values of its column. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: Any column is not recognized by the dataframe 
+			:: Any result label repeats another 
+		TypeError :: 
+			:: stats is not a dict 
+			:: Any column is not of type str 
+			:: Any statistic is not of type str 
+		ValueError :: 
+			:: Any statistic is not recognized 
+
+		Example 
+		======= 
+		>>> df.groupby("pid").agg({"mvir": ["count", "sum", "median"]}) 
+		""" 
+		if not isinstance(stats, dict): 
+			raise TypeError("stats must be of type dict. Got: %s" % ( 
+				type(stats))) 
+		else: 
+			pass 
+		requests = [] 
+		for key in stats.keys(): 
+			if isinstance(key, str): 
+				if key.lower() in self._labels: 
+					column = self._labels.index(key.lower()) 
+				else: 
+					raise KeyError("Unrecognized key: %s" % (key)) 
+			else: 
+				raise TypeError("Key must be of type str. Got: %s" % ( 
+					type(key))) 
+			names = [stats[key]] if isinstance(stats[key], str) else stats[key] 
+			if not isinstance(names, list): 
+				raise TypeError("""Statistics must be of type str or list. \
+Got: %s""" % (type(names))) 
+			elif not all(map(lambda i: isinstance(i, str), names)): 
+				raise TypeError("Statistics must be of type str.") 
+			elif not all(map(lambda i: i.lower() in _STATISTICS_.keys(), 
+				names)): 
+				raise ValueError("Unrecognized statistic in: %s" % (names)) 
+			else: 
+				requests.append((key.lower(), column, [i.lower() for i in 
+					names])) 
+
+		cdef DATAFRAME keys 
+		cdef int c_column, num_stats, status 
+		cdef int num_keys = len(self._columns) 
+		cdef int *ptr_columns = _ints(self._columns) 
+		cdef int *ptr_stats 
+		cdef double *ptr_fractions 
+		cdef double *ptr_results 
+		cdef long *ptr_groups = _longs(self._groups) 
+		columns = {} 
+		for label, column, names in requests: 
+			c_stats = _array('i', [_STATISTICS_[i] for i in names]) 
+			fractions = _zeros('d', len(names)) 
+			results = _zeros('d', self._num_groups * len(names)) 
+			c_column = column 
+			num_stats = len(names) 
+			ptr_stats = _ints(c_stats) 
+			ptr_fractions = _doubles(fractions) 
+			ptr_results = _doubles(results) 
+			with nogil: 
+				status = group_statistic(self._df[0], ptr_groups, 
+					self._num_groups, c_column, ptr_stats, ptr_fractions, 
+					num_stats, ptr_results) 
+			if status: raise SystemError("Internal Error") 
+			for i in range(num_stats): 
+				if names[i] == "count": 
+					values = _array('q', [int(j) for j in 
+						results[i::num_stats]]) 
+				else: 
+					values = results[i::num_stats] 
+				columns["%s_%s" % (label, names[i])] = values 
+
+		memset(&keys, 0, sizeof(DATAFRAME)) 
+		with nogil: 
+			status = dfgroup_keys(self._df[0], ptr_columns, num_keys, 
+				self._first, self._num_groups, &keys) 
+		if status: 
+			raise SystemError("Internal Error") 
+		else: 
+			result = dataframe._wrap(keys, tuple(self.keys)) 
+			result.add_columns(columns) 
+			return result 
+
+
+ 
+
+
+cdef class dataframe_stream: 
+
+	"""
+	An iterator over the chunks of rows of an ASCII file, each a dataframe, 
+	as from dataframe.stream. The file is closed once every chunk has been 
+	read, or on close. 
+	""" 
+
+	# The C stream, the name of the file, the labels of the columns, and the 
+	# number of rows read once the stream is closed 
+	cdef FILE_STREAM *_stream 
+	cdef object _filename 
+	cdef tuple _labels 
+	cdef long _rows_read 
+
+	def __cinit__(self, *args, **kwargs): 
+		self._stream = NULL 
+		self._rows_read = 0 
+
+	def __dealloc__(self): 
+		if self._stream is not NULL: 
+			with nogil: 
+				free_stream(self._stream) 
+		else: 
+			pass 
+
+	def __init__(self, *args, **kwargs): 
+		raise TypeError("Streams are made with dataframe.stream.") 
+
+	def __repr__(self): 
+		return "dataframe_stream{file = %s, rows read = %d}" % ( 
+			self._filename, self.rows_read) 
+
+	def __str__(self): 
+		return self.__repr__() 
+
+	def __iter__(self): 
+		return self 
+
+	def __next__(self): 
+		cdef DATAFRAME dest 
+		cdef int status 
+		if self._stream is NULL: raise StopIteration 
+		memset(&dest, 0, sizeof(DATAFRAME)) 
+		with nogil: 
+			status = stream_next(self._stream, &dest) 
+		if status: 
+			self.close() 
+			raise IOError("Error reading file: %s" % (self._filename)) 
+		elif dest.num_rows == 0: 
+			self.close() 
+			raise StopIteration 
+		else: 
+			return dataframe._wrap(dest, self._labels) 
+
+	def __enter__(self): 
+		return self 
+
+	def __exit__(self, exc_type, exc_value, exc_tb): 
+		self.close() 
+		return exc_value is None 
+
+	@property 
+	def rows_read(self): 
+		"""
+		The number of rows handed out in chunks so far 
+		""" 
+		return self._stream.num_read if self._stream is not NULL else ( 
+			self._rows_read) 
+
+	def top(self, key, k, largest = True): 
+		"""
+		Find the k rows with the largest or smallest values in a column over 
+		the rest of the file, reading it in one pass and keeping only the 
+		best k rows in memory. 
+
+		Parameters 
+		========== 
+		key :: str [case-insensitive] 
+			The label of the column to rank by 
+		k :: int 
+			The number of rows to find 
+		largest :: bool [default :: True] 
+			Whether to find the largest values rather than the smallest 
+
+		Returns 
+		======= 
+		rows :: dataframe 
+			The rows, best first, as in dataframe.top 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: key is not recognized by this stream 
+		TypeError :: 
+			:: k is not a non-negative integer 
+		IOError :: 
+			:: A line of the file has too few columns 
+
+		Example 
+		======= 
+		The 1000 most massive halos of a tree file: 
+
+		>>> ultra.dataframe.stream("tree_0_0_0.dat", [1, 10], 
+			labels = ["id", "mvir"], types = ["int64", "float64"]).top( 
+			"mvir", 1000) 
+		""" 
+		return self.__reservoir(key, k, largest, None, 0) 
+
+	def sample(self, k, weights = None, seed = 0): 
+		"""
+		Draw a random sample of the rows over the rest of the file without 
+		replacement, reading it in one pass and keeping only k rows in 
+		memory. 
+
+		Parameters 
+		========== 
+		k :: int 
+			The number of rows to draw 
+		weights :: str [case-insensitive] [default :: None] 
+			The label of a column of weights, as in dataframe.sample 
+		seed :: int [default :: 0] 
+			The seed of the random numbers 
+
+		Returns 
+		======= 
+		rows :: dataframe 
+			The rows drawn, in the order they appear in the file. For a 
+			given seed these are the rows dataframe.sample draws from the 
+			whole file, whatever the chunksize. 
+
+		Raises 
+		====== 
+		KeyError :: 
+			:: weights is not recognized by this stream 
+		TypeError :: 
+			:: k or seed is not a non-negative integer 
+		IOError :: 
+			:: A line of the file has too few columns 
+		""" 
+		return self.__reservoir(weights, k, True, True, seed) 
+
+	def __reservoir(self, key, k, largest, sample, seed): 
+		"""
+		Pass the rest of the chunks through a top-k reservoir, or a sampling 
+		one if sample is not None, and take its rows. 
+		""" 
+		cdef RESERVOIR *r = NULL 
+		cdef DATAFRAME dest 
+		cdef dataframe chunk 
+		cdef int column = -1, num_cols = len(self._labels), status = 0 
+		cdef int *c_types 
+		cdef long c_k 
+		cdef unsigned long c_seed 
+		if key is not None: 
+			if not isinstance(key, str): 
+				raise TypeError("Key must be of type str. Got: %s" % ( 
+					type(key))) 
+			elif key.lower() not in self._labels: 
+				raise KeyError("Unrecognized key: %s" % (key)) 
+			else: 
+				column = self._labels.index(key.lower()) 
+		else: 
+			pass 
+		if not isinstance(k, numbers.Number) or k % 1 != 0 or k < 0: 
+			raise TypeError("k must be a non-negative integer. Got: %s" % ( 
+				str(k))) 
+		elif not isinstance(seed, numbers.Number) or seed % 1 != 0 or seed < 0: 
+			raise TypeError("seed must be a non-negative integer. Got: %s" % ( 
+				str(seed))) 
+		else: 
+			c_k = k 
+			c_seed = seed 
+		try: 
+			for chunk in self: 
+				if r is NULL: 
+					types = _array('i', [chunk._df.columns[i].type for i in 
+						range(num_cols)]) 
+					c_types = _ints(types) 
+					if sample is None: 
+						r = top_reservoir_initialize(c_k, num_cols, c_types, 
+							column, largest) 
+					else: 
+						r = sample_reservoir_initialize(c_k, num_cols, 
+							c_types, column, c_seed) 
+				else: 
+					pass 
+				with nogil: 
+					status = reservoir_update(r, chunk._df[0]) 
+				if status: raise SystemError("Internal Error") 
+			memset(&dest, 0, sizeof(DATAFRAME)) 
+			if r is not NULL: 
+				with nogil: 
+					reservoir_rows(r, &dest) 
+				return dataframe._wrap(dest, self._labels) 
+			else: 
+				# An empty file 
+				return dataframe.__new__(dataframe) 
+		finally: 
+			free_reservoir(r) 
+
+	def close(self): 
+		"""
+		Stop reading the file and close it. Chunks already read stay valid. 
+		""" 
+		if self._stream is not NULL: 
+			self._rows_read = self._stream.num_read 
+			with nogil: 
+				free_stream(self._stream) 
+			self._stream = NULL 
+		else: 
+			pass 
+
+cdef class quantile_sketch: 
+
+	"""
+	A mergeable streaming approximation to the quantiles of a set of values. 
+	This is a KLL sketch (Karnin, Lang & Liberty 2016): it holds at most a 
+	few times k values regardless of how many it has seen, and its 
+	percentiles are accurate to a rank error of roughly 1.7 / k. 
+
+	Sketches can be built from arrays, dataframe columns (see 
+	dataframe.sketch), or streamed directly from hlists and other ASCII 
+	files too large to hold in memory (see quantile_sketch.from_file), and 
+	any number of them can be merged. 
+
+	Parameters 
+	========== 
+	k :: int [default :: 200] 
+		The accuracy parameter 
+	seed :: int [default :: 0] 
+		The seed for the random number generator used in compaction 
+	""" 
+
+	# The C structure version of the sketch 
+	cdef QUANTILE_SKETCH *_sketch 
+
+	def __cinit__(self, *args, **kwargs): 
+		# Allocated here so that no method ever sees a NULL sketch, even on 
+		# an instance whose __init__ was skipped or raised 
+		self._sketch = sketch_initialize(200, 0) 
+		if self._sketch is NULL: raise SystemError("Internal Error") 
+
+	def __init__(self, k = 200, seed = 0): 
+		cdef QUANTILE_SKETCH *sketch 
+		if not(isinstance(k, numbers.Number) and k % 1 == 0): 
+			raise TypeError("Keyword arg 'k' must be an integer. Got: %s" % ( 
+				type(k))) 
+		elif k < 2: 
+			raise ValueError("Keyword arg 'k' must be at least 2. Got: %d" % ( 
+				k)) 
+		elif not (isinstance(seed, numbers.Number) and seed % 1 == 0): 
+			raise TypeError("""Keyword arg 'seed' must be an integer. Got: \
+%s""" % (type(seed))) 
+		else: 
+			sketch = sketch_initialize(int(k), int(seed) % 2**64) 
+			if sketch is NULL: raise SystemError("Internal Error") 
+			free_sketch(self._sketch) 
+			self._sketch = sketch 
+
+	def __dealloc__(self): 
+		if self._sketch is not NULL: 
+			free_sketch(self._sketch) 
+		else: 
+			pass 
+
+	def __repr__(self): 
+		return "quantile_sketch{k = %d, size = %d}" % (self.k, self.size) 
+
+	def __str__(self): 
+		return self.__repr__() 
+
+	@property 
+	def k(self): 
+		"""
+		The accuracy parameter of the sketch 
+		""" 
+		return self._sketch.k 
+
+	@property 
+	def size(self): 
+		"""
+		The number of values the sketch has seen 
+		""" 
+		return self._sketch.n 
+
+	def update(self, values): 
+		"""
+		Add values to the sketch. 
+
+		Parameters 
+		========== 
+		values :: array-like [elements are real numbers] 
+			The values to add. NaNs are ignored. 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: Any element of values is non-numerical 
+		""" 
+		cdef double *ptr 
+		cdef long length 
+		cdef int status 
+		copy = _copy_array_like_object(values, "values") 
+		if all(map(lambda x: isinstance(x, numbers.Number), copy)): 
+			copy = _array('d', copy) 
+			ptr = _doubles(copy) 
+			length = len(copy) 
+			with nogil: 
+				status = sketch_update_array(self._sketch, ptr, length) 
+			if status: raise SystemError("Internal Error") 
+		else: 
+			raise TypeError("Non-numerical value detected in values.") 
+
+	def merge(self, other): 
+		"""
+		Merge another sketch into this one. The other sketch is unchanged. 
+
+		Parameters 
+		========== 
+		other :: quantile_sketch 
+			The sketch to merge 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: other is not a quantile_sketch 
+		""" 
+		if isinstance(other, quantile_sketch): 
+			if sketch_merge(self._sketch, (<quantile_sketch> other)._sketch): 
+				raise SystemError("Internal Error") 
+			else: 
+				pass 
+		else: 
+			raise TypeError("Must merge with a quantile_sketch. Got: %s" % ( 
+				type(other))) 
+
+	def percentiles(self, values): 
+		"""
+		Determine approximate percentiles of the values the sketch has seen. 
+
+		Parameters 
+		========== 
+		values :: array-like [elements are real numbers between 0 and 100] 
+			The percentiles to take 
+
+		Returns 
+		======= 
+		pcts :: list [elements are real numbers] 
+			The approximate value at each percentile. The 0th and 100th 
+			percentiles are the exact minimum and maximum. 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: Any element of values is non-numerical 
+		ValueError :: 
+			:: Any element of values is not between 0 and 100 
+			:: The sketch is empty 
+		""" 
+		cdef double *c_fractions 
+		cdef double *ptr 
+		cdef int num_fractions, status 
+		copy = _copy_array_like_object(values, "values") 
+		if not all(map(lambda x: isinstance(x, numbers.Number), copy)): 
+			raise TypeError("Non-numerical value detected in values.") 
+		elif not all(map(lambda x: 0 <= x <= 100, copy)): 
+			raise ValueError("Percentiles must be between 0 and 100.") 
+		elif self.size == 0: 
+			raise ValueError("The sketch is empty.") 
+		else: 
+			fractions = _array('d', [i / 100 for i in copy]) 
+			x = _zeros('d', len(copy)) 
+			c_fractions = _doubles(fractions) 
+			ptr = _doubles(x) 
+			num_fractions = len(copy) 
+			with nogil: 
+				status = sketch_quantiles(self._sketch, c_fractions, 
+					num_fractions, ptr) 
+			if status: 
+				raise SystemError("Internal Error") 
+			else: 
+				return x.tolist() 
+
+	def median(self): 
+		"""
+		Determine the approximate median of the values the sketch has seen. 
+		""" 
+		return self.percentiles([50])[0] 
+
+	def scatter(self, value = 68.2): 
+		"""
+		Measure the approximate dispersion of the values the sketch has seen 
+		given a percentage value, as in dataframe.scatter. 
+
+		Parameters 
+		========== 
+		value :: real number between 0 and 100 
+			The percentile range to measure 
+
+		Returns 
+		======= 
+		lower :: real number 
+			A lower bound 
+		upper :: real number 
+			An upper bound 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: value is not a real number 
+		ValueError :: 
+			:: value is not between 0 and 100 
+		""" 
+		if not isinstance(value, numbers.Number): 
+			raise TypeError("""Keyword arg 'value' must be a numerical value. \
+Got: %s""" % (type(value))) 
+		elif not 0 <= value <= 100: 
+			raise ValueError("""Keyword arg 'value' must be between 0 and 100. \
+Got: %g""" % (value)) 
+		else: 
+			return self.percentiles([50 - value / 2, 50 + value / 2]) 
+
+	@staticmethod 
+	def from_file(filename, columns, k = 200, comment = '#', seed = 0): 
+		"""
+		Sketch several columns of an hlist or other ASCII file in a single 
+		pass, without reading the file into memory. 
+
+		Parameters 
+		========== 
+		filename :: str 
+			The name of the file 
+		columns :: list [elements are integers] 
+			The column numbers in the file to sketch 
+		k :: int [default :: 200] 
+			The accuracy parameter of the sketches 
+		comment :: char [default :: '#'] 
+			Lines beginning with this character are skipped 
+		seed :: int [default :: 0] 
+			The seed for the random number generators used in compaction 
+
+		Returns 
+		======= 
+		sketches :: list [elements are quantile_sketch] 
+			A sketch of each column, in the order given 
+
+		Raises 
+		====== 
+		TypeError :: 
+			:: filename is not of type str 
+			:: columns is not a list of integers 
+			:: comment is not of type str 
+		IOError :: 
+			:: The file does not exist or could not be read 
+		""" 
+		cdef QUANTILE_SKETCH **ptrs 
+		cdef char *c_filename 
+		cdef char c_comment 
+		cdef int *c_cols 
+		cdef int num_cols, status 
+		if not isinstance(filename, str): 
+			raise TypeError("filename must be of type str. Got: %s" % ( 
+				type(filename))) 
+		elif not isinstance(columns, list): 
+			raise TypeError("columns must be of type list. Got: %s" % ( 
+				type(columns))) 
+		elif not all(map(lambda x: isinstance(x, numbers.Number) and 
+			x % 1 == 0 and x >= 0, columns)): 
+			raise TypeError("columns must contain only non-negative integers.") 
+		elif not isinstance(comment, str): 
+			raise TypeError("comment must be of type str. Got: %s" % ( 
+				type(comment))) 
+		elif not os.path.exists(filename): 
+			raise IOError("File not found: %s" % (filename)) 
+		else: 
+			sketches = [quantile_sketch(k = k, seed = seed + i) for i in range( 
+				len(columns))] 
+			cols = _array('i', [int(i) for i in columns]) 
+			encoded = filename.encode("latin-1") 
+			c_filename = encoded 
+			c_comment = ord(comment[0]) 
+			c_cols = _ints(cols) 
+			num_cols = len(columns) 
+			ptrs = <QUANTILE_SKETCH **> malloc(num_cols * 
+				sizeof(QUANTILE_SKETCH *)) 
+			for i in range(num_cols): 
+				ptrs[i] = (<quantile_sketch> sketches[i])._sketch 
+			with nogil: 
+				status = sketch_from_file(ptrs, c_filename, c_comment, c_cols, 
+					num_cols) 
+			free(ptrs) 
+			if status: 
+				raise IOError("Error reading file: %s" % (filename)) 
+			else: 
+				return sketches 
+
+
+cdef int _external_sink(double *rows, long n, int num_cols, 
+	void *state) noexcept nogil: 
+	# Hands a block of sorted rows from external_sort to a Python callable 
+	# as a dataframe; state is a list of the callable, the column labels, 
+	# room for an exception raised by the callable, and which columns hold 
+	# the bits of integers. 
+	cdef long i 
+	cdef int j 
+	cdef double *ptr 
+	cdef long *iptr 
+	with gil: 
+		sink = <list> state 
+		try: 
+			columns = {} 
+			for j in range(num_cols): 
+				if sink[3][j]: 
+					values = _zeros('l', n) 
+					iptr = _longs(values) 
+					for i in range(n): 
+						memcpy(&iptr[i], &rows[i * num_cols + j], sizeof(long)) 
+				else: 
+					values = _zeros('d', n) 
+					ptr = _doubles(values) 
+					for i in range(n): 
+						ptr[i] = rows[i * num_cols + j] 
+				columns[sink[1][j]] = values 
+			sink[0](dataframe(columns)) 
+			return 0 
+		except BaseException as exc: 
+			sink[2] = exc 
+			return 1 
+
+def external_sort(files, columns, key, output, labels = None, 
+	descending = False, memory = 268435456, comment = '#', tmpdir = None, 
+	binary = False, integers = None): 
+	"""
+	Sort the rows of one or more hlists or other ASCII files by one of their 
+	columns without reading them into memory. The files are read in chunks 
+	which fit within the memory budget, each chunk is sorted and written to a 
+	temporary binary file, and these sorted runs are then merged into one 
+	sorted stream of rows. Different files are read and sorted on different 
+	threads. 
+
+	Parameters 
+	========== 
+	files :: str or list [elements are str] 
+		The name(s) of the file(s) 
+	columns :: list [elements are integers] 
+		The column numbers in the files to carry through the sort 
+	key :: int 
+		The column number to sort by; must be one of columns 
+	output :: str or callable 
+		The name of the file to write the sorted rows to, or a function to 
+		call with each block of sorted rows as a dataframe, in order. 
+	labels :: list [elements are str] [default :: None] 
+		The labels of the columns in the dataframes passed to a callable 
+		output. Defaults to the column numbers as strings. 
+	descending :: bool [default :: False] 
+		Whether to sort from high to low rather than low to high 
+	memory :: int [default :: 268435456 (256 MB)] 
+		The number of bytes the rows held in memory may take up 
+	comment :: char [default :: '#'] 
+		Lines beginning with this character are skipped 
+	tmpdir :: str [default :: None] 
+		The directory to write the sorted runs to; defaults to $TMPDIR, or 
+		/tmp if that isn't set. It needs room for a binary copy of the 
+		columns being sorted. 
+	binary :: bool [default :: False] 
+		Whether to write an output file as raw row-major 8-byte values 
+		(readable with numpy.fromfile) rather than ASCII: int64 in the 
+		integers columns, float64 in the others 
+	integers :: list [elements are integers] [default :: None] 
+		The column numbers, each one of columns, holding integers such as 
+		halo IDs, which are carried through the sort exactly rather than 
+		as doubles. These are int64 columns in the dataframes passed to a 
+		callable output. 
+
+	Returns 
+	======= 
+	n :: int 
+		The number of rows sorted 
+
+	Raises 
+	====== 
+	TypeError :: 
+		:: files is not a str or a list of str 
+		:: columns is not a list of integers 
+		:: key is not one of columns 
+		:: output is neither a str nor callable 
+		:: labels is not a list of str the length of columns 
+		:: integers is not a list of column numbers in columns 
+	ValueError :: 
+		:: memory is smaller than a single row 
+	IOError :: 
+		:: A file does not exist or could not be read 
+		:: A sorted run or the output could not be written 
+
+	Notes 
+	===== 
+	Values are read as doubles, so integers above 2^53 lose precision unless 
+	their columns are listed in integers; a value in one of those columns 
+	not written as an integer (e.g. 1e+06) is truncated. NaNs sort last in 
+	either direction, and -0 ties with 0. ASCII output holds doubles to 17 
+	significant digits, which read back exactly. The sort is stable: rows 
+	with equal keys keep the order of the files and of the rows within 
+	them. 
+
+	Example 
+	======= 
+	Write the halos of every tree file sorted by mass (column 10) from high 
+	to low, with their ids (column 1): 
+
+	>>> ultra.external_sort(["tree_%d.dat" % (i) for i in 
+		range(1000)], [1, 10], 10, "sorted.dat", descending = True, 
+		memory = 2**32) 
+	""" 
+	cdef char **c_files 
+	cdef char *c_output = NULL 
+	cdef char *c_tmpdir = NULL 
+	cdef char c_comment 
+	cdef int *c_cols 
+	cdef int *c_integers 
+	cdef int num_files, num_cols, c_key, c_descending, c_binary, status 
+	cdef unsigned long budget 
+	cdef long num_rows = 0 
+	cdef list sink 
+	if isinstance(files, str): 
+		files = [files] 
+	else: 
+		pass 
+	if not isinstance(files, list) or not all(map(lambda x: isinstance(x, 
+		str), files)): 
+		raise TypeError("files must be of type str or list of str.") 
+	elif not isinstance(columns, list) or not all(map(lambda x: isinstance(x, 
+		numbers.Number) and x % 1 == 0 and x >= 0, columns)): 
+		raise TypeError("columns must be a list of non-negative integers.") 
+	elif key not in columns: 
+		raise TypeError("key must be one of columns. Got: %s" % (str(key))) 
+	elif not isinstance(output, str) and not callable(output): 
+		raise TypeError("output must be of type str or callable. Got: %s" % ( 
+			type(output))) 
+	elif not isinstance(memory, numbers.Number) or memory < 8 * len(columns): 
+		raise ValueError("memory must be at least one row. Got: %s" % ( 
+			str(memory))) 
+	elif not isinstance(comment, str): 
+		raise TypeError("comment must be of type str. Got: %s" % ( 
+			type(comment))) 
+	else: 
+		for filename in files: 
+			if not os.path.exists(filename): 
+				raise IOError("File not found: %s" % (filename)) 
+			else: 
+				continue 
+	if labels is None: 
+		labels = [str(int(i)) for i in columns] 
+	elif (not isinstance(labels, list) or len(labels) != len(columns) or 
+		not all(map(lambda x: isinstance(x, str), labels))): 
+		raise TypeError("labels must be a list of str, one per column.") 
+	else: 
+		pass 
+	if integers is None: 
+		integers = [] 
+	elif not isinstance(integers, list) or not all(map(lambda x: x in 
+		columns, integers)): 
+		raise TypeError("integers must be a list of column numbers in columns.") 
+	else: 
+		pass 
+
+	encoded = [filename.encode("latin-1") for filename in files] 
+	cols = _array('i', [int(i) for i in columns]) 
+	flags = _array('i', [int(i in integers) for i in columns]) 
+	num_files = len(files) 
+	num_cols = len(columns) 
+	c_key = columns.index(key) 
+	c_descending = bool(descending) 
+	c_binary = bool(binary) 
+	c_comment = ord(comment[0]) 
+	c_cols = _ints(cols) 
+	c_integers = _ints(flags) 
+	budget = int(memory) 
+	if tmpdir is not None: 
+		encoded_tmpdir = str(tmpdir).encode("latin-1") 
+		c_tmpdir = encoded_tmpdir 
+	else: 
+		pass 
+	c_files = <char **> malloc(num_files * sizeof(char *)) 
+	for i in range(num_files): 
+		c_files[i] = encoded[i] 
+	if isinstance(output, str): 
+		encoded_output = output.encode("latin-1") 
+		c_output = encoded_output 
+		with nogil: 
+			status = external_sort_to_file(c_files, num_files, c_comment, 
+				c_cols, num_cols, c_integers, c_key, c_descending, budget, 
+				c_tmpdir, c_output, c_binary, &num_rows) 
+		free(c_files) 
+		if status: 
+			raise IOError("Error sorting into file: %s" % (output)) 
+		else: 
+			return num_rows 
+	else: 
+		sink = [output, [i.lower() for i in labels], None, list(flags)] 
+		with nogil: 
+			status = external_sort_rows(c_files, num_files, c_comment, c_cols, 
+				num_cols, c_integers, c_key, c_descending, budget, c_tmpdir, 
+				_external_sink, <void *> sink, &num_rows) 
+		free(c_files) 
+		if sink[2] is not None: 
+			raise sink[2] 
+		elif status: 
+			raise IOError("Error reading or writing sorted runs.") 
+		else: 
+			return num_rows 
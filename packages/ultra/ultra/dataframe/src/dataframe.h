@@ -5,24 +5,377 @@
 #ifndef DATAFRAME_H 
 #define DATAFRAME_H 
 
+#include <stdio.h> 
+
+/* 
+ * The arena struct. An arena is a single large allocation from which the 
+ * column buffers of a dataframe are carved by bumping an offset, such that 
+ * building a dataframe takes one allocation and tearing it down one free. 
+ * The struct sits at the start of its own memory. 
+ * 
+ * Fields 
+ * ====== 
+ * memory: 		The start of the memory available for carving 
+ * capacity: 	The number of bytes available for carving 
+ * used: 		The number of bytes carved so far 
+ * refcount: 	The number of column buffers carved from the arena, plus one 
+ * 				for its creator until it calls arena_release 
+ */ 
+typedef struct arena {
+
+	char *memory; 
+	unsigned long capacity; 
+	unsigned long used; 
+	int refcount; 
+
+} ARENA; 
+
+/* 
+ * The compressed form of the values of a column buffer. Each scheme keeps 
+ * random access to the values, so every kernel can read an encoded column, 
+ * and some scan the encoding directly (e.g. a sum over the runs of a run- 
+ * length encoded column). 
+ * 
+ * Fields 
+ * ====== 
+ * scheme: 		The encoding, as the ENCODING_* codes below 
+ * data: 		ENCODING_RLE: the value of each run, of the column's type 
+ * 				ENCODING_FOR: the packed offsets from the reference, bits 
+ * 				apiece, in 64-bit words 
+ * 				ENCODING_SHUFFLE: the byte planes which aren't constant 
+ * ends: 		ENCODING_RLE: one past the last position of each run 
+ * num_runs: 	ENCODING_RLE: the number of runs 
+ * reference: 	ENCODING_FOR: the smallest value 
+ * bits: 		ENCODING_FOR: the number of bits in each packed offset 
+ * planes: 		ENCODING_SHUFFLE: where in data byte k of every value is 
+ * 				stored; -1 if it's the same for every value 
+ * constants: 	ENCODING_SHUFFLE: byte k of every value, if it's the same 
+ * size: 		The number of bytes the encoding takes 
+ */ 
+typedef struct column_encoding {
+
+	int scheme; 
+	void *data; 
+	long *ends; 
+	long num_runs; 
+	long long reference; 
+	int bits; 
+	long planes[8]; 
+	unsigned char constants[8]; 
+	unsigned long size; 
+
+} COLUMN_ENCODING; 
+
+/* 
+ * The ways of encoding a column: none, run-length, frame of reference 
+ * bit-packing for integers, and byte shuffling with constant bytes dropped. 
+ * ENCODING_AUTO picks whichever takes the least memory. 
+ */ 
+#define ENCODING_PLAIN 0 
+#define ENCODING_RLE 1 
+#define ENCODING_FOR 2 
+#define ENCODING_SHUFFLE 3 
+#define ENCODING_AUTO 4 
+
+/* 
+ * A reference-counted buffer holding the values of one column. Several 
+ * dataframes may share a buffer, in which case each holds a reference to it; 
+ * the buffer is freed when the last reference is released. 
+ * 
+ * Fields 
+ * ====== 
+ * values: 		The values themselves, of the C type given by type; NULL if 
+ * 				the buffer is encoded 
+ * length: 		The number of values in the buffer 
+ * type: 		The type of the values, as the COLUMN_* codes below 
+ * refcount: 	The number of dataframes referencing the buffer 
+ * arena: 		The arena the buffer was carved from; NULL if it was allocated 
+ * 				on its own 
+ * destructor: 	For a buffer wrapping memory owned by someone else, the 
+ * 				function to call with context when the buffer is freed; NULL 
+ * 				if the buffer owns its values. The dataframe never writes to 
+ * 				memory it doesn't own. 
+ * context: 	The argument to the destructor 
+ * validity: 	One bit per value, set for the valid ones and clear for the 
+ * 				missing ones (e.g. sentinels like -1 or -99 in a halo 
+ * 				catalog); NULL if every value is valid. This is allocated on 
+ * 				its own even for a buffer carved from an arena. 
+ * encoding: 	The compressed values; NULL if the buffer holds them plainly 
+ * version: 	A number no other buffer has had, changed whenever the values 
+ * 				or their validity are modified in place (see version_stamp) 
+ * writers: 	The number of writable arrays sharing the values, through which 
+ * 				they may change at any time without a new version 
+ */ 
+typedef struct column_buffer {
+
+	void *values; 
+	long length; 
+	int type; 
+	int refcount; 
+	ARENA *arena; 
+	void (*destructor)(void *); 
+	void *context; 
+	unsigned char *validity; 
+	COLUMN_ENCODING *encoding; 
+	unsigned long version; 
+	int writers; 
+
+} COLUMN_BUFFER; 
+
+/* 
+ * The types of values a column buffer can hold: double, float, long long, 
+ * and int, respectively 
+ */ 
+#define COLUMN_FLOAT64 0 
+#define COLUMN_FLOAT32 1 
+#define COLUMN_INT64 2 
+#define COLUMN_INT32 3 
+
+/* 
+ * The value at a given position of a column buffer as a double whatever its 
+ * type or encoding, and as a long long for the integer types, which is 
+ * exact. 
+ */ 
+#define column_value(buffer, i) ((buffer) -> encoding != NULL ? \
+	column_encoded_value((buffer), (i)) : \
+	(buffer) -> type == COLUMN_FLOAT64 ? \
+	((double *) (buffer) -> values)[(i)] : \
+	(buffer) -> type == COLUMN_FLOAT32 ? \
+	(double) ((float *) (buffer) -> values)[(i)] : \
+	(buffer) -> type == COLUMN_INT64 ? \
+	(double) ((long long *) (buffer) -> values)[(i)] : \
+	(double) ((int *) (buffer) -> values)[(i)]) 
+#define column_integer(buffer, i) ((buffer) -> encoding != NULL ? \
+	column_encoded_integer((buffer), (i)) : \
+	(buffer) -> type == COLUMN_INT64 ? \
+	((long long *) (buffer) -> values)[(i)] : \
+	(long long) ((int *) (buffer) -> values)[(i)]) 
+#define column_is_integer(type) ((type) == COLUMN_INT64 || \
+	(type) == COLUMN_INT32) 
+
+/* 
+ * Whether or not the value at a given position of a column buffer is valid, 
+ * and the number of bytes of a validity bitmap for a given number of values 
+ */ 
+#define column_valid(buffer, i) ((buffer) -> validity == NULL || \
+	(((buffer) -> validity[(i) >> 3] >> ((i) & 7)) & 1)) 
+#define validity_bytes(length) (((length) + 7l) / 8l) 
+
 /* 
  * The dataframe struct. This is the struct that will store the data read in 
- * from a halo catalog. 
+ * from a halo catalog. The data are stored column by column in shared 
+ * buffers, and a dataframe is a view of some of the rows of those buffers: 
+ * either a contiguous slice of them or an arbitrary selection. 
  * 
  * Fields 
  * ====== 
- * data: 		The data itself - a double pointer to it 
- * num_rows: 	The number of elements in the first dimension of indexing 
- * num_cols: 	The number of elements in the second dimension of indexing 
+ * columns: 	The buffer holding each column. These are all the same length. 
+ * index: 		The row of the buffers holding each row of the dataframe; NULL 
+ * 				if the dataframe is a contiguous slice of the buffers 
+ * offset: 		The row of the buffers holding the first row of the 
+ * 				dataframe if it is a slice; ignored if index is not NULL 
+ * num_rows: 	The number of rows in the dataframe 
+ * num_cols: 	The number of columns in the dataframe 
+ * max_cols: 	The number of columns there is room for in the columns array 
+ * version: 	0 for a new or released dataframe until its rows are reordered 
+ * 				in place, after which a number no other dataframe has had 
+ * 				(see version_stamp). Views are stamped when they're made. 
  */ 
 typedef struct dataframe {
 
-	double **data; 
+	COLUMN_BUFFER **columns; 
+	long *index; 
+	long offset; 
 	long num_rows; 
 	int num_cols; 
+	int max_cols; 
+	unsigned long version; 
 
 } DATAFRAME; 
 
+/* 
+ * The row of the column buffers holding a given row of a dataframe, and the 
+ * value in a given row and column of a dataframe. 
+ */ 
+#define dfrow_index(df, row) ((df).index == NULL ? (df).offset + (row) : \
+	(df).index[(row)]) 
+#define dfvalue(df, row, column) \
+	column_value((df).columns[(column)], dfrow_index(df, row)) 
+#define dftype(df, column) ((df).columns[(column)] -> type) 
+#define dfvalid(df, row, column) \
+	column_valid((df).columns[(column)], dfrow_index(df, row)) 
+
+/* 
+ * The quantile sketch struct. This is a KLL sketch (Karnin, Lang & Liberty 
+ * 2016) which approximates the quantiles of a stream of values in bounded 
+ * memory. 
+ * 
+ * Fields 
+ * ====== 
+ * levels: 		The compactors. Items at level h each represent 2^h values. 
+ * sizes: 		The number of items in each level 
+ * allocated: 	The number of items allocated for each level 
+ * n: 			The number of values the sketch has seen 
+ * size: 		The number of items currently held across all levels 
+ * capacity: 	The number of items the sketch may hold before compacting 
+ * min: 		The minimum value seen 
+ * max: 		The maximum value seen 
+ * state: 		The state of the random number generator used in compaction 
+ * num_levels: 	The number of levels 
+ * k: 			The accuracy parameter: the capacity of the top level 
+ */ 
+typedef struct quantile_sketch {
+
+	double **levels; 
+	long *sizes; 
+	long *allocated; 
+	long n; 
+	long size; 
+	long capacity; 
+	double min; 
+	double max; 
+	unsigned long state; 
+	int num_levels; 
+	int k; 
+
+} QUANTILE_SKETCH; 
+
+/* 
+ * A sorted index of a column of a dataframe, which answers range selections 
+ * and rank queries with binary searches rather than scans of every row. 
+ * 
+ * Fields 
+ * ====== 
+ * rows: 			The rows of the dataframe in ascending order of their 
+ * 					values in the column, those missing one or holding a NaN 
+ * 					last 
+ * fences: 			The value in every INDEX_FENCE_STRIDE'th of the sorted 
+ * 					rows, searched first so that only a short stretch of the 
+ * 					rows is searched through the column itself 
+ * integer_fences: 	The same values as integers for an integer column; NULL 
+ * 					otherwise 
+ * num_valid: 		The number of rows holding a value that isn't NaN 
+ * num_rows: 		The number of rows of the dataframe 
+ * num_fences: 		The number of fences 
+ * buffer_version: 	The version of the column buffer the index was built on 
+ * version: 		The version of the dataframe the index was built on 
+ */ 
+typedef struct column_index {
+
+	long *rows; 
+	double *fences; 
+	long long *integer_fences; 
+	long num_valid; 
+	long num_rows; 
+	long num_fences; 
+	unsigned long buffer_version; 
+	unsigned long version; 
+
+} COLUMN_INDEX; 
+
+/* 
+ * The number of sets of column buffers a file stream cycles through: one 
+ * being parsed ahead, one handed out, and one handed out before it. 
+ */ 
+#define STREAM_BUFFERS 3 
+
+/* 
+ * The file stream struct. This reads an ASCII table in chunks of rows, 
+ * parsing each chunk on a separate thread while the one before it is used. 
+ * 
+ * Fields 
+ * ====== 
+ * in: 			The file 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the file to read 
+ * types: 		The type each column is stored as, as the COLUMN_* codes 
+ * num_cols: 	The number of columns 
+ * maxcol: 		The largest of the column numbers 
+ * chunksize: 	The number of rows in each chunk 
+ * chunks: 		The sets of column buffers the chunks are parsed into 
+ * lengths: 	The number of rows parsed into each set 
+ * filling: 	The set being parsed into, or just parsed 
+ * status: 		1 if a line of the file had too few columns, else 0 
+ * eof: 		1 once the end of the file has been reached, else 0 
+ * num_read: 	The number of rows handed out so far 
+ * reader: 		The thread parsing ahead (a pthread_t *); NULL if there is 
+ * 				none 
+ */ 
+typedef struct file_stream {
+
+	FILE *in; 
+	char comment; 
+	int *columns; 
+	int *types; 
+	int num_cols; 
+	int maxcol; 
+	long chunksize; 
+	COLUMN_BUFFER **chunks[STREAM_BUFFERS]; 
+	long lengths[STREAM_BUFFERS]; 
+	int filling; 
+	int status; 
+	int eof; 
+	long num_read; 
+	void *reader; 
+
+} FILE_STREAM; 
+
+/* 
+ * A row held by a top-k or sampling operator and its key, larger keys being 
+ * better. 
+ * 
+ * Fields 
+ * ====== 
+ * key: 		The key 
+ * row: 		The row number, counting from the first row offered 
+ * slot: 		Where a reservoir stores the row's values 
+ */ 
+typedef struct top_entry {
+
+	unsigned long long key; 
+	long row; 
+	long slot; 
+
+} TOP_ENTRY; 
+
+/* 
+ * The reservoir struct. This keeps the k best rows offered to it across 
+ * several dataframes (e.g. the chunks of a file stream), copying their 
+ * values, for a top-k or a random sample. 
+ * 
+ * Fields 
+ * ====== 
+ * k: 			The number of rows to keep 
+ * size: 		The number of rows kept so far 
+ * seen: 		The number of rows offered so far 
+ * num_cols: 	The number of columns 
+ * types: 		The type of each column, as the COLUMN_* codes 
+ * values: 		The values of each column, in slots 0 through k - 1 
+ * valid: 		Whether or not each value is valid, by column and slot 
+ * heap: 		The rows kept, the worst at the root 
+ * column: 		The column ranked by, or the column of weights of a sample 
+ * 				(-1 if uniform) 
+ * largest: 	1 to keep the largest values, 0 the smallest 
+ * random: 		1 for a sample, 0 for a top-k 
+ * seed: 		The seed of a sample's random numbers 
+ */ 
+typedef struct reservoir {
+
+	long k; 
+	long size; 
+	long seen; 
+	int num_cols; 
+	int *types; 
+	void **values; 
+	unsigned char **valid; 
+	TOP_ENTRY *heap; 
+	int column; 
+	int largest; 
+	int random; 
+	unsigned long seed; 
+
+} RESERVOIR; 
+
 /* 
  * Allocates memory for a dataframe struct and returns the pointer. 
  * 
@@ -43,8 +396,8 @@ extern DATAFRAME *dataframe_initialize(void);
 extern DATAFRAME **dataframe_array_initialize(int n); 
 
 /* 
- * Frees the memory storing both the data attribute and the dataframe struct 
- * itself. 
+ * Releases the dataframe's references to its column buffers and frees the 
+ * dataframe struct itself. 
  * 
  * source: dataframe_utils.c 
  */ 
@@ -66,338 +419,2069 @@ extern void free_dataframe_array(DATAFRAME **df, int n);
 
 
 
-/* --------------------------- FILE I/O FUNCTIONS --------------------------- */ 
+/* ----------------------- COLUMN BUFFERS AND VIEWS ----------------------- */ 
 
 /* 
- * Reads in the data from a file and stored it in a dataframe object's data 
- * field. Takes user-specified columns from the file. 
+ * Allocates memory for a column buffer holding one reference and returns the 
+ * pointer. 
  * 
  * Parameters 
  * ========== 
- * df: 			A pointer to the dataframe itself 
- * file: 		The name of the file 
- * comment: 	The commenting character 
- * columns: 	The column numbers to take 
- * num_cols: 	The number of columns being imported 
- * 
- * Returns 
- * ======= 
- * 0 on success, 1 on failure 
+ * length: 		The number of values in the buffer 
+ * type: 		The type of the values, as the COLUMN_* codes 
  * 
- * header: dataframe.h 
- */
-extern int populate_from_file(DATAFRAME *df, char *file, char comment, 
-	int *columns, int num_cols); 
-
-
+ * source: dataframe_views.c 
+ */ 
+extern COLUMN_BUFFER *column_buffer_initialize(long length, int type); 
 
+/* 
+ * The number of bytes taken by one value of a given type, as the COLUMN_* 
+ * codes; 0 if the type is not recognized. 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern unsigned long column_type_size(int type); 
 
+/* 
+ * Allocates memory for a column buffer wrapping values owned by someone 
+ * else, without copying them, and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * values: 		The values to wrap 
+ * length: 		The number of values 
+ * type: 		The type of the values, as the COLUMN_* codes 
+ * destructor: 	The function to call with context when the buffer is freed, 
+ * 				e.g. to let the owner know the values are no longer in use 
+ * context: 	The argument to the destructor 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern COLUMN_BUFFER *column_buffer_wrap(void *values, long length, int type, 
+	void (*destructor)(void *), void *context); 
 
+/* 
+ * Allocates memory for a column buffer holding a contiguous copy of an array 
+ * of a given type, with a given stride between elements. 
+ * 
+ * Parameters 
+ * ========== 
+ * data: 		The start of the array 
+ * length: 		The number of elements 
+ * stride: 		The number of bytes between consecutive elements 
+ * type: 		The type of the elements, as the COLUMN_* codes above 
+ * 
+ * Returns 
+ * ======= 
+ * The buffer; NULL if the type is not recognized 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern COLUMN_BUFFER *column_buffer_convert(void *data, long length, 
+	long stride, int type); 
 
+/* 
+ * Adds a reference to a column buffer. 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern void column_buffer_retain(COLUMN_BUFFER *buffer); 
 
+/* 
+ * Determine a number no previous call has returned, to mark a column buffer 
+ * or dataframe as changed. This is safe to call from parallel regions. 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern unsigned long version_stamp(void); 
 
+/* 
+ * Removes a reference from a column buffer, freeing it if that was the last 
+ * one. 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern void column_buffer_release(COLUMN_BUFFER *buffer); 
 
-/* ---------------------------- DATAFRAME SUBS ---------------------------- */ 
+/* 
+ * Releases a dataframe's references to its column buffers and frees its 
+ * selection, leaving it empty. The dataframe struct itself is not freed. 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern void dataframe_release(DATAFRAME *df); 
 
 /* 
- * Takes a column from the data and returns a double pointer to it 
+ * Makes a dataframe a view of a contiguous range of the rows of another. 
  * 
  * Parameters 
  * ========== 
- * df: 			The dataframe to take the column from 
- * column: 		The column number to take 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * start: 		The first row of the source in the view 
+ * stop: 		One past the last row of the source in the view 
  * 
  * Returns 
  * ======= 
- * Type *double :: The column'th element of each row in the dataframe 
- * NULL if the column number is not allowed 
+ * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern double *dfcolumn(DATAFRAME df, int column); 
+extern int dataframe_slice(DATAFRAME source, DATAFRAME *dest, long start, 
+	long stop); 
 
 /* 
- * Adds a new column to the dataframe. 
+ * Makes a dataframe a view of an arbitrary selection of the rows of another. 
  * 
  * Parameters 
  * ========== 
- * df: 			A pointer to the dataframe to put the new column into 
- * arr: 		A pointer to the array to store as the new column 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * rows: 		The rows of the source in the view, in the order they should 
+ * 				appear in it 
+ * num_rows: 	The number of rows in the view 
  * 
  * Returns 
  * ======= 
- * 0 always; anything else is a SystemError 
+ * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern int dfcolumn_new(DATAFRAME *df, double *arr); 
+extern int dataframe_select(DATAFRAME source, DATAFRAME *dest, long *rows, 
+	long num_rows); 
 
 /* 
- * Modify a column of the dataframe. 
+ * Makes a dataframe a view of the rows of another which pass a test. 
  * 
  * Parameters 
  * ========== 
- * df: 			A pointer to the dataframe to be modified 
- * arr: 		A pointer to the array representing the new values in the given 
- * 				column 
- * column: 		The column number to modify 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * test: 		1s at the rows of the source to include, 0s elsewhere 
  * 
  * Returns 
  * ======= 
- * 0 always; anything else is a SystemError 
+ * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern int dfcolumn_modify(DATAFRAME *df, double *arr, int column); 
+extern int dataframe_select_mask(DATAFRAME source, DATAFRAME *dest, 
+	int *test); 
 
 /* 
- * Determine the minimum value in a column of the dataframe 
+ * Ensures that a dataframe has room for at least a given number of columns 
+ * without reallocating its columns array. The room is at least doubled when 
+ * it grows, so adding columns one at a time takes amortized constant time. 
  * 
  * Parameters 
  * ========== 
- * df: 			The dataframe itself 
- * column: 		The column index to take the minimum value from 
- * ptr: 		A pointer to put the minimum value in 
+ * df: 			A pointer to the dataframe 
+ * num_cols: 	The number of columns to make room for 
+ * 
+ * source: dataframe_views.c 
+ */ 
+extern void dataframe_reserve_columns(DATAFRAME *df, int num_cols); 
+
+/* 
+ * Gives a dataframe its own compact copy of the rows of its column buffers 
+ * that it views, releasing its references to the shared ones. 
  * 
  * Returns 
  * ======= 
  * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern int dfcolumn_min(DATAFRAME df, int column, double *ptr); 
+extern int dataframe_materialize(DATAFRAME *df); 
 
 /* 
- * Determine the maximum value in a column of the dataframe 
+ * Copies the rows of a column of a dataframe that it views into a contiguous 
+ * array of the column's own type, without converting them. 
  * 
  * Parameters 
  * ========== 
  * df: 			The dataframe itself 
- * column: 		The column index to take the minimum value from 
- * ptr: 		A pointer to put the maximum value in 
+ * column: 		The column number 
+ * dest: 		The array to copy into, with df.num_rows elements of the type 
+ * 				of the column 
  * 
  * Returns 
  * ======= 
  * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern int dfcolumn_max(DATAFRAME df, int column, double *ptr); 
+extern int dfcolumn_gather(DATAFRAME df, int column, void *dest); 
 
 /* 
- * Determine the sum of the values stored in a column of the dataframe 
+ * Ensures that a dataframe holds the only reference to the buffer of a given 
+ * column, copying the buffer if it's shared (i.e. copy-on-write). 
  * 
  * Parameters 
  * ========== 
- * df: 			The dataframe itself 
- * column: 		The column index to take the minimum value of 
- * ptr: 		A pointer to put the sum in 
+ * df: 			A pointer to the dataframe about to write to the column 
+ * column: 		The column number 
  * 
  * Returns 
  * ======= 
- * 0 on success, 1 on failure
+ * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_views.c 
  */ 
-extern int dfcolumn_sum(DATAFRAME df, int column, double *ptr); 
+extern int dfcolumn_detach(DATAFRAME *df, int column); 
+
+
+
+
+
+/* ------------------------------- VALIDITY ------------------------------- */ 
 
 /* 
- * Determine the arithmetic mean of the value stored ina column of the 
- * dataframe. 
+ * Marks the values in a column of a dataframe equal to any of a set of 
+ * sentinels as missing. Only the rows the dataframe views are marked, and 
+ * the dataframe is first given its own copy of the column if it's shared. 
  * 
  * Parameters 
  * ========== 
- * df: 			The dataframe itself 
- * column: 		The column index to find the mean value of 
- * ptr: 		A pointer to put the mean value in 
+ * df: 				A pointer to the dataframe 
+ * column: 			The column number 
+ * sentinels: 		The values which mean missing. A NaN marks NaNs missing. 
+ * num_sentinels: 	The number of sentinels 
  * 
  * Returns 
  * ======= 
  * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_validity.c 
  */ 
-extern int dfcolumn_mean(DATAFRAME df, int column, double *ptr); 
+extern int dfcolumn_mark_invalid(DATAFRAME *df, int column, double *sentinels, 
+	int num_sentinels); 
 
 /* 
- * Determine the median of a given column of the data 
+ * Determine which rows of a column of a dataframe are valid. 
  * 
  * Parameters 
  * ========== 
  * df: 			The dataframe itself 
- * column: 		The column number to find the median of 
- * ptr: 		A pointer to put the median value into 
+ * column: 		The column number 
+ * ptr: 		A pointer to put 1s at the valid rows and 0s at the missing ones 
+ * 				into, with df.num_rows elements 
  * 
  * Returns 
  * ======= 
  * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_validity.c 
  */ 
-extern int dfcolumn_median(DATAFRAME df, int column, double *ptr); 
+extern int dfcolumn_validity(DATAFRAME df, int column, int *ptr); 
 
 /* 
- * Determine the standard deviation of a column of the data. 
+ * Determine the number of valid values in a column of a dataframe. 
  * 
  * Parameters 
  * ========== 
  * df: 			The dataframe itself 
- * column:	 	The column number to find the standard deviation of 
- * ptr: 		A pointer to put the standard deviation into 
+ * column: 		The column number 
+ * ptr: 		A pointer to put the number of valid values into 
  * 
  * Returns 
  * ======= 
  * 0 on success, 1 on failure 
  * 
- * source: dataframe_subs.c 
+ * source: dataframe_validity.c 
  */ 
-extern int dfcolumn_std(DATAFRAME df, int column, double *ptr); 
+extern int dfcolumn_count_valid(DATAFRAME df, int column, long *ptr); 
 
 /* 
- * Determine a dispersion measurement in a given column of the data. The two 
- * returned values will contain the specified fraction of the data centered on 
- * the median. 
+ * Takes the valid values of a column as doubles, skipping the missing ones. 
  * 
  * Parameters 
  * ========== 
  * df: 			The dataframe itself 
- * column: 		The column to find the dispersion of 
- * fraction: 	The fraction of the data that is contained between the two 
- * 				returned lower and upper bounds 
- * ptr: 		A pointer to put the 2 values into 
+ * column: 		The column number, which must be in range 
+ * length: 		A pointer to put the number of valid values into 
  * 
  * Returns 
  * ======= 
- * 0 on success, 1 on failure 
+ * Type *double :: The valid values, in row order 
  * 
- * header: dataframe.h 
+ * source: dataframe_validity.c 
  */ 
-extern int dfcolumn_scatter(DATAFRAME df, int column, double fraction, 
-	double *ptr); 
-
-
-
-
-
-/* ---------------------------- SIEVE FUNCTIONS ---------------------------- */ 
+extern double *dfcolumn_valid_values(DATAFRAME df, int column, long *length); 
 
 /* 
- * Filter the dataset based on some condition applied to the values stored in 
- * a given column. 
+ * Copies the validity of the rows of a column of a dataframe that it views 
+ * into the validity bitmap of another column buffer, row for row. 
  * 
  * Parameters 
  * ========== 
- * source: 				The dataframe containing the data to be filtered 
- * dest: 				A pointer to the dataframe to put the filtered data into 
- * column: 				The column number to filter based on 
- * value: 				The value to compare to for filtering 
- * relational_code:		1 for < 
- * 						2 for <= 
- *						3 for = 
- * 						4 for >= 
- * 						5 for > 
- * 						6 for != 
- * 
- * Returns 
- * ======= 
- * 0 on success, 1 on failure 
+ * df: 			The dataframe itself 
+ * column: 		The column number 
+ * dest: 		The buffer to give the validity to, with df.num_rows values. 
+ * 				Its bitmap is left NULL if every value is valid. 
  * 
- * header: dataframe.h 
+ * source: dataframe_validity.c 
  */ 
-extern int sieve(DATAFRAME source, DATAFRAME *dest, int column, double value, 
-	int relational_code); 
-
-
+extern void dfcolumn_gather_validity(DATAFRAME df, int column, 
+	COLUMN_BUFFER *dest); 
 
-
-
-
-
-
-/* --------------------------- SORTING FUNCTIONS --------------------------- */ 
+/* ------------------------------- ENCODINGS ------------------------------- */ 
 
 /* 
- * Sorts a dataframe pointer in ascending order based on the data in a given 
- * column. 
+ * Replaces the buffer of a column of a dataframe with an encoded copy of it, 
+ * or a plain one. Other dataframes sharing the buffer are unaffected. 
  * 
  * Parameters 
  * ========== 
- * df: 			A pointer to the dataframe to sort 
- * column: 		The column number to sort based on 
+ * df: 			A pointer to the dataframe 
+ * column: 		The column number 
+ * scheme: 		The encoding, as the ENCODING_* codes. ENCODING_PLAIN decodes 
+ * 				the column, and ENCODING_AUTO picks the smallest encoding, 
+ * 				leaving the column plain if none is smaller. 
  * 
  * Returns 
  * ======= 
- * 0 on success, anything else would be a system error. 
+ * 0 on success, 1 on failure (e.g. ENCODING_FOR on a floating point column) 
  * 
- * source: dataframe_sorting.c 
+ * source: dataframe_encoding.c 
  */ 
-extern int dfcolumn_order(DATAFRAME *df, int column); 
+extern int dfcolumn_encode(DATAFRAME *df, int column, int scheme); 
 
 /* 
- * Take the data from a source dataframe and put into a destination dataframe 
- * only the data which lie in a given bin based on the values in a given 
- * column. 
+ * Allocates memory for a plain column buffer holding the decoded values of 
+ * another, along with its validity. 
  * 
- * Parameters 
+ * source: dataframe_encoding.c 
+ */ 
+extern COLUMN_BUFFER *column_buffer_decode(COLUMN_BUFFER *buffer); 
+
+/* 
+ * Allocates memory for a copy of an encoding and returns the pointer. 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern COLUMN_ENCODING *column_encoding_copy(COLUMN_ENCODING *e); 
+
+/* 
+ * Frees the memory stored by an encoding. 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern void column_encoding_free(COLUMN_ENCODING *e); 
+
+/* 
+ * The value at a given position of an encoded column buffer, as a double and 
+ * as a long long. 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern double column_encoded_value(COLUMN_BUFFER *buffer, long i); 
+extern long long column_encoded_integer(COLUMN_BUFFER *buffer, long i); 
+
+/* 
+ * Copies the value at a given position of an encoded column buffer into 
+ * dest, as it'd be stored plainly. 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern void column_encoded_get(COLUMN_BUFFER *buffer, long i, void *dest); 
+
+/* 
+ * The number of bytes taken by the values of a column buffer, encoded or 
+ * not, excluding its validity. 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern unsigned long column_buffer_nbytes(COLUMN_BUFFER *buffer); 
+
+/* 
+ * Whether or not a column of a dataframe is a run-length encoded slice with 
+ * no missing values, which the kernels scan run by run. 
+ */ 
+#define dfcolumn_runs(df, column) ((df).index == NULL && \
+	(df).columns[(column)] -> encoding != NULL && \
+	(df).columns[(column)] -> encoding -> scheme == ENCODING_RLE && \
+	(df).columns[(column)] -> validity == NULL) 
+
+/* 
+ * Determine the sum, minimum, and maximum of a contiguous range of the 
+ * values of a run-length encoded column buffer, one run at a time. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 		The buffer, with ENCODING_RLE 
+ * first: 		The first position of the range 
+ * last: 		One past the last position of the range 
+ * sum: 		A pointer to put the sum into 
+ * minimum: 	A pointer to put the minimum into (0 for an empty range) 
+ * maximum: 	A pointer to put the maximum into (0 for an empty range) 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern void rle_summary(COLUMN_BUFFER *buffer, long first, long last, 
+	double *sum, double *minimum, double *maximum); 
+
+/* 
+ * Determine which values of a contiguous range of a run-length encoded 
+ * column buffer satisfy a relation, testing each run once. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 				The buffer, with ENCODING_RLE 
+ * first: 				The first position of the range 
+ * last: 				One past the last position of the range 
+ * value: 				The value to compare to 
+ * integer: 			The same value as an integer, to compare integer 
+ * 						columns to exactly; NULL to compare as doubles 
+ * relational_code: 	As in sieve 
+ * test: 				A pointer to put 1s at the values that pass and 0s 
+ * 						elsewhere into, with last - first elements 
+ * 
+ * source: dataframe_encoding.c 
+ */ 
+extern void rle_test(COLUMN_BUFFER *buffer, long first, long last, 
+	double value, long long *integer, int relational_code, int *test); 
+
+/* -------------------------------- ARENAS -------------------------------- */ 
+
+/* 
+ * Allocates an arena with room for at least a given number of bytes and 
+ * returns the pointer. Large arenas are aligned to and padded out to whole 
+ * huge pages, which the kernel is advised to back them with. 
+ * 
+ * Parameters 
+ * ========== 
+ * capacity: 	The number of bytes to make available for carving 
+ * 
+ * Returns 
+ * ======= 
+ * The arena, holding one reference for its creator; NULL if the memory 
+ * could not be allocated 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern ARENA *arena_initialize(unsigned long capacity); 
+
+/* 
+ * Carves memory out of an arena. This is safe to call from several threads 
+ * at once: each carve is a single atomic bump of the offset. 
+ * 
+ * Parameters 
+ * ========== 
+ * a: 			The arena itself 
+ * size: 		The number of bytes to carve 
+ * 
+ * Returns 
+ * ======= 
+ * The memory, aligned to a cache line; NULL if the arena is full 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern void *arena_allocate(ARENA *a, unsigned long size); 
+
+/* 
+ * Adds a reference to an arena. This is safe to call from several threads 
+ * at once. 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern void arena_retain(ARENA *a); 
+
+/* 
+ * Removes a reference from an arena, freeing all of its memory at once if 
+ * that was the last one. 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern void arena_release(ARENA *a); 
+
+/* 
+ * The number of bytes of an arena a column buffer of a given length and type 
+ * takes. 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern unsigned long column_buffer_footprint(long length, int type); 
+
+/* 
+ * Carves a column buffer holding one reference out of an arena. The buffer 
+ * holds a reference to the arena. 
+ * 
+ * Parameters 
+ * ========== 
+ * a: 			The arena to carve from 
+ * length: 		The number of values in the buffer 
+ * type: 		The type of the values, as the COLUMN_* codes 
+ * 
+ * Returns 
+ * ======= 
+ * The buffer. If the arena is NULL or full, the buffer is allocated on its 
+ * own as in column_buffer_initialize. 
+ * 
+ * source: dataframe_arena.c 
+ */ 
+extern COLUMN_BUFFER *column_buffer_from_arena(ARENA *a, long length, 
+	int type); 
+
+
+
+
+
+/* --------------------------- FILE I/O FUNCTIONS --------------------------- */ 
+
+/* 
+ * Reads in the data from a file and stored it in a dataframe object's data 
+ * field. Takes user-specified columns from the file. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe itself 
+ * file: 		The name of the file 
+ * comment: 	The commenting character 
+ * columns: 	The column numbers to take 
+ * num_cols: 	The number of columns being imported 
+ * types: 		The type to store each column as, as the COLUMN_* codes in 
+ * 				dataframe.h. Integer columns are parsed as integers, so e.g. 
+ * 				IDs past 2^53 are read exactly. NULL to store them all as 
+ * 				float64. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */
+extern int populate_from_file(DATAFRAME *df, char *file, char comment, 
+	int *columns, int num_cols, int *types); 
+
+/* 
+ * Opens a file for reading in chunks and starts parsing the first chunk. 
+ * 
+ * Parameters 
+ * ========== 
+ * file: 		The name of the file 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the file to read 
+ * num_cols: 	The number of columns 
+ * types: 		The type to store each column as, as the COLUMN_* codes; 
+ * 				NULL to store them all as doubles 
+ * chunksize: 	The number of rows in each chunk 
+ * 
+ * Returns 
+ * ======= 
+ * The stream; NULL if the file can't be opened or the arguments are 
+ * invalid 
+ * 
+ * source: dataframe_stream.c 
+ */ 
+extern FILE_STREAM *stream_initialize(char *file, char comment, 
+	int *columns, int num_cols, int *types, long chunksize); 
+
+/* 
+ * Frees the memory stored in a file stream and closes the file. Chunks 
+ * already handed out keep their column buffers. 
+ * 
+ * source: dataframe_stream.c 
+ */ 
+extern void free_stream(FILE_STREAM *s); 
+
+/* 
+ * Takes the next chunk of a file stream as a dataframe and starts parsing 
+ * the one after it. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The stream 
+ * dest: 		The dataframe to put the chunk into, which views the column 
+ * 				buffers of the stream. It is left with no rows or columns 
+ * 				once the file is exhausted. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if a line of the file has too few columns 
+ * 
+ * source: dataframe_stream.c 
+ */ 
+extern int stream_next(FILE_STREAM *s, DATAFRAME *dest); 
+
+
+
+
+
+
+
+
+
+/* ---------------------------- DATAFRAME SUBS ---------------------------- */ 
+
+/* 
+ * Takes a column from the data and returns a double pointer to it 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe to take the column from 
+ * column: 		The column number to take 
+ * 
+ * Returns 
+ * ======= 
+ * Type *double :: The column'th element of each row in the dataframe 
+ * NULL if the column number is not allowed 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern double *dfcolumn(DATAFRAME df, int column); 
+
+/* 
+ * Copies a column of the data into an array. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe to take the column from 
+ * column: 		The column number to take 
+ * ptr: 		A pointer to put the num_rows values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_get(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Copies a row of the data into an array. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe to take the row from 
+ * row: 		The row number to take 
+ * ptr: 		A pointer to put the num_cols values into. Missing values are 
+ * 				NaN. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfrow_get(DATAFRAME df, long row, double *ptr); 
+
+/* 
+ * Adds a new column to the dataframe. A view of only some of the rows of its 
+ * column buffers is first given its own compact copy of them. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe to put the new column into 
+ * arr: 		A pointer to the array to store as the new column 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_new(DATAFRAME *df, double *arr); 
+
+/* 
+ * Adds several new columns to the dataframe at once. The new columns are 
+ * carved from a single arena and filled in parallel. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe to put the new columns into 
+ * arr: 		A pointer to the values of the new columns, one column after 
+ * 				another (i.e. num_new * num_rows values) 
+ * num_new: 	The number of new columns 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumns_new(DATAFRAME *df, double *arr, int num_new); 
+
+/* 
+ * Puts a column buffer into the dataframe, either replacing a column or 
+ * adding a new one, without copying it. An empty dataframe takes its number 
+ * of rows from the buffer. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe 
+ * buffer: 		The buffer. The dataframe takes over the caller's reference to 
+ * 				it on success. 
+ * column: 		The column number to replace; num_cols to add a new column 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (the column number is out of range, or the 
+ * buffer's length is not the number of rows) 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_adopt(DATAFRAME *df, COLUMN_BUFFER *buffer, int column); 
+
+/* 
+ * Modify a column of the dataframe. A column buffer shared with other 
+ * dataframes is copied first (i.e. copy-on-write). 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe to be modified 
+ * arr: 		A pointer to the array representing the new values in the given 
+ * 				column 
+ * column: 		The column number to modify 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_modify(DATAFRAME *df, double *arr, int column); 
+
+/* 
+ * Determine the minimum value in a column of the dataframe 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column index to take the minimum value from 
+ * ptr: 		A pointer to put the minimum value in 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_min(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine the maximum value in a column of the dataframe 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column index to take the minimum value from 
+ * ptr: 		A pointer to put the maximum value in 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_max(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine the sum of the values stored in a column of the dataframe 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column index to take the minimum value of 
+ * ptr: 		A pointer to put the sum in 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_sum(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine the arithmetic mean of the value stored ina column of the 
+ * dataframe. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column index to find the mean value of 
+ * ptr: 		A pointer to put the mean value in 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_mean(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine the median of a given column of the data 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to find the median of 
+ * ptr: 		A pointer to put the median value into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_median(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine the standard deviation of a column of the data. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column:	 	The column number to find the standard deviation of 
+ * ptr: 		A pointer to put the standard deviation into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_std(DATAFRAME df, int column, double *ptr); 
+
+/* 
+ * Determine a dispersion measurement in a given column of the data. The two 
+ * returned values will contain the specified fraction of the data centered on 
+ * the median. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column to find the dispersion of 
+ * fraction: 	The fraction of the data that is contained between the two 
+ * 				returned lower and upper bounds 
+ * ptr: 		A pointer to put the 2 values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_scatter(DATAFRAME df, int column, double fraction, 
+	double *ptr); 
+
+/* 
+ * Determine several quantiles of a given column of the data in a single 
+ * selection pass. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column to find the quantiles of 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * ptr: 			A pointer to put the num_fractions values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_subs.c 
+ */ 
+extern int dfcolumn_quantiles(DATAFRAME df, int column, double *fractions, 
+	int num_fractions, double *ptr); 
+
+
+
+
+
+/* ---------------------------- SIEVE FUNCTIONS ---------------------------- */ 
+
+/* 
+ * Filter the dataset based on some condition applied to the values stored in 
+ * a given column. The filtered dataframe is a view of the source. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 				The dataframe containing the data to be filtered 
+ * dest: 				A pointer to the dataframe to put the filtered data into 
+ * column: 				The column number to filter based on 
+ * value: 				The value to compare to for filtering 
+ * relational_code:		1 for < 
+ * 						2 for <= 
+ *						3 for = 
+ * 						4 for >= 
+ * 						5 for > 
+ * 						6 for != 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sieve(DATAFRAME source, DATAFRAME *dest, int column, double value, 
+	int relational_code); 
+
+/* 
+ * Filter the dataset based on some condition applied to the values stored in 
+ * an integer column, comparing them to an integer exactly. A column of 
+ * floating point values is compared as in sieve. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 				The dataframe containing the data to be filtered 
+ * dest: 				A pointer to the dataframe to put the filtered data into 
+ * column: 				The column number to filter based on 
+ * value: 				The integer to compare to for filtering 
+ * relational_code:		As in sieve 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_sieve.c 
+ */ 
+extern int sieve_integer(DATAFRAME source, DATAFRAME *dest, int column, 
+	long long value, int relational_code); 
+
+
+
+
+
+
+
+
+/* --------------------------- SORTING FUNCTIONS --------------------------- */ 
+
+/* 
+ * Sorts a dataframe pointer in ascending order based on the data in a given 
+ * column. Only its view of its column buffers is reordered. Rows missing a 
+ * value in the column go last, in their original order. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe to sort 
+ * column: 		The column number to sort based on 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int dfcolumn_order(DATAFRAME *df, int column); 
+
+/* 
+ * Sorts a dataframe pointer on the data in several columns, ordering rows 
+ * by the first column, then those tied in it by the second, and so on. 
+ * Only its view of its column buffers is reordered. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				A pointer to the dataframe to sort 
+ * columns: 		The column numbers to sort based on 
+ * descending: 		1 to sort on each column in descending order, 0 for 
+ * 					ascending 
+ * num_keys: 		The number of columns to sort based on 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * The sort is stable: rows tied in every column keep their order. Rows 
+ * missing a value in a column, or holding a NaN, go after the others tied 
+ * with them in the columns before it, whether ascending or descending. 
+ * Integer columns are compared exactly. The values are turned into 64-bit 
+ * keys whose order as unsigned integers is theirs (see column_key) and 
+ * radix sorted. 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int dfcolumns_order(DATAFRAME *df, int *columns, int *descending, 
+	int num_keys); 
+
+/* 
+ * Determine the order of the rows of a dataframe sorted on the data in 
+ * several columns, as in dfcolumns_order, without reordering it. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers to sort based on 
+ * descending: 		1 to sort on each column in descending order, 0 for 
+ * 					ascending 
+ * num_keys: 		The number of columns to sort based on 
+ * order: 			A pointer to put the row numbers into in sorted order, 
+ * 					with df.num_rows elements 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int dfcolumns_argsort(DATAFRAME df, int *columns, int *descending, 
+	int num_keys, long *order); 
+
+/* 
+ * Take the data from a source dataframe and put into a destination dataframe 
+ * only the data which lie in a given bin based on the values in a given 
+ * column. The destination is a view of the source. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 			The source dataframe 
+ * dest: 			The destination dataframe 
+ * column: 			The column number that binning is based on 
+ * bin: 			The left and right bin edges 
+ * 
+ * Returns 
+ * ======= 
+ * 0 always, anything else would be a system error 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_bin(DATAFRAME source, DATAFRAME *dest, int column, 
+	double *bin); 
+
+/* 
+ * Determine the number of data points that fall within specified bin (i.e. 
+ * a histogram) based on the values in a given column of the dataframe. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to get counts based on 
+ * binspace: 	The binspace to sort based on 
+ * num_bins: 	The number of bins in the binspace. This should be one less 
+ * 				than the number of values in the binspace array. 
+ * 
+ * Returns 
+ * =======
+ * 0 always. If it returns anything else, there was an internal error. 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int hist(DATAFRAME df, int column, double *binspace, long num_bins, 
+	long *counts);  
+
+/* 
+ * Determine weighted counts of the data points that fall within a grid of 
+ * bins in any number of dimensions (i.e. a multi-dimensional histogram) 
+ * based on the values in a given set of columns. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers for each dimension 
+ * ndim: 			The number of dimensions 
+ * binspaces: 		The bin edges along each dimension, in ascending order 
+ * num_bins: 		The number of bins along each dimension 
+ * weights: 		The column number of the weights; -1 for unweighted counts 
+ * mask: 			1s at the rows to include and 0s at the rows to skip; NULL 
+ * 					to include all rows 
+ * cumulative: 		1 to return the cumulative sums along every dimension 
+ * 					(i.e. the sums over all bins at or below each bin), 0 for 
+ * 					the sums within each bin 
+ * sums: 			A pointer to put the sum of the weights in each bin into. 
+ * 					The bins are laid out in row-major order (the last 
+ * 					dimension varies fastest), and there must be the product 
+ * 					of num_bins elements. 
+ * sums2: 			A pointer to put the sum of the squared weights in each bin 
+ * 					into, laid out the same as sums; NULL to skip it 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int histdd(DATAFRAME df, int *columns, int ndim, double **binspaces, 
+	long *num_bins, int weights, int *mask, int cumulative, double *sums, 
+	double *sums2); 
+
+/* 
+ * The statistics binned_statistic and group_statistic can take within each 
+ * bin or group 
+ */ 
+#define BINNED_COUNT 0 
+#define BINNED_SUM 1 
+#define BINNED_MEAN 2 
+#define BINNED_STD 3 
+#define BINNED_MIN 4 
+#define BINNED_MAX 5 
+#define BINNED_MEDIAN 6 
+#define BINNED_QUANTILE 7 
+
+/* 
+ * Determine summary statistics of the values in one column of the data 
+ * within bins of the values in another column. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * xcolumn: 		The column number to bin based on 
+ * ycolumn: 		The column number to take the statistics of 
+ * binspace: 		The bin edges, in ascending order 
+ * num_bins: 		The number of bins in the binspace. This should be one less 
+ * 					than the number of values in the binspace array. 
+ * stats: 			The statistics to take, as the BINNED_* codes above 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics requested 
+ * results: 		A pointer to put the statistics into. Bin i's statistics 
+ * 					are at results[i * num_stats] through 
+ * 					results[i * num_stats + num_stats - 1], in the same order 
+ * 					as stats. This must have num_bins * num_stats elements. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_statistics.c 
+ */ 
+extern int binned_statistic(DATAFRAME df, int xcolumn, int ycolumn, 
+	double *binspace, long num_bins, int *stats, double *fractions, 
+	int num_stats, double *results); 
+
+/* 
+ * Determine summary statistics of the values in a column of the data within 
+ * groups of its rows. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * groups: 			The group number of each row; -1 for rows in no group 
+ * num_groups: 		The number of groups 
+ * column: 			The column number to take the statistics of 
+ * stats: 			The statistics to take, as the BINNED_* codes above 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics requested 
+ * results: 		A pointer to put the statistics into. Group i's statistics 
+ * 					are at results[i * num_stats] through 
+ * 					results[i * num_stats + num_stats - 1], in the same order 
+ * 					as stats. This must have num_groups * num_stats elements. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_statistics.c 
+ */ 
+extern int group_statistic(DATAFRAME df, long *groups, long num_groups, 
+	int column, int *stats, double *fractions, int num_stats, 
+	double *results); 
+
+/* 
+ * Generates an equal number subsample off of a dataframe that has already been 
+ * sorted into ascending order based on the data in a given column. The 
+ * subsample is a view of a slice of the ordered dataframe. 
+ * 
+ * Parameters 
+ * ========== 
+ * ordered: 		The ordered dataframe 
+ * dest: 			The destination dataframe 
+ * num_subs: 		The number of subsamples being generated 
+ * index: 			The index of the subsample that is being generated 
+ * 
+ * Returns 
+ * ======= 
+ * 0 always; anything else is a SystemError 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_equal_number_subsample(DATAFRAME ordered, DATAFRAME *dest, 
+	int num_subs, int index); 
+
+/* 
+ * Splits a dataframe into equal number subsamples based on the data in a 
+ * given column without sorting it. The split values are found by 
+ * multi-quantile selection and the rows scattered into contiguous 
+ * partitions in a single counting pass. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe to split 
+ * column: 			The column number to split based on 
+ * num_subs: 		The number of subsamples to generate 
+ * dests: 			A pointer to num_subs dataframes to put the subsamples into. 
+ * 					Subsample i holds the rows of sorted rank i * N / num_subs 
+ * 					up to (i + 1) * N / num_subs, where N is the number of 
+ * 					rows, in their original order. Rows missing a value in 
+ * 					the column are left out of every subsample. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * The subsamples are views which share the column buffers of the source 
+ * dataframe. 
+ * 
+ * source: dataframe_sorting.c 
+ */ 
+extern int dfcolumn_equal_number_partition(DATAFRAME df, int column, 
+	int num_subs, DATAFRAME *dests); 
+
+
+
+
+
+/* -------------------------------- JOINS --------------------------------- */ 
+
+/* 
+ * The rows of the left dataframe a join keeps, and how it finds the pairs 
+ */ 
+#define JOIN_INNER 0 
+#define JOIN_LEFT 1 
+#define JOIN_HASH 0 
+#define JOIN_MERGE 1 
+#define JOIN_AUTO 2 
+
+/* 
+ * Pairs the rows of two dataframes holding the same value in a key column 
+ * of each. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The left dataframe 
+ * lcolumn: 	The column number of the key in the left dataframe 
+ * right: 		The right dataframe 
+ * rcolumn: 	The column number of the key in the right dataframe 
+ * how: 		JOIN_INNER to keep only the pairs, JOIN_LEFT to also keep the 
+ * 				rows of the left dataframe matching nothing 
+ * strategy: 	JOIN_HASH, JOIN_MERGE, or JOIN_AUTO to merge if both 
+ * 				dataframes are sorted on their keys and hash if not 
+ * lrows: 		A pointer to put an int64 buffer of the row of the left 
+ * 				dataframe in each pair into 
+ * rrows: 		A pointer to put an int64 buffer of the row of the right 
+ * 				dataframe in each pair into; -1 for the rows of the left 
+ * 				dataframe matching nothing in a left join 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (e.g. JOIN_MERGE on a dataframe which isn't 
+ * sorted on its key) 
+ * 
+ * Notes 
+ * ===== 
+ * The pairs are in order of the row of the left dataframe, then of the row 
+ * of the right dataframe, whichever the strategy. Keys are compared as 
+ * integers if both key columns are of integer types and as doubles if not. 
+ * Missing values and NaNs match nothing. 
+ * 
+ * source: dataframe_join.c 
+ */ 
+extern int dfjoin_rows(DATAFRAME left, int lcolumn, DATAFRAME right, 
+	int rcolumn, int how, int strategy, COLUMN_BUFFER **lrows, 
+	COLUMN_BUFFER **rrows); 
+
+/* 
+ * Builds a dataframe out of the pairs of rows of a join, holding every 
+ * column of the left dataframe followed by those of the right. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The left dataframe 
+ * right: 		The right dataframe 
+ * lrows: 		The row of the left dataframe in each pair, as from 
+ * 				dfjoin_rows 
+ * rrows: 		The row of the right dataframe in each pair; values in rows 
+ * 				where this is negative are missing 
+ * rcolumn: 	A column of the right dataframe to leave out (i.e. its key, 
+ * 				which repeats the left one's); -1 to keep them all 
+ * dest: 		A pointer to an empty dataframe to put the result into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_join.c 
+ */ 
+extern int dataframe_join(DATAFRAME left, DATAFRAME right, 
+	COLUMN_BUFFER *lrows, COLUMN_BUFFER *rrows, int rcolumn, 
+	DATAFRAME *dest); 
+
+/* 
+ * Determine the key of a value in a column buffer, by which it's joined, 
+ * grouped, or sorted. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 		The buffer 
+ * j: 			The position of the value in the buffer 
+ * integer: 	1 to take the key as an integer, 0 as a double 
+ * key: 		A pointer to put the key into. Its order as an unsigned 
+ * 				integer is the order of the values. 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if the value may match others, 0 if it's missing or NaN 
+ * 
+ * source: dataframe_join.c 
+ */ 
+extern int column_key(COLUMN_BUFFER *buffer, long j, int integer, 
+	unsigned long long *key); 
+
+/* 
+ * Mixes the bits of a key so that every bit of the hash depends on every bit 
+ * of the key. 
+ * 
+ * source: dataframe_join.c 
+ */ 
+extern unsigned long long key_hash(unsigned long long key); 
+
+/* ------------------------------- GROUP-BY ------------------------------- */ 
+
+/* 
+ * How dfgroup finds the groups 
+ */ 
+#define GROUPBY_HASH 0 
+#define GROUPBY_SORT 1 
+#define GROUPBY_AUTO 2 
+
+/* 
+ * Splits the rows of a dataframe into groups sharing the values in a set of 
+ * key columns. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers of the keys 
+ * num_keys: 		The number of keys 
+ * strategy: 		GROUPBY_HASH, GROUPBY_SORT, or GROUPBY_AUTO to hash if a 
+ * 					sample of the rows holds few distinct keys and sort if not 
+ * groups: 			A pointer to put the group number of each row into, with 
+ * 					df.num_rows elements; -1 for rows missing a key 
+ * num_groups: 		A pointer to put the number of groups into 
+ * first: 			A pointer to put an array of the first row of each group 
+ * 					into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * The groups are numbered in ascending order of their keys, comparing the 
+ * first key column first, whichever the strategy. Rows missing a key or 
+ * holding a NaN in one are in no group. 
+ * 
+ * source: dataframe_groupby.c 
+ */ 
+extern int dfgroup(DATAFRAME df, int *columns, int num_keys, int strategy, 
+	long *groups, long *num_groups, long **first); 
+
+/* 
+ * Makes a dataframe a view of the key columns of another at the first row 
+ * of each of its groups, i.e. a table of the distinct keys. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The grouped dataframe 
+ * columns: 		The column numbers of the keys 
+ * num_keys: 		The number of keys 
+ * first: 			The first row of each group, as from dfgroup 
+ * num_groups: 		The number of groups 
+ * dest: 			A pointer to an empty dataframe to make the view 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_groupby.c 
+ */ 
+extern int dfgroup_keys(DATAFRAME df, int *columns, int num_keys, 
+	long *first, long num_groups, DATAFRAME *dest); 
+
+/* -------------------------------- INDEXES -------------------------------- */ 
+
+/* 
+ * Allocates memory for a sorted index of a column of a dataframe, builds it, 
+ * and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number to index 
+ * 
+ * Returns 
+ * ======= 
+ * The index; NULL if the column number is out of range 
+ * 
+ * Notes 
+ * ===== 
+ * The index describes the dataframe as it was when it was built. Once the 
+ * dataframe's rows are reordered or the column is modified, replaced, or 
+ * marked missing in place, the index is out of date (see 
+ * column_index_current) and the routines below fall back to scanning the 
+ * rows. 
+ * 
+ * source: dataframe_index.c 
+ */ 
+extern COLUMN_INDEX *column_index_initialize(DATAFRAME df, int column); 
+
+/* 
+ * Frees the memory stored by a column index. 
+ * 
+ * source: dataframe_index.c 
+ */ 
+extern void free_column_index(COLUMN_INDEX *idx); 
+
+/* 
+ * Determine whether or not an index of a column still describes the 
+ * dataframe it was built on, by the versions of the dataframe and of its 
+ * column buffer. An index of a column with writable arrays sharing its 
+ * values is never current, as they may have been written to since. 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if it does, 0 if it doesn't or the index is NULL 
+ * 
+ * source: dataframe_index.c 
+ */ 
+extern int column_index_current(DATAFRAME df, int column, COLUMN_INDEX *idx); 
+
+/* 
+ * Counts the values in a column of a dataframe below a given value. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * idx: 		An index of the column, to count in O(log n) time; NULL to 
+ * 				scan the column 
+ * value: 		The value to count below 
+ * counts: 		A pointer to put the number of values less than the value, 
+ * 				the number less than or equal to it, and the number of values 
+ * 				which aren't missing or NaN into, in that order 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_index.c 
+ */ 
+extern int dfcolumn_rank(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long *counts); 
+
+/* 
+ * Filters a dataframe as sieve and sieve_integer do, taking the rows from 
+ * an index of the column in O(log n + k) time for k rows where possible. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 				The dataframe to filter 
+ * dest: 				A pointer to the dataframe to make the view 
+ * column: 				The column number to filter based on 
+ * idx: 				An index of the column; NULL to scan the column 
+ * value: 				The value to compare to 
+ * integer: 			The same value as an integer, to compare integer 
+ * 						columns to exactly as sieve_integer does; NULL to 
+ * 						compare as sieve does 
+ * relational_code: 	As in sieve 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * The rows are in their original order, as from sieve. != is not a range 
+ * of the index, so it always scans, as does an index out of date. 
+ * 
+ * source: dataframe_index.c 
+ */ 
+extern int indexed_sieve(DATAFRAME source, DATAFRAME *dest, int column, 
+	COLUMN_INDEX *idx, double value, long long *integer, 
+	int relational_code); 
+
+/* 
+ * Takes the rows of a dataframe in a bin of a column as dfcolumn_bin does, 
+ * taking them from an index of the column where possible. 
+ * 
+ * Parameters 
  * ========== 
- * source: 			The source dataframe 
- * dest: 			The destination dataframe 
- * column: 			The column number that binning is based on 
- * bin: 			The left and right bin edges 
+ * source: 		The dataframe to take the rows of 
+ * dest: 		A pointer to the dataframe to make the view 
+ * column: 		The column number to bin based on 
+ * idx: 		An index of the column; NULL to scan the column 
+ * bin: 		The left and right bin edges, both inclusive 
  * 
  * Returns 
  * ======= 
- * 0 always, anything else would be a system error 
+ * 0 on success, 1 on failure 
  * 
- * header: dataframe.h 
+ * source: dataframe_index.c 
  */ 
-extern int dfcolumn_bin(DATAFRAME source, DATAFRAME *dest, int column, 
-	double *bin); 
+extern int indexed_bin(DATAFRAME source, DATAFRAME *dest, int column, 
+	COLUMN_INDEX *idx, double *bin); 
+
+/* --------------------------- QUANTILE SKETCHES --------------------------- */ 
 
 /* 
- * Determine the number of data points that fall within specified bin (i.e. 
- * a histogram) based on the values in a given column of the dataframe. 
+ * Allocates memory for an empty quantile sketch and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The accuracy parameter: the capacity of the top level. Rank 
+ * 				errors scale as ~1.7 / k. 
+ * seed: 		The seed for the random promotions during compaction 
+ * 
+ * Returns 
+ * ======= 
+ * The sketch; NULL if k < 2 or the memory can't be allocated 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern QUANTILE_SKETCH *sketch_initialize(int k, unsigned long seed); 
+
+/* 
+ * Frees the memory stored by a quantile sketch. 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern void free_sketch(QUANTILE_SKETCH *s); 
+
+/* 
+ * Adds a value to a quantile sketch. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The sketch itself 
+ * value: 		The value to add. NaNs are ignored. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated. The sketch remains valid 
+ * either way, with or without the value. 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern int sketch_update(QUANTILE_SKETCH *s, double value); 
+
+/* 
+ * Adds an array of values to a quantile sketch. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The sketch itself 
+ * arr: 		The values to add 
+ * length: 		The number of values in arr 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated, in which case the values 
+ * after the one which failed aren't added 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern int sketch_update_array(QUANTILE_SKETCH *s, double *arr, 
+	long length); 
+
+/* 
+ * Merges one quantile sketch into another. The source sketch is unchanged. 
+ * 
+ * Parameters 
+ * ========== 
+ * dest: 		The sketch to merge into 
+ * source: 		The sketch to merge from 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated. The destination remains 
+ * valid either way, and holds none of the source unless the failure came 
+ * while compacting the merged levels. 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern int sketch_merge(QUANTILE_SKETCH *dest, QUANTILE_SKETCH *source); 
+
+/* 
+ * Determine approximate quantiles of the stream a sketch has seen. The 
+ * quantile q is taken as the value at rank (long) (q * n), as in the exact 
+ * ptr_quantiles, and q = 0 and q = 1 give the exact minimum and maximum. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 				The sketch itself 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * values: 			A pointer to put the quantiles into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (an empty sketch, quantiles outside [0, 1], or 
+ * memory which can't be allocated) 
+ * 
+ * source: dataframe_sketch.c 
+ */ 
+extern int sketch_quantiles(QUANTILE_SKETCH *s, double *fractions, 
+	int num_fractions, double *values); 
+
+/* 
+ * Builds a quantile sketch of a given column of the data. Each thread 
+ * sketches its own share of the rows, and the per-thread sketches are 
+ * merged at the end. 
  * 
  * Parameters 
  * ========== 
  * df: 			The dataframe itself 
- * column: 		The column number to get counts based on 
- * binspace: 	The binspace to sort based on 
- * num_bins: 	The number of bins in the binspace. This should be one less 
- * 				than the number of values in the binspace array. 
+ * column: 		The column number to sketch 
+ * s: 			The sketch to add the column's values to 
  * 
  * Returns 
- * =======
- * 0 always. If it returns anything else, there was an internal error. 
+ * ======= 
+ * 0 on success, 1 on failure 
  * 
- * source: dataframe_sorting.c 
+ * source: dataframe_sketch.c 
  */ 
-extern int hist(DATAFRAME df, int column, double *binspace, long num_bins, 
-	long *counts);  
+extern int dfcolumn_sketch(DATAFRAME df, int column, QUANTILE_SKETCH *s); 
 
 /* 
- * Generates an equal number subsample off of a dataframe that has already been 
- * sorted into ascending order based on the data in a given column. 
+ * Streams the data in several columns of a file into quantile sketches 
+ * without holding the file in memory. This reads hlists and any other 
+ * whitespace-separated ASCII table, skipping lines which start with the 
+ * commenting character. 
  * 
  * Parameters 
  * ========== 
- * ordered: 		The ordered dataframe 
- * dest: 			The destination dataframe 
- * num_subs: 		The number of subsamples being generated 
- * index: 			The index of the subsample that is being generated 
+ * sketches: 	The sketches to add each column's values to 
+ * file: 		The name of the file 
+ * comment: 	The commenting character 
+ * columns: 	The column numbers in the file to sketch 
+ * num_cols: 	The number of columns (and sketches) 
  * 
  * Returns 
  * ======= 
- * 0 always; anything else is a SystemError 
+ * 0 on success, 1 on failure to read the file 
  * 
- * header: dataframe.h 
+ * source: dataframe_sketch.c 
  */ 
-extern int dfcolumn_equal_number_subsample(DATAFRAME ordered, DATAFRAME *dest, 
-	int num_subs, int index); 
+extern int sketch_from_file(QUANTILE_SKETCH **sketches, char *file, 
+	char comment, int *columns, int num_cols); 
+
+/* ----------------------------- EXTERNAL SORT ----------------------------- */ 
+
+/* 
+ * A consumer of the sorted rows of an external sort, called with one block 
+ * of rows at a time. 
+ * 
+ * Parameters 
+ * ========== 
+ * rows: 		The block of rows, row-major 
+ * n: 			The number of rows in the block 
+ * num_cols: 	The number of columns 
+ * state: 		The state passed to the external sort 
+ * 
+ * Returns 
+ * ======= 
+ * 0 to continue the sort, nonzero to stop it 
+ */ 
+typedef int (*ROW_SINK)(double *rows, long n, int num_cols, void *state); 
+
+/* 
+ * Sorts the rows of one or more whitespace-separated ASCII tables by one of 
+ * their columns without holding them in memory, streaming the sorted rows 
+ * to a sink. 
+ * 
+ * Parameters 
+ * ========== 
+ * files: 		The names of the files 
+ * num_files: 	The number of files 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the files to carry through the sort 
+ * num_cols: 	The number of columns 
+ * integers: 	1 for each column to carry as an exact 64-bit integer, 0 for 
+ * 				a double; NULL if they're all doubles 
+ * key: 		The position within columns of the column to sort by 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * budget: 		The number of bytes the rows in memory may take up 
+ * tmpdir: 		The directory to write the sorted runs to (NULL for $TMPDIR 
+ * 				or /tmp) 
+ * sink: 		Called with each block of sorted rows, row-major. The values 
+ * 				of integer columns hold the bits of a long long. A nonzero 
+ * 				return value stops the sort. 
+ * state: 		Passed through to the sink 
+ * num_rows: 	Pointer to the total number of rows sorted 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to read a file or to write a run, or if the 
+ * sink stops the sort 
+ * 
+ * source: dataframe_external.c 
+ */ 
+extern int external_sort_rows(char **files, int num_files, char comment, 
+	int *columns, int num_cols, int *integers, int key, int descending, 
+	unsigned long budget, char *tmpdir, ROW_SINK sink, void *state, 
+	long *num_rows); 
+
+/* 
+ * Sorts the rows of one or more whitespace-separated ASCII tables by one of 
+ * their columns without holding them in memory, writing the sorted rows to 
+ * a file. 
+ * 
+ * Parameters 
+ * ========== 
+ * files: 		The names of the files 
+ * num_files: 	The number of files 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the files to carry through the sort 
+ * num_cols: 	The number of columns 
+ * integers: 	1 for each column to carry as an exact 64-bit integer, 0 for 
+ * 				a double; NULL if they're all doubles 
+ * key: 		The position within columns of the column to sort by 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * budget: 		The number of bytes the rows in memory may take up 
+ * tmpdir: 		The directory to write the sorted runs to (NULL for $TMPDIR 
+ * 				or /tmp) 
+ * output: 		The name of the file to write the sorted rows to 
+ * binary: 		1 to write the rows as raw row-major 8-byte values (long 
+ * 				longs in the integer columns, doubles elsewhere), 0 for 
+ * 				ASCII, where doubles are written with 17 significant digits 
+ * 				so that they read back exactly 
+ * num_rows: 	Pointer to the total number of rows sorted 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_external.c 
+ */ 
+extern int external_sort_to_file(char **files, int num_files, 
+	char comment, int *columns, int num_cols, int *integers, int key, 
+	int descending, unsigned long budget, char *tmpdir, char *output, 
+	int binary, long *num_rows); 
+
+/* ------------------------------- SAMPLING ------------------------------- */ 
 
+/* 
+ * Finds the rows of a dataframe with the largest or smallest values in a 
+ * column. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to rank by 
+ * k: 			The number of rows to find 
+ * largest: 	1 for the largest values, 0 for the smallest 
+ * rows: 		A pointer to put the row numbers into, best first; room for k 
+ * num_rows: 	A pointer to put the number of rows found into, which is less 
+ * 				than k if fewer rows hold a value 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number or k 
+ * 
+ * Notes 
+ * ===== 
+ * Rows missing the value or holding a NaN are never chosen. Ties go to the 
+ * earlier row. Integer columns are compared exactly. 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern int dfcolumn_top(DATAFRAME df, int column, long k, int largest, 
+	long *rows, long *num_rows); 
+
+/* 
+ * Draws a random sample of the rows of a dataframe without replacement. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * k: 			The number of rows to draw 
+ * weights: 	The column number of the weights of the rows; -1 to draw 
+ * 				every row with equal probability 
+ * seed: 		The seed of the random numbers 
+ * rows: 		A pointer to put the row numbers into, in ascending order; 
+ * 				room for k 
+ * num_rows: 	A pointer to put the number of rows drawn into, which is less 
+ * 				than k if the dataframe has fewer (positively weighted) rows 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number or k 
+ * 
+ * Notes 
+ * ===== 
+ * Rows with a missing, NaN, zero or negative weight are never drawn. The 
+ * random numbers are a function of the seed and the row number alone, so 
+ * the sample doesn't depend on the number of threads. 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern int dataframe_sample(DATAFRAME df, long k, int weights, 
+	unsigned long seed, long *rows, long *num_rows); 
+
+/* 
+ * Allocates memory for a reservoir keeping the rows with the largest or 
+ * smallest values in a column across the chunks of a stream. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The number of rows to keep 
+ * num_cols: 	The number of columns of the chunks 
+ * types: 		The type of each column, as the COLUMN_* codes 
+ * column: 		The column number to rank by 
+ * largest: 	1 for the largest values, 0 for the smallest 
+ * 
+ * Returns 
+ * ======= 
+ * The reservoir; NULL on an invalid column number or k 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern RESERVOIR *top_reservoir_initialize(long k, int num_cols, int *types, 
+	int column, int largest); 
+
+/* 
+ * Allocates memory for a reservoir drawing a random sample of the rows 
+ * across the chunks of a stream. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The number of rows to draw 
+ * num_cols: 	The number of columns of the chunks 
+ * types: 		The type of each column, as the COLUMN_* codes 
+ * weights: 	The column number of the weights of the rows; -1 to draw 
+ * 				every row with equal probability 
+ * seed: 		The seed of the random numbers 
+ * 
+ * Returns 
+ * ======= 
+ * The reservoir; NULL on an invalid column number or k 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern RESERVOIR *sample_reservoir_initialize(long k, int num_cols, 
+	int *types, int weights, unsigned long seed); 
+
+/* 
+ * Frees the memory stored in a reservoir. 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern void free_reservoir(RESERVOIR *r); 
+
+/* 
+ * Offers the rows of a dataframe, e.g. a chunk of a stream, to a reservoir, 
+ * which copies those it keeps. 
+ * 
+ * Parameters 
+ * ========== 
+ * r: 			The reservoir 
+ * df: 			The dataframe, with the columns the reservoir was made for 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if the columns don't match 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern int reservoir_update(RESERVOIR *r, DATAFRAME df); 
+
+/* 
+ * Takes the rows a reservoir has kept as a dataframe of their own. 
+ * 
+ * Parameters 
+ * ========== 
+ * r: 			The reservoir 
+ * dest: 		The dataframe to put the rows into. A top-k reservoir's rows 
+ * 				come best first, and a sample's in the order they were 
+ * 				offered in. 
+ * 
+ * source: dataframe_sampling.c 
+ */ 
+extern void reservoir_rows(RESERVOIR *r, DATAFRAME *dest); 
+
+/* ------------------------------ RESAMPLING ------------------------------ */ 
+
+/* 
+ * Estimates the uncertainty on statistics of the values in a column by the 
+ * (Poisson) bootstrap, weighting the values rather than copying them. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column number to take the statistics of 
+ * stats: 			The statistics to take, as the BINNED_* codes 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics 
+ * num_resamples: 	The number of bootstrap resamples (at least 2) 
+ * seed: 			The seed of the random weights 
+ * replicates: 		A pointer to put the statistics of each resample into, 
+ * 					num_stats per resample 
+ * estimates: 		A pointer to put the statistics of the values into 
+ * errors: 			A pointer to put the standard deviation of each statistic 
+ * 					across the resamples into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_resampling.c 
+ */ 
+extern int dfcolumn_bootstrap(DATAFRAME df, int column, int *stats, 
+	double *fractions, int num_stats, long num_resamples, unsigned long seed, 
+	double *replicates, double *estimates, double *errors); 
+
+/* 
+ * Estimates the uncertainty on statistics of the values in a column by the 
+ * delete-one-group jackknife. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column number to take the statistics of 
+ * groups: 			The group number of each row; -1 for rows in no group 
+ * num_groups: 		The number of groups 
+ * stats: 			The statistics to take, as the BINNED_* codes 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics 
+ * replicates: 		A pointer to put the statistics without each group into, 
+ * 					num_stats per group; NaN for empty groups 
+ * estimates: 		A pointer to put the statistics of the values into 
+ * errors: 			A pointer to put the jackknife standard error of each 
+ * 					statistic into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure, including fewer than two groups with values 
+ * 
+ * source: dataframe_resampling.c 
+ */ 
+extern int dfcolumn_jackknife(DATAFRAME df, int column, long *groups, 
+	long num_groups, int *stats, double *fractions, int num_stats, 
+	double *replicates, double *estimates, double *errors); 
+
+/* 
+ * Assigns the rows of a dataframe to a regular grid of sub-boxes of a box 
+ * in the space of several columns, for a spatial jackknife. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * columns: 	The column numbers of the coordinates 
+ * num_dims: 	The number of coordinates 
+ * divisions: 	The number of sub-boxes along each coordinate 
+ * lower: 		The lower edge of the box along each coordinate 
+ * upper: 		The upper edge of the box along each coordinate 
+ * groups: 		A pointer to put the sub-box of each row into, with the 
+ * 				first coordinate varying fastest; -1 for rows outside the 
+ * 				box or missing a coordinate 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, division or box 
+ * 
+ * source: dataframe_resampling.c 
+ */ 
+extern int dataframe_subboxes(DATAFRAME df, int *columns, int num_dims, 
+	long *divisions, double *lower, double *upper, long *groups); 
+
+/* 
+ * Draws the Poisson(1) weights of a run of values in a bootstrap resample, 
+ * as used by dfcolumn_bootstrap. Each weight depends only on the seed, the 
+ * resample and the value's place among all of them. 
+ * 
+ * Parameters 
+ * ========== 
+ * seed: 		The seed of the random weights 
+ * replicate: 	The number of the resample 
+ * start: 		The place of the first value among all of them 
+ * n: 			The number of values 
+ * w: 			A pointer to put the n weights into 
+ * 
+ * source: dataframe_resampling.c 
+ */ 
+extern void poisson_weights(unsigned long seed, long replicate, long start, 
+	long n, unsigned int *w); 
+
+/* ----------------------------- CORRELATIONS ----------------------------- */ 
 
+/* The statistics dataframe_correlations can take */ 
+#define CORRELATION_PEARSON 0 
+#define CORRELATION_SPEARMAN 1 
+#define CORRELATION_KENDALL 2 
+
+/* 
+ * Determine the correlation matrices (Pearson's r, Spearman's rho and/or 
+ * Kendall's tau-b) of a set of columns, optionally with bootstrap errors. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers 
+ * num_cols: 		The number of columns 
+ * methods: 		The statistics to take, as the CORRELATION_* codes 
+ * num_methods: 	The number of statistics 
+ * num_resamples: 	The number of bootstrap resamples for the errors; 0 for 
+ * 					no errors 
+ * seed: 			The seed of the bootstrap's random weights 
+ * results: 		A pointer to put the matrices into, num_cols * num_cols 
+ * 					per method, in row-major order 
+ * errors: 			A pointer to put the standard deviation of each element 
+ * 					across the resamples into; may be NULL without resamples 
+ * num_rows: 		A pointer to put the number of rows used into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, method or number of 
+ * resamples 
+ * 
+ * Notes 
+ * ===== 
+ * Only rows holding a value (not NaN) in every column are used. Each 
+ * column is sorted once for all of the rank statistics. 
+ * 
+ * source: dataframe_correlation.c 
+ */ 
+extern int dataframe_correlations(DATAFRAME df, int *columns, int num_cols, 
+	int *methods, int num_methods, long num_resamples, unsigned long seed, 
+	double *results, double *errors, long *num_rows); 
 
+/* ------------------------ CONDITIONAL PERCENTILES ------------------------ */ 
 
+/* 
+ * Determine the percentile of each row's value in one column among those of 
+ * its neighbours in another column: the rows in the same bin, or a window 
+ * of the rows nearest to it in rank. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * xcolumn: 	The column number to find neighbours in 
+ * ycolumn: 	The column number to take the percentiles of 
+ * binspace: 	The bin edges in xcolumn, in ascending order; NULL to take 
+ * 				the neighbours as a window of rows instead 
+ * num_bins: 	The number of bins, one less than the number of edges 
+ * window: 		Without a binspace, the number of rows nearest in rank in 
+ * 				xcolumn to take as each row's neighbours, including itself 
+ * results: 	A pointer to put the percentile of each row into, between 0 
+ * 				and 100; NaN for rows missing either value, holding a NaN, 
+ * 				or outside the binspace 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, binspace or window 
+ * 
+ * Notes 
+ * ===== 
+ * The percentile of a value among m neighbours is 100 (l + e / 2) / m, 
+ * where l of them are below it and e equal to it, itself included. The 
+ * window slides along the rows in order of xcolumn, updating a Fenwick tree 
+ * of the values in it, in O(n log n) altogether. 
+ * 
+ * source: dataframe_conditional.c 
+ */ 
+extern int dfcolumn_conditional_percentile(DATAFRAME df, int xcolumn, 
+	int ycolumn, double *binspace, long num_bins, long window, 
+	double *results); 
 
 #endif /* DATAFRAME_H */ 
 
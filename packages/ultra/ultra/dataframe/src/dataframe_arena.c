@@ -0,0 +1,206 @@
+/* 
+ * This file scripts the arenas that dataframes are built in. An arena is one 
+ * large allocation, aligned to and padded out to whole huge pages when it's 
+ * big enough, from which column buffers are carved by bumping an offset. 
+ * Building a dataframe then takes a single allocation no matter how many 
+ * columns it has, and tearing it down a single free once the last of its 
+ * column buffers is released. Carving is a single atomic operation, so threads 
+ * filling a dataframe in parallel can each carve their own buffers without 
+ * locking. 
+ */ 
+
+#define _GNU_SOURCE 
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <sys/mman.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The size of a huge page, to which large arenas are aligned and padded */ 
+#ifndef ARENA_HUGE_PAGE 
+#define ARENA_HUGE_PAGE 2097152ul 
+#endif /* ARENA_HUGE_PAGE */ 
+
+/* The alignment of everything carved from an arena: one cache line */ 
+#ifndef ARENA_ALIGNMENT 
+#define ARENA_ALIGNMENT 64ul 
+#endif /* ARENA_ALIGNMENT */ 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static unsigned long round_up(unsigned long size, unsigned long alignment); 
+
+/* 
+ * Allocates an arena with room for at least a given number of bytes and 
+ * returns the pointer. Large arenas are aligned to and padded out to whole 
+ * huge pages, which the kernel is advised to back them with. 
+ * 
+ * Parameters 
+ * ========== 
+ * capacity: 	The number of bytes to make available for carving 
+ * 
+ * Returns 
+ * ======= 
+ * The arena, holding one reference for its creator; NULL if the memory 
+ * could not be allocated 
+ * 
+ * header: dataframe.h 
+ */ 
+extern ARENA *arena_initialize(unsigned long capacity) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * header: 		The bytes at the start of the block holding the struct 
+	 * total: 		The size of the whole block 
+	 * alignment: 	The alignment of the whole block 
+	 */ 
+	void *block; 
+	unsigned long header = round_up(sizeof(ARENA), ARENA_ALIGNMENT); 
+	unsigned long total = header + round_up(capacity, ARENA_ALIGNMENT); 
+	unsigned long alignment = ARENA_ALIGNMENT; 
+	if (total >= ARENA_HUGE_PAGE) {
+		total = round_up(total, ARENA_HUGE_PAGE); 
+		alignment = ARENA_HUGE_PAGE; 
+	} else {} 
+	if (posix_memalign(&block, alignment, total)) return NULL; 
+	#ifdef MADV_HUGEPAGE 
+	if (alignment == ARENA_HUGE_PAGE) madvise(block, total, MADV_HUGEPAGE); 
+	#endif /* MADV_HUGEPAGE */ 
+
+	ARENA *a = (ARENA *) block; 
+	a -> memory = (char *) block + header; 
+	a -> capacity = total - header; 
+	a -> used = 0ul; 
+	a -> refcount = 1; 
+	return a; 
+
+} 
+
+/* 
+ * Carves memory out of an arena. This is safe to call from several threads 
+ * at once: each carve is a single atomic bump of the offset. 
+ * 
+ * Parameters 
+ * ========== 
+ * a: 			The arena itself 
+ * size: 		The number of bytes to carve 
+ * 
+ * Returns 
+ * ======= 
+ * The memory, aligned to a cache line; NULL if the arena is full 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void *arena_allocate(ARENA *a, unsigned long size) {
+
+	unsigned long start; 
+	size = round_up(size, ARENA_ALIGNMENT); 
+	#pragma omp atomic capture 
+	{
+		start = a -> used; 
+		a -> used += size; 
+	} 
+	if (start + size > (*a).capacity) {
+		/* Full; the overshoot only means later carves fail as well */ 
+		return NULL; 
+	} else {
+		return (*a).memory + start; 
+	} 
+
+} 
+
+/* 
+ * Adds a reference to an arena. This is safe to call from several threads 
+ * at once. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void arena_retain(ARENA *a) {
+
+	#pragma omp atomic 
+	a -> refcount++; 
+
+} 
+
+/* 
+ * Removes a reference from an arena, freeing all of its memory at once if 
+ * that was the last one. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void arena_release(ARENA *a) {
+
+	int remaining; 
+	if (a == NULL) return; 
+	#pragma omp atomic capture 
+	remaining = --(a -> refcount); 
+	if (remaining <= 0) free(a); 
+
+} 
+
+/* 
+ * The number of bytes of an arena a column buffer of a given length and type 
+ * takes. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern unsigned long column_buffer_footprint(long length, int type) {
+
+	return round_up(sizeof(COLUMN_BUFFER), ARENA_ALIGNMENT) + 
+		round_up((length > 0l ? length : 1l) * column_type_size(type), 
+		ARENA_ALIGNMENT); 
+
+} 
+
+/* 
+ * Carves a column buffer holding one reference out of an arena. The buffer 
+ * holds a reference to the arena. 
+ * 
+ * Parameters 
+ * ========== 
+ * a: 			The arena to carve from 
+ * length: 		The number of values in the buffer 
+ * type: 		The type of the values, as the COLUMN_* codes in dataframe.h 
+ * 
+ * Returns 
+ * ======= 
+ * The buffer. If the arena is NULL or full, the buffer is allocated on its 
+ * own as in column_buffer_initialize. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_BUFFER *column_buffer_from_arena(ARENA *a, long length, 
+	int type) {
+
+	char *memory = a != NULL ? (char *) arena_allocate(a, 
+		column_buffer_footprint(length, type)) : NULL; 
+	if (memory == NULL) return column_buffer_initialize(length, type); 
+	COLUMN_BUFFER *buffer = (COLUMN_BUFFER *) memory; 
+	buffer -> values = (void *) (memory + round_up(sizeof(COLUMN_BUFFER), 
+		ARENA_ALIGNMENT)); 
+	buffer -> length = length; 
+	buffer -> type = type; 
+	buffer -> refcount = 1; 
+	buffer -> arena = a; 
+	buffer -> destructor = NULL; 
+	buffer -> context = NULL; 
+	buffer -> validity = NULL; 
+	buffer -> encoding = NULL; 
+	buffer -> version = version_stamp(); 
+	buffer -> writers = 0; 
+	arena_retain(a); 
+	return buffer; 
+
+} 
+
+/* 
+ * Rounds a size up to the nearest multiple of an alignment, which must be a 
+ * power of two. 
+ */ 
+static unsigned long round_up(unsigned long size, unsigned long alignment) {
+
+	return (size + alignment - 1ul) & ~(alignment - 1ul); 
+
+} 
+
@@ -0,0 +1,180 @@
+/* 
+ * This file scripts the bin lookup shared by the histogramming and binning 
+ * routines. Uniform linear and logarithmic binspaces are detected once up 
+ * front, after which the bin number of a value is computed arithmetically in 
+ * O(1); arbitrary bin edges fall back on a branch-free binary search in 
+ * O(log n). Either way the result is corrected against the actual bin edges, 
+ * so round-off can never put a value in a different bin than a linear scan 
+ * over the edges would. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The relative tolerance to which bin widths must agree to be uniform */ 
+#ifndef BINSPACE_UNIFORM_TOLERANCE 
+#define BINSPACE_UNIFORM_TOLERANCE 1e-9 
+#endif /* BINSPACE_UNIFORM_TOLERANCE */ 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static int is_uniform(double *edges, long num_bins, int logarithmic); 
+static long binary_search(BINSPACE *b, double value); 
+
+/* 
+ * Allocates memory for a binspace, determines whether or not its bins are 
+ * uniform in linear or logarithmic space, and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * edges: 		The bin edges, in ascending order. These are not copied, and 
+ * 				must outlive the binspace. 
+ * num_bins: 	The number of bins. This should be one less than the number of 
+ * 				values in the edges array. 
+ * 
+ * Returns 
+ * ======= 
+ * The binspace; NULL if num_bins < 1 
+ * 
+ * header: utils.h 
+ */ 
+extern BINSPACE *binspace_initialize(double *edges, long num_bins) {
+
+	if (num_bins < 1l) return NULL; 
+	BINSPACE *b = (BINSPACE *) malloc (sizeof(BINSPACE)); 
+	b -> edges = edges; 
+	b -> num_bins = num_bins; 
+	b -> lower = edges[0]; 
+	b -> upper = edges[num_bins]; 
+	if (is_uniform(edges, num_bins, 0)) {
+		b -> mode = BINSPACE_LINEAR; 
+		b -> origin = edges[0]; 
+		b -> scale = num_bins / (edges[num_bins] - edges[0]); 
+	} else if (is_uniform(edges, num_bins, 1)) {
+		b -> mode = BINSPACE_LOGARITHMIC; 
+		b -> origin = log(edges[0]); 
+		b -> scale = num_bins / (log(edges[num_bins]) - log(edges[0])); 
+	} else {
+		b -> mode = BINSPACE_ARBITRARY; 
+		b -> origin = 0; 
+		b -> scale = 0; 
+	} 
+	return b; 
+
+} 
+
+/* 
+ * Frees the memory stored by a binspace. The bin edges themselves are not 
+ * freed. 
+ * 
+ * header: utils.h 
+ */ 
+extern void binspace_free(BINSPACE *b) {
+
+	free(b); 
+
+} 
+
+/* 
+ * Determines the bin number of a given value within a binspace. The bins are 
+ * closed on both sides; a value on the edge between two bins falls in the 
+ * lower of the two. 
+ * 
+ * Parameters 
+ * ========== 
+ * b: 			The binspace 
+ * value: 		The value to get the bin number for 
+ * 
+ * Returns 
+ * ======= 
+ * Type long :: The bin number; -1l if the value is not within the binspace 
+ * 
+ * header: utils.h 
+ */ 
+extern long binspace_lookup(BINSPACE *b, double value) {
+
+	/* This also rejects NaNs, for which both comparisons are false */ 
+	if (!(value >= (*b).lower && value <= (*b).upper)) return -1l; 
+
+	long i; 
+	switch ((*b).mode) {
+
+		case BINSPACE_LINEAR: 
+			i = (long) ((value - (*b).origin) * (*b).scale); 
+			break; 
+
+		case BINSPACE_LOGARITHMIC: 
+			i = (long) ((log(value) - (*b).origin) * (*b).scale); 
+			break; 
+
+		default: 
+			return binary_search(b, value); 
+
+	} 
+
+	/* Correct the arithmetic guess against the bin edges themselves */ 
+	if (i < 0l) i = 0l; 
+	if (i >= (*b).num_bins) i = (*b).num_bins - 1l; 
+	while (i > 0l && value <= (*b).edges[i]) i--; 
+	while (i < (*b).num_bins - 1l && value > (*b).edges[i + 1l]) i++; 
+	return i; 
+
+} 
+
+/* 
+ * Determines whether or not the bins are of uniform width, either in linear 
+ * or logarithmic space. 
+ * 
+ * Parameters 
+ * ========== 
+ * edges: 			The bin edges 
+ * num_bins: 		The number of bins 
+ * logarithmic: 	1 to test the widths in logarithmic space, 0 for linear 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if the bins are uniform, 0 if not 
+ */ 
+static int is_uniform(double *edges, long num_bins, int logarithmic) {
+
+	long i; 
+	if (logarithmic && edges[0] <= 0) return 0; 
+	double first = logarithmic ? log(edges[0]) : edges[0]; 
+	double last = logarithmic ? log(edges[num_bins]) : edges[num_bins]; 
+	double width = (last - first) / num_bins; 
+	if (!(width > 0) || isinf(width)) return 0; 
+	for (i = 1l; i < num_bins; i++) {
+		double x = logarithmic ? log(edges[i]) : edges[i]; 
+		if (fabs(x - (first + i * width)) > BINSPACE_UNIFORM_TOLERANCE * 
+			width) {
+			return 0; 
+		} else {
+			continue; 
+		} 
+	} 
+	return 1; 
+
+} 
+
+/* 
+ * Finds the bin number of a value known to lie within the binspace by a 
+ * branch-free binary search for the first upper bin edge not below the 
+ * value. The loop runs exactly ceil(log2(num_bins)) times regardless of the 
+ * value, with a conditional move in place of a branch. 
+ */ 
+static long binary_search(BINSPACE *b, double value) {
+
+	double *upper = (*b).edges + 1; 
+	long low = 0l, length = (*b).num_bins; 
+	while (length > 1l) {
+		long half = length / 2l; 
+		low = (upper[low + half - 1l] < value) ? low + half : low; 
+		length -= half; 
+	} 
+	return low + (upper[low] < value); 
+
+} 
+
@@ -0,0 +1,298 @@
+/* 
+ * This file scripts the conditional percentile transform: the percentile of 
+ * each row's value in one column among its neighbours in another, e.g. the 
+ * spin of a halo relative to others of the same mass. The neighbours are 
+ * either the rows in the same bin, each bin's values sorted once, or the 
+ * rows nearest in rank, in which case a window slides along the rows in 
+ * order and a Fenwick tree over the ranks of the values in it is updated 
+ * as rows enter and leave, giving each percentile in O(log n). The bins, 
+ * or the chunks of rows the window slides over, are handled in parallel. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* A value and its row, for sorting the values in a bin */ 
+typedef struct bin_entry {
+
+	double value; 
+	long row; 
+
+} BIN_ENTRY; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static long usable_rows(DATAFRAME df, int xcolumn, int ycolumn, long *place); 
+static void binned_percentiles(DATAFRAME df, int xcolumn, int ycolumn, 
+	BINSPACE *b, long *place, double *results); 
+static void window_percentiles(DATAFRAME df, int xcolumn, int ycolumn, 
+	long window, long *place, long n, double *results); 
+static long *sorted_places(DATAFRAME df, int column, long *place, long n); 
+static void fenwick_add(int *tree, long size, long i, int delta); 
+static long fenwick_prefix(int *tree, long i); 
+static int compare_bin_entries(const void *a, const void *b); 
+
+/* 
+ * Determine the percentile of each row's value in one column among those of 
+ * its neighbours in another column, either the rows in the same bin or the 
+ * rows nearest to it in rank. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * xcolumn: 	The column number to find neighbours in (e.g. mass) 
+ * ycolumn: 	The column number to take the percentiles of (e.g. spin) 
+ * binspace: 	The bin edges in xcolumn, in ascending order; NULL to take 
+ * 				the neighbours as a window of rows instead 
+ * num_bins: 	The number of bins, one less than the number of edges 
+ * window: 		Without a binspace, the number of rows nearest in rank in 
+ * 				xcolumn to take as each row's neighbours, including itself. 
+ * 				The window is centered on the row except within half of it 
+ * 				of either end, where it is the first or last rows. 
+ * results: 	A pointer to put the percentile of each row into, between 0 
+ * 				and 100; NaN for rows missing either value, holding a NaN, 
+ * 				or outside the binspace 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, binspace or window 
+ * 
+ * Notes 
+ * ===== 
+ * The percentile of a value among m neighbours is 100 (l + e / 2) / m, 
+ * where l of them are below it and e equal to it, itself included: the 
+ * mean of the fractions below it and at or below it. It is therefore 
+ * symmetric, with 50 in the middle, and ties share a percentile. Ties in 
+ * xcolumn are ordered by row for the window. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_conditional_percentile(DATAFRAME df, int xcolumn, 
+	int ycolumn, double *binspace, long num_bins, long window, 
+	double *results) {
+
+	long i; 
+	BINSPACE *b = NULL; 
+	if (xcolumn < 0 || xcolumn >= df.num_cols || ycolumn < 0 || 
+		ycolumn >= df.num_cols) return 1; 
+	if (binspace != NULL) {
+		b = binspace_initialize(binspace, num_bins); 
+		if (b == NULL) return 1; 
+	} else if (window < 1l) {
+		return 1; 
+	} else {} 
+
+	long *place = (long *) malloc ((df.num_rows ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	long n = usable_rows(df, xcolumn, ycolumn, place); 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < df.num_rows; i++) results[i] = NAN; 
+	if (b != NULL) {
+		binned_percentiles(df, xcolumn, ycolumn, b, place, results); 
+		binspace_free(b); 
+	} else if (n) {
+		window_percentiles(df, xcolumn, ycolumn, window, place, n, results); 
+	} else {} 
+	free(place); 
+	return 0; 
+
+} 
+
+/* 
+ * Finds the rows holding a value that isn't NaN in both columns, giving 
+ * each its place among them (-1 for the others) and returning how many. 
+ */ 
+static long usable_rows(DATAFRAME df, int xcolumn, int ycolumn, long *place) {
+
+	long i, n = 0l; 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (dfvalid(df, i, xcolumn) && dfvalid(df, i, ycolumn) && 
+			!isnan(dfvalue(df, i, xcolumn)) && 
+			!isnan(dfvalue(df, i, ycolumn))) {
+			place[i] = n++; 
+		} else {
+			place[i] = -1l; 
+		} 
+	} 
+	return n; 
+
+} 
+
+/* 
+ * Determine the percentiles within bins: the rows are partitioned by bin 
+ * with a counting sort, and each bin's values are sorted once, a run of 
+ * ties from l to l + e in sorted order all taking 100 (l + e / 2) / m. 
+ */ 
+static void binned_percentiles(DATAFRAME df, int xcolumn, int ycolumn, 
+	BINSPACE *b, long *place, double *results) {
+
+	long i, bin, num_bins = (*b).num_bins; 
+	long *bins = (long *) malloc ((df.num_rows ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	long *offsets = (long *) calloc (num_bins + 1l, sizeof(long)); 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < df.num_rows; i++) {
+		bins[i] = place[i] != -1l ? binspace_lookup(b, 
+			dfvalue(df, i, xcolumn)) : -1l; 
+	} 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (bins[i] != -1l) offsets[bins[i] + 1l]++; 
+	} 
+	for (bin = 0l; bin < num_bins; bin++) offsets[bin + 1l] += offsets[bin]; 
+	BIN_ENTRY *entries = (BIN_ENTRY *) malloc ((offsets[num_bins] ? 
+		offsets[num_bins] : 1l) * sizeof(BIN_ENTRY)); 
+	long *filled = (long *) malloc (num_bins * sizeof(long)); 
+	memcpy(filled, offsets, num_bins * sizeof(long)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (bins[i] != -1l) {
+			BIN_ENTRY entry = {dfvalue(df, i, ycolumn), i}; 
+			entries[filled[bins[i]]++] = entry; 
+		} else {} 
+	} 
+
+	#pragma omp parallel for schedule(dynamic) 
+	for (bin = 0l; bin < num_bins; bin++) {
+		BIN_ENTRY *values = entries + offsets[bin]; 
+		long j = 0l, k, m = offsets[bin + 1l] - offsets[bin]; 
+		qsort(values, m, sizeof(BIN_ENTRY), compare_bin_entries); 
+		while (j < m) {
+			for (k = j; k < m && values[k].value == values[j].value; k++); 
+			double percentile = 100.0 * (j + k) / (2.0 * m); 
+			for (; j < k; j++) results[values[j].row] = percentile; 
+		} 
+	} 
+	free(bins); 
+	free(offsets); 
+	free(filled); 
+	free(entries); 
+
+} 
+
+/* 
+ * Determine the percentiles within a window of the rows nearest in rank. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * xcolumn: 	The column to rank the rows on 
+ * ycolumn: 	The column to take the percentiles of 
+ * window: 		The number of rows in the window 
+ * place: 		The place of each row among those used, -1 for the others 
+ * n: 			The number of rows used 
+ * results: 	A pointer to put the percentiles into 
+ * 
+ * Notes 
+ * ===== 
+ * In ascending order of xcolumn, the window of the row at position i 
+ * starts at min(max(i - window / 2, 0), n - window), which moves up by at 
+ * most one from one row to the next. Each chunk of the rows keeps its own 
+ * Fenwick tree of the counts of each distinct value of ycolumn (by dense 
+ * rank) in its window, built once for its first row and then updated by 
+ * adding the row entering and removing the one leaving. 
+ */ 
+static void window_percentiles(DATAFRAME df, int xcolumn, int ycolumn, 
+	long window, long *place, long n, double *results) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * rows: 		The rows used, in ascending order of xcolumn 
+	 * ranks: 		The dense rank in ycolumn of each of them, in that order 
+	 * distinct: 	The number of distinct values in ycolumn 
+	 */ 
+	long i, b, num_blocks = 1l, distinct = 0l; 
+	long k = min(window, n); 
+	long *rows = sorted_places(df, xcolumn, place, n); 
+	long *yorder = sorted_places(df, ycolumn, place, n); 
+	long *ranks = (long *) malloc (n * sizeof(long)); 
+	long *yrank = (long *) malloc (n * sizeof(long)); 
+	for (i = 0l; i < n; i++) {
+		if (i && dfvalue(df, yorder[i], ycolumn) != 
+			dfvalue(df, yorder[i - 1l], ycolumn)) distinct++; 
+		yrank[place[yorder[i]]] = distinct; 
+	} 
+	distinct++; 
+	for (i = 0l; i < n; i++) ranks[i] = yrank[place[rows[i]]]; 
+	free(yorder); 
+	free(yrank); 
+
+	#ifdef _OPENMP 
+	num_blocks = min((long) omp_get_max_threads(), n); 
+	#endif /* _OPENMP */ 
+	#pragma omp parallel for schedule(static, 1) 
+	for (b = 0l; b < num_blocks; b++) {
+		long first = n * b / num_blocks, last = n * (b + 1l) / num_blocks; 
+		long j, start = min(max(first - k / 2l, 0l), n - k); 
+		int *tree = (int *) calloc (distinct + 1l, sizeof(int)); 
+		for (j = start; j < start + k; j++) {
+			fenwick_add(tree, distinct, ranks[j], 1); 
+		} 
+		for (j = first; j < last; j++) {
+			long next = min(max(j - k / 2l, 0l), n - k); 
+			if (next > start) {
+				fenwick_add(tree, distinct, ranks[start], -1); 
+				fenwick_add(tree, distinct, ranks[start + k], 1); 
+				start = next; 
+			} else {} 
+			long below = ranks[j] ? fenwick_prefix(tree, ranks[j] - 1l) : 0l; 
+			long equal = fenwick_prefix(tree, ranks[j]) - below; 
+			results[rows[j]] = 100.0 * (below + 0.5 * equal) / k; 
+		} 
+		free(tree); 
+	} 
+	free(rows); 
+	free(ranks); 
+
+} 
+
+/* 
+ * The rows used in ascending order of a column, ties in the order of the 
+ * rows, as dfcolumns_argsort gives them. 
+ */ 
+static long *sorted_places(DATAFRAME df, int column, long *place, long n) {
+
+	long i, k = 0l; 
+	int ascending = 0; 
+	long *sorted = (long *) malloc ((df.num_rows ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	long *rows = (long *) malloc ((n ? n : 1l) * sizeof(long)); 
+	dfcolumns_argsort(df, &column, &ascending, 1, sorted); 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (place[sorted[i]] != -1l) rows[k++] = sorted[i]; 
+	} 
+	free(sorted); 
+	return rows; 
+
+} 
+
+/* Adds delta to the count of dense rank i in a Fenwick tree of size ranks */ 
+static void fenwick_add(int *tree, long size, long i, int delta) {
+
+	for (i++; i <= size; i += i & -i) tree[i] += delta; 
+
+} 
+
+/* The total count of the dense ranks 0 through i in a Fenwick tree */ 
+static long fenwick_prefix(int *tree, long i) {
+
+	long total = 0l; 
+	for (i++; i > 0l; i -= i & -i) total += tree[i]; 
+	return total; 
+
+} 
+
+/* Orders the values in a bin in ascending order */ 
+static int compare_bin_entries(const void *a, const void *b) {
+
+	double x = (*((const BIN_ENTRY *) a)).value; 
+	double y = (*((const BIN_ENTRY *) b)).value; 
+	return (x > y) - (x < y); 
+
+} 
+
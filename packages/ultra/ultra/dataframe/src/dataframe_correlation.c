@@ -0,0 +1,635 @@
+/* 
+ * This file scripts the correlation matrices: Pearson's r, Spearman's rho 
+ * and Kendall's tau-b between every pair of a set of columns. The values of 
+ * the rows holding all of them are gathered once and each column is sorted 
+ * once; the ranks for Spearman's rho and the orders for Kendall's tau all 
+ * come from that one sort. Pearson's and Spearman's matrices are the 
+ * normalized cross products of the centered values or ranks, accumulated 
+ * over blocks of rows in parallel, and Kendall's tau is counted for the 
+ * pairs of columns in parallel with Knight's (1966) O(n log n) merge sort. 
+ * Bootstrap errors reweight the rows with the Poisson weights of 
+ * dfcolumn_bootstrap rather than copying them, which every one of these 
+ * statistics takes directly. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* 
+ * The number of rows in each tile of the cross products, small enough that 
+ * a tile of every column stays in cache while each pair is taken over it. 
+ */ 
+#ifndef CROSS_BLOCK 
+#define CROSS_BLOCK 1024l 
+#endif /* CROSS_BLOCK */ 
+
+/* 
+ * The values of the columns in the rows holding all of them, and what the 
+ * one sort of each column gives. 
+ * 
+ * Fields 
+ * ====== 
+ * n: 			The number of rows 
+ * p: 			The number of columns 
+ * values: 		The values of each column, one array of n per column 
+ * order: 		The rows of each column in ascending order of their values; 
+ * 				NULL if no statistic needs them 
+ * ties: 		The number of distinct values below the value of each row 
+ * 				(its dense rank), one array of n per column, indexed by row; 
+ * 				NULL if no statistic needs them 
+ */ 
+typedef struct correlation_data {
+
+	long n; 
+	int p; 
+	double **values; 
+	long **order; 
+	long **ties; 
+
+} CORRELATION_DATA; 
+
+/* 
+ * A row in Kendall's merge sort. 
+ * 
+ * Fields 
+ * ====== 
+ * y: 			The dense rank of the row in the second column 
+ * weight: 		The weight of the row 
+ */ 
+typedef struct kendall_entry {
+
+	long y; 
+	double weight; 
+
+} KENDALL_ENTRY; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static void correlation_gather(DATAFRAME df, int *columns, int num_cols, 
+	int ranked, CORRELATION_DATA *data); 
+static void free_correlation_data(CORRELATION_DATA *data); 
+static void correlation_pass(CORRELATION_DATA data, unsigned int *weights, 
+	int *methods, int num_methods, double **scratch, double *results); 
+static void centered_values(CORRELATION_DATA data, unsigned int *weights, 
+	int ranked, double **z); 
+static void cross_products(double **z, int p, long n, double *results); 
+static double kendall_tau(CORRELATION_DATA data, unsigned int *weights, 
+	int a, int b, KENDALL_ENTRY *entries, KENDALL_ENTRY *tmp); 
+static double merge_discordant(KENDALL_ENTRY *entries, KENDALL_ENTRY *tmp, 
+	long n); 
+static double tied_pairs(KENDALL_ENTRY *entries, long n); 
+static int compare_kendall_entries(const void *a, const void *b); 
+
+/* 
+ * Determine the correlation matrices of a set of columns. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers 
+ * num_cols: 		The number of columns 
+ * methods: 		The statistics to take, as the CORRELATION_* codes 
+ * num_methods: 	The number of statistics 
+ * num_resamples: 	The number of bootstrap resamples for the errors; 0 for 
+ * 					no errors 
+ * seed: 			The seed of the bootstrap's random weights 
+ * results: 		A pointer to put the matrices into, num_cols * num_cols 
+ * 					per method, in row-major order 
+ * errors: 			A pointer to put the standard deviation of each element 
+ * 					across the bootstrap resamples into, laid out as the 
+ * 					results; ignored (and may be NULL) without resamples 
+ * num_rows: 		A pointer to put the number of rows used into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, method or number of 
+ * resamples 
+ * 
+ * Notes 
+ * ===== 
+ * Only rows holding a value (not NaN) in every column are used, so the 
+ * matrices are of the same rows throughout. Ties take their average rank 
+ * for Spearman's rho, and Kendall's tau is tau-b, which corrects for them. 
+ * Correlations with a column holding one value throughout are NaN. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_correlations(DATAFRAME df, int *columns, int num_cols, 
+	int *methods, int num_methods, long num_resamples, unsigned long seed, 
+	double *results, double *errors, long *num_rows) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * size: 		The number of elements of all of the matrices 
+	 * ranked: 		Whether or not any statistic needs the sort 
+	 * scratch: 	The centered values or ranks of each column 
+	 * replicates: 	The matrices of each bootstrap resample 
+	 */ 
+	long b, i; 
+	int j, ranked = 0; 
+	if (num_cols < 1 || num_methods < 1 || num_resamples < 0l || 
+		num_resamples == 1l) return 1; 
+	for (j = 0; j < num_cols; j++) {
+		if (columns[j] < 0 || columns[j] >= df.num_cols) return 1; 
+	} 
+	for (j = 0; j < num_methods; j++) {
+		if (methods[j] < CORRELATION_PEARSON || 
+			methods[j] > CORRELATION_KENDALL) return 1; 
+		ranked |= methods[j] != CORRELATION_PEARSON; 
+	} 
+
+	CORRELATION_DATA data; 
+	correlation_gather(df, columns, num_cols, ranked, &data); 
+	*num_rows = data.n; 
+	long size = (long) num_methods * num_cols * num_cols; 
+	double **scratch = (double **) malloc (num_cols * sizeof(double *)); 
+	for (j = 0; j < num_cols; j++) {
+		scratch[j] = (double *) malloc ((data.n ? data.n : 1l) * 
+			sizeof(double)); 
+	} 
+	correlation_pass(data, NULL, methods, num_methods, scratch, results); 
+
+	if (num_resamples) {
+		double *replicates = (double *) malloc (num_resamples * size * 
+			sizeof(double)); 
+		unsigned int *weights = (unsigned int *) malloc ((data.n ? data.n : 
+			1l) * sizeof(unsigned int)); 
+		for (b = 0l; b < num_resamples; b++) {
+			poisson_weights(seed, b, 0l, data.n, weights); 
+			correlation_pass(data, weights, methods, num_methods, scratch, 
+				replicates + b * size); 
+		} 
+		for (i = 0l; i < size; i++) {
+			double mean = 0, var = 0; 
+			for (b = 0l; b < num_resamples; b++) {
+				mean += replicates[b * size + i]; 
+			} 
+			mean /= num_resamples; 
+			for (b = 0l; b < num_resamples; b++) {
+				double delta = replicates[b * size + i] - mean; 
+				var += delta * delta; 
+			} 
+			errors[i] = sqrt(var / (num_resamples - 1l)); 
+		} 
+		free(replicates); 
+		free(weights); 
+	} else {} 
+
+	for (j = 0; j < num_cols; j++) free(scratch[j]); 
+	free(scratch); 
+	free_correlation_data(&data); 
+	return 0; 
+
+} 
+
+/* 
+ * Gathers the values of the rows holding all of the columns and, if any 
+ * statistic needs them, sorts each column (with dfcolumns_argsort) to find 
+ * the order and dense ranks of its rows. 
+ */ 
+static void correlation_gather(DATAFRAME df, int *columns, int num_cols, 
+	int ranked, CORRELATION_DATA *data) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * rows: 		The rows holding every column 
+	 * place: 		The place of each row among them; -1 for the others 
+	 * sorted: 		The order of all of the rows in a column 
+	 */ 
+	long i, n = 0l, m = df.num_rows ? df.num_rows : 1l; 
+	int j; 
+	long *rows = (long *) malloc (m * sizeof(long)); 
+	long *place = (long *) malloc (m * sizeof(long)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		for (j = 0; j < num_cols; j++) {
+			if (!dfvalid(df, i, columns[j]) || 
+				isnan(dfvalue(df, i, columns[j]))) break; 
+		} 
+		if (j == num_cols) {
+			place[i] = n; 
+			rows[n++] = i; 
+		} else {
+			place[i] = -1l; 
+		} 
+	} 
+
+	data -> n = n; 
+	data -> p = num_cols; 
+	data -> values = (double **) malloc (num_cols * sizeof(double *)); 
+	data -> order = ranked ? (long **) malloc (num_cols * sizeof(long *)) : 
+		NULL; 
+	data -> ties = ranked ? (long **) malloc (num_cols * sizeof(long *)) : 
+		NULL; 
+	long *sorted = ranked ? (long *) malloc (m * sizeof(long)) : NULL; 
+	for (j = 0; j < num_cols; j++) {
+		double *values = (double *) malloc ((n ? n : 1l) * sizeof(double)); 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < n; i++) values[i] = dfvalue(df, rows[i], columns[j]); 
+		data -> values[j] = values; 
+		if (ranked) {
+			int ascending = 0; 
+			long k = 0l, rank = 0l; 
+			long *order = (long *) malloc ((n ? n : 1l) * sizeof(long)); 
+			long *ties = (long *) malloc ((n ? n : 1l) * sizeof(long)); 
+			dfcolumns_argsort(df, columns + j, &ascending, 1, sorted); 
+			for (i = 0l; i < df.num_rows; i++) {
+				if (place[sorted[i]] != -1l) order[k++] = place[sorted[i]]; 
+			} 
+			for (i = 0l; i < n; i++) {
+				if (i && values[order[i]] != values[order[i - 1l]]) rank++; 
+				ties[order[i]] = rank; 
+			} 
+			data -> order[j] = order; 
+			data -> ties[j] = ties; 
+		} else {} 
+	} 
+	free(rows); 
+	free(place); 
+	free(sorted); 
+
+} 
+
+/* Frees the memory stored in the gathered values of the columns */ 
+static void free_correlation_data(CORRELATION_DATA *data) {
+
+	int j; 
+	for (j = 0; j < (*data).p; j++) {
+		free(data -> values[j]); 
+		if ((*data).order != NULL) {
+			free(data -> order[j]); 
+			free(data -> ties[j]); 
+		} else {} 
+	} 
+	free(data -> values); 
+	free(data -> order); 
+	free(data -> ties); 
+
+} 
+
+/* 
+ * Determine the correlation matrices of the gathered columns with each row 
+ * counted as many times as its weight. 
+ * 
+ * Parameters 
+ * ========== 
+ * data: 		The gathered columns 
+ * weights: 	The weight of each row; NULL for a weight of 1 throughout 
+ * methods: 	The statistics to take, as the CORRELATION_* codes 
+ * num_methods: The number of statistics 
+ * scratch: 	Room for n values of each column 
+ * results: 	A pointer to put the matrices into 
+ */ 
+static void correlation_pass(CORRELATION_DATA data, unsigned int *weights, 
+	int *methods, int num_methods, double **scratch, double *results) {
+
+	int m, a, p = data.p; 
+	for (m = 0; m < num_methods; m++) {
+		double *matrix = results + (long) m * p * p; 
+		switch (methods[m]) {
+
+			case CORRELATION_PEARSON: case CORRELATION_SPEARMAN: 
+				centered_values(data, weights, 
+					methods[m] == CORRELATION_SPEARMAN, scratch); 
+				cross_products(scratch, p, data.n, matrix); 
+				for (a = 0; a < p; a++) {
+					int b; 
+					for (b = 0; b < p; b++) {
+						if (a == b) continue; 
+						matrix[a * p + b] /= sqrt(matrix[a * p + a] * 
+							matrix[b * p + b]); 
+					} 
+				} 
+				for (a = 0; a < p; a++) {
+					matrix[a * p + a] = matrix[a * p + a] > 0 ? 1 : NAN; 
+				} 
+				break; 
+
+			case CORRELATION_KENDALL: {
+				/* Each pair of columns in parallel, with its own scratch */ 
+				long pair, num_pairs = (long) p * (p - 1) / 2; 
+				long size = data.n ? data.n : 1l; 
+				#pragma omp parallel 
+				{
+					KENDALL_ENTRY *entries = (KENDALL_ENTRY *) malloc (size * 
+						sizeof(KENDALL_ENTRY)); 
+					KENDALL_ENTRY *tmp = (KENDALL_ENTRY *) malloc (size * 
+						sizeof(KENDALL_ENTRY)); 
+					#pragma omp for schedule(dynamic) 
+					for (pair = 0l; pair < num_pairs; pair++) {
+						/* The pair'th (a, b) with a < b, row by row */ 
+						int x = 0, y; 
+						long first = p - 1; 
+						long remaining = pair; 
+						while (remaining >= first) {
+							remaining -= first; 
+							first--; 
+							x++; 
+						} 
+						y = x + 1 + (int) remaining; 
+						double tau = kendall_tau(data, weights, x, y, entries, 
+							tmp); 
+						matrix[x * p + y] = tau; 
+						matrix[y * p + x] = tau; 
+					} 
+					free(entries); 
+					free(tmp); 
+				} 
+				for (a = 0; a < p; a++) {
+					double self = kendall_tau(data, weights, a, a, NULL, NULL); 
+					matrix[a * p + a] = self; 
+				} 
+				break; 
+			} 
+
+		} 
+	} 
+
+} 
+
+/* 
+ * Determine the values (or ranks) of each gathered column less their 
+ * weighted mean, times the square root of each row's weight, so that their 
+ * cross products are the weighted sums of the products of the deviations. 
+ * 
+ * Parameters 
+ * ========== 
+ * data: 		The gathered columns 
+ * weights: 	The weight of each row; NULL for a weight of 1 throughout 
+ * ranked: 		1 to take the ranks, the average of those of ties, 0 for the 
+ * 				values 
+ * z: 			A pointer to put the results into, n per column 
+ * 
+ * Notes 
+ * ===== 
+ * A row of weight w counts as w copies of it, so the ranks are those of 
+ * the resample: a run of tied values of total weight W starting after a 
+ * weight C of smaller ones all take the rank C + (W + 1) / 2. 
+ */ 
+static void centered_values(CORRELATION_DATA data, unsigned int *weights, 
+	int ranked, double **z) {
+
+	int j; 
+	#pragma omp parallel for schedule(dynamic) 
+	for (j = 0; j < data.p; j++) {
+		long i, n = data.n; 
+		double total = 0, sum = 0; 
+		if (ranked) {
+			long *order = data.order[j], *ties = data.ties[j]; 
+			double below = 0; 
+			i = 0l; 
+			while (i < n) {
+				/* A run of rows tied in this column */ 
+				long k = i; 
+				double run = 0; 
+				while (k < n && ties[order[k]] == ties[order[i]]) {
+					run += weights != NULL ? weights[order[k]] : 1; 
+					k++; 
+				} 
+				for (; i < k; i++) z[j][order[i]] = below + (run + 1) / 2; 
+				below += run; 
+			} 
+		} else {
+			for (i = 0l; i < n; i++) z[j][i] = data.values[j][i]; 
+		} 
+		for (i = 0l; i < n; i++) {
+			double w = weights != NULL ? weights[i] : 1; 
+			total += w; 
+			sum += w * z[j][i]; 
+		} 
+		double mean = total ? sum / total : 0; 
+		for (i = 0l; i < n; i++) {
+			double w = weights != NULL ? weights[i] : 1; 
+			z[j][i] = (z[j][i] - mean) * sqrt(w); 
+		} 
+	} 
+
+} 
+
+/* 
+ * Determine the cross products of every pair of columns, sum(z_a * z_b), 
+ * into a p x p matrix. 
+ * 
+ * Notes 
+ * ===== 
+ * Each thread takes a contiguous share of the rows and accumulates its 
+ * own matrix over tiles of CROSS_BLOCK rows, taking every pair over a tile 
+ * while it is in cache. The shares are summed in order, so the result is 
+ * the same each time for a given number of threads. 
+ */ 
+static void cross_products(double **z, int p, long n, double *results) {
+
+	long b, num_blocks = 1l; 
+	int a; 
+	#ifdef _OPENMP 
+	num_blocks = omp_get_max_threads(); 
+	#endif /* _OPENMP */ 
+	double *partial = (double *) calloc (num_blocks * p * p, 
+		sizeof(double)); 
+
+	#pragma omp parallel for schedule(static, 1) 
+	for (b = 0l; b < num_blocks; b++) {
+		long start = n * b / num_blocks, stop = n * (b + 1l) / num_blocks; 
+		long tile, i; 
+		int x, y; 
+		double *sums = partial + b * p * p; 
+		for (tile = start; tile < stop; tile += CROSS_BLOCK) {
+			long end = min(tile + CROSS_BLOCK, stop); 
+			for (x = 0; x < p; x++) {
+				for (y = 0; y <= x; y++) {
+					double sum = 0; 
+					for (i = tile; i < end; i++) sum += z[x][i] * z[y][i]; 
+					sums[x * p + y] += sum; 
+				} 
+			} 
+		} 
+	} 
+
+	for (a = 0; a < p * p; a++) results[a] = 0; 
+	for (b = 0l; b < num_blocks; b++) {
+		for (a = 0; a < p * p; a++) results[a] += partial[b * p * p + a]; 
+	} 
+	for (a = 0; a < p; a++) {
+		int c; 
+		for (c = 0; c < a; c++) results[c * p + a] = results[a * p + c]; 
+	} 
+	free(partial); 
+
+} 
+
+/* 
+ * Determine Kendall's tau-b between two gathered columns, each row counted 
+ * as many times as its weight. 
+ * 
+ * Parameters 
+ * ========== 
+ * data: 		The gathered columns 
+ * weights: 	The weight of each row; NULL for a weight of 1 throughout 
+ * a, b: 		The two columns, by their place in the set 
+ * entries: 	Room for n entries; may be NULL when a == b 
+ * tmp: 		Room for n more 
+ * 
+ * Returns 
+ * ======= 
+ * tau-b, (n_c - n_d) / sqrt((n_0 - n_1) (n_0 - n_2)); NaN if either 
+ * column holds one value throughout 
+ * 
+ * Notes 
+ * ===== 
+ * Knight's algorithm: in order of the first column, with ties in it broken 
+ * by the second, the discordant pairs are the swaps a merge sort on the 
+ * second column makes. With weights a swap of two entries counts the 
+ * product of their weights, and a run of ties of total weight W holds 
+ * W (W - 1) / 2 pairs, so that the copies of a row are tied with each other 
+ * in both columns. 
+ */ 
+static double kendall_tau(CORRELATION_DATA data, unsigned int *weights, 
+	int a, int b, KENDALL_ENTRY *entries, KENDALL_ENTRY *tmp) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * n0: 			The number of pairs of rows 
+	 * n1, n2: 		The number tied in the first and second column 
+	 * n3: 			The number tied in both 
+	 * nd: 			The number discordant 
+	 */ 
+	long i, k, n = 0l; 
+	long *order = data.order[a], *ties = data.ties[a]; 
+	double total = 0, n0, n1 = 0, n2, n3 = 0, nd; 
+
+	if (a == b) {
+		/* Every pair is concordant or tied in both */ 
+		for (i = 0l; i < data.n; i++) {
+			total += weights != NULL ? weights[i] : 1; 
+		} 
+		n0 = total * (total - 1) / 2; 
+		i = 0l; 
+		while (i < data.n) {
+			double run = 0; 
+			for (k = i; k < data.n && ties[order[k]] == ties[order[i]]; k++) {
+				run += weights != NULL ? weights[order[k]] : 1; 
+			} 
+			n1 += run * (run - 1) / 2; 
+			i = k; 
+		} 
+		return n0 - n1 > 0 ? 1 : NAN; 
+	} else {} 
+
+	/* The rows with weight in order of the first column */ 
+	long *xties = (long *) malloc ((data.n ? data.n : 1l) * sizeof(long)); 
+	for (i = 0l; i < data.n; i++) {
+		double w = weights != NULL ? weights[order[i]] : 1; 
+		if (w) {
+			entries[n].y = data.ties[b][order[i]]; 
+			entries[n].weight = w; 
+			xties[n] = ties[order[i]]; 
+			total += w; 
+			n++; 
+		} else {} 
+	} 
+	n0 = total * (total - 1) / 2; 
+
+	/* Break ties in the first column by the second, counting both kinds */ 
+	i = 0l; 
+	while (i < n) {
+		double run = 0; 
+		for (k = i; k < n && xties[k] == xties[i]; k++) {
+			run += entries[k].weight; 
+		} 
+		n1 += run * (run - 1) / 2; 
+		if (k - i > 1l) {
+			qsort(entries + i, k - i, sizeof(KENDALL_ENTRY), 
+				compare_kendall_entries); 
+			n3 += tied_pairs(entries + i, k - i); 
+		} else {} 
+		i = k; 
+	} 
+	free(xties); 
+
+	nd = merge_discordant(entries, tmp, n); 
+	n2 = tied_pairs(entries, n); 
+	if (n0 - n1 > 0 && n0 - n2 > 0) {
+		return (n0 - n1 - n2 + n3 - 2 * nd) / sqrt((n0 - n1) * (n0 - n2)); 
+	} else {
+		return NAN; 
+	} 
+
+} 
+
+/* 
+ * Sorts entries by their second column with a bottom-up merge sort, 
+ * counting the weighted swaps: each entry taken from the right half ahead 
+ * of the entries remaining in the left half is discordant with all of 
+ * them. Equal entries are taken from the left first, so ties are not 
+ * counted. 
+ */ 
+static double merge_discordant(KENDALL_ENTRY *entries, KENDALL_ENTRY *tmp, 
+	long n) {
+
+	long width, start, l; 
+	double swaps = 0; 
+	KENDALL_ENTRY *source = entries, *dest = tmp; 
+	for (width = 1l; width < n; width *= 2l) {
+		for (start = 0l; start < n; start += 2l * width) {
+			long mid = min(start + width, n), stop = min(start + 2l * width, n); 
+			long i = start, j = mid, k = start; 
+			double left = 0; 
+			for (l = start; l < mid; l++) left += source[l].weight; 
+			while (i < mid && j < stop) {
+				if (source[j].y < source[i].y) {
+					swaps += source[j].weight * left; 
+					dest[k++] = source[j++]; 
+				} else {
+					left -= source[i].weight; 
+					dest[k++] = source[i++]; 
+				} 
+			} 
+			while (i < mid) dest[k++] = source[i++]; 
+			while (j < stop) dest[k++] = source[j++]; 
+		} 
+		KENDALL_ENTRY *swap = source; 
+		source = dest; 
+		dest = swap; 
+	} 
+	if (source != entries) memcpy(entries, source, n * sizeof(KENDALL_ENTRY)); 
+	return swaps; 
+
+} 
+
+/* 
+ * The number of pairs tied in the second column among entries sorted by 
+ * it: W (W - 1) / 2 for each run of ties of total weight W. 
+ */ 
+static double tied_pairs(KENDALL_ENTRY *entries, long n) {
+
+	long i = 0l, k; 
+	double pairs = 0; 
+	while (i < n) {
+		double run = 0; 
+		for (k = i; k < n && entries[k].y == entries[i].y; k++) {
+			run += entries[k].weight; 
+		} 
+		pairs += run * (run - 1) / 2; 
+		i = k; 
+	} 
+	return pairs; 
+
+} 
+
+/* Orders Kendall entries by their second column */ 
+static int compare_kendall_entries(const void *a, const void *b) {
+
+	long x = (*((const KENDALL_ENTRY *) a)).y; 
+	long y = (*((const KENDALL_ENTRY *) b)).y; 
+	return (x > y) - (x < y); 
+
+} 
+
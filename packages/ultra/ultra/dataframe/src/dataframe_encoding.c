@@ -0,0 +1,620 @@
+/* 
+ * This file scripts the encodings which compress the values of a column in 
+ * memory. Much of a halo catalog compresses well: the scale factor is the 
+ * same for every halo in a snapshot, IDs are integers in a narrow range, and 
+ * flags take only a few values. Three lightweight schemes cover these: 
+ * 
+ * run-length: 			Runs of equal values are stored once, along with 
+ * 						where they end. A value is found by binary search. 
+ * frame of reference: 	Integers are stored as offsets from the smallest 
+ * 						value, packed into as few bits as the largest offset 
+ * 						needs. A value is found in constant time. 
+ * byte shuffle: 		Byte k of every value is stored together, and bytes 
+ * 						which are the same for every value (e.g. the sign and 
+ * 						exponent of floats in a narrow range) are stored 
+ * 						once. A value is found in constant time. 
+ * 
+ * Every scheme keeps random access, so the kernels read encoded columns 
+ * through column_value like any other; the heavy ones scan run-length 
+ * encoded columns run by run. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static COLUMN_ENCODING *encode(COLUMN_BUFFER *buffer, int scheme); 
+static COLUMN_ENCODING *encode_rle(COLUMN_BUFFER *buffer); 
+static COLUMN_ENCODING *encode_for(COLUMN_BUFFER *buffer); 
+static COLUMN_ENCODING *encode_shuffle(COLUMN_BUFFER *buffer); 
+static COLUMN_ENCODING *encoding_initialize(int scheme); 
+static long run_containing(COLUMN_ENCODING *e, long i); 
+static unsigned long long unpack(unsigned long long *words, int bits, long i); 
+static int relation_holds(double x, double value, int relational_code); 
+static int integer_relation_holds(long long x, long long value, 
+	int relational_code); 
+
+/* 
+ * Replaces the buffer of a column of a dataframe with an encoded copy of it, 
+ * or a plain one. Other dataframes sharing the buffer are unaffected. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe 
+ * column: 		The column number 
+ * scheme: 		The encoding, as the ENCODING_* codes in dataframe.h. 
+ * 				ENCODING_PLAIN decodes the column, and ENCODING_AUTO picks the 
+ * 				smallest encoding, leaving the column plain if none is smaller. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (e.g. ENCODING_FOR on a floating point column) 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_encode(DATAFRAME *df, int column, int scheme) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * source: 		The buffer being replaced 
+	 * plain: 		The plain values of the source, decoded if need be 
+	 * replacement: The buffer replacing it 
+	 */ 
+	if (column < 0 || column >= (*df).num_cols || scheme < ENCODING_PLAIN || 
+		scheme > ENCODING_AUTO) return 1; 
+	COLUMN_BUFFER *source = (*df).columns[column]; 
+	COLUMN_BUFFER *plain = (*source).encoding != NULL ? 
+		column_buffer_decode(source) : source; 
+	COLUMN_BUFFER *replacement; 
+	if (scheme == ENCODING_PLAIN) {
+		if (plain == source) return 0; /* Already plain */ 
+		replacement = plain; 
+	} else {
+		COLUMN_ENCODING *e = encode(plain, scheme); 
+		if (e == NULL && scheme != ENCODING_AUTO) {
+			if (plain != source) column_buffer_release(plain); 
+			return 1; 
+		} else if (e == NULL) {
+			/* Nothing is smaller than the plain values */ 
+			replacement = plain; 
+		} else {
+			replacement = column_buffer_initialize(0l, (*plain).type); 
+			free(replacement -> values); 
+			replacement -> values = NULL; 
+			replacement -> length = (*plain).length; 
+			replacement -> encoding = e; 
+			if ((*plain).validity != NULL) {
+				replacement -> validity = (unsigned char *) malloc ( 
+					validity_bytes((*plain).length > 0l ? (*plain).length : 
+					1l)); 
+				memcpy(replacement -> validity, (*plain).validity, 
+					validity_bytes((*plain).length)); 
+			} else {} 
+			if (plain != source) column_buffer_release(plain); 
+		} 
+	} 
+	if (replacement != source) {
+		column_buffer_release(source); 
+		df -> columns[column] = replacement; 
+	} else {} 
+	return 0; 
+
+} 
+
+/* 
+ * Allocates memory for a plain column buffer holding the decoded values of 
+ * another, along with its validity. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_BUFFER *column_buffer_decode(COLUMN_BUFFER *buffer) {
+
+	long i; 
+	unsigned long size = column_type_size((*buffer).type); 
+	COLUMN_BUFFER *plain = column_buffer_initialize((*buffer).length, 
+		(*buffer).type); 
+	if ((*buffer).encoding == NULL) {
+		memcpy(plain -> values, (*buffer).values, (*buffer).length * size); 
+	} else {
+		unsigned char *values = (unsigned char *) (*plain).values; 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < (*buffer).length; i++) {
+			column_encoded_get(buffer, i, values + i * size); 
+		} 
+	} 
+	if ((*buffer).validity != NULL) {
+		plain -> validity = (unsigned char *) malloc (validity_bytes( 
+			(*buffer).length > 0l ? (*buffer).length : 1l)); 
+		memcpy(plain -> validity, (*buffer).validity, 
+			validity_bytes((*buffer).length)); 
+	} else {} 
+	return plain; 
+
+} 
+
+/* 
+ * Allocates memory for a copy of an encoding and returns the pointer. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_ENCODING *column_encoding_copy(COLUMN_ENCODING *e) {
+
+	COLUMN_ENCODING *copy = (COLUMN_ENCODING *) malloc ( 
+		sizeof(COLUMN_ENCODING)); 
+	memcpy(copy, e, sizeof(COLUMN_ENCODING)); 
+	copy -> data = malloc ((*e).size > 0ul ? (*e).size : 1ul); 
+	memcpy(copy -> data, (*e).data, (*e).size); 
+	if ((*e).ends != NULL) {
+		copy -> ends = (long *) malloc ((*e).num_runs * sizeof(long)); 
+		memcpy(copy -> ends, (*e).ends, (*e).num_runs * sizeof(long)); 
+	} else {} 
+	return copy; 
+
+} 
+
+/* 
+ * Frees the memory stored by an encoding. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void column_encoding_free(COLUMN_ENCODING *e) {
+
+	if (e == NULL) return; 
+	if ((*e).data != NULL) free(e -> data); 
+	if ((*e).ends != NULL) free(e -> ends); 
+	free(e); 
+
+} 
+
+/* 
+ * Copies the value at a given position of an encoded column buffer into 
+ * dest, as it'd be stored plainly. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void column_encoded_get(COLUMN_BUFFER *buffer, long i, void *ptr) {
+
+	int k; 
+	unsigned char *dest = (unsigned char *) ptr; 
+	unsigned long size = column_type_size((*buffer).type); 
+	COLUMN_ENCODING *e = (*buffer).encoding; 
+	switch ((*e).scheme) {
+
+		case ENCODING_RLE: 
+			memcpy(dest, (unsigned char *) (*e).data + run_containing(e, i) * 
+				size, size); 
+			break; 
+
+		case ENCODING_FOR: {
+			long long x = column_encoded_integer(buffer, i); 
+			if ((*buffer).type == COLUMN_INT64) {
+				memcpy(dest, &x, size); 
+			} else {
+				int y = (int) x; 
+				memcpy(dest, &y, size); 
+			} 
+			break; 
+		} 
+
+		case ENCODING_SHUFFLE: 
+			for (k = 0; k < (int) size; k++) {
+				dest[k] = (*e).planes[k] == -1l ? (*e).constants[k] : 
+					((unsigned char *) (*e).data)[(*e).planes[k] * 
+					(*buffer).length + i]; 
+			} 
+			break; 
+
+	} 
+
+} 
+
+/* 
+ * The value at a given position of an encoded column buffer as a double. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern double column_encoded_value(COLUMN_BUFFER *buffer, long i) {
+
+	double x; 
+	float y; 
+	switch ((*buffer).type) {
+
+		case COLUMN_FLOAT64: 
+			column_encoded_get(buffer, i, &x); 
+			return x; 
+
+		case COLUMN_FLOAT32: 
+			column_encoded_get(buffer, i, &y); 
+			return y; 
+
+		default: 
+			return (double) column_encoded_integer(buffer, i); 
+
+	} 
+
+} 
+
+/* 
+ * The value at a given position of an encoded column buffer of integers as a 
+ * long long, which is exact. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern long long column_encoded_integer(COLUMN_BUFFER *buffer, long i) {
+
+	union { long long i64; int i32; float f32; double f64; } x; 
+	COLUMN_ENCODING *e = (*buffer).encoding; 
+	if ((*e).scheme == ENCODING_FOR) {
+		/* Unsigned arithmetic wraps, so any offset from any reference works */ 
+		return (long long) ((unsigned long long) (*e).reference + 
+			unpack((unsigned long long *) (*e).data, (*e).bits, i)); 
+	} else {} 
+	column_encoded_get(buffer, i, &x); 
+	switch ((*buffer).type) {
+
+		case COLUMN_INT64: 
+			return x.i64; 
+
+		case COLUMN_INT32: 
+			return x.i32; 
+
+		case COLUMN_FLOAT32: 
+			return (long long) x.f32; 
+
+		default: 
+			return (long long) x.f64; 
+
+	} 
+
+} 
+
+/* 
+ * The number of bytes taken by the values of a column buffer, encoded or 
+ * not, excluding its validity. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern unsigned long column_buffer_nbytes(COLUMN_BUFFER *buffer) {
+
+	if ((*buffer).encoding != NULL) {
+		return (*buffer).encoding -> size + (*buffer).encoding -> num_runs * 
+			sizeof(long); 
+	} else {
+		return (*buffer).length * column_type_size((*buffer).type); 
+	} 
+
+} 
+
+/* 
+ * Determine the sum, minimum, and maximum of a contiguous range of the 
+ * values of a run-length encoded column buffer, one run at a time. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 		The buffer, with ENCODING_RLE 
+ * first: 		The first position of the range 
+ * last: 		One past the last position of the range 
+ * sum: 		A pointer to put the sum into 
+ * minimum: 	A pointer to put the minimum into (0 for an empty range) 
+ * maximum: 	A pointer to put the maximum into (0 for an empty range) 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void rle_summary(COLUMN_BUFFER *buffer, long first, long last, 
+	double *sum, double *minimum, double *maximum) {
+
+	long r, start = first; 
+	COLUMN_ENCODING *e = (*buffer).encoding; 
+	*sum = 0; 
+	*minimum = 0; 
+	*maximum = 0; 
+	if (first >= last) return; 
+	for (r = run_containing(e, first); start < last; r++) {
+		long stop = min((*e).ends[r], last); 
+		double x = column_encoded_value(buffer, start); 
+		*sum += x * (stop - start); 
+		if (start == first || x < *minimum) *minimum = x; 
+		if (start == first || x > *maximum) *maximum = x; 
+		start = stop; 
+	} 
+
+} 
+
+/* 
+ * Determine which values of a contiguous range of a run-length encoded 
+ * column buffer satisfy a relation, testing each run once. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 				The buffer, with ENCODING_RLE 
+ * first: 				The first position of the range 
+ * last: 				One past the last position of the range 
+ * value: 				The value to compare to 
+ * integer: 			The same value as an integer, to compare integer 
+ * 						columns to exactly; NULL to compare as doubles 
+ * relational_code: 	As in sieve 
+ * test: 				A pointer to put 1s at the values that pass and 0s 
+ * 						elsewhere into, with last - first elements 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void rle_test(COLUMN_BUFFER *buffer, long first, long last, 
+	double value, long long *integer, int relational_code, int *test) {
+
+	long i, r, start = first; 
+	COLUMN_ENCODING *e = (*buffer).encoding; 
+	if (first >= last) return; 
+	for (r = run_containing(e, first); start < last; r++) {
+		long stop = min((*e).ends[r], last); 
+		int passes; 
+		if (integer != NULL && column_is_integer((*buffer).type)) {
+			passes = integer_relation_holds(column_encoded_integer(buffer, 
+				start), *integer, relational_code); 
+		} else {
+			passes = relation_holds(column_encoded_value(buffer, start), 
+				value, relational_code); 
+		} 
+		for (i = start; i < stop; i++) {
+			test[i - first] = passes; 
+		} 
+		start = stop; 
+	} 
+
+} 
+
+/* 
+ * Encodes the values of a plain column buffer with a given scheme. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 		The plain buffer 
+ * scheme: 		The encoding; ENCODING_AUTO for the smallest 
+ * 
+ * Returns 
+ * ======= 
+ * The encoding; NULL if the scheme doesn't apply to the type of the values, 
+ * or, for ENCODING_AUTO, if no encoding is smaller than the plain values 
+ */ 
+static COLUMN_ENCODING *encode(COLUMN_BUFFER *buffer, int scheme) {
+
+	switch (scheme) {
+
+		case ENCODING_RLE: 
+			return encode_rle(buffer); 
+
+		case ENCODING_FOR: 
+			return encode_for(buffer); 
+
+		case ENCODING_SHUFFLE: 
+			return encode_shuffle(buffer); 
+
+		case ENCODING_AUTO: {
+			/* 
+			 * Keep the smallest of those which apply, except that a run-length 
+			 * encoding an eighth the size of the plain values or less is kept 
+			 * outright, since the kernels then step through it run by run. 
+			 */ 
+			int s; 
+			COLUMN_ENCODING *best = NULL; 
+			unsigned long plain = column_buffer_nbytes(buffer); 
+			for (s = ENCODING_RLE; s <= ENCODING_SHUFFLE; s++) {
+				COLUMN_ENCODING *e = encode(buffer, s); 
+				if (e == NULL) continue; 
+				unsigned long size = (*e).size + (*e).num_runs * 
+					sizeof(long); 
+				if (s == ENCODING_RLE && 8ul * size <= plain) return e; 
+				if (size < plain && (best == NULL || size < (*best).size + 
+					(*best).num_runs * sizeof(long))) {
+					column_encoding_free(best); 
+					best = e; 
+				} else {
+					column_encoding_free(e); 
+				} 
+			} 
+			return best; 
+		} 
+
+		default: 
+			return NULL; 
+
+	} 
+
+} 
+
+/* 
+ * Run-length encodes the values of a plain column buffer. Values are equal 
+ * if their bytes are, so runs of NaNs are runs too. 
+ */ 
+static COLUMN_ENCODING *encode_rle(COLUMN_BUFFER *buffer) {
+
+	long i; 
+	unsigned long size = column_type_size((*buffer).type); 
+	unsigned char *values = (unsigned char *) (*buffer).values; 
+	COLUMN_ENCODING *e = encoding_initialize(ENCODING_RLE); 
+	for (i = 0l; i < (*buffer).length; i++) {
+		if (!i || memcmp(values + i * size, values + (i - 1l) * size, size)) {
+			e -> num_runs++; 
+		} else {} 
+	} 
+	e -> size = (*e).num_runs * size; 
+	e -> data = malloc ((*e).size > 0ul ? (*e).size : 1ul); 
+	e -> ends = (long *) malloc (((*e).num_runs > 0l ? (*e).num_runs : 1l) * 
+		sizeof(long)); 
+	long r = -1l; 
+	for (i = 0l; i < (*buffer).length; i++) {
+		if (!i || memcmp(values + i * size, values + (i - 1l) * size, size)) {
+			r++; 
+			memcpy((unsigned char *) (*e).data + r * size, values + i * size, 
+				size); 
+		} else {} 
+		e -> ends[r] = i + 1l; 
+	} 
+	return e; 
+
+} 
+
+/* 
+ * Frame of reference encodes the values of a plain column buffer of integers, 
+ * packing each value's offset from the smallest into as few bits as the 
+ * largest offset needs. 
+ */ 
+static COLUMN_ENCODING *encode_for(COLUMN_BUFFER *buffer) {
+
+	long i; 
+	if (!column_is_integer((*buffer).type)) return NULL; 
+	long long lowest = 0ll, highest = 0ll; 
+	for (i = 0l; i < (*buffer).length; i++) {
+		long long x = column_integer(buffer, i); 
+		if (!i || x < lowest) lowest = x; 
+		if (!i || x > highest) highest = x; 
+	} 
+	unsigned long long range = (unsigned long long) highest - 
+		(unsigned long long) lowest; 
+	COLUMN_ENCODING *e = encoding_initialize(ENCODING_FOR); 
+	e -> reference = lowest; 
+	while ((*e).bits < 64 && (range >> (*e).bits)) e -> bits++; 
+	/* One extra word, so a value straddling two words can always read both */ 
+	long num_words = ((*buffer).length * (*e).bits + 63l) / 64l + 1l; 
+	e -> size = num_words * sizeof(unsigned long long); 
+	e -> data = calloc (num_words, sizeof(unsigned long long)); 
+	unsigned long long *words = (unsigned long long *) (*e).data; 
+	if (!(*e).bits) return e; /* Every value is the reference */ 
+	for (i = 0l; i < (*buffer).length; i++) {
+		unsigned long long offset = (unsigned long long) column_integer( 
+			buffer, i) - (unsigned long long) lowest; 
+		long bit = i * (*e).bits; 
+		words[bit >> 6] |= offset << (bit & 63); 
+		if ((bit & 63) + (*e).bits > 64) {
+			words[(bit >> 6) + 1l] |= offset >> (64 - (bit & 63)); 
+		} else {} 
+	} 
+	return e; 
+
+} 
+
+/* 
+ * Byte shuffles the values of a plain column buffer: byte k of every value is 
+ * stored together, and stored only once if it's the same for every value. 
+ */ 
+static COLUMN_ENCODING *encode_shuffle(COLUMN_BUFFER *buffer) {
+
+	int k; 
+	long i, num_planes = 0l; 
+	unsigned long size = column_type_size((*buffer).type); 
+	unsigned char *values = (unsigned char *) (*buffer).values; 
+	COLUMN_ENCODING *e = encoding_initialize(ENCODING_SHUFFLE); 
+	for (k = 0; k < (int) size; k++) {
+		e -> constants[k] = (*buffer).length > 0l ? values[k] : 0; 
+		e -> planes[k] = -1l; 
+		for (i = 1l; i < (*buffer).length; i++) {
+			if (values[i * size + k] != (*e).constants[k]) {
+				e -> planes[k] = num_planes++; 
+				break; 
+			} else {
+				continue; 
+			} 
+		} 
+	} 
+	e -> size = num_planes * (*buffer).length; 
+	e -> data = malloc ((*e).size > 0ul ? (*e).size : 1ul); 
+	unsigned char *data = (unsigned char *) (*e).data; 
+	for (k = 0; k < (int) size; k++) {
+		if ((*e).planes[k] == -1l) continue; 
+		unsigned char *plane = data + (*e).planes[k] * (*buffer).length; 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < (*buffer).length; i++) {
+			plane[i] = values[i * size + k]; 
+		} 
+	} 
+	return e; 
+
+} 
+
+/* 
+ * Allocates memory for an empty encoding with a given scheme. 
+ */ 
+static COLUMN_ENCODING *encoding_initialize(int scheme) {
+
+	COLUMN_ENCODING *e = (COLUMN_ENCODING *) calloc (1, 
+		sizeof(COLUMN_ENCODING)); 
+	e -> scheme = scheme; 
+	return e; 
+
+} 
+
+/* 
+ * The run of a run-length encoding holding a given position, found by 
+ * binary search. 
+ */ 
+static long run_containing(COLUMN_ENCODING *e, long i) {
+
+	long low = 0l, high = (*e).num_runs - 1l; 
+	while (low < high) {
+		long mid = (low + high) / 2l; 
+		if ((*e).ends[mid] > i) {
+			high = mid; 
+		} else {
+			low = mid + 1l; 
+		} 
+	} 
+	return low; 
+
+} 
+
+/* 
+ * The i'th packed value of a given number of bits from an array of 64-bit 
+ * words. 
+ */ 
+static unsigned long long unpack(unsigned long long *words, int bits, long i) {
+
+	if (!bits) return 0ull; 
+	long bit = i * bits; 
+	unsigned long long x = words[bit >> 6] >> (bit & 63); 
+	if ((bit & 63) + bits > 64) x |= words[(bit >> 6) + 1l] << (64 - 
+		(bit & 63)); 
+	return bits == 64 ? x : x & ((1ull << bits) - 1ull); 
+
+} 
+
+/* 
+ * Whether or not x holds a relation to a value, as the relational codes of 
+ * sieve. 
+ */ 
+static int relation_holds(double x, double value, int relational_code) {
+
+	switch (relational_code) {
+		case 1: return x < value; 
+		case 2: return x <= value; 
+		case 3: return x == value; 
+		case 4: return x >= value; 
+		case 5: return x > value; 
+		case 6: return x != value; 
+		default: return 0; 
+	} 
+
+} 
+
+/* 
+ * Whether or not an integer x holds a relation to an integer value, as the 
+ * relational codes of sieve. 
+ */ 
+static int integer_relation_holds(long long x, long long value, 
+	int relational_code) {
+
+	switch (relational_code) {
+		case 1: return x < value; 
+		case 2: return x <= value; 
+		case 3: return x == value; 
+		case 4: return x >= value; 
+		case 5: return x > value; 
+		case 6: return x != value; 
+		default: return 0; 
+	} 
+
+} 
+
@@ -0,0 +1,847 @@
+/* 
+ * This file scripts the external sort: ordering the rows of ASCII tables 
+ * too large to hold in memory by one of their columns. The files are read 
+ * in chunks that fit within a memory budget, each chunk is sorted and 
+ * spilled to a temporary binary file as a sorted run, and the runs are then 
+ * merged through a loser tree into a single sorted stream of rows which is 
+ * handed off to a sink in blocks. Runs are generated for different files on 
+ * different threads at the same time. Every value takes 8 bytes in a row: 
+ * the value itself as a double, or for a column of integers, the bits of a 
+ * long long, which carries IDs above 2^53 through the sort exactly. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <ctype.h> 
+#include <math.h> 
+#include <unistd.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* 
+ * The smallest read buffer given to each run during a merge; this bounds 
+ * the number of runs merged at once given the memory budget. 
+ */ 
+#ifndef EXTERNAL_MIN_BUFFER 
+#define EXTERNAL_MIN_BUFFER 65536ul 
+#endif /* EXTERNAL_MIN_BUFFER */ 
+
+/* The most runs merged at once, to stay clear of open file limits */ 
+#ifndef EXTERNAL_MAX_FAN_IN 
+#define EXTERNAL_MAX_FAN_IN 256 
+#endif /* EXTERNAL_MAX_FAN_IN */ 
+
+/* 
+ * A sorted run spilled to disk. 
+ * 
+ * Fields 
+ * ====== 
+ * path: 		The name of the temporary file holding the run 
+ * num_rows: 	The number of rows in the run 
+ * file: 		The input file the run came from 
+ * chunk: 		The position of the run's chunk within that file 
+ */ 
+typedef struct sort_run {
+
+	char *path; 
+	long num_rows; 
+	int file; 
+	long chunk; 
+
+} SORT_RUN; 
+
+/* 
+ * A run being read back during a merge. 
+ * 
+ * Fields 
+ * ====== 
+ * in: 			The open run file 
+ * buffer: 		The rows read from the file but not yet merged 
+ * length: 		The number of rows in the buffer 
+ * position: 	The row of the buffer at the head of the run 
+ * remaining: 	The number of rows not yet read from the file 
+ * key: 		The sort key of the row at the head of the run 
+ * exhausted: 	Whether or not every row of the run has been merged 
+ */ 
+typedef struct merge_run {
+
+	FILE *in; 
+	double *buffer; 
+	long length; 
+	long position; 
+	long remaining; 
+	unsigned long long key; 
+	int exhausted; 
+
+} MERGE_RUN; 
+
+/* A row of a chunk and its sort key */ 
+typedef struct chunk_entry {
+
+	unsigned long long key; 
+	long row; 
+
+} CHUNK_ENTRY; 
+
+/* An ASCII output file and which of its columns hold integers */ 
+typedef struct text_output {
+
+	FILE *out; 
+	int *integers; 
+
+} TEXT_OUTPUT; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static unsigned long long external_key(double *row, int key, int integer, 
+	int descending); 
+static int generate_runs(char **files, int num_files, char comment, 
+	int *columns, int num_cols, int *integers, int key, int descending, 
+	unsigned long budget, char *tmpdir, SORT_RUN **runs, long *num_runs); 
+static int read_chunk(FILE *in, char *line, char comment, int *columns, 
+	int num_cols, int *integers, int maxcol, int *parse_integer, 
+	double *values, double *rows, long capacity, long *length); 
+static int spill_run(double *rows, long length, int num_cols, int key, 
+	int integer, int descending, CHUNK_ENTRY *entries, char *tmpdir, 
+	SORT_RUN *run); 
+static FILE *temporary_file(char *tmpdir, char **path); 
+static int merge_runs(SORT_RUN *runs, int k, int num_cols, int key, 
+	int integer, int descending, unsigned long budget, ROW_SINK sink, 
+	void *state); 
+static int run_advance(MERGE_RUN *run, int num_cols, int key, int integer, 
+	int descending, long capacity); 
+static int run_beats(MERGE_RUN *runs, int a, int b); 
+static int loser_tree_build(MERGE_RUN *runs, int k, int *tree, int node); 
+static int run_file_sink(double *rows, long n, int num_cols, void *state); 
+static int text_sink(double *rows, long n, int num_cols, void *state); 
+static int binary_sink(double *rows, long n, int num_cols, void *state); 
+static void remove_runs(SORT_RUN *runs, long num_runs); 
+static int compare_entries(const void *a, const void *b); 
+static int compare_runs(const void *a, const void *b); 
+
+/* 
+ * Sorts the rows of one or more whitespace-separated ASCII tables by one of 
+ * their columns without holding them in memory, streaming the sorted rows 
+ * to a sink. 
+ * 
+ * Parameters 
+ * ========== 
+ * files: 		The names of the files 
+ * num_files: 	The number of files 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the files to carry through the sort 
+ * num_cols: 	The number of columns 
+ * integers: 	1 for each column to carry as an exact 64-bit integer, 0 for 
+ * 				a double; NULL if they're all doubles 
+ * key: 		The position within columns of the column to sort by 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * budget: 		The number of bytes the rows in memory may take up 
+ * tmpdir: 		The directory to write the sorted runs to (NULL for $TMPDIR 
+ * 				or /tmp) 
+ * sink: 		Called with each block of sorted rows, row-major. The values 
+ * 				of integer columns hold the bits of a long long. A nonzero 
+ * 				return value stops the sort. 
+ * state: 		Passed through to the sink 
+ * num_rows: 	Pointer to the total number of rows sorted 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to read a file or to write a run, or if the 
+ * sink stops the sort 
+ * 
+ * Notes 
+ * ===== 
+ * Each thread reads a different file, so run generation is parallel 
+ * across files only. Values are parsed as doubles except in the integer 
+ * columns, where a value not written as an integer (e.g. 1e+06) is 
+ * truncated. NaNs sort last in either direction, and -0 and 0 tie, as in 
+ * dfcolumns_argsort. The sort is stable: rows with equal keys come out in 
+ * the order of the files and of the rows within them. When there are more 
+ * runs than can be merged at once given the budget, they are merged in 
+ * several passes. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int external_sort_rows(char **files, int num_files, char comment, 
+	int *columns, int num_cols, int *integers, int key, int descending, 
+	unsigned long budget, char *tmpdir, ROW_SINK sink, void *state, 
+	long *num_rows) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * runs: 		The sorted runs, in the order of the input 
+	 * num_runs: 	The number of runs 
+	 * fan_in: 		The most runs to merge at once 
+	 * integer: 	Whether or not the key column holds integers 
+	 * i, j: 		For-looping 
+	 */ 
+	SORT_RUN *runs = NULL; 
+	long i, j, num_runs = 0l; 
+	int status; 
+	if (num_files < 1 || num_cols < 1 || key < 0 || key >= num_cols || 
+		budget < (unsigned long) num_cols * sizeof(double)) return 1; 
+	for (j = 0; j < num_cols; j++) {
+		if (columns[j] < 0) return 1; 
+	} 
+	int integer = integers != NULL && integers[key]; 
+	if (generate_runs(files, num_files, comment, columns, num_cols, integers, 
+		key, descending, budget, tmpdir, &runs, &num_runs)) return 1; 
+	*num_rows = 0l; 
+	for (i = 0l; i < num_runs; i++) *num_rows += runs[i].num_rows; 
+
+	long fan_in = max(2ul, min(budget / EXTERNAL_MIN_BUFFER, 
+		(unsigned long) EXTERNAL_MAX_FAN_IN)); 
+	while (num_runs > fan_in) {
+		/* 
+		 * Merge consecutive groups of runs into longer runs, which keeps 
+		 * them in input order for the next pass. 
+		 */ 
+		long num_merged = (num_runs + fan_in - 1l) / fan_in; 
+		SORT_RUN *merged = (SORT_RUN *) calloc (num_merged, 
+			sizeof(SORT_RUN)); 
+		status = 0; 
+		for (i = 0l; i < num_merged; i++) {
+			long start = i * fan_in, k = min(fan_in, num_runs - start); 
+			FILE *out = temporary_file(tmpdir, &merged[i].path); 
+			if (out == NULL) {
+				status = 1; 
+				break; 
+			} else {
+				merged[i].chunk = i; 
+				for (j = start; j < start + k; j++) {
+					merged[i].num_rows += runs[j].num_rows; 
+				} 
+				status = merge_runs(runs + start, k, num_cols, key, integer, 
+					descending, budget, run_file_sink, out); 
+				if (fclose(out)) status = 1; 
+				if (status) break; 
+			} 
+		} 
+		remove_runs(runs, num_runs); 
+		runs = merged; 
+		num_runs = num_merged; 
+		if (status) {
+			remove_runs(runs, num_runs); 
+			return 1; 
+		} else {} 
+	} 
+
+	status = num_runs ? merge_runs(runs, num_runs, num_cols, key, integer, 
+		descending, budget, sink, state) : 0; 
+	remove_runs(runs, num_runs); 
+	return status; 
+
+} 
+
+/* 
+ * Sorts the rows of one or more whitespace-separated ASCII tables by one of 
+ * their columns without holding them in memory, writing the sorted rows to 
+ * a file. 
+ * 
+ * Parameters 
+ * ========== 
+ * files: 		The names of the files 
+ * num_files: 	The number of files 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the files to carry through the sort 
+ * num_cols: 	The number of columns 
+ * integers: 	1 for each column to carry as an exact 64-bit integer, 0 for 
+ * 				a double; NULL if they're all doubles 
+ * key: 		The position within columns of the column to sort by 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * budget: 		The number of bytes the rows in memory may take up 
+ * tmpdir: 		The directory to write the sorted runs to (NULL for $TMPDIR 
+ * 				or /tmp) 
+ * output: 		The name of the file to write the sorted rows to 
+ * binary: 		1 to write the rows as raw row-major 8-byte values (long 
+ * 				longs in the integer columns, doubles elsewhere), 0 for 
+ * 				ASCII, where doubles are written with 17 significant digits 
+ * 				so that they read back exactly 
+ * num_rows: 	Pointer to the total number of rows sorted 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int external_sort_to_file(char **files, int num_files, 
+	char comment, int *columns, int num_cols, int *integers, int key, 
+	int descending, unsigned long budget, char *tmpdir, char *output, 
+	int binary, long *num_rows) {
+
+	FILE *out = fopen(output, binary ? "wb" : "w"); 
+	if (out == NULL) return 1; 
+	TEXT_OUTPUT text = {out, integers}; 
+	int status = external_sort_rows(files, num_files, comment, columns, 
+		num_cols, integers, key, descending, budget, tmpdir, 
+		binary ? binary_sink : text_sink, binary ? (void *) out : 
+		(void *) &text, num_rows); 
+	if (fclose(out)) status = 1; 
+	return status; 
+
+} 
+
+/* 
+ * Reads the files in chunks and spills each one to disk as a sorted run. 
+ * 
+ * Parameters 
+ * ========== 
+ * files: 		The names of the files 
+ * num_files: 	The number of files 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the files to read 
+ * num_cols: 	The number of columns 
+ * integers: 	Which of the columns hold integers; NULL for none 
+ * key: 		The position within columns of the column to sort by 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * budget: 		The number of bytes the chunks in memory may take up 
+ * tmpdir: 		The directory to write the runs to 
+ * runs: 		Pointer to the runs, in the order of the input 
+ * num_runs: 	Pointer to the number of runs 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure, in which case no runs are left on disk 
+ */ 
+static int generate_runs(char **files, int num_files, char comment, 
+	int *columns, int num_cols, int *integers, int key, int descending, 
+	unsigned long budget, char *tmpdir, SORT_RUN **runs, long *num_runs) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * row_bytes: 	The memory each row of a chunk takes up, with its entry 
+	 * num_threads: The number of chunks in memory at once 
+	 * capacity: 	The number of rows in each chunk 
+	 * maxcol: 		The largest column number to parse 
+	 * capacity_runs: The number of runs there is room for 
+	 * failed: 		Whether or not any thread has hit an error 
+	 * parse_integer: Whether or not to parse each column of the files up to 
+	 * 				maxcol as an integer 
+	 */ 
+	unsigned long row_bytes = num_cols * sizeof(double) + sizeof(CHUNK_ENTRY); 
+	int f, j, maxcol = 0, failed = 0, num_threads = 1; 
+	int integer = integers != NULL && integers[key]; 
+	long capacity_runs = num_files; 
+	for (j = 0; j < num_cols; j++) maxcol = max(maxcol, columns[j]); 
+	int *parse_integer = (int *) calloc (maxcol + 1, sizeof(int)); 
+	for (j = 0; j < num_cols; j++) {
+		if (integers != NULL && integers[j]) parse_integer[columns[j]] = 1; 
+	} 
+	#ifdef _OPENMP 
+		num_threads = min(omp_get_max_threads(), num_files); 
+	#endif /* _OPENMP */ 
+	long capacity = max(1l, (long) (budget / num_threads / row_bytes)); 
+	*runs = (SORT_RUN *) malloc (capacity_runs * sizeof(SORT_RUN)); 
+	*num_runs = 0l; 
+
+	#pragma omp parallel num_threads(num_threads) 
+	{
+		double *rows = (double *) malloc (capacity * num_cols * 
+			sizeof(double)); 
+		CHUNK_ENTRY *entries = (CHUNK_ENTRY *) malloc (capacity * 
+			sizeof(CHUNK_ENTRY)); 
+		double *values = (double *) malloc ((maxcol + 1) * sizeof(double)); 
+		char *line = (char *) malloc (LINESIZE * sizeof(char)); 
+
+		#pragma omp for schedule(dynamic, 1) 
+		for (f = 0; f < num_files; f++) {
+			int stop; 
+			#pragma omp atomic read 
+			stop = failed; 
+			if (stop) continue; 
+			FILE *in = fopen(files[f], "r"); 
+			if (in == NULL) {
+				#pragma omp atomic write 
+				failed = 1; 
+				continue; 
+			} else {} 
+			long chunk = 0l, length; 
+			do {
+				SORT_RUN run; 
+				run.file = f; 
+				run.chunk = chunk++; 
+				if (read_chunk(in, line, comment, columns, num_cols, integers, 
+					maxcol, parse_integer, values, rows, capacity, &length) || 
+					(length && spill_run(rows, length, num_cols, key, integer, 
+						descending, entries, tmpdir, &run))) {
+					#pragma omp atomic write 
+					failed = 1; 
+					break; 
+				} else if (length) {
+					#pragma omp critical (external_runs) 
+					{
+						if (*num_runs == capacity_runs) {
+							capacity_runs *= 2l; 
+							*runs = (SORT_RUN *) realloc (*runs, 
+								capacity_runs * sizeof(SORT_RUN)); 
+						} else {} 
+						(*runs)[(*num_runs)++] = run; 
+					} 
+				} else {} 
+			} while (length == capacity); 
+			fclose(in); 
+		} 
+
+		free(rows); 
+		free(entries); 
+		free(values); 
+		free(line); 
+	} 
+	free(parse_integer); 
+
+	if (failed) {
+		remove_runs(*runs, *num_runs); 
+		*runs = NULL; 
+		*num_runs = 0l; 
+		return 1; 
+	} else {
+		/* Threads finish runs in any order; put them back in input order */ 
+		qsort(*runs, *num_runs, sizeof(SORT_RUN), compare_runs); 
+		return 0; 
+	} 
+
+} 
+
+/* 
+ * Reads up to a chunk's worth of rows from a file. 
+ * 
+ * Parameters 
+ * ========== 
+ * in: 			The open file 
+ * line: 		Room for a line of the file 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the file to read 
+ * num_cols: 	The number of columns 
+ * integers: 	Which of the columns hold integers; NULL for none 
+ * maxcol: 		The largest of the column numbers 
+ * parse_integer: Which columns of the file up to maxcol to parse as integers 
+ * values: 		Room for the values of a row up to maxcol 
+ * rows: 		The chunk to fill, row-major 
+ * capacity: 	The number of rows the chunk can hold 
+ * length: 		Pointer to the number of rows read 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if a line has too few columns 
+ */ 
+static int read_chunk(FILE *in, char *line, char comment, int *columns, 
+	int num_cols, int *integers, int maxcol, int *parse_integer, 
+	double *values, double *rows, long capacity, long *length) {
+
+	int j; 
+	*length = 0l; 
+	while (*length < capacity && fgets(line, LINESIZE, in) != NULL) {
+		char *pos = line, *end; 
+		if (line[0] == comment) continue; 
+		for (j = 0; j <= maxcol; j++) {
+			if (parse_integer[j]) {
+				long long x = strtoll(pos, &end, 10); 
+				if (end != pos && *end != '\0' && 
+					!isspace((unsigned char) *end)) {
+					/* Not written as an integer, e.g. 1e+06 */ 
+					x = (long long) strtod(pos, &end); 
+				} else {} 
+				memcpy(values + j, &x, sizeof(double)); 
+			} else {
+				values[j] = strtod(pos, &end); 
+			} 
+			if (end == pos) break; 
+			pos = end; 
+		} 
+		if (j == 0) {
+			continue; /* a blank line */ 
+		} else if (j <= maxcol) {
+			return 1; 
+		} else {
+			double *row = rows + *length * num_cols; 
+			for (j = 0; j < num_cols; j++) {
+				if (parse_integer[columns[j]] && 
+					!(integers != NULL && integers[j])) {
+					/* The same file column also carried as a double */ 
+					long long x; 
+					memcpy(&x, values + columns[j], sizeof(double)); 
+					row[j] = x; 
+				} else {
+					row[j] = values[columns[j]]; 
+				} 
+			} 
+			(*length)++; 
+		} 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Sorts a chunk of rows and writes them to a temporary file. 
+ * 
+ * Parameters 
+ * ========== 
+ * rows: 		The chunk, row-major 
+ * length: 		The number of rows in the chunk 
+ * num_cols: 	The number of columns 
+ * key: 		The column to sort by 
+ * integer: 	Whether or not the key column holds integers 
+ * descending: 	1 to sort from high to low, 0 for low to high 
+ * entries: 	Room for the sort key of each row 
+ * tmpdir: 		The directory to write the run to 
+ * run: 		The run to record the file name and length in 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to write the run 
+ */ 
+static int spill_run(double *rows, long length, int num_cols, int key, 
+	int integer, int descending, CHUNK_ENTRY *entries, char *tmpdir, 
+	SORT_RUN *run) {
+
+	long i; 
+	int status = 0; 
+	for (i = 0l; i < length; i++) {
+		entries[i].key = external_key(rows + i * num_cols, key, integer, 
+			descending); 
+		entries[i].row = i; 
+	} 
+	/* Ties break on the row number, so the sort is stable */ 
+	qsort(entries, length, sizeof(CHUNK_ENTRY), compare_entries); 
+
+	FILE *out = temporary_file(tmpdir, &(run -> path)); 
+	if (out == NULL) return 1; 
+	for (i = 0l; i < length; i++) {
+		if (fwrite(rows + entries[i].row * num_cols, sizeof(double), 
+			num_cols, out) != (unsigned long) num_cols) {
+			status = 1; 
+			break; 
+		} else {} 
+	} 
+	if (fclose(out)) status = 1; 
+	if (status) {
+		remove(run -> path); 
+		free(run -> path); 
+	} else {
+		run -> num_rows = length; 
+	} 
+	return status; 
+
+} 
+
+/* 
+ * Merges sorted runs through a loser tree, handing the merged rows to a 
+ * sink in blocks. 
+ * 
+ * Parameters 
+ * ========== 
+ * runs: 		The runs to merge, in input order 
+ * k: 			The number of runs 
+ * num_cols: 	The number of columns 
+ * key: 		The column the runs are sorted by 
+ * integer: 	Whether or not the key column holds integers 
+ * descending: 	1 if the runs are sorted from high to low, 0 if low to high 
+ * budget: 		The number of bytes the read and write buffers may take up 
+ * sink: 		Called with each block of merged rows 
+ * state: 		Passed through to the sink 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to read a run or if the sink returns nonzero 
+ * 
+ * Notes 
+ * ===== 
+ * Internal node t of the tree holds the loser of the match between its 
+ * children 2t and 2t + 1, where node k + i is run i, and tree[0] holds the 
+ * overall winner. Advancing the winner only replays the matches on its 
+ * path to the root, so each row costs log2(k) comparisons. 
+ */ 
+static int merge_runs(SORT_RUN *runs, int k, int num_cols, int key, 
+	int integer, int descending, unsigned long budget, ROW_SINK sink, 
+	void *state) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * capacity: 	The number of rows in each buffer 
+	 * merging: 	The runs being read back 
+	 * tree: 		The loser tree 
+	 * out: 		The block of merged rows for the sink 
+	 * length: 		The number of rows in the block 
+	 */ 
+	int i, w, t, status = 0; 
+	long length = 0l; 
+	long capacity = max(1l, (long) (budget / (k + 1) / 
+		(num_cols * sizeof(double)))); 
+	MERGE_RUN *merging = (MERGE_RUN *) calloc (k, sizeof(MERGE_RUN)); 
+	int *tree = (int *) malloc (k * sizeof(int)); 
+	double *out = (double *) malloc (capacity * num_cols * sizeof(double)); 
+
+	for (i = 0; i < k; i++) {
+		merging[i].in = fopen(runs[i].path, "rb"); 
+		merging[i].buffer = (double *) malloc (capacity * num_cols * 
+			sizeof(double)); 
+		merging[i].remaining = runs[i].num_rows; 
+		merging[i].position = -1l; 
+		if (merging[i].in == NULL || run_advance(&merging[i], num_cols, key, 
+			integer, descending, capacity)) status = 1; 
+	} 
+
+	if (!status) {
+		tree[0] = loser_tree_build(merging, k, tree, 1); 
+		while (!merging[tree[0]].exhausted) {
+			w = tree[0]; 
+			memcpy(out + length * num_cols, merging[w].buffer + 
+				merging[w].position * num_cols, num_cols * sizeof(double)); 
+			if (++length == capacity) {
+				if (sink(out, length, num_cols, state)) {
+					status = 1; 
+					break; 
+				} else {
+					length = 0l; 
+				} 
+			} else {} 
+			if (run_advance(&merging[w], num_cols, key, integer, descending, 
+				capacity)) {
+				status = 1; 
+				break; 
+			} else {} 
+			/* Replay the winner's path to the root */ 
+			for (t = (w + k) / 2; t > 0; t /= 2) {
+				if (run_beats(merging, tree[t], w)) {
+					int loser = w; 
+					w = tree[t]; 
+					tree[t] = loser; 
+				} else {} 
+			} 
+			tree[0] = w; 
+		} 
+		if (!status && length && sink(out, length, num_cols, state)) {
+			status = 1; 
+		} else {} 
+	} else {} 
+
+	for (i = 0; i < k; i++) {
+		if (merging[i].in != NULL) fclose(merging[i].in); 
+		free(merging[i].buffer); 
+	} 
+	free(merging); 
+	free(tree); 
+	free(out); 
+	return status; 
+
+} 
+
+/* 
+ * Moves a run being merged on to its next row, refilling its buffer from 
+ * the file when it runs out. 
+ * 
+ * Parameters 
+ * ========== 
+ * run: 		The run 
+ * num_cols: 	The number of columns 
+ * key: 		The column the run is sorted by 
+ * integer: 	Whether or not the key column holds integers 
+ * descending: 	1 if the run is sorted from high to low, 0 if low to high 
+ * capacity: 	The number of rows the buffer can hold 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to read the file 
+ */ 
+static int run_advance(MERGE_RUN *run, int num_cols, int key, int integer, 
+	int descending, long capacity) {
+
+	run -> position++; 
+	if ((*run).position == (*run).length) {
+		if ((*run).remaining == 0l) {
+			run -> exhausted = 1; 
+			return 0; 
+		} else {
+			long n = min(capacity, (*run).remaining); 
+			if (fread(run -> buffer, num_cols * sizeof(double), n, 
+				(*run).in) != (unsigned long) n) return 1; 
+			run -> remaining -= n; 
+			run -> length = n; 
+			run -> position = 0l; 
+		} 
+	} else {} 
+	run -> key = external_key((*run).buffer + (*run).position * num_cols, 
+		key, integer, descending); 
+	return 0; 
+
+} 
+
+/* 
+ * Determines whether the head of one run comes before the head of another 
+ * in the merged order. Exhausted runs lose every match, and ties go to the 
+ * earlier run, which keeps the merge stable. 
+ */ 
+static int run_beats(MERGE_RUN *runs, int a, int b) {
+
+	if (runs[a].exhausted) {
+		return 0; 
+	} else if (runs[b].exhausted) {
+		return 1; 
+	} else if (runs[a].key != runs[b].key) {
+		return runs[a].key < runs[b].key; 
+	} else {
+		return a < b; 
+	} 
+
+} 
+
+/* 
+ * Plays the matches of a loser tree below a given node, recording the 
+ * loser at each internal node and returning the winner. 
+ */ 
+static int loser_tree_build(MERGE_RUN *runs, int k, int *tree, int node) {
+
+	if (node >= k) return node - k; 
+	int a = loser_tree_build(runs, k, tree, 2 * node); 
+	int b = loser_tree_build(runs, k, tree, 2 * node + 1); 
+	if (run_beats(runs, a, b)) {
+		tree[node] = b; 
+		return a; 
+	} else {
+		tree[node] = a; 
+		return b; 
+	} 
+
+} 
+
+/* 
+ * Maps the key of a row onto an unsigned integer with the same order, 
+ * flipped for a descending sort. NaNs map to the largest integer in either 
+ * direction, and -0 to the same integer as 0. 
+ */ 
+static unsigned long long external_key(double *row, int key, int integer, 
+	int descending) {
+
+	unsigned long long bits; 
+	if (integer) {
+		memcpy(&bits, row + key, sizeof(double)); 
+		bits ^= 1ull << 63; 
+	} else {
+		double value = row[key]; 
+		if (isnan(value)) return ~0ull; 
+		if (value == 0) value = 0; /* -0 ties with 0 */ 
+		memcpy(&bits, &value, sizeof(double)); 
+		bits = (bits >> 63) ? ~bits : bits | (1ull << 63); 
+	} 
+	return descending ? ~bits : bits; 
+
+} 
+
+/* 
+ * Creates and opens a uniquely named file in a directory for writing. 
+ * 
+ * Parameters 
+ * ========== 
+ * tmpdir: 		The directory (NULL for $TMPDIR or /tmp) 
+ * path: 		Pointer to the name of the file, allocated here 
+ * 
+ * Returns 
+ * ======= 
+ * The open file; NULL on failure, in which case path is not allocated 
+ */ 
+static FILE *temporary_file(char *tmpdir, char **path) {
+
+	if (tmpdir == NULL) tmpdir = getenv("TMPDIR"); 
+	if (tmpdir == NULL) tmpdir = "/tmp"; 
+	*path = (char *) malloc ((strlen(tmpdir) + 24) * sizeof(char)); 
+	sprintf(*path, "%s/ultra-sort-XXXXXX", tmpdir); 
+	int fd = mkstemp(*path); 
+	FILE *out = fd == -1 ? NULL : fdopen(fd, "wb"); 
+	if (out == NULL) {
+		if (fd != -1) {
+			close(fd); 
+			remove(*path); 
+		} else {} 
+		free(*path); 
+		*path = NULL; 
+	} else {} 
+	return out; 
+
+} 
+
+/* A sink appending rows to an intermediate run */ 
+static int run_file_sink(double *rows, long n, int num_cols, void *state) {
+
+	return fwrite(rows, num_cols * sizeof(double), n, (FILE *) state) != 
+		(unsigned long) n; 
+
+} 
+
+/* A sink writing rows to a binary file, as raw row-major 8-byte values */ 
+static int binary_sink(double *rows, long n, int num_cols, void *state) {
+
+	return run_file_sink(rows, n, num_cols, state); 
+
+} 
+
+/* 
+ * A sink writing rows to an ASCII file (state is a TEXT_OUTPUT), one line 
+ * per row with its values separated by tabs. Doubles are written with 17 
+ * significant digits, enough to read every one back exactly. 
+ */ 
+static int text_sink(double *rows, long n, int num_cols, void *state) {
+
+	long i; 
+	int j; 
+	TEXT_OUTPUT *text = (TEXT_OUTPUT *) state; 
+	for (i = 0l; i < n; i++) {
+		for (j = 0; j < num_cols; j++) {
+			double *value = rows + i * num_cols + j; 
+			int written; 
+			if ((*text).integers != NULL && (*text).integers[j]) {
+				long long x; 
+				memcpy(&x, value, sizeof(double)); 
+				written = fprintf((*text).out, "%lld", x); 
+			} else {
+				written = fprintf((*text).out, "%.17g", *value); 
+			} 
+			if (written < 0 || fputc(j < num_cols - 1 ? '\t' : '\n', 
+				(*text).out) == EOF) return 1; 
+		} 
+	} 
+	return 0; 
+
+} 
+
+/* Deletes the files of a set of runs and frees them */ 
+static void remove_runs(SORT_RUN *runs, long num_runs) {
+
+	long i; 
+	for (i = 0l; i < num_runs; i++) {
+		if (runs[i].path != NULL) {
+			remove(runs[i].path); 
+			free(runs[i].path); 
+		} else {} 
+	} 
+	free(runs); 
+
+} 
+
+/* Orders chunk entries by their keys and then by row number */ 
+static int compare_entries(const void *a, const void *b) {
+
+	const CHUNK_ENTRY *x = (const CHUNK_ENTRY *) a; 
+	const CHUNK_ENTRY *y = (const CHUNK_ENTRY *) b; 
+	if ((*x).key != (*y).key) return (*x).key < (*y).key ? -1 : 1; 
+	return ((*x).row > (*y).row) - ((*x).row < (*y).row); 
+
+} 
+
+/* Orders runs by the file they came from and then by chunk */ 
+static int compare_runs(const void *a, const void *b) {
+
+	const SORT_RUN *x = (const SORT_RUN *) a; 
+	const SORT_RUN *y = (const SORT_RUN *) b; 
+	if ((*x).file != (*y).file) return (*x).file - (*y).file; 
+	return ((*x).chunk > (*y).chunk) - ((*x).chunk < (*y).chunk); 
+
+} 
+
@@ -0,0 +1,498 @@
+/* 
+ * This file scripts the group-by engine, which splits the rows of a dataframe 
+ * into groups sharing the values in one or more key columns, as in the 
+ * subhalos of each host (PID) or the halos of each merger tree. Each row is 
+ * given the number of its group, after which group_statistic (see 
+ * dataframe_statistics.c) takes the statistics of any column within every 
+ * group. The groups are found in one of two ways: 
+ * 
+ * hash: 	Each block of rows gets its own hash table of the distinct keys 
+ * 			in it, built in parallel, and the tables are merged at the end. 
+ * 			This is fastest when there are few groups. 
+ * sort: 	The rows are radix sorted on their keys, and the groups are the 
+ * 			runs of equal keys. This is fastest when most keys are distinct. 
+ * 
+ * Either way the groups are numbered in ascending order of their keys, so 
+ * the two give identical results. Rows missing a key, or holding a NaN in 
+ * one, are in no group. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The number of rows sampled to estimate the number of groups */ 
+#ifndef GROUPBY_SAMPLE_SIZE 
+#define GROUPBY_SAMPLE_SIZE 4096l 
+#endif /* GROUPBY_SAMPLE_SIZE */ 
+
+/* 
+ * The hash table of the distinct keys in a block of rows 
+ * 
+ * Fields 
+ * ====== 
+ * slots: 		The group in each slot; -1 for empty slots 
+ * firsts: 		The first row of each group 
+ * capacity: 	The number of slots, a power of 2 
+ * size: 		The number of groups 
+ */ 
+typedef struct group_table {
+
+	long *slots; 
+	long *firsts; 
+	long capacity; 
+	long size; 
+
+} GROUP_TABLE; 
+
+/* 
+ * A group or row to sort by its keys 
+ * 
+ * Fields 
+ * ====== 
+ * keys: 		Its keys, as from column_key 
+ * index: 		The group or row number, which breaks ties 
+ * num_keys: 	The number of keys 
+ */ 
+typedef struct group_entry {
+
+	unsigned long long *keys; 
+	long index; 
+	int num_keys; 
+
+} GROUP_ENTRY; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static unsigned long long *group_keys(DATAFRAME df, int *columns, 
+	int num_keys, long *groups); 
+static int estimate_few_groups(unsigned long long *keys, int num_keys, 
+	long *groups, long num_rows); 
+static void hash_groups(unsigned long long *keys, int num_keys, long *groups, 
+	long num_rows, long *num_groups, long **first); 
+static void sort_groups(DATAFRAME df, int *columns, unsigned long long *keys, 
+	int num_keys, long *groups, long *num_groups, long **first); 
+static void table_initialize(GROUP_TABLE *t, long capacity); 
+static long table_find(GROUP_TABLE *t, unsigned long long *keys, 
+	int num_keys, long row); 
+static unsigned long long tuple_hash(unsigned long long *key, int num_keys); 
+static int entry_compare(const void *a, const void *b); 
+
+/* 
+ * Splits the rows of a dataframe into groups sharing the values in a set of 
+ * key columns. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers of the keys 
+ * num_keys: 		The number of keys 
+ * strategy: 		GROUPBY_HASH, GROUPBY_SORT, or GROUPBY_AUTO to hash if a 
+ * 					sample of the rows holds few distinct keys and sort if not 
+ * groups: 			A pointer to put the group number of each row into, with 
+ * 					df.num_rows elements; -1 for rows missing a key 
+ * num_groups: 		A pointer to put the number of groups into 
+ * first: 			A pointer to put an array of the first row of each group 
+ * 					into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfgroup(DATAFRAME df, int *columns, int num_keys, int strategy, 
+	long *groups, long *num_groups, long **first) {
+
+	int k; 
+	if (num_keys < 1) return 1; 
+	if (strategy < GROUPBY_HASH || strategy > GROUPBY_AUTO) return 1; 
+	for (k = 0; k < num_keys; k++) {
+		if (columns[k] < 0 || columns[k] >= df.num_cols) return 1; 
+	} 
+	unsigned long long *keys = group_keys(df, columns, num_keys, groups); 
+	if (strategy == GROUPBY_AUTO) {
+		strategy = estimate_few_groups(keys, num_keys, groups, 
+			df.num_rows) ? GROUPBY_HASH : GROUPBY_SORT; 
+	} else {} 
+	if (strategy == GROUPBY_HASH) {
+		hash_groups(keys, num_keys, groups, df.num_rows, num_groups, first); 
+	} else {
+		sort_groups(df, columns, keys, num_keys, groups, num_groups, first); 
+	} 
+	free(keys); 
+	return 0; 
+
+} 
+
+/* 
+ * Makes a dataframe a view of the key columns of another at the first row 
+ * of each of its groups, i.e. a table of the distinct keys. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The grouped dataframe 
+ * columns: 		The column numbers of the keys 
+ * num_keys: 		The number of keys 
+ * first: 			The first row of each group, as from dfgroup 
+ * num_groups: 		The number of groups 
+ * dest: 			A pointer to an empty dataframe to make the view 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfgroup_keys(DATAFRAME df, int *columns, int num_keys, 
+	long *first, long num_groups, DATAFRAME *dest) {
+
+	int k; 
+	long g; 
+	for (k = 0; k < num_keys; k++) {
+		if (columns[k] < 0 || columns[k] >= df.num_cols) return 1; 
+	} 
+	dataframe_reserve_columns(dest, num_keys); 
+	for (k = 0; k < num_keys; k++) {
+		column_buffer_retain(df.columns[columns[k]]); 
+		dest -> columns[k] = df.columns[columns[k]]; 
+	} 
+	dest -> num_cols = num_keys; 
+	dest -> num_rows = num_groups; 
+	dest -> offset = 0l; 
+	dest -> index = (long *) malloc ((num_groups > 0l ? num_groups : 1l) * 
+		sizeof(long)); 
+	for (g = 0l; g < num_groups; g++) {
+		dest -> index[g] = dfrow_index(df, first[g]); 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Takes the keys of every row of a dataframe. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * columns: 	The column numbers of the keys 
+ * num_keys: 	The number of keys 
+ * groups: 		A pointer to put 0 at the rows with every key and -1 at the 
+ * 				rows missing any into 
+ * 
+ * Returns 
+ * ======= 
+ * The keys, those of row i at [i * num_keys] through 
+ * [i * num_keys + num_keys - 1] 
+ */ 
+static unsigned long long *group_keys(DATAFRAME df, int *columns, 
+	int num_keys, long *groups) {
+
+	long i; 
+	unsigned long long *keys = (unsigned long long *) malloc ((df.num_rows > 
+		0l ? df.num_rows : 1l) * num_keys * sizeof(unsigned long long)); 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < df.num_rows; i++) {
+		int k; 
+		groups[i] = 0l; 
+		for (k = 0; k < num_keys; k++) {
+			COLUMN_BUFFER *buffer = df.columns[columns[k]]; 
+			if (!column_key(buffer, dfrow_index(df, i), 
+				column_is_integer((*buffer).type), keys + i * num_keys + k)) {
+				groups[i] = -1l; 
+			} else {} 
+		} 
+	} 
+	return keys; 
+
+} 
+
+/* 
+ * Determine whether or not a sample of evenly spaced rows holds few enough 
+ * distinct keys that a hash table of them all would be small. 
+ * 
+ * Parameters 
+ * ========== 
+ * keys: 		The keys of each row 
+ * num_keys: 	The number of keys 
+ * groups: 		-1 at the rows missing a key 
+ * num_rows: 	The number of rows 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if at most half of the sampled keys are distinct, 0 if not 
+ */ 
+static int estimate_few_groups(unsigned long long *keys, int num_keys, 
+	long *groups, long num_rows) {
+
+	long i, n = 0l, distinct = 0l; 
+	long step = max(num_rows / GROUPBY_SAMPLE_SIZE, 1l); 
+	GROUP_ENTRY *sample = (GROUP_ENTRY *) malloc (GROUPBY_SAMPLE_SIZE * 
+		sizeof(GROUP_ENTRY)); 
+	for (i = 0l; i < num_rows && n < GROUPBY_SAMPLE_SIZE; i += step) {
+		if (groups[i] == -1l) continue; 
+		sample[n].keys = keys + i * num_keys; 
+		sample[n].index = i; 
+		sample[n++].num_keys = num_keys; 
+	} 
+	qsort(sample, n, sizeof(GROUP_ENTRY), entry_compare); 
+	for (i = 0l; i < n; i++) {
+		distinct += !i || memcmp(sample[i].keys, sample[i - 1l].keys, 
+			num_keys * sizeof(unsigned long long)); 
+	} 
+	free(sample); 
+	return 2l * distinct <= n; 
+
+} 
+
+/* 
+ * Numbers the groups of the rows of a dataframe with hash tables. The rows 
+ * are split into blocks, one per thread, each of which gets its own table 
+ * of the groups in it. These are then merged into one table, whose groups 
+ * are sorted by their keys. 
+ * 
+ * Parameters 
+ * ========== 
+ * keys: 			The keys of each row 
+ * num_keys: 		The number of keys 
+ * groups: 			-1 at the rows missing a key. The group number of each 
+ * 					row is put here. 
+ * num_rows: 		The number of rows 
+ * num_groups: 		A pointer to put the number of groups into 
+ * first: 			A pointer to put an array of the first row of each group 
+ * 					into 
+ */ 
+static void hash_groups(unsigned long long *keys, int num_keys, long *groups, 
+	long num_rows, long *num_groups, long **first) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * tables: 		The hash table of each block of rows 
+	 * maps: 		The number in the merged table of each group of each block 
+	 * ranks: 		The final number of each group of the merged table 
+	 */ 
+	long b, g, num_blocks = 1l; 
+	#ifdef _OPENMP 
+	num_blocks = omp_get_max_threads(); 
+	#endif /* _OPENMP */ 
+	GROUP_TABLE *tables = (GROUP_TABLE *) malloc (num_blocks * 
+		sizeof(GROUP_TABLE)); 
+	#pragma omp parallel for schedule(static, 1) 
+	for (b = 0l; b < num_blocks; b++) {
+		long i; 
+		table_initialize(tables + b, 64l); 
+		for (i = num_rows * b / num_blocks; i < num_rows * (b + 1l) / 
+			num_blocks; i++) {
+			if (groups[i] != -1l) groups[i] = table_find(tables + b, keys, 
+				num_keys, i); 
+		} 
+	} 
+
+	/* 
+	 * Each block's groups appear in the order of their first rows, and the 
+	 * blocks are merged in order, so the merged table has the first row of 
+	 * each group overall. 
+	 */ 
+	GROUP_TABLE merged; 
+	table_initialize(&merged, 64l); 
+	long **maps = (long **) malloc (num_blocks * sizeof(long *)); 
+	for (b = 0l; b < num_blocks; b++) {
+		maps[b] = (long *) malloc ((tables[b].size > 0l ? tables[b].size : 
+			1l) * sizeof(long)); 
+		for (g = 0l; g < tables[b].size; g++) {
+			maps[b][g] = table_find(&merged, keys, num_keys, 
+				tables[b].firsts[g]); 
+		} 
+		free(tables[b].slots); 
+		free(tables[b].firsts); 
+	} 
+	free(tables); 
+
+	GROUP_ENTRY *sorted = (GROUP_ENTRY *) malloc ((merged.size > 0l ? 
+		merged.size : 1l) * sizeof(GROUP_ENTRY)); 
+	long *ranks = (long *) malloc ((merged.size > 0l ? merged.size : 1l) * 
+		sizeof(long)); 
+	*first = (long *) malloc ((merged.size > 0l ? merged.size : 1l) * 
+		sizeof(long)); 
+	for (g = 0l; g < merged.size; g++) {
+		sorted[g].keys = keys + merged.firsts[g] * num_keys; 
+		sorted[g].index = g; 
+		sorted[g].num_keys = num_keys; 
+	} 
+	qsort(sorted, merged.size, sizeof(GROUP_ENTRY), entry_compare); 
+	for (g = 0l; g < merged.size; g++) {
+		ranks[sorted[g].index] = g; 
+		(*first)[g] = merged.firsts[sorted[g].index]; 
+	} 
+	#pragma omp parallel for schedule(static, 1) 
+	for (b = 0l; b < num_blocks; b++) {
+		long i; 
+		for (i = num_rows * b / num_blocks; i < num_rows * (b + 1l) / 
+			num_blocks; i++) {
+			if (groups[i] != -1l) groups[i] = ranks[maps[b][groups[i]]]; 
+		} 
+	} 
+	*num_groups = merged.size; 
+
+	for (b = 0l; b < num_blocks; b++) {
+		free(maps[b]); 
+	} 
+	free(maps); 
+	free(merged.slots); 
+	free(merged.firsts); 
+	free(sorted); 
+	free(ranks); 
+
+} 
+
+/* 
+ * Numbers the groups of the rows of a dataframe by sorting the rows on their 
+ * keys (see dfcolumns_argsort). The sort is stable, so the first row of each 
+ * group comes first. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers of the keys 
+ * keys: 			The keys of each row 
+ * num_keys: 		The number of keys 
+ * groups: 			-1 at the rows missing a key. The group number of each 
+ * 					row is put here. 
+ * num_groups: 		A pointer to put the number of groups into 
+ * first: 			A pointer to put an array of the first row of each group 
+ * 					into 
+ */ 
+static void sort_groups(DATAFRAME df, int *columns, unsigned long long *keys, 
+	int num_keys, long *groups, long *num_groups, long **first) {
+
+	long i, prev = -1l, g = -1l; 
+	long *order = (long *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	int *descending = (int *) calloc (num_keys, sizeof(int)); 
+	dfcolumns_argsort(df, columns, descending, num_keys, order); 
+	*first = (long *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		long row = order[i]; 
+		if (groups[row] == -1l) continue; 
+		if (prev == -1l || memcmp(keys + row * num_keys, keys + prev * 
+			num_keys, num_keys * sizeof(unsigned long long))) {
+			(*first)[++g] = row; 
+		} else {} 
+		groups[row] = g; 
+		prev = row; 
+	} 
+	*num_groups = g + 1l; 
+	free(descending); 
+	free(order); 
+
+} 
+
+/* 
+ * Allocates the memory for an empty hash table of groups. 
+ * 
+ * Parameters 
+ * ========== 
+ * t: 			The table 
+ * capacity: 	The number of slots to start with, a power of 2 
+ */ 
+static void table_initialize(GROUP_TABLE *t, long capacity) {
+
+	t -> capacity = capacity; 
+	t -> size = 0l; 
+	t -> slots = (long *) malloc (capacity * sizeof(long)); 
+	t -> firsts = (long *) malloc ((capacity / 2l) * sizeof(long)); 
+	memset(t -> slots, 0xff, capacity * sizeof(long)); 
+
+} 
+
+/* 
+ * Finds the group holding the keys of a given row in a hash table, adding 
+ * it if it's not there. The table doubles in size whenever it's half full. 
+ * 
+ * Parameters 
+ * ========== 
+ * t: 			The table 
+ * keys: 		The keys of each row 
+ * num_keys: 	The number of keys 
+ * row: 		The row 
+ * 
+ * Returns 
+ * ======= 
+ * The group number within the table 
+ */ 
+static long table_find(GROUP_TABLE *t, unsigned long long *keys, 
+	int num_keys, long row) {
+
+	unsigned long long *key = keys + row * num_keys; 
+	unsigned long long mask = (unsigned long long) (*t).capacity - 1ull; 
+	unsigned long long slot = tuple_hash(key, num_keys) & mask; 
+	while ((*t).slots[slot] != -1l) {
+		/* Linear probing */ 
+		if (!memcmp(keys + (*t).firsts[(*t).slots[slot]] * num_keys, key, 
+			num_keys * sizeof(unsigned long long))) {
+			return (*t).slots[slot]; 
+		} else {
+			slot = (slot + 1ull) & mask; 
+		} 
+	} 
+	t -> slots[slot] = (*t).size; 
+	t -> firsts[(*t).size] = row; 
+	if (++(t -> size) == (*t).capacity / 2l) {
+		long g; 
+		t -> capacity *= 2l; 
+		mask = (unsigned long long) (*t).capacity - 1ull; 
+		t -> slots = (long *) realloc (t -> slots, (*t).capacity * 
+			sizeof(long)); 
+		t -> firsts = (long *) realloc (t -> firsts, ((*t).capacity / 2l) * 
+			sizeof(long)); 
+		memset(t -> slots, 0xff, (*t).capacity * sizeof(long)); 
+		for (g = 0l; g < (*t).size; g++) {
+			slot = tuple_hash(keys + (*t).firsts[g] * num_keys, num_keys) & 
+				mask; 
+			while ((*t).slots[slot] != -1l) slot = (slot + 1ull) & mask; 
+			t -> slots[slot] = g; 
+		} 
+	} else {} 
+	return (*t).size - 1l; 
+
+} 
+
+/* 
+ * Hashes the keys of a row together. 
+ */ 
+static unsigned long long tuple_hash(unsigned long long *key, int num_keys) {
+
+	int k; 
+	unsigned long long h = 0x9E3779B97F4A7C15ull; 
+	for (k = 0; k < num_keys; k++) {
+		h = key_hash(h ^ key[k]); 
+	} 
+	return h; 
+
+} 
+
+/* 
+ * Compares two groups or rows by their keys, in order of the key columns, 
+ * then by their numbers, for qsort. 
+ */ 
+static int entry_compare(const void *a, const void *b) {
+
+	int k; 
+	GROUP_ENTRY *x = (GROUP_ENTRY *) a, *y = (GROUP_ENTRY *) b; 
+	for (k = 0; k < (*x).num_keys; k++) {
+		if ((*x).keys[k] != (*y).keys[k]) {
+			return (*x).keys[k] < (*y).keys[k] ? -1 : 1; 
+		} else {
+			continue; 
+		} 
+	} 
+	return ((*x).index > (*y).index) - ((*x).index < (*y).index); 
+
+} 
@@ -0,0 +1,426 @@
+/* 
+ * This file scripts the sorted column indexes, which spare repeated range 
+ * selections, bins, and rank queries on the same column (e.g. binning a 
+ * catalog by mass over and over) a scan of every row. An index holds the 
+ * rows in sorted order of the column and every INDEX_FENCE_STRIDE'th value 
+ * in that order. A query binary searches the fences, which are contiguous, 
+ * then the one stretch of rows between two fences through the column, and 
+ * the rows in a range are then a contiguous stretch of the sorted rows. 
+ * 
+ * An index records the versions of the dataframe and the column buffer it 
+ * was built on (see version_stamp), and once either changes it is out of 
+ * date and the queries scan the rows instead. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The number of sorted rows per fence */ 
+#ifndef INDEX_FENCE_STRIDE 
+#define INDEX_FENCE_STRIDE 64l 
+#endif /* INDEX_FENCE_STRIDE */ 
+
+/* 
+ * Selections of more than one in this many rows are put back in order by 
+ * marking them rather than by sorting them 
+ */ 
+#ifndef INDEX_SORT_FRACTION 
+#define INDEX_SORT_FRACTION 32l 
+#endif /* INDEX_SORT_FRACTION */ 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static int index_bounds(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long long *integer, long *below, long *through); 
+static long count_passing(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long long *integer, int inclusive); 
+static int index_select(DATAFRAME source, DATAFRAME *dest, COLUMN_INDEX *idx, 
+	long start, long stop); 
+static int compare_rows(const void *a, const void *b); 
+
+/* 
+ * Allocates memory for a sorted index of a column of a dataframe, builds it, 
+ * and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number to index 
+ * 
+ * Returns 
+ * ======= 
+ * The index; NULL if the column number is out of range 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_INDEX *column_index_initialize(DATAFRAME df, int column) {
+
+	long i, f, num_valid = 0l; 
+	int ascending = 0; 
+	if (column < 0 || column >= df.num_cols) return NULL; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	int integer = column_is_integer((*buffer).type); 
+	COLUMN_INDEX *idx = (COLUMN_INDEX *) malloc (sizeof(COLUMN_INDEX)); 
+	idx -> rows = (long *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+		sizeof(long)); 
+	dfcolumns_argsort(df, &column, &ascending, 1, idx -> rows); 
+
+	/* The rows missing a value or holding a NaN were sorted last */ 
+	#pragma omp parallel for reduction(+:num_valid) 
+	for (i = 0l; i < df.num_rows; i++) {
+		unsigned long long key; 
+		num_valid += column_key(buffer, dfrow_index(df, i), integer, &key); 
+	} 
+	idx -> num_valid = num_valid; 
+	idx -> num_rows = df.num_rows; 
+	idx -> num_fences = (num_valid + INDEX_FENCE_STRIDE - 1l) / 
+		INDEX_FENCE_STRIDE; 
+	idx -> fences = (double *) malloc (((*idx).num_fences > 0l ? 
+		(*idx).num_fences : 1l) * sizeof(double)); 
+	idx -> integer_fences = integer ? (long long *) malloc ( 
+		((*idx).num_fences > 0l ? (*idx).num_fences : 1l) * 
+		sizeof(long long)) : NULL; 
+	for (f = 0l; f < (*idx).num_fences; f++) {
+		long j = dfrow_index(df, (*idx).rows[f * INDEX_FENCE_STRIDE]); 
+		idx -> fences[f] = column_value(buffer, j); 
+		if (integer) idx -> integer_fences[f] = column_integer(buffer, j); 
+	} 
+	idx -> buffer_version = (*buffer).version; 
+	idx -> version = df.version; 
+	return idx; 
+
+} 
+
+/* 
+ * Frees the memory stored by a column index. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void free_column_index(COLUMN_INDEX *idx) {
+
+	if (idx != NULL) {
+		free(idx -> rows); 
+		free(idx -> fences); 
+		if ((*idx).integer_fences != NULL) free(idx -> integer_fences); 
+		free(idx); 
+	} else {} 
+
+} 
+
+/* 
+ * Determine whether or not an index of a column still describes the 
+ * dataframe it was built on. Writes through a writable array of the column 
+ * don't change its version, so it's never current while one exists. 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if it does, 0 if it doesn't or the index is NULL 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int column_index_current(DATAFRAME df, int column, COLUMN_INDEX *idx) {
+
+	if (idx == NULL || column < 0 || column >= df.num_cols) return 0; 
+	return (!(*df.columns[column]).writers && 
+		(*idx).buffer_version == df.columns[column] -> version && 
+		(*idx).version == df.version && (*idx).num_rows == df.num_rows); 
+
+} 
+
+/* 
+ * Counts the values in a column of a dataframe below a given value. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * idx: 		An index of the column; NULL to scan the column 
+ * value: 		The value to count below 
+ * counts: 		A pointer to put the number of values less than the value, 
+ * 				the number less than or equal to it, and the number of values 
+ * 				which aren't missing or NaN into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_rank(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long *counts) {
+
+	if (column < 0 || column >= df.num_cols) return 1; 
+	if (column_index_current(df, column, idx)) {
+		index_bounds(df, column, idx, value, NULL, counts, counts + 1); 
+		counts[2] = (*idx).num_valid; 
+	} else {
+		long i, below = 0l, through = 0l, num_valid = 0l; 
+		COLUMN_BUFFER *buffer = df.columns[column]; 
+		#pragma omp parallel for reduction(+:below,through,num_valid) 
+		for (i = 0l; i < df.num_rows; i++) {
+			long j = dfrow_index(df, i); 
+			if (column_valid(buffer, j)) {
+				double x = column_value(buffer, j); 
+				below += x < value; 
+				through += x <= value; 
+				num_valid += !isnan(x); 
+			} else {} 
+		} 
+		counts[0] = below; 
+		counts[1] = through; 
+		counts[2] = num_valid; 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Filters a dataframe as sieve and sieve_integer do, taking the rows from 
+ * an index of the column where possible. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 				The dataframe to filter 
+ * dest: 				A pointer to the dataframe to make the view 
+ * column: 				The column number to filter based on 
+ * idx: 				An index of the column; NULL to scan the column 
+ * value: 				The value to compare to 
+ * integer: 			The same value as an integer, or NULL, as in 
+ * 						get_test_results (see dataframe_sieve.c) 
+ * relational_code: 	As in sieve 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int indexed_sieve(DATAFRAME source, DATAFRAME *dest, int column, 
+	COLUMN_INDEX *idx, double value, long long *integer, 
+	int relational_code) {
+
+	long below, through; 
+	if (relational_code == 6 || !column_index_current(source, column, idx)) {
+		return integer != NULL ? sieve_integer(source, dest, column, *integer, 
+			relational_code) : sieve(source, dest, column, value, 
+			relational_code); 
+	} else if (relational_code < 1 || relational_code > 6) {
+		return 1; 
+	} else {} 
+	if (!index_bounds(source, column, idx, value, integer, &below, &through)) {
+		/* Nothing compares to a NaN */ 
+		return index_select(source, dest, idx, 0l, 0l); 
+	} else {} 
+	switch (relational_code) {
+
+		case 1: 
+			return index_select(source, dest, idx, 0l, below); 
+
+		case 2: 
+			return index_select(source, dest, idx, 0l, through); 
+
+		case 3: 
+			return index_select(source, dest, idx, below, through); 
+
+		case 4: 
+			return index_select(source, dest, idx, below, (*idx).num_valid); 
+
+		default: 
+			return index_select(source, dest, idx, through, (*idx).num_valid); 
+
+	} 
+
+} 
+
+/* 
+ * Takes the rows of a dataframe in a bin of a column as dfcolumn_bin does, 
+ * taking them from an index of the column where possible. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 		The dataframe to take the rows of 
+ * dest: 		A pointer to the dataframe to make the view 
+ * column: 		The column number to bin based on 
+ * idx: 		An index of the column; NULL to scan the column 
+ * bin: 		The left and right bin edges, both inclusive 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int indexed_bin(DATAFRAME source, DATAFRAME *dest, int column, 
+	COLUMN_INDEX *idx, double *bin) {
+
+	long below, through, skip; 
+	if (!column_index_current(source, column, idx)) {
+		return dfcolumn_bin(source, dest, column, bin); 
+	} else {} 
+	if (index_bounds(source, column, idx, bin[0], NULL, &below, &skip) && 
+		index_bounds(source, column, idx, bin[1], NULL, &skip, &through)) {
+		return index_select(source, dest, idx, below, max(below, through)); 
+	} else {
+		/* Nothing falls in a bin with a NaN edge */ 
+		return index_select(source, dest, idx, 0l, 0l); 
+	} 
+
+} 
+
+/* 
+ * Determine the number of values in an indexed column below a given value 
+ * and the number at or below it, compared as get_test_results does (see 
+ * dataframe_sieve.c). NaNs count as neither. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * idx: 		An up to date index of the column 
+ * value: 		The value to compare to 
+ * integer: 	The same value as an integer, to compare an integer column to 
+ * 				exactly; NULL to compare as doubles 
+ * below: 		A pointer to put the number of values less than the value 
+ * through: 	A pointer to put the number of values at most the value 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if the value compares to others, 0 if it's a NaN, in which case both 
+ * counts are 0 
+ */ 
+static int index_bounds(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long long *integer, long *below, long *through) {
+
+	if (isnan(value) && integer == NULL) {
+		*below = *through = 0l; 
+		return 0; 
+	} else {
+		*below = count_passing(df, column, idx, value, integer, 0); 
+		*through = count_passing(df, column, idx, value, integer, 1); 
+		return 1; 
+	} 
+
+} 
+
+/* 
+ * Counts the sorted values of an indexed column which are less than, or at 
+ * most, a given value. These are the first ones, so the fences are binary 
+ * searched for the first which isn't, then the stretch of rows before it. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * idx: 		An up to date index of the column 
+ * value: 		The value to compare to 
+ * integer: 	The same value as an integer, or NULL 
+ * inclusive: 	1 to count the values at most the value, 0 those less than 
+ * 
+ * Returns 
+ * ======= 
+ * The number of values 
+ */ 
+static long count_passing(DATAFRAME df, int column, COLUMN_INDEX *idx, 
+	double value, long long *integer, int inclusive) {
+
+	long low = 0l, high = (*idx).num_fences, mid; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	int exact = integer != NULL && (*idx).integer_fences != NULL; 
+	while (low < high) {
+		mid = (low + high) / 2l; 
+		int passes = exact ? (inclusive ? 
+			(*idx).integer_fences[mid] <= *integer : 
+			(*idx).integer_fences[mid] < *integer) : (inclusive ? 
+			(*idx).fences[mid] <= value : (*idx).fences[mid] < value); 
+		if (passes) {
+			low = mid + 1l; 
+		} else {
+			high = mid; 
+		} 
+	} 
+	if (low == 0l) return 0l; 
+
+	/* Fence low - 1 passes and fence low, if there is one, doesn't */ 
+	high = min(low * INDEX_FENCE_STRIDE, (*idx).num_valid); 
+	low = (low - 1l) * INDEX_FENCE_STRIDE + 1l; 
+	while (low < high) {
+		mid = (low + high) / 2l; 
+		long j = dfrow_index(df, (*idx).rows[mid]); 
+		int passes; 
+		if (exact) {
+			long long x = column_integer(buffer, j); 
+			passes = inclusive ? x <= *integer : x < *integer; 
+		} else {
+			double x = column_value(buffer, j); 
+			passes = inclusive ? x <= value : x < value; 
+		} 
+		if (passes) {
+			low = mid + 1l; 
+		} else {
+			high = mid; 
+		} 
+	} 
+	return low; 
+
+} 
+
+/* 
+ * Makes a dataframe a view of the rows of another at a stretch of the 
+ * sorted rows of an index, in their original order. A short stretch is 
+ * sorted back into order; a long one marks its rows for one pass over the 
+ * dataframe, which is cheaper than sorting them. 
+* 
+ * Parameters 
+ * ========== 
+ * source: 		The indexed dataframe 
+ * dest: 		A pointer to the dataframe to make the view 
+ * idx: 		The index 
+ * start: 		The first of the sorted rows in the view 
+ * stop: 		One past the last of the sorted rows in the view 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ */ 
+static int index_select(DATAFRAME source, DATAFRAME *dest, COLUMN_INDEX *idx, 
+	long start, long stop) {
+
+	int status; 
+	long i, n = stop - start; 
+	long *rows = (long *) malloc ((n > 0l ? n : 1l) * sizeof(long)); 
+	if (n <= source.num_rows / INDEX_SORT_FRACTION) {
+		memcpy(rows, (*idx).rows + start, n * sizeof(long)); 
+		qsort(rows, n, sizeof(long), compare_rows); 
+	} else {
+		long k = 0l; 
+		char *marked = (char *) calloc (source.num_rows, sizeof(char)); 
+		#pragma omp parallel for schedule(static) 
+		for (i = start; i < stop; i++) {
+			marked[(*idx).rows[i]] = 1; 
+		} 
+		for (i = 0l; i < source.num_rows; i++) {
+			if (marked[i]) rows[k++] = i; 
+		} 
+		free(marked); 
+	} 
+	status = dataframe_select(source, dest, rows, n); 
+	free(rows); 
+	return status; 
+
+} 
+
+/* 
+ * qsort comparison function for row numbers in ascending order 
+ */ 
+static int compare_rows(const void *a, const void *b) {
+
+	long x = *((long *) a), y = *((long *) b); 
+	return (x > y) - (x < y); 
+
+} 
@@ -9,6 +9,12 @@
 #include "dataframe.h" 
 #include "utils.h" 
 
+/* The longest value in a file that can be read, and the format reading it */ 
+#ifndef TOKENSIZE 
+#define TOKENSIZE 64 
+#define TOKENFORMAT "%63s" 
+#endif /* TOKENSIZE */ 
+
 /* ---------- static routine comment headers not duplicated here ---------- */ 
 static int header_length(char *file, char comment); 
 static int file_dimension(char *file, int hlength); 
@@ -25,6 +31,10 @@ static long num_lines(char *file);
  * comment: 	The commenting character 
  * columns: 	The column numbers to take 
  * num_cols: 	The number of columns being imported 
+ * types: 		The type to store each column as, as the COLUMN_* codes in 
+ * 				dataframe.h. Integer columns are parsed as integers, so e.g. 
+ * 				IDs past 2^53 are read exactly. NULL to store them all as 
+ * 				float64. 
  * 
  * Returns 
  * ======= 
@@ -33,7 +43,7 @@ static long num_lines(char *file);
  * header: dataframe.h 
  */
 extern int populate_from_file(DATAFRAME *df, char *file, char comment, 
-	int *columns, int num_cols) {
+	int *columns, int num_cols, int *types) {
 
 	/* 
 	 * debugging 
@@ -49,9 +59,11 @@ extern int populate_from_file(DATAFRAME *df, char *file, char comment,
 	 * =========== 
 	 * hlen: 		The length of the header in the file 
 	 * dim: 		The dimensionality of the file 
+	 * capacity: 	The size of the arena holding all of the columns 
 	 * i, j: 		For-looping 
 	 */ 
 	long i; 
+	unsigned long capacity = 0ul; 
 	int j, hlen = header_length(file, comment); 
 	int dim = file_dimension(file, hlen); 
 	df -> num_rows = num_lines(file) - hlen; 
@@ -61,6 +73,9 @@ extern int populate_from_file(DATAFRAME *df, char *file, char comment,
 	if ((*df).num_rows == 0 || (*df).num_cols == -1) {
 		return 1; 
 	} else {} 
+	for (j = 0; j < num_cols; j++) {
+		if (types != NULL && !column_type_size(types[j])) return 1; 
+	} 
 
 	/* Open the file and read past the header */ 
 	FILE *in; 
@@ -76,14 +91,39 @@ extern int populate_from_file(DATAFRAME *df, char *file, char comment,
 	} 
 	free(line); 
 
-	/* Allocate memory for the data */ 
-	df -> data = (double **) malloc ((*df).num_rows * sizeof(double *)); 
+	/* 
+	 * Allocate memory for the data, one buffer per column, all carved from 
+	 * a single arena. 
+	 */ 
+	for (j = 0; j < (*df).num_cols; j++) {
+		capacity += column_buffer_footprint((*df).num_rows, 
+			types != NULL ? types[j] : COLUMN_FLOAT64); 
+	} 
+	ARENA *a = arena_initialize(capacity); 
+	df -> max_cols = (*df).num_cols; 
+	df -> columns = (COLUMN_BUFFER **) malloc ((*df).num_cols * 
+		sizeof(COLUMN_BUFFER *)); 
+	for (j = 0; j < (*df).num_cols; j++) {
+		df -> columns[j] = column_buffer_from_arena(a, (*df).num_rows, 
+			types != NULL ? types[j] : COLUMN_FLOAT64); 
+	} 
+	arena_release(a); /* The buffers hold it from here on */ 
+	df -> index = NULL; 
+	df -> offset = 0l; 
+
+	/* 
+	 * Each line is read as text and each value parsed both as a double and 
+	 * as an integer, so integer columns don't go through a double first. 
+	 */ 
+	char token[TOKENSIZE]; 
+	double *values = (double *) malloc (dim * sizeof(double)); 
+	long long *integers = (long long *) malloc (dim * sizeof(long long)); 
 	for (i = 0l; i < (*df).num_rows; i++) { 
 		/* Read in the next line */ 
-		double *line = (double *) malloc (dim * sizeof(double)); 
 		for (j = 0; j < dim; j++) {
-			if (fscanf(in, "%lf", &line[j])) {
-				continue; 
+			if (fscanf(in, TOKENFORMAT, token) == 1) {
+				values[j] = strtod(token, NULL); 
+				integers[j] = strtoll(token, NULL, 10); 
 			} else {
 				printf("ERROR reading file: %s\n", file); 
 				printf("Error code: io.5\n"); 
@@ -91,13 +131,32 @@ extern int populate_from_file(DATAFRAME *df, char *file, char comment,
 			} 
 		} 
 
-		/* Allocate memory for the next row of the data and copy it over */ 
-		df -> data[i] = (double *) malloc ((*df).num_cols * sizeof(double)); 
+		/* Copy the next row of the data into each column */ 
 		for (j = 0; j < (*df).num_cols; j++) { 
-			df -> data[i][j] = line[columns[j]]; 
+			COLUMN_BUFFER *buffer = (*df).columns[j]; 
+			switch ((*buffer).type) {
+
+				case COLUMN_FLOAT64: 
+					((double *) buffer -> values)[i] = values[columns[j]]; 
+					break; 
+
+				case COLUMN_FLOAT32: 
+					((float *) buffer -> values)[i] = values[columns[j]]; 
+					break; 
+
+				case COLUMN_INT64: 
+					((long long *) buffer -> values)[i] = integers[columns[j]]; 
+					break; 
+
+				case COLUMN_INT32: 
+					((int *) buffer -> values)[i] = integers[columns[j]]; 
+					break; 
+
+			} 
 		} 
-		free(line); /* Free the temporary copy */ 
 	} 
+	free(values); 
+	free(integers); 
 	fclose(in); 
 	return 0; 
 
@@ -0,0 +1,612 @@
+/* 
+ * This file scripts the joins between dataframes: pairing each row of one 
+ * with the rows of another holding the same value in a key column, as in 
+ * matching halos to their progenitors (ID with DESC_ID) or subhalos to their 
+ * hosts (PID with ID). Two strategies are provided: 
+ * 
+ * hash: 	Both tables are partitioned on a hash of their keys so that the 
+ * 			hash table of each partition fits in cache, and the partitions 
+ * 			are joined in parallel. This works on any input. 
+ * merge: 	Both tables are walked in step. This needs both to be sorted on 
+ * 			their keys, as dfcolumn_order leaves them, but no hashing. 
+ * 
+ * Either way the pairs come out in order of the row of the left table, then 
+ * of the row of the right table, so the strategies give identical results. 
+ * Keys are compared exactly as integers when both key columns are of integer 
+ * types and as doubles otherwise; missing values and NaNs match nothing. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The number of keys of the right table each partition of a hash join gets */ 
+#ifndef JOIN_PARTITION_SIZE 
+#define JOIN_PARTITION_SIZE 4096l 
+#endif /* JOIN_PARTITION_SIZE */ 
+
+/* The most partitions a hash join splits its tables into, as a power of 2 */ 
+#ifndef JOIN_MAX_PARTITION_BITS 
+#define JOIN_MAX_PARTITION_BITS 14 
+#endif /* JOIN_MAX_PARTITION_BITS */ 
+
+/* 
+ * The key of a row of one of the tables being joined 
+ * 
+ * Fields 
+ * ====== 
+ * key: 	The key, mapped onto the unsigned integers preserving its order 
+ * row: 	The row of the dataframe holding it 
+ */ 
+typedef struct join_entry {
+
+	unsigned long long key; 
+	long row; 
+
+} JOIN_ENTRY; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static JOIN_ENTRY *join_entries(DATAFRAME df, int column, int integer, 
+	long *length); 
+static int entries_sorted(JOIN_ENTRY *entries, long length); 
+static JOIN_ENTRY *partition(JOIN_ENTRY *entries, long length, int bits, 
+	long *bounds); 
+static void hash_join(JOIN_ENTRY *left, long *lbounds, JOIN_ENTRY *right, 
+	long *rbounds, int bits, long *counts, long *offsets, long long *rrows); 
+static void merge_join(JOIN_ENTRY *left, long nleft, JOIN_ENTRY *right, 
+	long nright, long *counts, long *offsets, long long *rrows); 
+static void take(DATAFRAME df, int column, long long *rows, long length, 
+	COLUMN_BUFFER *dest); 
+
+/* 
+ * Pairs the rows of two dataframes holding the same value in a key column 
+ * of each. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The left dataframe 
+ * lcolumn: 	The column number of the key in the left dataframe 
+ * right: 		The right dataframe 
+ * rcolumn: 	The column number of the key in the right dataframe 
+ * how: 		JOIN_INNER to keep only the pairs, JOIN_LEFT to also keep the 
+ * 				rows of the left dataframe matching nothing 
+ * strategy: 	JOIN_HASH, JOIN_MERGE, or JOIN_AUTO to merge if both 
+ * 				dataframes are sorted on their keys and hash if not 
+ * lrows: 		A pointer to put an int64 buffer of the row of the left 
+ * 				dataframe in each pair into 
+ * rrows: 		A pointer to put an int64 buffer of the row of the right 
+ * 				dataframe in each pair into; -1 for the rows of the left 
+ * 				dataframe matching nothing in a left join 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (e.g. JOIN_MERGE on a dataframe which isn't 
+ * sorted on its key) 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfjoin_rows(DATAFRAME left, int lcolumn, DATAFRAME right, 
+	int rcolumn, int how, int strategy, COLUMN_BUFFER **lrows, 
+	COLUMN_BUFFER **rrows) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * integer: 	Whether or not the keys are compared as integers 
+	 * counts: 		The number of matches of each row of the left dataframe 
+	 * offsets: 	Where the pairs of each row of the left dataframe start 
+	 * bits: 		The number of partitions of a hash join, as a power of 2 
+	 */ 
+	long i, nleft, nright, total = 0l; 
+	int bits = 0; 
+	if (lcolumn < 0 || lcolumn >= left.num_cols || rcolumn < 0 || 
+		rcolumn >= right.num_cols) return 1; 
+	if (how != JOIN_INNER && how != JOIN_LEFT) return 1; 
+	if (strategy < JOIN_HASH || strategy > JOIN_AUTO) return 1; 
+	int integer = column_is_integer(dftype(left, lcolumn)) && 
+		column_is_integer(dftype(right, rcolumn)); 
+	JOIN_ENTRY *l = join_entries(left, lcolumn, integer, &nleft); 
+	JOIN_ENTRY *r = join_entries(right, rcolumn, integer, &nright); 
+	if (strategy == JOIN_AUTO) {
+		strategy = entries_sorted(l, nleft) && entries_sorted(r, nright) ? 
+			JOIN_MERGE : JOIN_HASH; 
+	} else if (strategy == JOIN_MERGE && !(entries_sorted(l, nleft) && 
+		entries_sorted(r, nright))) {
+		free(l); 
+		free(r); 
+		return 1; 
+	} else {} 
+
+	long *lbounds = NULL, *rbounds = NULL; 
+	if (strategy == JOIN_HASH) {
+		/* Enough partitions that each hash table fits in cache */ 
+		while (bits < JOIN_MAX_PARTITION_BITS && (nright >> bits) > 
+			JOIN_PARTITION_SIZE) bits++; 
+		lbounds = (long *) malloc (((1l << bits) + 1l) * sizeof(long)); 
+		rbounds = (long *) malloc (((1l << bits) + 1l) * sizeof(long)); 
+		JOIN_ENTRY *partitioned = partition(l, nleft, bits, lbounds); 
+		free(l); 
+		l = partitioned; 
+		partitioned = partition(r, nright, bits, rbounds); 
+		free(r); 
+		r = partitioned; 
+	} else {} 
+
+	/* Count the matches of each row, then write the pairs where they go */ 
+	long *counts = long_zeroes(left.num_rows > 0l ? left.num_rows : 1l); 
+	long *offsets = (long *) malloc ((left.num_rows + 1l) * sizeof(long)); 
+	if (strategy == JOIN_HASH) {
+		hash_join(l, lbounds, r, rbounds, bits, counts, NULL, NULL); 
+	} else {
+		merge_join(l, nleft, r, nright, counts, NULL, NULL); 
+	} 
+	for (i = 0l; i < left.num_rows; i++) {
+		offsets[i] = total; 
+		total += how == JOIN_LEFT && !counts[i] ? 1l : counts[i]; 
+	} 
+	offsets[left.num_rows] = total; 
+	*lrows = column_buffer_initialize(total, COLUMN_INT64); 
+	*rrows = column_buffer_initialize(total, COLUMN_INT64); 
+	long long *lvalues = (long long *) (**lrows).values; 
+	long long *rvalues = (long long *) (**rrows).values; 
+	if (strategy == JOIN_HASH) {
+		hash_join(l, lbounds, r, rbounds, bits, counts, offsets, rvalues); 
+	} else {
+		merge_join(l, nleft, r, nright, counts, offsets, rvalues); 
+	} 
+	/* The left rows follow from the offsets alone, in one sequential pass */ 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < left.num_rows; i++) {
+		long k; 
+		for (k = offsets[i]; k < offsets[i + 1l]; k++) lvalues[k] = i; 
+		if (!counts[i] && how == JOIN_LEFT) rvalues[offsets[i]] = -1ll; 
+	} 
+
+	free(l); 
+	free(r); 
+	free(lbounds); 
+	free(rbounds); 
+	free(counts); 
+	free(offsets); 
+	return 0; 
+
+} 
+
+/* 
+ * Builds a dataframe out of the pairs of rows of a join, holding every 
+ * column of the left dataframe followed by those of the right. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The left dataframe 
+ * right: 		The right dataframe 
+ * lrows: 		The row of the left dataframe in each pair, as from 
+ * 				dfjoin_rows 
+ * rrows: 		The row of the right dataframe in each pair; values in rows 
+ * 				where this is negative are missing 
+ * rcolumn: 	A column of the right dataframe to leave out (i.e. its key, 
+ * 				which repeats the left one's); -1 to keep them all 
+ * dest: 		A pointer to an empty dataframe to put the result into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_join(DATAFRAME left, DATAFRAME right, 
+	COLUMN_BUFFER *lrows, COLUMN_BUFFER *rrows, int rcolumn, 
+	DATAFRAME *dest) {
+
+	/* 
+	 * As in dataframe_materialize, each thread carves and fills the buffers 
+	 * of its own columns out of one arena holding them all. 
+	 */ 
+	int j, num_cols = left.num_cols + right.num_cols - (rcolumn >= 0); 
+	long length = (*lrows).length; 
+	unsigned long capacity = 0ul; 
+	if ((*rrows).length != length || (*dest).num_cols || 
+		rcolumn >= right.num_cols) return 1; 
+	for (j = 0; j < left.num_cols; j++) {
+		capacity += column_buffer_footprint(length, dftype(left, j)); 
+	} 
+	for (j = 0; j < right.num_cols; j++) {
+		if (j != rcolumn) capacity += column_buffer_footprint(length, 
+			dftype(right, j)); 
+	} 
+	ARENA *a = arena_initialize(capacity); 
+	dataframe_reserve_columns(dest, num_cols); 
+	#pragma omp parallel for schedule(dynamic) 
+	for (j = 0; j < num_cols; j++) {
+		DATAFRAME source = j < left.num_cols ? left : right; 
+		COLUMN_BUFFER *rows = j < left.num_cols ? lrows : rrows; 
+		int column = j < left.num_cols ? j : j - left.num_cols; 
+		if (j >= left.num_cols && rcolumn >= 0 && column >= rcolumn) {
+			column++; 
+		} else {} 
+		dest -> columns[j] = column_buffer_from_arena(a, length, 
+			dftype(source, column)); 
+		take(source, column, (long long *) (*rows).values, length, 
+			dest -> columns[j]); 
+	} 
+	arena_release(a); 
+	if ((*dest).index != NULL) free(dest -> index); 
+	dest -> index = NULL; 
+	dest -> offset = 0l; 
+	dest -> num_rows = length; 
+	dest -> num_cols = num_cols; 
+	return 0; 
+
+} 
+
+/* 
+ * Determine the key of a value in a column buffer, by which it's joined, 
+ * grouped, or sorted. 
+ * 
+ * Parameters 
+ * ========== 
+ * buffer: 		The buffer 
+ * j: 			The position of the value in the buffer 
+ * integer: 	1 to take the key as an integer, 0 as a double 
+ * key: 		A pointer to put the key into. Its order as an unsigned 
+ * 				integer is the order of the values. 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if the value may match others, 0 if it's missing or NaN 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int column_key(COLUMN_BUFFER *buffer, long j, int integer, 
+	unsigned long long *key) {
+
+	if (!column_valid(buffer, j)) return 0; 
+	if (integer) {
+		/* Flipping the sign bit orders the signed integers as unsigned */ 
+		*key = (unsigned long long) column_integer(buffer, j) ^ (1ull << 63); 
+	} else {
+		double x = column_value(buffer, j); 
+		if (isnan(x)) return 0; 
+		if (x == 0) x = 0; /* -0 and +0 are equal */ 
+		memcpy(key, &x, sizeof(double)); 
+		/* Negatives count down from zero, positives up */ 
+		*key = *key >> 63 ? ~*key : *key | (1ull << 63); 
+	} 
+	return 1; 
+
+} 
+
+/* 
+ * Mixes the bits of a key so that every bit of the hash depends on every bit 
+ * of the key (the finalizer of MurmurHash3). A hash join takes the partition 
+ * of a key from the top bits of its hash and its bucket from the bottom bits. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern unsigned long long key_hash(unsigned long long key) {
+
+	key ^= key >> 33; 
+	key *= 0xFF51AFD7ED558CCDull; 
+	key ^= key >> 33; 
+	key *= 0xC4CEB9FE1A85EC53ull; 
+	key ^= key >> 33; 
+	return key; 
+
+} 
+
+/* 
+ * Takes the keys of the rows of a dataframe which may match others. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number of the key 
+ * integer: 	1 to take the keys as integers, 0 as doubles 
+ * length: 		A pointer to put the number of keys into 
+ * 
+ * Returns 
+ * ======= 
+ * The keys, in order of their rows 
+ */ 
+static JOIN_ENTRY *join_entries(DATAFRAME df, int column, int integer, 
+	long *length) {
+
+	/* 
+	 * Each thread packs the keys of its own block of rows at the start of 
+	 * the block, and the blocks are then slid down against one another. 
+	 */ 
+	int t, nthreads = 1; 
+	#ifdef _OPENMP 
+	nthreads = omp_get_max_threads(); 
+	#endif /* _OPENMP */ 
+	long *counts = (long *) calloc (nthreads + 1, sizeof(long)); 
+	JOIN_ENTRY *entries = (JOIN_ENTRY *) malloc ((df.num_rows > 0l ? 
+		df.num_rows : 1l) * sizeof(JOIN_ENTRY)); 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	#pragma omp parallel num_threads(nthreads) 
+	{
+		int tid = 0; 
+		#ifdef _OPENMP 
+		tid = omp_get_thread_num(); 
+		#endif /* _OPENMP */ 
+		long i, n = df.num_rows * tid / nthreads; 
+		long stop = df.num_rows * (tid + 1) / nthreads; 
+		for (i = n; i < stop; i++) {
+			if (column_key(buffer, dfrow_index(df, i), integer, 
+				&entries[n].key)) entries[n++].row = i; 
+		} 
+		counts[tid + 1] = n - df.num_rows * tid / nthreads; 
+	} 
+	for (t = 0; t < nthreads; t++) {
+		memmove(entries + counts[t], entries + df.num_rows * t / nthreads, 
+			counts[t + 1] * sizeof(JOIN_ENTRY)); 
+		counts[t + 1] += counts[t]; 
+	} 
+	*length = counts[nthreads]; 
+	free(counts); 
+	return entries; 
+
+} 
+
+/* 
+ * Determine whether or not a set of keys is in ascending order. 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if it is, 0 if it isn't 
+ */ 
+static int entries_sorted(JOIN_ENTRY *entries, long length) {
+
+	long i, descents = 0l; 
+	#pragma omp parallel for schedule(static) reduction(+:descents) 
+	for (i = 1l; i < length; i++) {
+		descents += entries[i].key < entries[i - 1l].key; 
+	} 
+	return !descents; 
+
+} 
+
+/* 
+ * Scatters a set of keys into partitions by the top bits of their hashes, 
+ * keeping the keys within each partition in their original order. 
+ * 
+ * Parameters 
+ * ========== 
+ * entries: 	The keys 
+ * length: 		The number of keys 
+ * bits: 		The number of partitions, as a power of 2 
+ * bounds: 		A pointer to put where each partition starts into, with 
+ * 				2^bits + 1 elements; the last is the number of keys 
+ * 
+ * Returns 
+ * ======= 
+ * The partitioned keys 
+ */ 
+static JOIN_ENTRY *partition(JOIN_ENTRY *entries, long length, int bits, 
+	long *bounds) {
+
+	/* 
+	 * As in join_entries, but each thread counts the keys in its block 
+	 * going to every partition, and the prefix sums run over the partitions 
+	 * first, then the threads. 
+	 */ 
+	int t, nthreads = 1; 
+	long p, num_parts = 1l << bits; 
+	#ifdef _OPENMP 
+	nthreads = omp_get_max_threads(); 
+	#endif /* _OPENMP */ 
+	long *counts = (long *) calloc (nthreads * num_parts, sizeof(long)); 
+	JOIN_ENTRY *partitioned = (JOIN_ENTRY *) malloc ((length > 0l ? length : 
+		1l) * sizeof(JOIN_ENTRY)); 
+	#pragma omp parallel num_threads(nthreads) 
+	{
+		int tid = 0; 
+		#ifdef _OPENMP 
+		tid = omp_get_thread_num(); 
+		#endif /* _OPENMP */ 
+		long i, start = length * tid / nthreads; 
+		long stop = length * (tid + 1) / nthreads; 
+		long *local = counts + tid * num_parts; 
+		for (i = start; i < stop; i++) {
+			local[bits ? key_hash(entries[i].key) >> (64 - bits) : 0ull]++; 
+		} 
+		#pragma omp barrier 
+		#pragma omp single 
+		{
+			long total = 0l; 
+			for (p = 0l; p < num_parts; p++) {
+				bounds[p] = total; 
+				for (t = 0; t < nthreads; t++) {
+					long n = counts[t * num_parts + p]; 
+					counts[t * num_parts + p] = total; 
+					total += n; 
+				} 
+			} 
+			bounds[num_parts] = total; 
+		} 
+		for (i = start; i < stop; i++) {
+			unsigned long long q = bits ? key_hash(entries[i].key) >> 
+				(64 - bits) : 0ull; 
+			partitioned[local[q]++] = entries[i]; 
+		} 
+	} 
+	free(counts); 
+	return partitioned; 
+
+} 
+
+/* 
+ * Joins partitioned keys one partition at a time, either counting the 
+ * matches of each row of the left dataframe or writing the right row of 
+ * each pair. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The partitioned keys of the left dataframe 
+ * lbounds: 	Where each partition of the left keys starts 
+ * right: 		The partitioned keys of the right dataframe 
+ * rbounds: 	Where each partition of the right keys starts 
+ * bits: 		The number of partitions, as a power of 2 
+ * counts: 		A pointer to put the number of matches of each row into 
+ * offsets: 	Where the pairs of each row go; NULL to count the matches 
+ * rrows: 		A pointer to write the right row of each pair into 
+ */ 
+static void hash_join(JOIN_ENTRY *left, long *lbounds, JOIN_ENTRY *right, 
+	long *rbounds, int bits, long *counts, long *offsets, long long *rrows) {
+
+	long p, largest = 1l, num_parts = 1l << bits; 
+	for (p = 0l; p < num_parts; p++) {
+		largest = max(largest, rbounds[p + 1l] - rbounds[p]); 
+	} 
+	#pragma omp parallel 
+	{
+		/* 
+		 * Chained hash tables: heads holds the first key in each bucket and 
+		 * next the one after each key. Inserting the keys in reverse leaves 
+		 * each chain in the order of the rows of the right dataframe. 
+		 */ 
+		long size = 1l; 
+		while (size < largest) size <<= 1; 
+		long *heads = (long *) malloc (size * sizeof(long)); 
+		long *next = (long *) malloc (largest * sizeof(long)); 
+		#pragma omp for schedule(dynamic) 
+		for (p = 0l; p < num_parts; p++) {
+			long i, k, n = rbounds[p + 1l] - rbounds[p]; 
+			JOIN_ENTRY *r = right + rbounds[p]; 
+			unsigned long long mask = 1ull; 
+			while (mask < (unsigned long long) n) mask <<= 1; 
+			mask--; 
+			memset(heads, 0xff, (mask + 1ull) * sizeof(long)); 
+			for (k = n - 1l; k >= 0l; k--) {
+				unsigned long long b = key_hash(r[k].key) & mask; 
+				next[k] = heads[b]; 
+				heads[b] = k; 
+			} 
+			for (i = lbounds[p]; i < lbounds[p + 1l]; i++) {
+				long row = left[i].row, m = 0l; 
+				if (!n) break; 
+				for (k = heads[key_hash(left[i].key) & mask]; k != -1l; 
+					k = next[k]) {
+					if (r[k].key != left[i].key) continue; 
+					if (offsets != NULL) rrows[offsets[row] + m] = r[k].row; 
+					m++; 
+				} 
+				if (offsets == NULL) counts[row] = m; 
+			} 
+		} 
+		free(heads); 
+		free(next); 
+	} 
+
+} 
+
+/* 
+ * Joins sorted keys by walking them in step, either counting the matches of 
+ * each row of the left dataframe or writing the right row of each pair. Each 
+ * thread walks its own block of the left keys, starting from the first 
+ * matching right key. 
+ * 
+ * Parameters 
+ * ========== 
+ * left: 		The keys of the left dataframe, in ascending order 
+ * nleft: 		The number of left keys 
+ * right: 		The keys of the right dataframe, in ascending order 
+ * nright: 		The number of right keys 
+ * counts: 		A pointer to put the number of matches of each row into 
+ * offsets: 	Where the pairs of each row go; NULL to count the matches 
+ * rrows: 		A pointer to write the right row of each pair into 
+ */ 
+static void merge_join(JOIN_ENTRY *left, long nleft, JOIN_ENTRY *right, 
+	long nright, long *counts, long *offsets, long long *rrows) {
+
+	#pragma omp parallel 
+	{
+		int tid = 0, nthreads = 1; 
+		#ifdef _OPENMP 
+		tid = omp_get_thread_num(); 
+		nthreads = omp_get_num_threads(); 
+		#endif /* _OPENMP */ 
+		long i, k, start = nleft * tid / nthreads; 
+		long stop = nleft * (tid + 1) / nthreads; 
+		/* Binary search for the first right key not below the first left */ 
+		long lo = 0l, hi = nright; 
+		while (start < stop && lo < hi) {
+			long mid = lo + (hi - lo) / 2l; 
+			if (right[mid].key < left[start].key) {
+				lo = mid + 1l; 
+			} else {
+				hi = mid; 
+			} 
+		} 
+		/* right[lo, hi) holds the keys equal to that of left[i] */ 
+		for (i = start, hi = lo; i < stop; i++) {
+			if (i == start || left[i].key != left[i - 1l].key) {
+				while (lo < nright && right[lo].key < left[i].key) lo++; 
+				hi = lo; 
+				while (hi < nright && right[hi].key == left[i].key) hi++; 
+			} else {} 
+			long row = left[i].row; 
+			if (offsets != NULL) {
+				for (k = lo; k < hi; k++) {
+					rrows[offsets[row] + k - lo] = right[k].row; 
+				} 
+			} else {
+				counts[row] = hi - lo; 
+			} 
+		} 
+	} 
+
+} 
+
+/* 
+ * Copies the values in given rows of a column of a dataframe into a column 
+ * buffer of the same type, along with their validity. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * rows: 		The rows to take; the values where these are negative are 
+ * 				missing 
+ * length: 		The number of rows to take 
+ * dest: 		The buffer to copy into, with length values 
+ */ 
+static void take(DATAFRAME df, int column, long long *rows, long length, 
+	COLUMN_BUFFER *dest) {
+
+	long i; 
+	int complete = (*df.columns[column]).validity == NULL; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	unsigned long size = column_type_size((*buffer).type); 
+	for (i = 0l; i < length && complete; i++) complete = rows[i] >= 0ll; 
+	if (!complete) dest -> validity = (unsigned char *) calloc ( 
+		validity_bytes(length > 0l ? length : 1l), sizeof(unsigned char)); 
+	/* Threads write whole bytes of the bitmap, so blocks of 8 rows */ 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < length; i += 8l) {
+		long k; 
+		for (k = i; k < i + 8l && k < length; k++) {
+			char *value = (char *) dest -> values + k * size; 
+			if (rows[k] < 0ll) {
+				memset(value, 0, size); 
+				continue; 
+			} else {} 
+			long j = dfrow_index(df, rows[k]); 
+			if ((*buffer).encoding != NULL) {
+				column_encoded_get(buffer, j, value); 
+			} else {
+				memcpy(value, (char *) (*buffer).values + j * size, size); 
+			} 
+			if (!complete && column_valid(buffer, j)) {
+				dest -> validity[k >> 3] |= 1 << (k & 7); 
+			} else {} 
+		} 
+	} 
+
+} 
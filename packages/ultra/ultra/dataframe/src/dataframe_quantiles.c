@@ -0,0 +1,483 @@
+/* 
+ * This file scripts the multi-quantile selection engine used by the median, 
+ * scatter, and any other routine which needs order statistics of a column. 
+ * 
+ * All k requested ranks are found in a single recursive partitioning pass: 
+ * each partition step resolves every rank falling on the pivot and only 
+ * descends into the pieces which still contain requested ranks. Pivots are 
+ * taken as the median-of-3 (or Tukey's ninther on larger pieces), falling 
+ * back on the median-of-medians once a piece has been partitioned too many 
+ * times, which guarantees O(n) in the worst case. The recursion runs on an 
+ * explicit stack, and large pieces are partitioned in parallel when compiled 
+ * with OpenMP. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* Pieces at or below this size are finished off with an insertion sort */ 
+#ifndef SELECT_INSERTION_CUTOFF 
+#define SELECT_INSERTION_CUTOFF 16l 
+#endif /* SELECT_INSERTION_CUTOFF */ 
+
+/* Pieces above this size take the ninther rather than the median-of-3 */ 
+#ifndef SELECT_NINTHER_CUTOFF 
+#define SELECT_NINTHER_CUTOFF 128l 
+#endif /* SELECT_NINTHER_CUTOFF */ 
+
+/* 
+ * A piece of the array which still contains requested ranks 
+ * 
+ * Fields 
+ * ====== 
+ * low: 		The starting index of the piece 
+ * high: 		The ending index of the piece (inclusive) 
+ * first: 		The index of the first rank (in the sorted ranks) in the piece 
+ * last: 		The index of the last rank (in the sorted ranks) in the piece 
+ * depth: 		The number of partitions allowed before falling back on the 
+ * 				median-of-medians 
+ */ 
+typedef struct select_task {
+
+	long low; 
+	long high; 
+	int first; 
+	int last; 
+	int depth; 
+
+} SELECT_TASK; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static double choose_pivot(double *arr, long low, long high, int depth); 
+static double median_of_three(double a, double b, double c); 
+static double median_of_medians(double *arr, long low, long high); 
+static void partition3(double *arr, long low, long high, double pivot, 
+	long *lt, long *gt, double *scratch); 
+static void insertion_sort(double *arr, long low, long high); 
+static int depth_limit(long length); 
+static int *sorted_rank_order(long *ranks, int num_ranks); 
+
+/* 
+ * Determine the values at several rank orders of an array of unsorted values 
+ * in a single partitioning pass. The array is rearranged in place. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 			A pointer to the array of unsorted values 
+ * length: 			The number of elements in the array 
+ * ranks: 			The rank orders to take, in any order. Each must lie 
+ * 					between 0 and length - 1. 
+ * num_ranks: 		The number of rank orders requested 
+ * values: 			A pointer to put the values into, in the same order as 
+ * 					ranks 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: utils.h 
+ */ 
+extern int ptr_select_ranks(double *arr, long length, long *ranks, 
+	int num_ranks, double *values) {
+
+	int i; 
+	if (length <= 0l || num_ranks <= 0) return 1; 
+	for (i = 0; i < num_ranks; i++) {
+		if (ranks[i] < 0l || ranks[i] >= length) return 1; 
+	} 
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * order: 		The indeces which sort the requested ranks 
+	 * sorted: 		The requested ranks in ascending order 
+	 * stack: 		The pieces of the array left to partition 
+	 * scratch: 	Workspace for parallel partitioning (NULL if serial, 
+	 * 				which it always is when called from a parallel region) 
+	 */ 
+	int *order = sorted_rank_order(ranks, num_ranks); 
+	long *sorted = (long *) malloc (num_ranks * sizeof(long)); 
+	for (i = 0; i < num_ranks; i++) {
+		sorted[i] = ranks[order[i]]; 
+	} 
+	long stack_size = 64l, n = 0l; 
+	SELECT_TASK *stack = (SELECT_TASK *) malloc (stack_size * 
+		sizeof(SELECT_TASK)); 
+	double *scratch = NULL; 
+	#ifdef _OPENMP 
+	if (length > SELECT_PARALLEL_CUTOFF && omp_get_max_threads() > 1 && 
+		!omp_in_parallel()) {
+		scratch = (double *) malloc (length * sizeof(double)); 
+	} else {} 
+	#endif /* _OPENMP */ 
+
+	SELECT_TASK first = {0l, length - 1l, 0, num_ranks - 1, 
+		depth_limit(length)}; 
+	stack[n++] = first; 
+	while (n) {
+		SELECT_TASK t = stack[--n]; 
+		if (t.high - t.low + 1l <= SELECT_INSERTION_CUTOFF) {
+			/* Small pieces: every rank within is resolved by sorting */ 
+			insertion_sort(arr, t.low, t.high); 
+			continue; 
+		} else {} 
+
+		/* Partition about the pivot and resolve the ranks landing on it */ 
+		long lt, gt; 
+		double pivot = choose_pivot(arr, t.low, t.high, t.depth); 
+		partition3(arr, t.low, t.high, pivot, &lt, &gt, 
+			t.high - t.low + 1l > SELECT_PARALLEL_CUTOFF ? scratch : NULL); 
+
+		/* Find the ranks below and above the pivot */ 
+		int below = t.first, above = t.last; 
+		while (below <= t.last && sorted[below] < lt) below++; 
+		while (above >= t.first && sorted[above] > gt) above--; 
+
+		if (n + 2l > stack_size) {
+			stack_size *= 2l; 
+			stack = (SELECT_TASK *) realloc (stack, stack_size * 
+				sizeof(SELECT_TASK)); 
+		} else {} 
+		if (below > t.first) {
+			SELECT_TASK left = {t.low, lt - 1l, t.first, below - 1, 
+				t.depth - 1}; 
+			stack[n++] = left; 
+		} else {} 
+		if (above < t.last) {
+			SELECT_TASK right = {gt + 1l, t.high, above + 1, t.last, 
+				t.depth - 1}; 
+			stack[n++] = right; 
+		} else {} 
+	} 
+
+	/* Every requested rank is now in its final position */ 
+	for (i = 0; i < num_ranks; i++) {
+		values[order[i]] = arr[sorted[i]]; 
+	} 
+	free(order); 
+	free(sorted); 
+	free(stack); 
+	if (scratch != NULL) free(scratch); 
+	return 0; 
+
+} 
+
+/* 
+ * Determine several quantiles of an array of unsorted values in a single 
+ * partitioning pass. The quantile q is taken as the element of rank 
+ * (long) (q * length), capped at length - 1. The array is rearranged in 
+ * place. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 			A pointer to the array of unsorted values 
+ * length: 			The number of elements in the array 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * values: 			A pointer to put the quantiles into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: utils.h 
+ */ 
+extern int ptr_quantiles(double *arr, long length, double *fractions, 
+	int num_fractions, double *values) {
+
+	int i, status; 
+	if (length <= 0l || num_fractions <= 0) return 1; 
+	long *ranks = (long *) malloc (num_fractions * sizeof(long)); 
+	for (i = 0; i < num_fractions; i++) {
+		if (fractions[i] < 0 || fractions[i] > 1) {
+			free(ranks); 
+			return 1; 
+		} else {
+			ranks[i] = min((long) (fractions[i] * length), length - 1l); 
+		} 
+	} 
+	status = ptr_select_ranks(arr, length, ranks, num_fractions, values); 
+	free(ranks); 
+	return status; 
+
+} 
+
+/* 
+ * Choose a pivot value for a piece of the array. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 		The array itself 
+ * low: 		The starting index of the piece 
+ * high: 		The ending index of the piece (inclusive) 
+ * depth: 		The number of partitions remaining before the 
+ * 				median-of-medians is required 
+ * 
+ * Returns 
+ * ======= 
+ * The median-of-3 of the first, middle, and last elements on small pieces, 
+ * Tukey's ninther on larger pieces, and the median-of-medians once depth 
+ * has run out. 
+ */ 
+static double choose_pivot(double *arr, long low, long high, int depth) {
+
+	long length = high - low + 1l; 
+	long mid = low + length / 2l; 
+	if (depth <= 0) {
+		return median_of_medians(arr, low, high); 
+	} else if (length > SELECT_NINTHER_CUTOFF) {
+		long s = length / 8l; 
+		return median_of_three( 
+			median_of_three(arr[low], arr[low + s], arr[low + 2l * s]), 
+			median_of_three(arr[mid - s], arr[mid], arr[mid + s]), 
+			median_of_three(arr[high - 2l * s], arr[high - s], arr[high]) 
+		); 
+	} else {
+		return median_of_three(arr[low], arr[mid], arr[high]); 
+	} 
+
+} 
+
+/* 
+ * Determine the median of three values. 
+ */ 
+static double median_of_three(double a, double b, double c) {
+
+	if (a < b) {
+		if (b < c) {
+			return b; 
+		} else {
+			return a < c ? c : a; 
+		} 
+	} else {
+		if (a < c) {
+			return a; 
+		} else {
+			return b < c ? c : b; 
+		} 
+	} 
+
+} 
+
+/* 
+ * The median-of-medians (BFPRT) pivot. The medians of each group of 5 are 
+ * moved to the front of the piece, and their median is selected exactly. 
+ * This guarantees that at least 30% of the piece lies on either side of the 
+ * pivot, and therefore linear time overall. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 		The array itself 
+ * low: 		The starting index of the piece 
+ * high: 		The ending index of the piece (inclusive) 
+ * 
+ * Returns 
+ * ======= 
+ * The median-of-medians of the piece 
+ */ 
+static double median_of_medians(double *arr, long low, long high) {
+
+	long i, groups = 0l; 
+	for (i = low; i <= high; i += 5l) {
+		long end = min(i + 4l, high); 
+		insertion_sort(arr, i, end); 
+		double x = arr[low + groups]; 
+		arr[low + groups] = arr[i + (end - i) / 2l]; 
+		arr[i + (end - i) / 2l] = x; 
+		groups++; 
+	} 
+	long rank = groups / 2l; 
+	double pivot; 
+	if (ptr_select_ranks(arr + low, groups, &rank, 1, &pivot)) {
+		/* Can't happen: there is always at least one group */ 
+		return arr[low]; 
+	} else {
+		return pivot; 
+	} 
+
+} 
+
+/* 
+ * A three-way partition: rearrange a piece of the array such that all values 
+ * less than the pivot come first, followed by all values equal to it, 
+ * followed by all values greater than it. Runs of equal values therefore 
+ * cost a single pass, unlike the classic two-way partition. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 		The array itself 
+ * low: 		The starting index of the piece 
+ * high: 		The ending index of the piece (inclusive) 
+ * pivot: 		The value to partition on 
+ * lt: 			A pointer to put the index of the first value equal to the 
+ * 				pivot into 
+ * gt: 			A pointer to put the index of the last value equal to the 
+ * 				pivot into 
+ * scratch: 	Workspace at least as long as the whole array. If non-NULL, 
+ * 				the partition is done in parallel out of place. 
+ */ 
+static void partition3(double *arr, long low, long high, double pivot, 
+	long *lt, long *gt, double *scratch) {
+
+	#ifdef _OPENMP 
+	if (scratch != NULL) {
+		/* 
+		 * Each thread counts the values on either side of the pivot in its 
+		 * own block; prefix sums over the counts give each thread a private 
+		 * range of the scratch array to write into. The blocks are sized by 
+		 * the team actually spawned, which may be smaller than requested. 
+		 */ 
+		int t, nthreads = omp_get_max_threads(); 
+		long *counts = (long *) calloc (3 * (nthreads + 1), sizeof(long)); 
+		long length = high - low + 1l; 
+		#pragma omp parallel num_threads(nthreads) 
+		{
+			int tid = omp_get_thread_num(), nteam = omp_get_num_threads(); 
+			long i, start = low + length * tid / nteam; 
+			long stop = low + length * (tid + 1) / nteam; 
+			long nless = 0l, nequal = 0l; 
+			for (i = start; i < stop; i++) {
+				nless += arr[i] < pivot; 
+				nequal += arr[i] == pivot; 
+			} 
+			counts[3 * (tid + 1)] = nless; 
+			counts[3 * (tid + 1) + 1] = nequal; 
+			counts[3 * (tid + 1) + 2] = (stop - start) - nless - nequal; 
+			#pragma omp barrier 
+			#pragma omp single 
+			{
+				long totless = 0l, totequal = 0l; 
+				for (t = 1; t <= nteam; t++) {
+					totless += counts[3 * t]; 
+					totequal += counts[3 * t + 1]; 
+				} 
+				long offsets[3] = {low, low + totless, low + totless + 
+					totequal}; 
+				for (t = 1; t <= nteam; t++) {
+					long n0= counts[3 * t], n1 = counts[3 * t + 1]; 
+					long n2 = counts[3 * t + 2]; 
+					counts[3 * t] = offsets[0]; 
+					counts[3 * t + 1] = offsets[1]; 
+					counts[3 * t + 2] = offsets[2]; 
+					offsets[0] += n0; 
+					offsets[1] += n1; 
+					offsets[2] += n2; 
+				} 
+				*lt = low + totless; 
+				*gt = low + totless + totequal - 1l; 
+			} 
+			long a = counts[3 * (tid + 1)], b = counts[3 * (tid + 1) + 1]; 
+			long c = counts[3 * (tid + 1) + 2]; 
+			for (i = start; i < stop; i++) {
+				if (arr[i] < pivot) {
+					scratch[a++] = arr[i]; 
+				} else if (arr[i] == pivot) {
+					scratch[b++] = arr[i]; 
+				} else {
+					scratch[c++] = arr[i]; 
+				} 
+			} 
+			#pragma omp barrier 
+			#pragma omp for 
+			for (i = low; i <= high; i++) {
+				arr[i] = scratch[i]; 
+			} 
+		} 
+		free(counts); 
+		return; 
+	} else {} 
+	#else 
+	(void) scratch; 
+	#endif /* _OPENMP */ 
+
+	/* Dijkstra's Dutch national flag partition */ 
+	long i = low, l = low, g = high; 
+	while (i <= g) {
+		double x = arr[i]; 
+		if (x < pivot) {
+			arr[i++] = arr[l]; 
+			arr[l++] = x; 
+		} else if (x > pivot) {
+			arr[i] = arr[g]; 
+			arr[g--] = x; 
+		} else {
+			i++; 
+		} 
+	} 
+	*lt = l; 
+	*gt = g; 
+
+} 
+
+/* 
+ * Sorts a (small) piece of an array of doubles in ascending order by 
+ * insertion. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 		The array itself 
+ * low: 		The starting index of the piece 
+ * high: 		The ending index of the piece (inclusive) 
+ */ 
+static void insertion_sort(double *arr, long low, long high) {
+
+	long i, j; 
+	for (i = low + 1l; i <= high; i++) {
+		double x = arr[i]; 
+		for (j = i - 1l; j >= low && arr[j] > x; j--) {
+			arr[j + 1l] = arr[j]; 
+		} 
+		arr[j + 1l] = x; 
+	} 
+
+} 
+
+/* 
+ * The number of partitions allowed on an array of a given length before 
+ * falling back on the median-of-medians: twice the base-2 logarithm. 
+ */ 
+static int depth_limit(long length) {
+
+	int depth = 0; 
+	while (length > 1l) {
+		length >>= 1; 
+		depth++; 
+	} 
+	return 2 * depth; 
+
+} 
+
+/* 
+ * Determine the indeces which sort an array of requested ranks. The number 
+ * of ranks is expected to be small, so an insertion sort suffices. 
+ * 
+ * Parameters 
+ * ========== 
+ * ranks: 		The requested ranks 
+ * num_ranks: 	The number of requested ranks 
+ * 
+ * Returns 
+ * ======= 
+ * Type *int :: The indeces which sort ranks in ascending order 
+ */ 
+static int *sorted_rank_order(long *ranks, int num_ranks) {
+
+	int i, j; 
+	int *order = (int *) malloc (num_ranks * sizeof(int)); 
+	for (i = 0; i < num_ranks; i++) {
+		int x = i; 
+		for (j = i - 1; j >= 0 && ranks[order[j]] > ranks[x]; j--) {
+			order[j + 1] = order[j]; 
+		} 
+		order[j + 1] = x; 
+	} 
+	return order; 
+
+} 
+
@@ -0,0 +1,658 @@
+/* 
+ * This file scripts the resampling error estimates: the bootstrap and the 
+ * (grouped, e.g. spatial sub-box) jackknife of the statistics of a column. 
+ * Neither copies the data for each resample. Instead each resample weights 
+ * the values of the column, once gathered (and sorted, if any statistic is 
+ * an order statistic), and every statistic of a resample is taken in one 
+ * or two passes over them. Resamples are handed out to threads, and the 
+ * bootstrap's random weights come from a counter-based generator keyed by 
+ * the seed, so they're the same whatever the number of threads. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* 
+ * The number of values whose weights are determined at once; the random 
+ * numbers for them are independent, so they overlap in the processor. 
+ */ 
+#ifndef WEIGHT_BLOCK 
+#define WEIGHT_BLOCK 16 
+#endif /* WEIGHT_BLOCK */ 
+
+/* The kinds of weights a resample gives the values */ 
+#define RESAMPLE_ALL 0 
+#define RESAMPLE_BOOTSTRAP 1 
+#define RESAMPLE_JACKKNIFE 2 
+
+/* 
+ * A value of the column and the group of its row. 
+ * 
+ * Fields 
+ * ====== 
+ * value: 		The value 
+ * group: 		The group of its row, for the jackknife 
+ */ 
+typedef struct resample_value {
+
+	double value; 
+	long group; 
+
+} RESAMPLE_VALUE; 
+
+/* 
+ * The weights a resample gives the values. 
+ * 
+ * Fields 
+ * ====== 
+ * kind: 		The RESAMPLE_* code 
+ * seed: 		The seed of the bootstrap's random weights 
+ * replicate: 	The number of the bootstrap resample, or the group the 
+ * 				jackknife resample leaves out 
+ */ 
+typedef struct resample_weights {
+
+	int kind; 
+	unsigned long seed; 
+	long replicate; 
+
+} RESAMPLE_WEIGHTS; 
+
+/* 
+ * A rank an order statistic is taken at. 
+ * 
+ * Fields 
+ * ====== 
+ * rank: 		The rank 
+ * stat: 		The index of the statistic 
+ * share: 		The share of the statistic the value at the rank makes up 
+ */ 
+typedef struct rank_target {
+
+	long rank; 
+	int stat; 
+	double share; 
+
+} RANK_TARGET; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static long gather_values(DATAFRAME df, int column, long *groups, 
+	int *stats, int num_stats, RESAMPLE_VALUE **values); 
+static int check_statistics(int *stats, double *fractions, int num_stats); 
+static void resample_statistics(RESAMPLE_VALUE *values, long n, 
+	double shift, RESAMPLE_WEIGHTS weights, int *stats, double *fractions, 
+	int num_stats, double *results); 
+static double values_mean(RESAMPLE_VALUE *values, long n); 
+static long resample_rank(int stat, double fraction, long total, int upper); 
+static void resample_weight_block(RESAMPLE_WEIGHTS weights, 
+	RESAMPLE_VALUE *values, long i, long n, unsigned int *w); 
+static unsigned int poisson_deviate(unsigned int u); 
+static int compare_values(const void *a, const void *b); 
+
+/* 
+ * Estimates the uncertainty on statistics of the values in a column by the 
+ * bootstrap. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column number to take the statistics of 
+ * stats: 			The statistics to take, as the BINNED_* codes 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics 
+ * num_resamples: 	The number of bootstrap resamples 
+ * seed: 			The seed of the random weights 
+ * replicates: 		A pointer to put the statistics of each resample into, 
+ * 					resample b's at [b * num_stats] through 
+ * 					[b * num_stats + num_stats - 1] 
+ * estimates: 		A pointer to put the statistics of the values themselves 
+ * 					into 
+ * errors: 			A pointer to put the standard deviation of each statistic 
+ * 					across the resamples into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * This is the Poisson bootstrap: each value is weighted by an independent 
+ * Poisson(1) deviate rather than drawing exactly n of them with replacement, 
+ * which approximates it closely for more than a few dozen values and needs 
+ * no memory per resample. The deviates are a function of the seed, the 
+ * resample, and the row alone (splitmix64 on a counter, as for 
+ * dataframe_sample), so they're the same for any number of threads. Rows 
+ * missing their value are left out. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_bootstrap(DATAFRAME df, int column, int *stats, 
+	double *fractions, int num_stats, long num_resamples, unsigned long seed, 
+	double *replicates, double *estimates, double *errors) {
+
+	long b; 
+	int s; 
+	RESAMPLE_VALUE *values; 
+	if (column < 0 || column >= df.num_cols || num_resamples < 2l || 
+		check_statistics(stats, fractions, num_stats)) return 1; 
+	long n = gather_values(df, column, NULL, stats, num_stats, &values); 
+	double shift = values_mean(values, n); 
+	RESAMPLE_WEIGHTS all = {RESAMPLE_ALL, seed, 0l}; 
+	resample_statistics(values, n, shift, all, stats, fractions, num_stats, 
+		estimates); 
+
+	#pragma omp parallel for schedule(dynamic) 
+	for (b = 0l; b < num_resamples; b++) {
+		RESAMPLE_WEIGHTS weights = {RESAMPLE_BOOTSTRAP, seed, b}; 
+		resample_statistics(values, n, shift, weights, stats, fractions, 
+			num_stats, replicates + b * num_stats); 
+	} 
+
+	for (s = 0; s < num_stats; s++) {
+		double mean = 0, var = 0; 
+		for (b = 0l; b < num_resamples; b++) {
+			mean += replicates[b * num_stats + s]; 
+		} 
+		mean /= num_resamples; 
+		for (b = 0l; b < num_resamples; b++) {
+			double delta = replicates[b * num_stats + s] - mean; 
+			var += delta * delta; 
+		} 
+		errors[s] = sqrt(var / (num_resamples - 1l)); 
+	} 
+	free(values); 
+	return 0; 
+
+} 
+
+/* 
+ * Estimates the uncertainty on statistics of the values in a column by the 
+ * delete-one-group jackknife. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column number to take the statistics of 
+ * groups: 			The group number of each row; -1 for rows in no group, 
+ * 					which are left out altogether 
+ * num_groups: 		The number of groups 
+ * stats: 			The statistics to take, as the BINNED_* codes 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics 
+ * replicates: 		A pointer to put the statistics without each group into, 
+ * 					group g's at [g * num_stats] through 
+ * 					[g * num_stats + num_stats - 1]; NaN for empty groups 
+ * estimates: 		A pointer to put the statistics of the values in every 
+ * 					group into 
+ * errors: 			A pointer to put the jackknife standard error of each 
+ * 					statistic into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure, including fewer than two groups with values 
+ * 
+ * Notes 
+ * ===== 
+ * Empty groups are not counted: with G groups holding values, the error 
+ * is sqrt((G - 1) / G * sum((x_g - mean(x_g))^2)). Rows missing their 
+ * value are left out. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_jackknife(DATAFRAME df, int column, long *groups, 
+	long num_groups, int *stats, double *fractions, int num_stats, 
+	double *replicates, double *estimates, double *errors) {
+
+	long g, i, used = 0l; 
+	int s; 
+	RESAMPLE_VALUE *values; 
+	if (column < 0 || column >= df.num_cols || num_groups < 1l || 
+		check_statistics(stats, fractions, num_stats)) return 1; 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (groups[i] < -1l || groups[i] >= num_groups) return 1; 
+	} 
+	long n = gather_values(df, column, groups, stats, num_stats, &values); 
+	double shift = values_mean(values, n); 
+	int *occupied = (int *) calloc (num_groups, sizeof(int)); 
+	for (i = 0l; i < n; i++) occupied[values[i].group] = 1; 
+	for (g = 0l; g < num_groups; g++) used += occupied[g]; 
+	if (used < 2l) {
+		free(values); 
+		free(occupied); 
+		return 1; 
+	} else {} 
+	RESAMPLE_WEIGHTS all = {RESAMPLE_ALL, 0ul, 0l}; 
+	resample_statistics(values, n, shift, all, stats, fractions, num_stats, 
+		estimates); 
+
+	#pragma omp parallel for schedule(dynamic) 
+	for (g = 0l; g < num_groups; g++) {
+		if (occupied[g]) {
+			RESAMPLE_WEIGHTS weights = {RESAMPLE_JACKKNIFE, 0ul, g}; 
+			resample_statistics(values, n, shift, weights, stats, fractions, 
+				num_stats, replicates + g * num_stats); 
+		} else {
+			for (s = 0; s < num_stats; s++) {
+				replicates[g * num_stats + s] = NAN; 
+			} 
+		} 
+	} 
+
+	for (s = 0; s < num_stats; s++) {
+		double mean = 0, var = 0; 
+		for (g = 0l; g < num_groups; g++) {
+			if (occupied[g]) mean += replicates[g * num_stats + s]; 
+		} 
+		mean /= used; 
+		for (g = 0l; g < num_groups; g++) {
+			if (occupied[g]) {
+				double delta = replicates[g * num_stats + s] - mean; 
+				var += delta * delta; 
+			} else {} 
+		} 
+		errors[s] = sqrt(var * (used - 1l) / used); 
+	} 
+	free(values); 
+	free(occupied); 
+	return 0; 
+
+} 
+
+/* 
+ * Assigns the rows of a dataframe to a regular grid of sub-boxes of a box 
+ * in the space of several columns (e.g. positions), for a spatial 
+ * jackknife. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * columns: 	The column numbers of the coordinates 
+ * num_dims: 	The number of coordinates 
+ * divisions: 	The number of sub-boxes along each coordinate 
+ * lower: 		The lower edge of the box along each coordinate 
+ * upper: 		The upper edge of the box along each coordinate 
+ * groups: 		A pointer to put the sub-box of each row into, numbered with 
+ * 				the first coordinate varying fastest; -1 for rows outside 
+ * 				the box or missing a coordinate 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number, division or box 
+ * 
+ * Notes 
+ * ===== 
+ * The box is closed at both edges, with values on an upper edge in the 
+ * last sub-box along it. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_subboxes(DATAFRAME df, int *columns, int num_dims, 
+	long *divisions, double *lower, double *upper, long *groups) {
+
+	long i; 
+	int d; 
+	if (num_dims < 1) return 1; 
+	for (d = 0; d < num_dims; d++) {
+		if (columns[d] < 0 || columns[d] >= df.num_cols || 
+			divisions[d] < 1l || !(upper[d] > lower[d])) return 1; 
+	} 
+
+	#pragma omp parallel for schedule(static) private(d) 
+	for (i = 0l; i < df.num_rows; i++) {
+		long group = 0l, stride = 1l; 
+		for (d = 0; d < num_dims; d++) {
+			if (!dfvalid(df, i, columns[d])) {
+				group = -1l; 
+				break; 
+			} else {} 
+			double x = dfvalue(df, i, columns[d]); 
+			if (!(x >= lower[d] && x <= upper[d])) {
+				group = -1l; 
+				break; 
+			} else {} 
+			long cell = (long) ((x - lower[d]) / (upper[d] - lower[d]) * 
+				divisions[d]); 
+			group += stride * min(cell, divisions[d] - 1l); 
+			stride *= divisions[d]; 
+		} 
+		groups[i] = group; 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Draws the Poisson(1) weights of a run of values in a bootstrap resample. 
+ * 
+ * Parameters 
+ * ========== 
+ * seed: 		The seed of the random weights 
+ * replicate: 	The number of the resample 
+ * start: 		The place of the first value among all of them 
+ * n: 			The number of values 
+ * w: 			A pointer to put the n weights into 
+ * 
+ * Notes 
+ * ===== 
+ * Each pair of values shares one splitmix64 draw on its place in the 
+ * resample's stream, half of the bits going to each, so a weight depends 
+ * only on the seed, the resample and the value's place, however the 
+ * values are split up between threads. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void poisson_weights(unsigned long seed, long replicate, long start, 
+	long n, unsigned int *w) {
+
+	long t; 
+	unsigned long long bits = 0ull; 
+	unsigned long long stream = key_hash(key_hash(seed) + 
+		(replicate + 1ull) * 0xBF58476D1CE4E5B9ull); 
+	for (t = start; t < start + n; t++) {
+		if (t == start || !(t & 1l)) {
+			bits = key_hash(stream + (t / 2 + 1ull) * 0x9E3779B97F4A7C15ull); 
+		} else {} 
+		w[t - start] = poisson_deviate((unsigned int) (t & 1l ? bits >> 32 : 
+			bits)); 
+	} 
+
+} 
+
+/* 
+ * Takes the values of a column in the rows which hold one, along with the 
+ * group of each row if there are groups. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * column: 		The column number 
+ * groups: 		The group number of each row, -1 for rows to leave out; NULL 
+ * 				to take every row 
+ * stats: 		The statistics to be taken; the values are sorted if any of 
+ * 				them is an order statistic 
+ * num_stats: 	The number of statistics 
+ * values: 		A pointer to put the values into 
+ * 
+ * Returns 
+ * ======= 
+ * The number of values 
+ */ 
+static long gather_values(DATAFRAME df, int column, long *groups, 
+	int *stats, int num_stats, RESAMPLE_VALUE **values) {
+
+	long i, n = 0l; 
+	int s, ordered = 0; 
+	*values = (RESAMPLE_VALUE *) malloc ((df.num_rows > 0l ? df.num_rows : 
+		1l) * sizeof(RESAMPLE_VALUE)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		if ((groups == NULL || groups[i] != -1l) && 
+			dfvalid(df, i, column)) {
+			(*values)[n].value = dfvalue(df, i, column); 
+			(*values)[n].group = groups != NULL ? groups[i] : 0l; 
+			n++; 
+		} else {} 
+	} 
+	for (s = 0; s < num_stats; s++) {
+		ordered |= stats[s] == BINNED_MIN || stats[s] == BINNED_MAX || 
+			stats[s] == BINNED_MEDIAN || stats[s] == BINNED_QUANTILE; 
+	} 
+	if (ordered) qsort(*values, n, sizeof(RESAMPLE_VALUE), compare_values); 
+	return n; 
+
+} 
+
+/* The mean of the values, finite or 0, to take the sums about */ 
+static double values_mean(RESAMPLE_VALUE *values, long n) {
+
+	long i; 
+	double sum = 0; 
+	for (i = 0l; i < n; i++) sum += values[i].value; 
+	return n && isfinite(sum / n) ? sum / n : 0; 
+
+} 
+
+/* Checks the statistics requested: 0 if they're all valid, else 1 */ 
+static int check_statistics(int *stats, double *fractions, int num_stats) {
+
+	int s; 
+	if (num_stats < 1) return 1; 
+	for (s = 0; s < num_stats; s++) {
+		if (stats[s] < BINNED_COUNT || stats[s] > BINNED_QUANTILE) {
+			return 1; 
+		} else if (stats[s] == BINNED_QUANTILE && 
+			!(fractions[s] >= 0 && fractions[s] <= 1)) {
+			return 1; 
+		} else {} 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Determine the statistics of the values under the weights of a resample, 
+ * with the same definitions as for the statistics within bins. 
+ * 
+ * Parameters 
+ * ========== 
+ * values: 		The values, sorted if any statistic is an order statistic 
+ * n: 			The number of values 
+ * weights: 	The weights of the resample 
+ * stats: 		The statistics to take 
+ * fractions: 	The quantile to take for each BINNED_QUANTILE statistic 
+ * num_stats: 	The number of statistics 
+ * results: 	A pointer to put the num_stats statistics into. A resample 
+ * 				with no weight has a count and sum of 0, and NaN for 
+ * 				everything else. 
+ * 
+ * Notes 
+ * ===== 
+ * The first pass accumulates the total weight, the weighted sums of the 
+ * values and of their squares, both taken about the mean of all of them 
+ * (shift) so that the variance doesn't lose precision, and the extrema. The 
+ * order statistics take a second pass over the sorted values, walking the 
+ * cumulative weight up to their ranks. Weights are integers, so a value of 
+ * weight w counts as w copies of it. 
+ */ 
+static void resample_statistics(RESAMPLE_VALUE *values, long n, 
+	double shift, RESAMPLE_WEIGHTS weights, int *stats, double *fractions, 
+	int num_stats, double *results) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * w: 			The weights of the current block of values 
+	 * total: 		The total weight 
+	 * s1, s2: 		The weighted sums of the values and their squares, less 
+	 * 				the shift 
+	 * lo, hi: 		The smallest and largest values with weight 
+	 * ordered: 	Whether or not any statistic needs the second pass 
+	 */ 
+	long i, total = 0l; 
+	int s, ordered = 0; 
+	unsigned int w[WEIGHT_BLOCK]; 
+	double s1 = 0, s2 = 0, lo = INFINITY, hi = -INFINITY; 
+	for (i = 0l; i < n; i++) {
+		if (!(i % WEIGHT_BLOCK)) resample_weight_block(weights, values, i, n, w); 
+		double x = values[i].value, delta = x - shift; 
+		double weight = w[i % WEIGHT_BLOCK]; 
+		total += w[i % WEIGHT_BLOCK]; 
+		s1 += weight * delta; 
+		s2 += weight * delta * delta; 
+		lo = w[i % WEIGHT_BLOCK] && x < lo ? x : lo; 
+		hi = w[i % WEIGHT_BLOCK] && x > hi ? x : hi; 
+	} 
+	if (total == 0l) {
+		for (s = 0; s < num_stats; s++) {
+			results[s] = (stats[s] == BINNED_COUNT || stats[s] == BINNED_SUM) ? 
+				0 : NAN; 
+		} 
+		return; 
+	} else {} 
+
+	for (s = 0; s < num_stats; s++) {
+		switch (stats[s]) {
+
+			case BINNED_COUNT: 
+				results[s] = total; 
+				break; 
+
+			case BINNED_SUM: 
+				results[s] = s1 + shift * total; 
+				break; 
+
+			case BINNED_MEAN: 
+				results[s] = shift + s1 / total; 
+				break; 
+
+			case BINNED_STD: 
+				results[s] = sqrt(max(s2 / total - (s1 / total) * (s1 / total), 
+					0.0)); 
+				break; 
+
+			case BINNED_MIN: 
+				results[s] = lo; 
+				break; 
+
+			case BINNED_MAX: 
+				results[s] = hi; 
+				break; 
+
+			case BINNED_MEDIAN: case BINNED_QUANTILE: 
+				/* Filled in below; the median as the mean of two ranks */ 
+				results[s] = 0; 
+				ordered = 1; 
+				break; 
+
+		} 
+	} 
+	if (!ordered) return; 
+
+	/* 
+	 * Walk the cumulative weight up to the highest rank, filling in each 
+	 * order statistic as the walk passes its rank(s), in ascending order. 
+	 * The median takes half of each of its two ranks. 
+	 */ 
+	int t, num_targets = 0; 
+	RANK_TARGET *targets = (RANK_TARGET *) malloc (2 * num_stats * 
+		sizeof(RANK_TARGET)); 
+	for (s = 0; s < num_stats; s++) {
+		if (stats[s] == BINNED_MEDIAN || stats[s] == BINNED_QUANTILE) {
+			int halves = stats[s] == BINNED_MEDIAN ? 2 : 1; 
+			for (t = 0; t < halves; t++) {
+				RANK_TARGET target = {resample_rank(stats[s], fractions[s], 
+					total, t), s, 1.0 / halves}; 
+				int k = num_targets++; 
+				while (k && targets[k - 1].rank > target.rank) {
+					targets[k] = targets[k - 1]; 
+					k--; 
+				} 
+				targets[k] = target; 
+			} 
+		} else {} 
+	} 
+	long cumulative = 0l; 
+	for (i = 0l, t = 0; i < n && t < num_targets; i++) {
+		if (!(i % WEIGHT_BLOCK)) resample_weight_block(weights, values, i, n, w); 
+		cumulative += w[i % WEIGHT_BLOCK]; 
+		while (t < num_targets && targets[t].rank < cumulative) {
+			results[targets[t].stat] += targets[t].share * values[i].value; 
+			t++; 
+		} 
+	} 
+	free(targets); 
+
+} 
+
+/* 
+ * The rank of an order statistic among a total weight of values: the lower 
+ * or upper of the two middle ranks for the median, and the rank of the 
+ * quantile for a quantile, as within bins. 
+ */ 
+static long resample_rank(int stat, double fraction, long total, int upper) {
+
+	if (stat == BINNED_MEDIAN) {
+		return upper ? total / 2l : (total - 1l) / 2l; 
+	} else {
+		return min((long) (fraction * total), total - 1l); 
+	} 
+
+} 
+
+/* 
+ * Determine the weights a resample gives a block of WEIGHT_BLOCK values, 
+ * starting at a multiple of WEIGHT_BLOCK. 
+ * 
+ * Parameters 
+ * ========== 
+ * weights: 	The weights of the resample 
+ * values: 		The values 
+ * i: 			The first value of the block 
+ * n: 			The number of values 
+ * w: 			A pointer to put the weights into; 0 past the last value 
+ */ 
+static void resample_weight_block(RESAMPLE_WEIGHTS weights, 
+	RESAMPLE_VALUE *values, long i, long n, unsigned int *w) {
+
+	int j; 
+	switch (weights.kind) {
+
+		case RESAMPLE_ALL: 
+			for (j = 0; j < WEIGHT_BLOCK; j++) w[j] = i + j < n; 
+			break; 
+
+		case RESAMPLE_BOOTSTRAP: {
+			long m = min(n - i, (long) WEIGHT_BLOCK); 
+			poisson_weights(weights.seed, weights.replicate, i, m, w); 
+			for (j = m; j < WEIGHT_BLOCK; j++) w[j] = 0u; 
+			break; 
+		} 
+
+		case RESAMPLE_JACKKNIFE: 
+			for (j = 0; j < WEIGHT_BLOCK; j++) {
+				w[j] = i + j < n && values[i + j].group != weights.replicate; 
+			} 
+			break; 
+
+	} 
+
+} 
+
+/* 
+ * A Poisson(1) deviate from a uniform 32-bit deviate, by inverting the 
+ * cumulative distribution: the number of its values, times 2^32 and 
+ * rounded down, which the deviate is at or above. The probability of 13 or 
+ * more is below 2^-32. 
+ */ 
+static unsigned int poisson_deviate(unsigned int u) {
+
+	static const unsigned int cdf[13] = {
+		1580030168u, 3160060337u, 3950075421u, 4213413783u, 4279248373u, 
+		4292415291u, 4294609777u, 4294923276u, 4294962463u, 4294966817u, 
+		4294967252u, 4294967292u, 4294967295u 
+	}; 
+	/* Nearly always under 4, so count those thresholds without branching */ 
+	unsigned int k = (u >= cdf[0]) + (u >= cdf[1]) + (u >= cdf[2]) + 
+		(u >= cdf[3]); 
+	while (k < 13u && u >= cdf[k]) k++; 
+	return k; 
+
+} 
+
+/* Orders values in ascending order */ 
+static int compare_values(const void *a, const void *b) {
+
+	double x = (*((const RESAMPLE_VALUE *) a)).value; 
+	double y = (*((const RESAMPLE_VALUE *) b)).value; 
+	return (x > y) - (x < y); 
+
+} 
+
@@ -0,0 +1,574 @@
+/* 
+ * This file scripts the top-k and sampling operators: finding the k rows 
+ * with the largest or smallest values in a column, and drawing uniform or 
+ * weighted random samples of k rows. Both keep the k rows with the largest 
+ * keys, where a sample's keys are random (Efraimidis & Spirakis 2006 for 
+ * the weighted case), so both run in one pass with O(k) memory. Each thread 
+ * keeps a bounded heap of its rows, and the heaps are merged at the end. 
+ * Reservoirs carry the same operators across the chunks of a file stream. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* 
+ * What the keys of the rows are drawn from. 
+ * 
+ * Fields 
+ * ====== 
+ * column: 		The column to rank by, or the column of weights for a 
+ * 				weighted sample; -1 for a uniform sample 
+ * largest: 	1 to keep the rows with the largest values, 0 the smallest 
+ * random: 		1 for a sample, 0 for a top-k 
+ * seed: 		The seed of the random keys 
+ * start: 		The number of rows before the first one of the dataframe, 
+ * 				such that each row of a stream gets its own random key 
+ */ 
+typedef struct key_spec {
+
+	int column; 
+	int largest; 
+	int random; 
+	unsigned long seed; 
+	long start; 
+
+} KEY_SPEC; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static long top_entries(DATAFRAME df, KEY_SPEC spec, long k, 
+	TOP_ENTRY *result); 
+static int row_key(DATAFRAME df, KEY_SPEC spec, long i, 
+	unsigned long long *key); 
+static unsigned long long double_key(double value); 
+static void heap_offer(TOP_ENTRY *heap, long *size, long k, TOP_ENTRY entry); 
+static void heap_sift_down(TOP_ENTRY *heap, long size, long i); 
+static int entry_better(TOP_ENTRY a, TOP_ENTRY b); 
+static int compare_best(const void *a, const void *b); 
+static int compare_rows(const void *a, const void *b); 
+static RESERVOIR *reservoir_allocate(long k, int num_cols, int *types); 
+static void reservoir_store(RESERVOIR *r, DATAFRAME df, long row, long slot); 
+
+/* 
+ * Finds the rows of a dataframe with the largest or smallest values in a 
+ * column. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to rank by 
+ * k: 			The number of rows to find 
+ * largest: 	1 for the largest values, 0 for the smallest 
+ * rows: 		A pointer to put the row numbers into, best first; room for k 
+ * num_rows: 	A pointer to put the number of rows found into, which is less 
+ * 				than k if fewer rows hold a value 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number or k 
+ * 
+ * Notes 
+ * ===== 
+ * Rows missing the value or holding a NaN are never chosen. Ties go to the 
+ * earlier row. Integer columns are compared exactly. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_top(DATAFRAME df, int column, long k, int largest, 
+	long *rows, long *num_rows) {
+
+	long i; 
+	if (column < 0 || column >= df.num_cols || k < 0l) return 1; 
+	KEY_SPEC spec = {column, largest, 0, 0ul, 0l}; 
+	TOP_ENTRY *entries = (TOP_ENTRY *) malloc ((k > 0l ? k : 1l) * 
+		sizeof(TOP_ENTRY)); 
+	*num_rows = top_entries(df, spec, k, entries); 
+	for (i = 0l; i < *num_rows; i++) rows[i] = entries[i].row; 
+	free(entries); 
+	return 0; 
+
+} 
+
+/* 
+ * Draws a random sample of the rows of a dataframe without replacement. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * k: 			The number of rows to draw 
+ * weights: 	The column number of the weights of the rows; -1 to draw 
+ * 				every row with equal probability 
+ * seed: 		The seed of the random numbers 
+ * rows: 		A pointer to put the row numbers into, in ascending order; 
+ * 				room for k 
+ * num_rows: 	A pointer to put the number of rows drawn into, which is less 
+ * 				than k if the dataframe has fewer (positively weighted) rows 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on an invalid column number or k 
+ * 
+ * Notes 
+ * ===== 
+ * Rows with a missing, NaN, zero or negative weight are never drawn. The 
+ * random numbers are a function of the seed and the row number alone, so 
+ * the sample doesn't depend on the number of threads. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_sample(DATAFRAME df, long k, int weights, 
+	unsigned long seed, long *rows, long *num_rows) {
+
+	long i; 
+	if (weights < -1 || weights >= df.num_cols || k < 0l) return 1; 
+	KEY_SPEC spec = {weights, 1, 1, seed, 0l}; 
+	TOP_ENTRY *entries = (TOP_ENTRY *) malloc ((k > 0l ? k : 1l) * 
+		sizeof(TOP_ENTRY)); 
+	*num_rows = top_entries(df, spec, k, entries); 
+	qsort(entries, *num_rows, sizeof(TOP_ENTRY), compare_rows); 
+	for (i = 0l; i < *num_rows; i++) rows[i] = entries[i].row; 
+	free(entries); 
+	return 0; 
+
+} 
+
+/* 
+ * Allocates memory for a reservoir keeping the rows with the largest or 
+ * smallest values in a column across the chunks of a stream. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The number of rows to keep 
+ * num_cols: 	The number of columns of the chunks 
+ * types: 		The type of each column, as the COLUMN_* codes 
+ * column: 		The column number to rank by 
+ * largest: 	1 for the largest values, 0 for the smallest 
+ * 
+ * Returns 
+ * ======= 
+ * The reservoir; NULL on an invalid column number or k 
+ * 
+ * header: dataframe.h 
+ */ 
+extern RESERVOIR *top_reservoir_initialize(long k, int num_cols, int *types, 
+	int column, int largest) {
+
+	if (column < 0 || column >= num_cols || k < 0l) return NULL; 
+	RESERVOIR *r = reservoir_allocate(k, num_cols, types); 
+	r -> column = column; 
+	r -> largest = largest; 
+	r -> random = 0; 
+	return r; 
+
+} 
+
+/* 
+ * Allocates memory for a reservoir drawing a random sample of the rows 
+ * across the chunks of a stream. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The number of rows to draw 
+ * num_cols: 	The number of columns of the chunks 
+ * types: 		The type of each column, as the COLUMN_* codes 
+ * weights: 	The column number of the weights of the rows; -1 to draw 
+ * 				every row with equal probability 
+ * seed: 		The seed of the random numbers 
+ * 
+ * Returns 
+ * ======= 
+ * The reservoir; NULL on an invalid column number or k 
+ * 
+ * header: dataframe.h 
+ */ 
+extern RESERVOIR *sample_reservoir_initialize(long k, int num_cols, 
+	int *types, int weights, unsigned long seed) {
+
+	if (weights < -1 || weights >= num_cols || k < 0l) return NULL; 
+	RESERVOIR *r = reservoir_allocate(k, num_cols, types); 
+	r -> column = weights; 
+	r -> largest = 1; 
+	r -> random = 1; 
+	r -> seed = seed; 
+	return r; 
+
+} 
+
+/* 
+ * Frees the memory stored in a reservoir. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void free_reservoir(RESERVOIR *r) {
+
+	int j; 
+	if (r == NULL) return; 
+	for (j = 0; j < (*r).num_cols; j++) {
+		free(r -> values[j]); 
+		free(r -> valid[j]); 
+	} 
+	free(r -> values); 
+	free(r -> valid); 
+	free(r -> types); 
+	free(r -> heap); 
+	free(r); 
+
+} 
+
+/* 
+ * Offers the rows of a dataframe, e.g. a chunk of a stream, to a reservoir, 
+ * which copies those it keeps. 
+ * 
+ * Parameters 
+ * ========== 
+ * r: 			The reservoir 
+ * df: 			The dataframe, with the columns the reservoir was made for 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if the columns don't match 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int reservoir_update(RESERVOIR *r, DATAFRAME df) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * spec: 		What the keys are drawn from, numbering the rows after 
+	 * 				those seen before 
+	 * candidates: 	The best k rows of the dataframe, best first 
+	 * n: 			The number of candidates 
+	 */ 
+	long i, n; 
+	int j; 
+	if (df.num_cols != (*r).num_cols) return 1; 
+	for (j = 0; j < df.num_cols; j++) {
+		if (dftype(df, j) != (*r).types[j]) return 1; 
+	} 
+	KEY_SPEC spec = {(*r).column, (*r).largest, (*r).random, (*r).seed, 
+		(*r).seen}; 
+	TOP_ENTRY *candidates = (TOP_ENTRY *) malloc (((*r).k > 0l ? (*r).k : 
+		1l) * sizeof(TOP_ENTRY)); 
+	n = top_entries(df, spec, (*r).k, candidates); 
+
+	for (i = 0l; i < n; i++) {
+		TOP_ENTRY entry = candidates[i]; 
+		entry.row += (*r).seen; 
+		if ((*r).size < (*r).k) {
+			entry.slot = (*r).size; 
+			reservoir_store(r, df, candidates[i].row, entry.slot); 
+			heap_offer(r -> heap, &(r -> size), (*r).k, entry); 
+		} else if (entry_better(entry, (*r).heap[0])) {
+			entry.slot = (*r).heap[0].slot; 
+			reservoir_store(r, df, candidates[i].row, entry.slot); 
+			r -> heap[0] = entry; 
+			heap_sift_down(r -> heap, (*r).size, 0l); 
+		} else {
+			break; /* the rest of the candidates are worse still */ 
+		} 
+	} 
+	r -> seen += df.num_rows; 
+	free(candidates); 
+	return 0; 
+
+} 
+
+/* 
+ * Takes the rows a reservoir has kept as a dataframe of their own. 
+ * 
+ * Parameters 
+ * ========== 
+ * r: 			The reservoir 
+ * dest: 		The dataframe to put the rows into. A top-k reservoir's rows 
+ * 				come best first, and a sample's in the order they were 
+ * 				offered in. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void reservoir_rows(RESERVOIR *r, DATAFRAME *dest) {
+
+	long i; 
+	int j; 
+	TOP_ENTRY *order = (TOP_ENTRY *) malloc (((*r).size > 0l ? (*r).size : 
+		1l) * sizeof(TOP_ENTRY)); 
+	memcpy(order, (*r).heap, (*r).size * sizeof(TOP_ENTRY)); 
+	qsort(order, (*r).size, sizeof(TOP_ENTRY), (*r).random ? 
+		compare_rows : compare_best); 
+
+	dataframe_reserve_columns(dest, (*r).num_cols); 
+	for (j = 0; j < (*r).num_cols; j++) {
+		unsigned long size = column_type_size((*r).types[j]); 
+		COLUMN_BUFFER *buffer = column_buffer_initialize((*r).size, 
+			(*r).types[j]); 
+		int all_valid = 1; 
+		for (i = 0l; i < (*r).size; i++) {
+			memcpy((char *) buffer -> values + i * size, (char *) 
+				(*r).values[j] + order[i].slot * size, size); 
+			all_valid &= (*r).valid[j][order[i].slot]; 
+		} 
+		if (!all_valid) {
+			buffer -> validity = (unsigned char *) calloc ( 
+				validity_bytes((*r).size), sizeof(unsigned char)); 
+			for (i = 0l; i < (*r).size; i++) {
+				if ((*r).valid[j][order[i].slot]) {
+					buffer -> validity[i >> 3] |= 1 << (i & 7); 
+				} else {} 
+			} 
+		} else {} 
+		dest -> columns[j] = buffer; 
+	} 
+	dest -> num_cols = (*r).num_cols; 
+	dest -> num_rows = (*r).size; 
+	dest -> offset = 0l; 
+	dest -> index = NULL; 
+	free(order); 
+
+} 
+
+/* 
+ * Finds the k rows of a dataframe with the largest keys, each thread 
+ * keeping a bounded heap of its block of rows. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * spec: 		What the keys are drawn from 
+ * k: 			The number of rows to find 
+ * result: 		A pointer to put the rows into, best first; room for k 
+ * 
+ * Returns 
+ * ======= 
+ * The number of rows found 
+ */ 
+static long top_entries(DATAFRAME df, KEY_SPEC spec, long k, 
+	TOP_ENTRY *result) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * num_blocks: 	The number of blocks of rows, one per thread 
+	 * heaps: 		The heap of each block, with room for min(k, block size) 
+	 * 				rows and holding sizes[b] of them 
+	 */ 
+	long b, i, num_blocks = 1l, size = 0l; 
+	if (k == 0l || df.num_rows == 0l) return 0l; 
+	#ifdef _OPENMP 
+	num_blocks = min((long) omp_get_max_threads(), df.num_rows); 
+	#endif /* _OPENMP */ 
+	TOP_ENTRY **heaps = (TOP_ENTRY **) malloc (num_blocks * 
+		sizeof(TOP_ENTRY *)); 
+	long *sizes = (long *) calloc (num_blocks, sizeof(long)); 
+
+	#pragma omp parallel for schedule(static, 1) 
+	for (b = 0l; b < num_blocks; b++) {
+		long j, first = df.num_rows * b / num_blocks; 
+		long last = df.num_rows * (b + 1l) / num_blocks; 
+		long capacity = min(k, last - first); 
+		heaps[b] = (TOP_ENTRY *) malloc (capacity * sizeof(TOP_ENTRY)); 
+		for (j = first; j < last; j++) {
+			TOP_ENTRY entry; 
+			if (row_key(df, spec, j, &entry.key)) {
+				entry.row = j; 
+				entry.slot = 0l; 
+				heap_offer(heaps[b], &sizes[b], capacity, entry); 
+			} else {} 
+		} 
+	} 
+
+	/* Merge the heaps of the blocks into one */ 
+	for (b = 0l; b < num_blocks; b++) {
+		for (i = 0l; i < sizes[b]; i++) {
+			heap_offer(result, &size, k, heaps[b][i]); 
+		} 
+		free(heaps[b]); 
+	} 
+	free(heaps); 
+	free(sizes); 
+	qsort(result, size, sizeof(TOP_ENTRY), compare_best); 
+	return size; 
+
+} 
+
+/* 
+ * Determines the key of a row of a dataframe, larger being better. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe 
+ * spec: 		What the key is drawn from 
+ * i: 			The row number 
+ * key: 		A pointer to put the key into 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if the row may be chosen, 0 if its value or weight is missing, NaN, or 
+ * (for a weight) not positive 
+ */ 
+static int row_key(DATAFRAME df, KEY_SPEC spec, long i, 
+	unsigned long long *key) {
+
+	if (spec.random) {
+		/* splitmix64 on the row's place in the stream */ 
+		unsigned long long bits = key_hash(key_hash(spec.seed) + 
+			(spec.start + i + 1ull) * 0x9E3779B97F4A7C15ull); 
+		if (spec.column == -1) {
+			*key = bits; 
+			return 1; 
+		} else {
+			COLUMN_BUFFER *buffer = df.columns[spec.column]; 
+			long row = dfrow_index(df, i); 
+			if (!column_valid(buffer, row)) return 0; 
+			double weight = column_value(buffer, row); 
+			if (!(weight > 0)) return 0; 
+			/* u^(1 / w) for u uniform on (0, 1), compared by its log */ 
+			double u = ((bits >> 11) + 0.5) / 9007199254740992.0; 
+			*key = double_key(log(u) / weight); 
+			return 1; 
+		} 
+	} else {
+		COLUMN_BUFFER *buffer = df.columns[spec.column]; 
+		if (!column_key(buffer, dfrow_index(df, i), 
+			column_is_integer((*buffer).type), key)) return 0; 
+		if (!spec.largest) *key = ~*key; 
+		return 1; 
+	} 
+
+} 
+
+/* Maps a double onto an unsigned integer with the same order */ 
+static unsigned long long double_key(double value) {
+
+	unsigned long long bits; 
+	memcpy(&bits, &value, sizeof(double)); 
+	return (bits >> 63) ? ~bits : bits | (1ull << 63); 
+
+} 
+
+/* 
+ * Offers an entry to a heap holding the best k entries seen, with the 
+ * worst of them at the root. 
+ */ 
+static void heap_offer(TOP_ENTRY *heap, long *size, long k, TOP_ENTRY entry) {
+
+	if (*size < k) {
+		long i = (*size)++; 
+		while (i > 0l && entry_better(heap[(i - 1l) / 2l], entry)) {
+			heap[i] = heap[(i - 1l) / 2l]; 
+			i = (i - 1l) / 2l; 
+		} 
+		heap[i] = entry; 
+	} else if (k > 0l && entry_better(entry, heap[0])) {
+		heap[0] = entry; 
+		heap_sift_down(heap, *size, 0l); 
+	} else {} 
+
+} 
+
+/* Moves an entry of a heap down until its children are no worse than it */ 
+static void heap_sift_down(TOP_ENTRY *heap, long size, long i) {
+
+	TOP_ENTRY entry = heap[i]; 
+	while (2l * i + 1l < size) {
+		long child = 2l * i + 1l; 
+		if (child + 1l < size && entry_better(heap[child], 
+			heap[child + 1l])) child++; 
+		if (entry_better(entry, heap[child])) {
+			heap[i] = heap[child]; 
+			i = child; 
+		} else {
+			break; 
+		} 
+	} 
+	heap[i] = entry; 
+
+} 
+
+/* Whether one entry outranks another: a larger key, or the earlier row */ 
+static int entry_better(TOP_ENTRY a, TOP_ENTRY b) {
+
+	return a.key != b.key ? a.key > b.key : a.row < b.row; 
+
+} 
+
+/* Orders entries best first */ 
+static int compare_best(const void *a, const void *b) {
+
+	return entry_better(*((const TOP_ENTRY *) b), *((const TOP_ENTRY *) a)) - 
+		entry_better(*((const TOP_ENTRY *) a), *((const TOP_ENTRY *) b)); 
+
+} 
+
+/* Orders entries by their row numbers */ 
+static int compare_rows(const void *a, const void *b) {
+
+	const TOP_ENTRY *x = (const TOP_ENTRY *) a; 
+	const TOP_ENTRY *y = (const TOP_ENTRY *) b; 
+	return ((*x).row > (*y).row) - ((*x).row < (*y).row); 
+
+} 
+
+/* Allocates a reservoir with room for k rows of the given columns */ 
+static RESERVOIR *reservoir_allocate(long k, int num_cols, int *types) {
+
+	int j; 
+	RESERVOIR *r = (RESERVOIR *) malloc (sizeof(RESERVOIR)); 
+	r -> k = k; 
+	r -> size = 0l; 
+	r -> seen = 0l; 
+	r -> seed = 0ul; 
+	r -> num_cols = num_cols; 
+	r -> types = (int *) malloc (num_cols * sizeof(int)); 
+	r -> values = (void **) malloc (num_cols * sizeof(void *)); 
+	r -> valid = (unsigned char **) malloc (num_cols * 
+		sizeof(unsigned char *)); 
+	for (j = 0; j < num_cols; j++) {
+		r -> types[j] = types[j]; 
+		r -> values[j] = malloc ((k > 0l ? k : 1l) * 
+			column_type_size(types[j])); 
+		r -> valid[j] = (unsigned char *) malloc ((k > 0l ? k : 1l) * 
+			sizeof(unsigned char)); 
+	} 
+	r -> heap = (TOP_ENTRY *) malloc ((k > 0l ? k : 1l) * sizeof(TOP_ENTRY)); 
+	return r; 
+
+} 
+
+/* Copies a row of a dataframe into a slot of a reservoir */ 
+static void reservoir_store(RESERVOIR *r, DATAFRAME df, long row, long slot) {
+
+	int j; 
+	long i = dfrow_index(df, row); 
+	for (j = 0; j < (*r).num_cols; j++) {
+		COLUMN_BUFFER *buffer = df.columns[j]; 
+		r -> valid[j][slot] = column_valid(buffer, i); 
+		switch ((*buffer).type) {
+
+			case COLUMN_FLOAT64: 
+				((double *) r -> values[j])[slot] = column_value(buffer, i); 
+				break; 
+
+			case COLUMN_FLOAT32: 
+				((float *) r -> values[j])[slot] = column_value(buffer, i); 
+				break; 
+
+			case COLUMN_INT64: 
+				((long long *) r -> values[j])[slot] = column_integer(buffer, 
+					i); 
+				break; 
+
+			case COLUMN_INT32: 
+				((int *) r -> values[j])[slot] = column_integer(buffer, i); 
+				break; 
+
+		} 
+	} 
+
+} 
+
@@ -12,7 +12,29 @@
 /* ---------- Static routine comment headers not duplicated here  ---------- */ 
 // static double **copy_only_filtered(DATAFRAME df, int *test); 
 static int *get_test_results(DATAFRAME df, int column, double value, 
-	int relational_code); 
+	long long *integer, int relational_code); 
+
+/* 
+ * Fills test with whether the value in each row of a column of C type ctype 
+ * holds a relation to a value, both taken as C type vtype. These expand 
+ * inside get_test_results, so the type and the relation are decided once 
+ * per column rather than once per row. 
+ */ 
+#define ROW_TEST(ctype, vtype, op, v) \
+	for (i = 0l; i < df.num_rows; i++) { \
+		long j = dfrow_index(df, i); \
+		test[i] = column_valid(buffer, j) && \
+			(vtype) ((ctype *) values)[j] op (v); \
+	} 
+#define RELATION_TEST(ctype, vtype, v) \
+	switch (relational_code) { \
+		case 1: ROW_TEST(ctype, vtype, <, v); break; \
+		case 2: ROW_TEST(ctype, vtype, <=, v); break; \
+		case 3: ROW_TEST(ctype, vtype, ==, v); break; \
+		case 4: ROW_TEST(ctype, vtype, >=, v); break; \
+		case 5: ROW_TEST(ctype, vtype, >, v); break; \
+		case 6: ROW_TEST(ctype, vtype, !=, v); break; \
+	} 
 
 #if 0
 /* 
@@ -86,7 +108,8 @@ extern int sieve(DATAFRAME *df, int column, double value, int relational_code) {
 
 /* 
  * Filter the dataset based on some condition applied to the values stored in 
- * a given column. 
+ * a given column. The filtered dataframe is a view of the rows of the source 
+ * which pass; no data are copied. 
  * 
  * Parameters 
  * ========== 
@@ -115,54 +138,63 @@ extern int sieve(DATAFRAME source, DATAFRAME *dest, int column, double value,
 	 * =========== 
 	 * test: 		0s at the positions of data points that don't pass the test, 
 	 * 				1s at the ones that do 
-	 * i, j: 		for-looping 
-	 * n: 			The line number in the new dataframe 
 	 * 
-	 * Start by figuring out which lines passed the test 
+	 * Start by figuring out which lines passed the test, then view them. 
 	 */
-	long i, n = 0l; 
-	int j, *test = get_test_results(source, column, value, relational_code); 
+	int status, *test = get_test_results(source, column, value, NULL, 
+		relational_code); 
 	if (test == NULL) return 1; /* return 1 on failure */ 
-	
-	/* 
-	 * The new dataframe should have the same dimensionality as the source 
-	 * data. The number of rows will be the sum of the test array
-	 */ 
-	dest -> num_cols = source.num_cols;  
-	dest -> num_rows = int_sum(test, source.num_rows); 
-	dest -> data = (double **) malloc ((*dest).num_rows * sizeof(double *)); 
+	status = dataframe_select_mask(source, dest, test); 
+	free(test); 
+	return status; 
 
-	/* 
-	 * Go through the old data line by line and copy the lines that pass the 
-	 * filter. 
-	 */ 
-	for (i = 0l; i < source.num_rows; i++) {
-		if (test[i]) {
-			dest -> data[n] = (double *) malloc ((*dest).num_cols * 
-				sizeof(double)); 
-			for (j = 0; j < (*dest).num_cols; j++) {
-				dest -> data[n][j] = source.data[i][j]; 
-			} 
-			n++; /* Next line */ 
-		} else {
-			continue; 
-		} 
-	} 
+}
 
+/* 
+ * Filter the dataset based on some condition applied to the values stored in 
+ * an integer column, comparing them to an integer exactly. Comparing as 
+ * doubles, as sieve does, can't tell apart integers past 2^53, e.g. halo IDs. 
+ * A column of floating point values is compared as in sieve. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 				The dataframe containing the data to be filtered 
+ * dest: 				A pointer to the dataframe to put the filtered data into 
+ * column: 				The column number to filter based on 
+ * value: 				The integer to compare to for filtering 
+ * relational_code:		As in sieve 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sieve_integer(DATAFRAME source, DATAFRAME *dest, int column, 
+	long long value, int relational_code) {
+
+	int status, *test = get_test_results(source, column, (double) value, 
+		&value, relational_code); 
+	if (test == NULL) return 1; 
+	status = dataframe_select_mask(source, dest, test); 
 	free(test); 
-	return 0; 
+	return status; 
 
-}
+} 
 
 /* 
  * Iterates over each row of the dataframe and determines if each row satisfies 
- * a given relation. 
+ * a given relation. The comparison is made in the type of the column: 
+ * integer columns are compared to an integer value exactly. Missing values 
+ * fail every relation. 
  * 
  * Parameters 
  * ========== 
  * df: 					The DATAFRAME struct 
  * column:				The column to condition the data on 
  * value: 				The value to compare each column to 
+ * integer: 			The same value as an integer, to compare integer columns 
+ * 						to; NULL to compare every column as doubles 
  * relational_code: 	1 for < 
  * 						2 for <= 
  *						3 for = 
@@ -176,32 +208,85 @@ extern int sieve(DATAFRAME source, DATAFRAME *dest, int column, double value,
  * 1 at the position of those that passed. 
  */ 
 static int *get_test_results(DATAFRAME df, int column, double value, 
-	int relational_code) {
+	long long *integer, int relational_code) {
 
 	/* 
 	 * Allocate memory for an array of boolean ints, and determine if each 
 	 * row satisfies the relation.  
 	 */ 
 	long i; 
-	int *test = (int *) malloc (df.num_rows * sizeof(int)); 
-	for (i = 0l; i < df.num_rows; i++) {
-		/* Look at each value and store a 1 if the relation holds, else 0. */ 
-		if (relational_code == 1) { 
-			test[i] = df.data[i][column] < value; /* 1: < */ 
-		} else if (relational_code == 2) { 
-			test[i] = df.data[i][column] <= value; /* 2 <= */  
-		} else if (relational_code == 3) { 
-			test[i] = df.data[i][column] == value; /* 3: == */ 
-		} else if (relational_code == 4) {
-			test[i] = df.data[i][column] >= value; /* 4: >= */ 
-		} else if (relational_code == 5) {
-			test[i] = df.data[i][column] > value; /* 5: > */ 
-		} else if (relational_code == 6) {
-			test[i] = df.data[i][column] != value; /* 6: != */ 
-		} else { 
+	if (column < 0 || column >= df.num_cols) return NULL; 
+	if (relational_code < 1 || relational_code > 6) return NULL; 
+	int *test = (int *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+		sizeof(int)); 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	void *values = (*buffer).values; 
+	if (dfcolumn_runs(df, column)) {
+		/* A slice of a run-length encoded column: one test per run */ 
+		rle_test(buffer, df.offset, df.offset + df.num_rows, value, integer, 
+			relational_code, test); 
+		return test; 
+	} else if ((*buffer).encoding != NULL) {
+		/* Otherwise encoded columns are decoded one value at a time */ 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < df.num_rows; i++) {
+			long j = dfrow_index(df, i); 
+			if (!column_valid(buffer, j)) {
+				test[i] = 0; 
+			} else if (integer != NULL && column_is_integer((*buffer).type)) {
+				long long x = column_integer(buffer, j); 
+				switch (relational_code) {
+					case 1: test[i] = x < *integer; break; 
+					case 2: test[i] = x <= *integer; break; 
+					case 3: test[i] = x == *integer; break; 
+					case 4: test[i] = x >= *integer; break; 
+					case 5: test[i] = x > *integer; break; 
+					default: test[i] = x != *integer; break; 
+				} 
+			} else {
+				double x = column_value(buffer, j); 
+				switch (relational_code) {
+					case 1: test[i] = x < value; break; 
+					case 2: test[i] = x <= value; break; 
+					case 3: test[i] = x == value; break; 
+					case 4: test[i] = x >= value; break; 
+					case 5: test[i] = x > value; break; 
+					default: test[i] = x != value; break; 
+				} 
+			} 
+		} 
+		return test; 
+	} else {} 
+	switch (dftype(df, column)) {
+
+		case COLUMN_FLOAT64: 
+			RELATION_TEST(double, double, value); 
+			break; 
+
+		case COLUMN_FLOAT32: 
+			RELATION_TEST(float, double, value); 
+			break; 
+
+		case COLUMN_INT64: 
+			if (integer != NULL) {
+				RELATION_TEST(long long, long long, *integer); 
+			} else {
+				RELATION_TEST(long long, double, value); 
+			} 
+			break; 
+
+		case COLUMN_INT32: 
+			if (integer != NULL) {
+				RELATION_TEST(int, long long, *integer); 
+			} else {
+				RELATION_TEST(int, double, value); 
+			} 
+			break; 
+
+		default: 
 			free(test); 
-			return NULL; /* Unallowed relational code */ 
-		}
+			return NULL; 
+
 	} 
 	return test; 
 
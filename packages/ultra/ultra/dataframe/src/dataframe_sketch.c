@@ -0,0 +1,527 @@
+/* 
+ * This file scripts the streaming quantile sketch: a KLL sketch (Karnin, 
+ * Lang & Liberty 2016) of a stream of doubles. It holds a hierarchy of 
+ * compactors, where items at level h each stand in for 2^h items of the 
+ * stream. Whenever a level fills up it is sorted and every other item is 
+ * promoted to the next level, so memory stays bounded at O(k log(n / k)) 
+ * while quantiles are accurate to a rank error of roughly 1.7 / k. Sketches 
+ * are mergeable, so they can be built per thread or per file and combined. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* The ratio between the capacities of adjacent levels */ 
+#ifndef SKETCH_CAPACITY_RATIO 
+#define SKETCH_CAPACITY_RATIO (2.0 / 3.0) 
+#endif /* SKETCH_CAPACITY_RATIO */ 
+
+/* A weighted item of the sketch, for answering quantile queries */ 
+typedef struct sketch_item {
+
+	double value; 
+	double weight; 
+
+} SKETCH_ITEM; 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static long level_capacity(QUANTILE_SKETCH *s, int level); 
+static int sketch_compress(QUANTILE_SKETCH *s); 
+static int sketch_add_level(QUANTILE_SKETCH *s); 
+static int level_reserve(QUANTILE_SKETCH *s, int level, long count); 
+static void level_append(QUANTILE_SKETCH *s, int level, double value); 
+static int coin_flip(QUANTILE_SKETCH *s); 
+static int compare_doubles(const void *a, const void *b); 
+static int compare_items(const void *a, const void *b); 
+
+/* 
+ * Allocates memory for an empty quantile sketch and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * k: 			The accuracy parameter: the capacity of the top level. Rank 
+ * 				errors scale as ~1.7 / k. 
+ * seed: 		The seed for the random promotions during compaction 
+ * 
+ * Returns 
+ * ======= 
+ * The sketch; NULL if k < 2 or the memory can't be allocated 
+ * 
+ * header: dataframe.h 
+ */ 
+extern QUANTILE_SKETCH *sketch_initialize(int k, unsigned long seed) {
+
+	if (k < 2) return NULL; 
+	QUANTILE_SKETCH *s = (QUANTILE_SKETCH *) malloc (sizeof(QUANTILE_SKETCH)); 
+	if (s == NULL) return NULL; 
+	s -> k = k; 
+	s -> n = 0l; 
+	s -> min = 0; 
+	s -> max = 0; 
+	/* xorshift requires a non-zero state */ 
+	s -> state = seed ? seed : 0x9E3779B97F4A7C15ul; 
+	s -> num_levels = 0; 
+	s -> size = 0l; 
+	s -> capacity = 0l; 
+	s -> levels = NULL; 
+	s -> sizes = NULL; 
+	s -> allocated = NULL; 
+	if (sketch_add_level(s)) {
+		free_sketch(s); 
+		return NULL; 
+	} else {
+		return s; 
+	} 
+
+} 
+
+/* 
+ * Frees the memory stored by a quantile sketch. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void free_sketch(QUANTILE_SKETCH *s) {
+
+	int i; 
+	for (i = 0; i < (*s).num_levels; i++) {
+		free(s -> levels[i]); 
+	} 
+	free(s -> levels); 
+	free(s -> sizes); 
+	free(s -> allocated); 
+	free(s); 
+
+} 
+
+/* 
+ * Adds a value to a quantile sketch. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The sketch itself 
+ * value: 		The value to add. NaNs are ignored. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated. The sketch remains valid 
+ * either way, with or without the value. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sketch_update(QUANTILE_SKETCH *s, double value) {
+
+	if (isnan(value)) return 0; 
+	if (level_reserve(s, 0, 1l)) return 1; 
+	level_append(s, 0, value); 
+	if ((*s).n == 0l) {
+		s -> min = value; 
+		s -> max = value; 
+	} else {
+		s -> min = min((*s).min, value); 
+		s -> max = max((*s).max, value); 
+	} 
+	s -> n++; 
+	return (*s).size >= (*s).capacity ? sketch_compress(s) : 0; 
+
+} 
+
+/* 
+ * Adds an array of values to a quantile sketch. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The sketch itself 
+ * arr: 		The values to add 
+ * length: 		The number of values in arr 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated, in which case the values 
+ * after the one which failed aren't added 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sketch_update_array(QUANTILE_SKETCH *s, double *arr, 
+	long length) {
+
+	long i; 
+	for (i = 0l; i < length; i++) {
+		if (sketch_update(s, arr[i])) return 1; 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Merges one quantile sketch into another. The source sketch is unchanged. 
+ * 
+ * Parameters 
+ * ========== 
+ * dest: 		The sketch to merge into 
+ * source: 		The sketch to merge from 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if memory can't be allocated. The destination remains 
+ * valid either way, and holds none of the source unless the failure came 
+ * while compacting the merged levels. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sketch_merge(QUANTILE_SKETCH *dest, QUANTILE_SKETCH *source) {
+
+	int h; 
+	long i; 
+	if ((*source).n == 0l) return 0; 
+	/* Make room for every item first, so that the merge can't fail midway */ 
+	for (h = 0; h < (*source).num_levels; h++) {
+		if ((*dest).num_levels <= h && sketch_add_level(dest)) return 1; 
+		if (level_reserve(dest, h, (*source).sizes[h])) return 1; 
+	} 
+	if ((*dest).n == 0l) {
+		dest -> min = (*source).min; 
+		dest -> max = (*source).max; 
+	} else {
+		dest -> min = min((*dest).min, (*source).min); 
+		dest -> max = max((*dest).max, (*source).max); 
+	} 
+	dest -> n += (*source).n; 
+
+	/* Items keep their weight, so each level appends onto the same level */ 
+	for (h = 0; h < (*source).num_levels; h++) {
+		for (i = 0l; i < (*source).sizes[h]; i++) {
+			level_append(dest, h, (*source).levels[h][i]); 
+		} 
+	} 
+	while ((*dest).size >= (*dest).capacity) {
+		if (sketch_compress(dest)) return 1; 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Determine approximate quantiles of the stream a sketch has seen. The 
+ * quantile q is taken as the value at rank (long) (q * n), as in the exact 
+ * ptr_quantiles, and q = 0 and q = 1 give the exact minimum and maximum. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 				The sketch itself 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * values: 			A pointer to put the quantiles into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (an empty sketch, quantiles outside [0, 1], or 
+ * memory which can't be allocated) 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sketch_quantiles(QUANTILE_SKETCH *s, double *fractions, 
+	int num_fractions, double *values) {
+
+	int h, i; 
+	long j, n = 0l; 
+	if ((*s).n == 0l) return 1; 
+	for (i = 0; i < num_fractions; i++) {
+		if (fractions[i] < 0 || fractions[i] > 1) return 1; 
+	} 
+
+	/* Pull every item with its weight and sort by value */ 
+	SKETCH_ITEM *items = (SKETCH_ITEM *) malloc ((*s).size * 
+		sizeof(SKETCH_ITEM)); 
+	if (items == NULL) return 1; 
+	for (h = 0;h < (*s).num_levels; h++) {
+		for (j = 0l; j < (*s).sizes[h]; j++) {
+			items[n].value = (*s).levels[h][j]; 
+			items[n].weight = (double) (1l << h); 
+			n++; 
+		} 
+	} 
+	qsort(items, n, sizeof(SKETCH_ITEM), compare_items); 
+
+	for (i = 0; i < num_fractions; i++) {
+		if (fractions[i] == 0) {
+			values[i] = (*s).min; 
+		} else if (fractions[i] == 1) {
+			values[i] = (*s).max; 
+		} else {
+			/* The first item whose cumulative weight passes the rank */ 
+			double rank = (long) (fractions[i] * (*s).n); 
+			double cumulative = 0; 
+			values[i] = (*s).max; 
+			for (j = 0l; j < n; j++) {
+				cumulative += items[j].weight; 
+				if (cumulative > rank) {
+					values[i] = items[j].value; 
+					break; 
+				} else {
+					continue; 
+				} 
+			} 
+		} 
+	} 
+	free(items); 
+	return 0; 
+
+} 
+
+/* 
+ * Builds a quantile sketch of a given column of the data. Each thread 
+ * sketches its own share of the rows, and the per-thread sketches are 
+ * merged at the end. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to sketch 
+ * s: 			The sketch to add the column's values to 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_sketch(DATAFRAME df, int column, QUANTILE_SKETCH *s) {
+
+	int status = 0; 
+	if (column < 0 || column >= df.num_cols) return 1; 
+	#pragma omp parallel reduction(|:status) 
+	{
+		long i; 
+		unsigned long tid = 0ul; 
+		#ifdef _OPENMP 
+		tid = (unsigned long) omp_get_thread_num(); 
+		#endif /* _OPENMP */ 
+		QUANTILE_SKETCH *local = sketch_initialize((*s).k, 
+			(*s).state + 0x9E3779B97F4A7C15ul * (tid + 1ul)); 
+		#pragma omp for schedule(static) 
+		for (i = 0l; i < df.num_rows; i++) {
+			if (local != NULL && !status && dfvalid(df, i, column)) {
+				status = sketch_update(local, dfvalue(df, i, column)); 
+			} else {} 
+		} 
+		if (local != NULL) {
+			#pragma omp critical 
+			status |= sketch_merge(s, local); 
+			free_sketch(local); 
+		} else {
+			status = 1; 
+		} 
+	} 
+	return status; 
+
+} 
+
+/* 
+ * Streams the data in several columns of a file into quantile sketches 
+ * without holding the file in memory. This reads hlists and any other 
+ * whitespace-separated ASCII table, skipping lines which start with the 
+ * commenting character. 
+ * 
+ * Parameters 
+ * ========== 
+ * sketches: 	The sketches to add each column's values to 
+ * file: 		The name of the file 
+ * comment: 	The commenting character 
+ * columns: 	The column numbers in the file to sketch 
+ * num_cols: 	The number of columns (and sketches) 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure to read the file or to allocate memory 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int sketch_from_file(QUANTILE_SKETCH **sketches, char *file, 
+	char comment, int *columns, int num_cols) {
+
+	int j, maxcol = 0; 
+	for (j = 0; j < num_cols; j++) {
+		if (columns[j] < 0) return 1; 
+		maxcol = max(maxcol, columns[j]); 
+	} 
+	FILE *in = fopen(file, "r"); 
+	if (in == NULL) return 1; 
+
+	/* Parse only as far into each line as the largest requested column */ 
+	int status = 0; 
+	char *line = (char *) malloc (LINESIZE * sizeof(char)); 
+	double *values = (double *) malloc ((maxcol + 1) * sizeof(double)); 
+	if (line == NULL || values == NULL) status = 1; 
+	while (!status && fgets(line, LINESIZE, in) != NULL) {
+		char *pos = line, *end; 
+		if (line[0] == comment) continue; 
+		for (j = 0; j <= maxcol; j++) {
+			values[j] = strtod(pos, &end); 
+			if (end == pos) break; 
+			pos = end; 
+		} 
+		if (j == 0) {
+			continue; /* a blank line */ 
+		} else if (j <= maxcol) {
+			status = 1; 
+		} else {
+			for (j = 0; j < num_cols && !status; j++) {
+				status = sketch_update(sketches[j], values[columns[j]]); 
+			} 
+		} 
+	} 
+	free(line); 
+	free(values); 
+	fclose(in); 
+	return status; 
+
+} 
+
+/* 
+ * The number of items a given level of the sketch may hold before it is 
+ * compacted: k on the top level, shrinking geometrically toward level 0, 
+ * but never below 2. 
+ */ 
+static long level_capacity(QUANTILE_SKETCH *s, int level) {
+
+	double cap = ceil((*s).k * pow(SKETCH_CAPACITY_RATIO, 
+		(*s).num_levels - 1 - level)); 
+	return max((long) cap, 2l); 
+
+} 
+
+/* 
+ * Compacts the lowest level of the sketch at or above its capacity. The level 
+ * is sorted, and either the even or the odd items (at random) are promoted 
+ * to the level above with twice the weight. With an odd number of items, one 
+ * stays behind so that the total weight is preserved. Returns 0 on success 
+ * and 1 if memory can't be allocated, leaving the sketch as it was. 
+ */ 
+static int sketch_compress(QUANTILE_SKETCH *s) {
+
+	int h; 
+	for (h = 0; h < (*s).num_levels; h++) {
+		if ((*s).sizes[h] >= level_capacity(s, h)) break; 
+	} 
+	if (h == (*s).num_levels) return 0; 
+	if (h == (*s).num_levels - 1 && sketch_add_level(s)) return 1; 
+
+	long i, start = (*s).sizes[h] % 2l; 
+	if (level_reserve(s, h + 1, ((*s).sizes[h] - start + 1l) / 2l)) return 1; 
+	double *level = s -> levels[h]; 
+	qsort(level + start, (*s).sizes[h] - start, sizeof(double), 
+		compare_doubles); 
+	for (i = start + coin_flip(s); i < (*s).sizes[h]; i += 2l) {
+		level_append(s, h + 1, level[i]); 
+	} 
+	s -> size -= (*s).sizes[h] - start; 
+	s -> sizes[h] = start; 
+	return 0; 
+
+} 
+
+/* 
+ * Adds an empty level to the top of the sketch. Returns 0 on success and 1 
+ * if memory can't be allocated, leaving the sketch with the levels it had. 
+ */ 
+static int sketch_add_level(QUANTILE_SKETCH *s) {
+
+	int h = (*s).num_levels; 
+	double **levels = (double **) realloc (s -> levels, (h + 1) * 
+		sizeof(double *)); 
+	if (levels == NULL) return 1; 
+	s -> levels = levels; 
+	long *sizes = (long *) realloc (s -> sizes, (h + 1) * sizeof(long)); 
+	if (sizes == NULL) return 1; 
+	s -> sizes = sizes; 
+	long *allocated = (long *) realloc (s -> allocated, (h + 1) * 
+		sizeof(long)); 
+	if (allocated == NULL) return 1; 
+	s -> allocated = allocated; 
+	double *level = (double *) malloc ((*s).k * sizeof(double)); 
+	if (level == NULL) return 1; 
+	s -> levels[h] = level; 
+	s -> allocated[h] = (long) (*s).k; 
+	s -> sizes[h] = 0l; 
+	s -> num_levels++; 
+
+	/* Adding a level raises the capacity of every level beneath it */ 
+	s -> capacity = 0l; 
+	for (h = 0; h < (*s).num_levels; h++) {
+		s -> capacity += level_capacity(s, h); 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Grows the buffer of a given level of the sketch, if need be, to hold a 
+ * number of items more than it does. Returns 0 on success and 1 if memory 
+ * can't be allocated, leaving the level as it was. 
+ */ 
+static int level_reserve(QUANTILE_SKETCH *s, int level, long count) {
+
+	long allocated = (*s).allocated[level]; 
+	if ((*s).sizes[level] + count <= allocated) return 0; 
+	while ((*s).sizes[level] + count > allocated) allocated *= 2l; 
+	double *values = (double *) realloc (s -> levels[level], allocated * 
+		sizeof(double)); 
+	if (values == NULL) return 1; 
+	s -> levels[level] = values; 
+	s -> allocated[level] = allocated; 
+	return 0; 
+
+} 
+
+/* 
+ * Appends an item to a given level of the sketch, which must have room for 
+ * it (see level_reserve) 
+ */ 
+static void level_append(QUANTILE_SKETCH *s, int level, double value) {
+
+	s -> levels[level][s -> sizes[level]++] = value; 
+	s -> size++; 
+
+} 
+
+/* 
+ * A fair coin flip from the sketch's xorshift64 generator: 0 or 1 
+ */ 
+static int coin_flip(QUANTILE_SKETCH *s) {
+
+	unsigned long x = (*s).state; 
+	x ^= x << 13; 
+	x ^= x >> 7; 
+	x ^= x << 17; 
+	s -> state = x; 
+	return (int) (x >> 63); 
+
+} 
+
+/* 
+ * qsort comparison function for doubles in ascending order 
+ */ 
+static int compare_doubles(const void *a, const void *b) {
+
+	double x = *((double *) a), y = *((double *) b); 
+	return (x > y) - (x < y); 
+
+} 
+
+/* 
+ * qsort comparison function for sketch items in ascending order of value 
+ */ 
+static int compare_items(const void *a, const void *b) {
+
+	double x = ((SKETCH_ITEM *) a) -> value, y = ((SKETCH_ITEM *) b) -> value; 
+	return (x > y) - (x < y); 
+
+} 
+
@@ -2,18 +2,44 @@
 #include <stdlib.h> 
 #include <string.h> 
 #include <stdio.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
 #include "dataframe.h" 
 #include "utils.h" 
 
+/* The number of bits of the keys a radix sort pass sorts on */ 
+#ifndef RADIX_BITS 
+#define RADIX_BITS 8 
+#endif /* RADIX_BITS */ 
+#define RADIX_BUCKETS (1l << RADIX_BITS) 
+
+/* 
+ * A row to sort 
+ * 
+ * Fields 
+ * ====== 
+ * key: 	Its key, as from column_key, whose order as an unsigned integer is 
+ * 			the order to sort in 
+ * row: 	The row number 
+ */ 
+typedef struct sort_entry {
+
+	unsigned long long key; 
+	long row; 
+
+} SORT_ENTRY; 
+
 /* ---------- Static routine comment headers not duplicated here  ---------- */ 
-static long get_bin_number(double value, double *binspace, long num_bins); 
-static long *rank_indeces(DATAFRAME df, int column); 
-static void long_ptr_swap(long *a, long *b); 
-static void double_ptr_swap(double *a, double *b); 
+static SORT_ENTRY *radix_sort(SORT_ENTRY *entries, SORT_ENTRY *scratch, 
+	long n); 
+static void cumulative_sum(double *arr, int ndim, long *num_bins); 
+static int count_below(double *arr, int length, double value); 
 
 /* 
  * Sorts a dataframe pointer in ascending order based on the data in a given 
- * column. 
+ * column. Only its view of its column buffers is reordered. Rows missing a 
+ * value in the column go last, in their original order. 
  * 
  * Parameters 
  * ========== 
@@ -22,38 +48,141 @@ static void double_ptr_swap(double *a, double *b);
  * 
  * Returns 
  * ======= 
- * 0 on success, anything else would be a system error. 
+ * 0 on success, 1 on failure 
  * 
  * header: dataframe.h 
  */ 
 extern int dfcolumn_order(DATAFRAME *df, int column) {
 
+	int descending = 0; 
+	return dfcolumns_order(df, &column, &descending, 1); 
+
+} 
+
+/* 
+ * Sorts a dataframe pointer on the data in several columns, ordering rows 
+ * by the first column, then those tied in it by the second, and so on. 
+ * Only its view of its column buffers is reordered. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				A pointer to the dataframe to sort 
+ * columns: 		The column numbers to sort based on 
+ * descending: 		1 to sort on each column in descending order, 0 for 
+ * 					ascending 
+ * num_keys: 		The number of columns to sort based on 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumns_order(DATAFRAME *df, int *columns, int *descending, 
+	int num_keys) {
+
+	/* 
+	 * Only the dataframe's view of its column buffers is reordered; the 
+	 * buffers themselves, which may be shared, are untouched. 
+	 */ 
+	long i, *order = (long *) malloc (((*df).num_rows > 0l ? 
+		(*df).num_rows : 1l) * sizeof(long)); 
+	if (dfcolumns_argsort(*df, columns, descending, num_keys, order)) {
+		free(order); 
+		return 1; 
+	} else {} 
+	for (i = 0l; i < (*df).num_rows; i++) {
+		/* The buffer row holding the next ranked row */ 
+		order[i] = dfrow_index(*df, order[i]); 
+	} 
+	if ((*df).index != NULL) free(df -> index); 
+	df -> index = order; 
+	df -> offset = 0l; 
+	df -> version = version_stamp(); 
+	return 0; 
+
+} 
+
+/* 
+ * Determine the order of the rows of a dataframe sorted on the data in 
+ * several columns, as in dfcolumns_order, without reordering it. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers to sort based on 
+ * descending: 		1 to sort on each column in descending order, 0 for 
+ * 					ascending 
+ * num_keys: 		The number of columns to sort based on 
+ * order: 			A pointer to put the row numbers into in sorted order, 
+ * 					with df.num_rows elements 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumns_argsort(DATAFRAME df, int *columns, int *descending, 
+	int num_keys, long *order) {
+
 	/* 
 	 * Bookkeeping 
 	 * =========== 
-	 * order: 		The rank index of each row of the dataframe 
-	 * new: 		The new, sorted data 
-	 * i, j: 		for-looping 
+	 * entries: 	The key in the current column of each row holding one 
+	 * valid: 		Whether or not each row holds a value in the column 
+	 * missing: 	The rows missing a value, in their current order 
+	 * 
+	 * The columns are sorted on from last to first, each sort stable, so 
+	 * that ties in each column keep the order of the columns after it. 
+	 * Rows missing a value go last within each column, whether ascending 
+	 * or descending. 
 	 */ 
-	int j; 
-	long i, *order = rank_indeces(*df, column); 
-	/* Allocate memory for the same number of rows */ 
-	double **new = (double **) malloc ((*df).num_rows * sizeof(double *)); 
-	for (i = 0l; i < (*df).num_rows; i++) { 
-		/* Allocate memory for the next row */ 
-		new[i] = (double *) malloc ((*df).num_cols * sizeof(double)); 
-		for (j = 0; j < (*df).num_cols; j++) { 
-			/* Pull the data from the next ranked row */ 
-			new[i][j] = (*df).data[order[i]][j]; 
+	int k; 
+	long i, n = df.num_rows; 
+	if (num_keys < 1) return 1; 
+	for (k = 0; k < num_keys; k++) {
+		if (columns[k] < 0 || columns[k] >= df.num_cols) return 1; 
+	} 
+	SORT_ENTRY *entries = (SORT_ENTRY *) malloc ((n > 0l ? n : 1l) * 
+		sizeof(SORT_ENTRY)); 
+	SORT_ENTRY *scratch = (SORT_ENTRY *) malloc ((n > 0l ? n : 1l) * 
+		sizeof(SORT_ENTRY)); 
+	char *valid = (char *) malloc ((n > 0l ? n : 1l) * sizeof(char)); 
+	long *missing = (long *) malloc ((n > 0l ? n : 1l) * sizeof(long)); 
+	for (i = 0l; i < n; i++) {
+		order[i] = i; 
+	} 
+	for (k = num_keys - 1; k >= 0; k--) {
+		COLUMN_BUFFER *buffer = df.columns[columns[k]]; 
+		int integer = column_is_integer((*buffer).type); 
+		int flip = descending[k]; 
+		long num_valid = 0l, num_missing = 0l; 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < n; i++) {
+			entries[i].row = order[i]; 
+			valid[i] = (char) column_key(buffer, dfrow_index(df, order[i]), 
+				integer, &entries[i].key); 
+			if (flip) entries[i].key = ~entries[i].key; 
+		} 
+		for (i = 0l; i < n; i++) {
+			if (valid[i]) {
+				entries[num_valid++] = entries[i]; 
+			} else {
+				missing[num_missing++] = order[i]; 
+			} 
+		} 
+		SORT_ENTRY *sorted = radix_sort(entries, scratch, num_valid); 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < num_valid; i++) {
+			order[i] = sorted[i].row; 
 		} 
+		memcpy(order + num_valid, missing, num_missing * sizeof(long)); 
 	} 
-	/*
-	 * Free up memory, reinitialize the data pointer, and return 0 for 
-	 * success. 
-	 */ 
-	free(order); 
-	free(df -> data); 
-	df -> data = new; 
+	free(entries); 
+	free(scratch); 
+	free(valid); 
+	free(missing); 
 	return 0; 
 
 } 
@@ -79,28 +208,25 @@ extern int dfcolumn_order(DATAFRAME *df, int column) {
 extern int dfcolumn_bin(DATAFRAME source, DATAFRAME *dest, int column, 
 	double *bin) {
 
-	/* The number of points that lie in this bin */ 
-	int j;  
-	long i, n = 0l, *counts = (long *) malloc (sizeof(long)); 
-	*counts = 0l; 
-	hist(source, column, bin, 1l, counts); 
-	dest -> num_rows = *counts; 
-	dest -> num_cols = source.num_cols; 
-
-	dest -> data = (double **) malloc (*counts * sizeof(double *)); 
-	for (i = 0l; i < source.num_rows; i++) { 
-		if (!get_bin_number(source.data[i][column], bin, 1l)) {
-			dest -> data[n] = (double *) malloc (source.num_cols * 
-				sizeof(double)); 
-			for (j = 0; j < source.num_cols; j++) {
-				dest -> data[n][j] = source.data[i][j]; 
-			} 
-			n++; 
-		} else { 
-			continue; 
-		} 
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * b: 			The binspace of the single bin 
+	 * test: 		1s at the rows in the bin, 0s elsewhere 
+	 * 
+	 * Look up each row once, then view the rows which fall in the bin. 
+	 */ 
+	long i; 
+	BINSPACE *b = binspace_initialize(bin, 1l); 
+	int *test = (int *) malloc (source.num_rows * sizeof(int)); 
+	#pragma omp parallel for 
+	for (i = 0l; i < source.num_rows; i++) {
+		test[i] = dfvalid(source, i, column) && 
+			binspace_lookup(b, dfvalue(source, i, column)) == 0l; 
 	} 
-	free(counts); 
+	binspace_free(b); 
+	dataframe_select_mask(source, dest, test); 
+	free(test); 
 	return 0; 
 
 } 
@@ -130,18 +256,166 @@ extern int hist(DATAFRAME df, int column, double *binspace, long num_bins,
 
 	/* 
 	 * Get the bin number for each element and increment the counts array 
-	 * up by one for each bin 
+	 * up by one for each bin. Each thread counts into its own private array 
+	 * so that no two threads write to the same bin, and the private counts 
+	 * are summed at the end. 
 	 */ 
-	long i; 
-	for (i = 0l; i < df.num_rows; i++) {
-		long bin = get_bin_number(df.data[i][column], binspace, num_bins); 
-		if (bin != -1l) { 
-			/* Increment that bin up by 1l */ 
-			counts[bin]++; 
+	BINSPACE *b = binspace_initialize(binspace, num_bins); 
+	if (b == NULL) return 0; /* There are no bins to count */ 
+	if (dfcolumn_runs(df, column)) {
+		/* Run-length encoded: each run is looked up once */ 
+		COLUMN_ENCODING *e = df.columns[column] -> encoding; 
+		long r = 0l, start = df.offset, last = df.offset + df.num_rows; 
+		while (r < (*e).num_runs && (*e).ends[r] <= start) r++; 
+		for (; start < last; r++) {
+			long stop = (*e).ends[r] < last ? (*e).ends[r] : last; 
+			long bin = binspace_lookup(b, column_value(df.columns[column], 
+				start)); 
+			if (bin != -1l) counts[bin] += stop - start; 
+			start = stop; 
+		} 
+		binspace_free(b); 
+		return 0; 
+	} else {} 
+	#pragma omp parallel 
+	{
+		long i, *local = long_zeroes(num_bins); 
+		#pragma omp for schedule(static) 
+		for (i = 0l; i < df.num_rows; i++) {
+			if (!dfvalid(df, i, column)) continue; /* Missing */ 
+			long bin = binspace_lookup(b, dfvalue(df, i, column)); 
+			if (bin != -1l) { 
+				/* Increment that bin up by 1l */ 
+				local[bin]++; 
+			} else {
+				continue; /* Not in the binspace */ 
+			} 
+		} 
+		#pragma omp critical 
+		{
+			for (i = 0l; i < num_bins; i++) {
+				counts[i] += local[i]; 
+			} 
+		} 
+		free(local); 
+	} 
+	binspace_free(b); 
+	return 0; 
+
+} 
+
+/* 
+ * Determine weighted counts of the data points that fall within a grid of 
+ * bins in any number of dimensions (i.e. a multi-dimensional histogram) 
+ * based on the values in a given set of columns. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * columns: 		The column numbers for each dimension 
+ * ndim: 			The number of dimensions 
+ * binspaces: 		The bin edges along each dimension, in ascending order 
+ * num_bins: 		The number of bins along each dimension 
+ * weights: 		The column number of the weights; -1 for unweighted counts 
+ * mask: 			1s at the rows to include and 0s at the rows to skip; NULL 
+ * 					to include all rows 
+ * cumulative: 		1 to return the cumulative sums along every dimension 
+ * 					(i.e. the sums over all bins at or below each bin), 0 for 
+ * 					the sums within each bin 
+ * sums: 			A pointer to put the sum of the weights in each bin into. 
+ * 					The bins are laid out in row-major order (the last 
+ * 					dimension varies fastest), and there must be the product 
+ * 					of num_bins elements. 
+ * sums2: 			A pointer to put the sum of the squared weights in each bin 
+ * 					into, laid out the same as sums; NULL to skip it 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int histdd(DATAFRAME df, int *columns, int ndim, double **binspaces, 
+	long *num_bins, int weights, int *mask, int cumulative, double *sums, 
+	double *sums2) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * b: 			The binspace along each dimension 
+	 * total: 		The total number of bins 
+	 * strides: 	The distance between adjacent bins along each dimension in 
+	 * 				the flattened sums array 
+	 */ 
+	int d; 
+	long i, total = 1l; 
+	if (ndim < 1 || (weights < -1 || weights >= df.num_cols)) return 1; 
+	for (d = 0; d < ndim; d++) {
+		if (columns[d] < 0 || columns[d] >= df.num_cols || num_bins[d] < 1l) {
+			return 1; 
 		} else {
-			continue; /* Not in the binspace */ 
+			total *= num_bins[d]; 
 		} 
 	} 
+	BINSPACE **b = (BINSPACE **) malloc (ndim * sizeof(BINSPACE *)); 
+	long *strides = (long *) malloc (ndim * sizeof(long)); 
+	for (d = ndim - 1; d >= 0; d--) {
+		b[d] = binspace_initialize(binspaces[d], num_bins[d]); 
+		strides[d] = d == ndim - 1 ? 1l : strides[d + 1] * num_bins[d + 1]; 
+	} 
+	for (i = 0l; i < total; i++) {
+		sums[i] = 0; 
+		if (sums2 != NULL) sums2[i] = 0; 
+	} 
+
+	/* 
+	 * Each thread accumulates into its own private arrays, which are summed 
+	 * at the end, as in hist. 
+	 */ 
+	#pragma omp parallel 
+	{
+		long j; 
+		double *local = (double *) calloc (total, sizeof(double)); 
+		double *local2 = sums2 != NULL ? (double *) calloc (total, 
+			sizeof(double)) : NULL; 
+		#pragma omp for schedule(static) 
+		for (j = 0l; j < df.num_rows; j++) {
+			if (mask != NULL && !mask[j]) continue; 
+			int k; 
+			long index = 0l; 
+			for (k = 0; k < ndim; k++) {
+				if (!dfvalid(df, j, columns[k])) break; 
+				long bin = binspace_lookup(b[k], dfvalue(df, j, columns[k])); 
+				if (bin == -1l) break; 
+				index += bin * strides[k]; 
+			} 
+			/* Not in the binspace, or missing a value */ 
+			if (k < ndim) continue; 
+			if (weights != -1 && !dfvalid(df, j, weights)) continue; 
+			double w = weights == -1 ? 1 : dfvalue(df, j, weights); 
+			local[index] += w; 
+			if (local2 != NULL) local2[index] += w * w; 
+		} 
+		#pragma omp critical 
+		{
+			for (j = 0l; j < total; j++) {
+				sums[j] += local[j]; 
+				if (local2 != NULL) sums2[j] += local2[j]; 
+			} 
+		} 
+		free(local); 
+		if (local2 != NULL) free(local2); 
+	} 
+
+	if (cumulative) {
+		cumulative_sum(sums, ndim, num_bins); 
+		if (sums2 != NULL) cumulative_sum(sums2, ndim, num_bins); 
+	} else {} 
+	for (d = 0; d < ndim; d++) {
+		binspace_free(b[d]); 
+	} 
+	free(b); 
+	free(strides); 
 	return 0; 
 
 } 
@@ -166,108 +440,295 @@ extern int hist(DATAFRAME df, int column, double *binspace, long num_bins,
 extern int dfcolumn_equal_number_subsample(DATAFRAME ordered, DATAFRAME *dest, 
 	int num_subs, int index) {
 
-	long i; 
-	int j; 
-
-	dest -> num_cols = ordered.num_cols; 
-	dest -> num_rows = ordered.num_rows / num_subs; 
-	dest -> data = (double **) malloc ((*dest).num_rows * sizeof(double *)); 
-
-	for (i = 0; i < (*dest).num_rows; i++) {
-		dest -> data[i] = (double *) malloc ((*dest).num_cols * sizeof(double)); 
-		long row_num = ordered.num_rows / num_subs * index + i; 
-		for (j = 0; j < (*dest).num_cols; j++) {
-			dest -> data[i][j] = ordered.data[row_num][j]; 
-		} 
-	} 
-	return 0; 
+	/* The subsample is a view of a contiguous slice of the ordered data */ 
+	long length = ordered.num_rows / num_subs; 
+	return dataframe_slice(ordered, dest, length * index, length * (index + 1)); 
 
 } 
 
 /* 
- * Determines the bin number of a given value within a specified binspace. 
+ * Splits a dataframe into equal number subsamples based on the data in a 
+ * given column without sorting it. The n - 1 split values are found in a 
+ * single multi-quantile selection pass, and the rows are then scattered into 
+ * n contiguous partitions in one counting pass, keeping their original order 
+ * within each partition. Rows tied with a split value are shared out in row 
+ * order so that every subsample has exactly the size it would have had the 
+ * dataframe been sorted. Rows missing a value in the column are left out of 
+ * every subsample. 
  * 
  * Parameters 
  * ========== 
- * value: 		The value to get the bin number for 
- * binspace: 	The bin edges 
- * num_bins: 	The number of bins. This should be one less than the number of 
- * 				values in the binspace array. 
+ * df: 				The dataframe to split 
+ * column: 			The column number to split based on 
+ * num_subs: 		The number of subsamples to generate 
+ * dests: 			A pointer to num_subs dataframes to put the subsamples into. 
+ * 					Subsample i holds the rows of sorted rank i * N / num_subs 
+ * 					up to (i + 1) * N / num_subs, where N is the number of 
+ * 					rows. 
  * 
  * Returns 
  * ======= 
- * Type long :: The bin value itself 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * The subsamples are views: no data is copied, and they share the column 
+ * buffers of the source dataframe. 
+ * 
+ * header: dataframe.h 
  */ 
-static long get_bin_number(double value, double *binspace, long num_bins) {
+extern int dfcolumn_equal_number_partition(DATAFRAME df, int column, 
+	int num_subs, DATAFRAME *dests) {
 
-	long i; 
-	for (i = 0l; i < num_bins; i++) {
-		/* If the value is between two bin edges */ 
-		if (binspace[i] <= value && value <= binspace[i + 1l]) {
-			return i; 
-		} else {
-			continue; 
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * bounds: 		The sorted rank at which each subsample begins 
+	 * splits: 		The values at the sorted ranks of the bounds 
+	 * part: 		The subsample of each row; -1 for rows tied with a split 
+	 * 				value, which are placed afterwards 
+	 * tie_rank: 	The next sorted rank for the rows tied with each split 
+	 * rows: 		The row numbers, grouped by subsample 
+	 */ 
+	int i; 
+	if (column < 0 || column >= df.num_cols || num_subs < 1) return 1; 
+	DATAFRAME valid; 
+	memset(&valid, 0, sizeof(DATAFRAME)); 
+	if (df.columns[column] -> validity != NULL) {
+		/* Only the valid rows are split, so split a view of them */ 
+		int *test = (int *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+			sizeof(int)); 
+		dfcolumn_validity(df, column, test); 
+		dataframe_select_mask(df, &valid, test); 
+		free(test); 
+		df = valid; 
+	} else {} 
+	long j, n = df.num_rows; 
+	long *bounds = (long *) malloc ((num_subs + 1) * sizeof(long)); 
+	for (i = 0; i <= num_subs; i++) {
+		bounds[i] = n * i / num_subs; 
+	} 
+	if (n == 0l || num_subs == 1) {
+		/* Nothing to split: the subsamples are slices */ 
+		for (i = 0; i < num_subs; i++) {
+			dataframe_slice(df, dests + i, bounds[i], bounds[i + 1]); 
+		} 
+		free(bounds); 
+		dataframe_release(&valid); 
+		return 0; 
+	} else {} 
+
+	int num_splits = num_subs - 1; 
+	double *splits = (double *) malloc (num_splits * sizeof(double)); 
+	double *col = dfcolumn(df, column); 
+	if (ptr_select_ranks(col, n, bounds + 1, num_splits, splits)) {
+		free(col); 
+		free(splits); 
+		free(bounds); 
+		dataframe_release(&valid); 
+		return 1; 
+	} else {
+		free(col); 
+	} 
+
+	/* 
+	 * Rows strictly between two split values belong to the subsample whose 
+	 * index is the number of split values below them. Rows equal to a split 
+	 * value are counted separately: knowing how many rows lie below that 
+	 * value gives the sorted ranks the tied rows occupy. 
+	 */ 
+	int *part = (int *) malloc (n * sizeof(int)); 
+	long *below = long_zeroes(num_splits); 
+	#pragma omp parallel 
+	{
+		long k, *local = long_zeroes(num_splits); 
+		#pragma omp for schedule(static) 
+		for (k = 0l; k < n; k++) {
+			double x = dfvalue(df, k, column); 
+			int p = count_below(splits, num_splits, x); 
+			if (p < num_splits && splits[p] == x) {
+				part[k] = -1; 
+			} else {
+				part[k] = p; 
+			} 
+			/* Every split value above x has this row below it */ 
+			if (p < num_splits) local[p]++; 
 		} 
+		#pragma omp critical 
+		{
+			for (k = 0l; k < num_splits; k++) {
+				below[k] += local[k]; 
+			} 
+		} 
+		free(local); 
+	} 
+	for (i = 1; i < num_splits; i++) {
+		below[i] += below[i - 1]; 
+	} 
+	/* below[i] counted rows <= splits[i]; remove those equal to it */ 
+	long *tie_rank = long_zeroes(num_splits); 
+	for (j = 0l; j < n; j++) {
+		if (part[j] == -1) tie_rank[count_below(splits, num_splits, 
+			dfvalue(df, j, column))]++; 
+	} 
+	for (i = 0; i < num_splits; i++) {
+		tie_rank[i] = below[i] - tie_rank[i]; 
 	} 
-	/* The value is not within the binspace. Return -1l on failure. */ 
-	return -1l; 
+
+	/* Scatter the row numbers into place in row order */ 
+	long *rows = (long *) malloc (n * sizeof(long)); 
+	long *fill = (long *) malloc (num_subs * sizeof(long)); 
+	for (i = 0; i < num_subs; i++) {
+		fill[i] = bounds[i]; 
+	} 
+	for (j = 0l; j < n; j++) {
+		int p = part[j]; 
+		if (p == -1) {
+			/* The subsample containing the tied row's sorted rank */ 
+			int t = count_below(splits, num_splits, dfvalue(df, j, column)); 
+			long rank = tie_rank[t]++; 
+			p = t; 
+			while (p < num_subs - 1 && rank >= bounds[p + 1]) p++; 
+			while (p > 0 && rank < bounds[p]) p--; 
+		} else {} 
+		rows[fill[p]++] = j; 
+	} 
+	for (i = 0; i < num_subs; i++) {
+		dataframe_select(df, dests + i, rows + bounds[i], 
+			bounds[i + 1] - bounds[i]); 
+	} 
+
+	free(fill); 
+	free(rows); 
+	free(tie_rank); 
+	free(below); 
+	free(part); 
+	free(splits); 
+	free(bounds); 
+	dataframe_release(&valid); 
+	return 0; 
 
 } 
 
 /* 
- * Determine the indeces that would sort the dataframe from least to greatest 
- * according to the data in a given column. 
+ * Replaces a multi-dimensional array of per-bin sums with the cumulative 
+ * sums along every dimension, such that each element becomes the sum over 
+ * all bins at or below it in every dimension. 
  * 
  * Parameters 
  * ========== 
- * df: 			The dataframe itself 
- * column: 		The column to sort based on 
- * 
- * Returns
- * ======= 
- * Type *long :: The indeces which sort the data from least to greatest. 
+ * arr: 		The flattened array, in row-major order 
+ * ndim: 		The number of dimensions 
+ * num_bins: 	The number of bins along each dimension 
  */ 
-static long *rank_indeces(DATAFRAME df, int column) {
-
-	/* Run the operations on a copy of the indeces */ 
-	long i, j, *indeces = range(0, df.num_rows); 
-	double *col = dfcolumn(df, column); /* Pull a copy, this is faster */ 
-
-	for (i = 0l; i < df.num_rows; i++) {
-		/* 
-		 * Look the column'th element of each subsequent row and find the 
-		 * smallest index. Then swap the indeces. 
-		 */ 
-		long smallest = i; 
-		for (j = i + 1l; j < df.num_rows; j++) {
-			if (col[j] <= col[smallest]) {
-				smallest = j; 
-			} else {
-				continue; 
-			}
+static void cumulative_sum(double *arr, int ndim, long *num_bins) {
+
+	int d; 
+	long i, total = 1l, stride = 1l; 
+	for (d = 0; d < ndim; d++) {
+		total *= num_bins[d]; 
+	} 
+	/* One running sum along each dimension in turn, innermost first */ 
+	for (d = ndim - 1; d >= 0; d--) {
+		for (i = 0l; i < total; i++) {
+			if ((i / stride) % num_bins[d]) arr[i] += arr[i - stride]; 
 		} 
-		double_ptr_swap(&col[i], &col[smallest]); 
-		long_ptr_swap(&indeces[i], &indeces[smallest]); 
-		/* printf("\r%ld of %ld", i, df.num_rows); */ 
+		stride *= num_bins[d]; 
 	} 
-	/* printf("\n"); */ 
-	return indeces; 
 
 } 
 
-static void long_ptr_swap(long *a, long *b) {
+/* 
+ * Determine the number of values in an array sorted in ascending order which 
+ * are strictly less than a given value by a binary search. 
+ */ 
+static int count_below(double *arr, int length, double value) {
 
-	long x = *a; 
-	*a = *b; 
-	*b = x; 
+	int low = 0, high = length; 
+	while (low < high) {
+		int mid = (low + high) / 2; 
+		if (arr[mid] < value) {
+			low = mid + 1; 
+		} else {
+			high = mid; 
+		} 
+	} 
+	return low; 
 
 } 
 
-static void double_ptr_swap(double *a, double *b) {
+/* 
+ * Sorts entries in ascending order of their keys by a least significant 
+ * digit radix sort, one byte per pass. Passes over bytes which every key 
+ * shares are skipped, so e.g. small non-negative integers take one or two 
+ * passes. Each thread counts and then scatters a contiguous block of the 
+ * entries, and the blocks are scattered in order, so the sort is stable. 
+ * 
+ * Parameters 
+ * ========== 
+ * entries: 	The entries to sort 
+ * scratch: 	Room for as many entries again 
+ * n: 			The number of entries 
+ * 
+ * Returns
+ * ======= 
+ * Whichever of entries and scratch holds the sorted entries 
+ */ 
+static SORT_ENTRY *radix_sort(SORT_ENTRY *entries, SORT_ENTRY *scratch, 
+	long n) {
 
-	double x = *a; 
-	*a = *b; 
-	*b = x; 
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * all: 		The bits set in every key 
+	 * any: 		The bits set in any key 
+	 * counts: 		The number of keys in each block with each digit, then 
+	 * 				where the next of them goes 
+	 */ 
+	long i, b, num_blocks = 1l; 
+	#ifdef _OPENMP 
+	num_blocks = omp_get_max_threads(); 
+	#endif /* _OPENMP */ 
+	unsigned long long all = ~0ull, any = 0ull; 
+	#pragma omp parallel for reduction(&:all) reduction(|:any) 
+	for (i = 0l; i < n; i++) {
+		all &= entries[i].key; 
+		any |= entries[i].key; 
+	} 
+	int shift; 
+	long *counts = (long *) malloc (num_blocks * RADIX_BUCKETS * 
+		sizeof(long)); 
+	for (shift = 0; shift < 64; shift += RADIX_BITS) {
+		if (!(((all ^ any) >> shift) & (RADIX_BUCKETS - 1ull))) continue; 
+		#pragma omp parallel for schedule(static, 1) 
+		for (b = 0l; b < num_blocks; b++) {
+			long j, *c = counts + b * RADIX_BUCKETS; 
+			memset(c, 0, RADIX_BUCKETS * sizeof(long)); 
+			for (j = n * b / num_blocks; j < n * (b + 1l) / num_blocks; j++) {
+				c[(entries[j].key >> shift) & (RADIX_BUCKETS - 1ull)]++; 
+			}
+		} 
+		long d, total = 0l; 
+		for (d = 0l; d < RADIX_BUCKETS; d++) {
+			for (b = 0l; b < num_blocks; b++) {
+				long c = counts[b * RADIX_BUCKETS + d]; 
+				counts[b * RADIX_BUCKETS + d] = total; 
+				total += c; 
+			} 
+		} 
+		#pragma omp parallel for schedule(static, 1) 
+		for (b = 0l; b < num_blocks; b++) {
+			long j, *c = counts + b * RADIX_BUCKETS; 
+			for (j = n * b / num_blocks; j < n * (b + 1l) / num_blocks; j++) {
+				scratch[c[(entries[j].key >> shift) & 
+					(RADIX_BUCKETS - 1ull)]++] = entries[j]; 
+			} 
+		} 
+		SORT_ENTRY *swap = entries; 
+		entries = scratch; 
+		scratch = swap; 
+	} 
+	free(counts); 
+	return entries; 
 
 }
-
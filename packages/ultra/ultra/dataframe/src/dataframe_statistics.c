@@ -0,0 +1,450 @@
+/* 
+ * This file scripts the binned statistic engine, which computes summary 
+ * statistics of the values in one column within bins of the values in 
+ * another. The row indices are partitioned by bin once with a counting sort, 
+ * after which the values in each bin are contiguous in memory and every 
+ * requested statistic of every bin is computed in parallel. Bins large 
+ * enough for the quantile selection to run in parallel itself are instead 
+ * taken one at a time afterwards. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static long *bin_numbers(DATAFRAME df, int column, BINSPACE *b); 
+static void bin_statistics(double *arr, long length, int *stats, 
+	double *fractions, int num_stats, long *ranks, double *selected, 
+	double *results); 
+static int partial_copies(void); 
+static void partial_statistics(DATAFRAME df, long *groups, long num_groups, 
+	int column, int *stats, int num_stats, double *results); 
+
+/* 
+ * Determine summary statistics of the values in one column of the data 
+ * within bins of the values in another column. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * xcolumn: 		The column number to bin based on 
+ * ycolumn: 		The column number to take the statistics of 
+ * binspace: 		The bin edges, in ascending order 
+ * num_bins: 		The number of bins in the binspace. This should be one less 
+ * 					than the number of values in the binspace array. 
+ * stats: 			The statistics to take, as the BINNED_* codes in 
+ * 					dataframe.h 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics requested 
+ * results: 		A pointer to put the statistics into. Bin i's statistics 
+ * 					are at results[i * num_stats] through 
+ * 					results[i * num_stats + num_stats - 1], in the same order 
+ * 					as stats. This must have num_bins * num_stats elements. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int binned_statistic(DATAFRAME df, int xcolumn, int ycolumn, 
+	double *binspace, long num_bins, int *stats, double *fractions, 
+	int num_stats, double *results) {
+
+	if (xcolumn < 0 || xcolumn >= df.num_cols) return 1; 
+	BINSPACE *b = binspace_initialize(binspace, num_bins); 
+	if (b == NULL) return 1; 
+	long *bins = bin_numbers(df, xcolumn, b); 
+	int status = group_statistic(df, bins, num_bins, ycolumn, stats, 
+		fractions, num_stats, results); 
+	free(bins); 
+	binspace_free(b); 
+	return status; 
+
+} 
+
+/* 
+ * Determine summary statistics of the values in a column of the data within 
+ * groups of its rows. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * groups: 			The group number of each row; -1 for rows in no group 
+ * num_groups: 		The number of groups 
+ * column: 			The column number to take the statistics of 
+ * stats: 			The statistics to take, as the BINNED_* codes in 
+ * 					dataframe.h 
+ * fractions: 		The quantile to take for each BINNED_QUANTILE statistic, 
+ * 					between 0 and 1. Ignored for the other statistics. 
+ * num_stats: 		The number of statistics requested 
+ * results: 		A pointer to put the statistics into. Group i's statistics 
+ * 					are at results[i * num_stats] through 
+ * 					results[i * num_stats + num_stats - 1], in the same order 
+ * 					as stats. This must have num_groups * num_stats elements. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * Notes 
+ * ===== 
+ * When none of the statistics are order statistics and there are few enough 
+ * groups, each thread accumulates partial statistics of every group over its 
+ * own rows, and these are merged at the end. Otherwise the values are 
+ * gathered by group first. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int group_statistic(DATAFRAME df, long *groups, long num_groups, 
+	int column, int *stats, double *fractions, int num_stats, 
+	double *results) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * counts: 		The number of rows in each group 
+	 * offsets: 	The index of the first value of each group in gathered 
+	 * gathered: 	The values of the column, grouped 
+	 */ 
+	int s, decomposable = 1; 
+	long i; 
+	if (column < 0 || column >= df.num_cols || num_stats < 1 || 
+		num_groups < 0l) return 1; 
+	for (s = 0; s < num_stats; s++) {
+		if (stats[s] < BINNED_COUNT || stats[s] > BINNED_QUANTILE) {
+			return 1; 
+		} else if (stats[s] == BINNED_QUANTILE && 
+			!(fractions[s] >= 0 && fractions[s] <= 1)) {
+			return 1; 
+		} else {
+			decomposable &= stats[s] != BINNED_MEDIAN && 
+				stats[s] != BINNED_QUANTILE; 
+		} 
+	} 
+	if (decomposable && num_groups * partial_copies() <= df.num_rows) {
+		partial_statistics(df, groups, num_groups, column, stats, num_stats, 
+			results); 
+		return 0; 
+	} else {} 
+
+	/* Counting sort of the values by group, keeping the row order in each */ 
+	long *counts = long_zeroes(num_groups > 0l ? num_groups : 1l); 
+	long *offsets = (long *) malloc ((num_groups + 1l) * sizeof(long)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		/* Rows missing their value are left out of every group */ 
+		if (groups[i] != -1l && dfvalid(df, i, column)) counts[groups[i]]++; 
+	} 
+	offsets[0] = 0l; 
+	for (i = 0l; i < num_groups; i++) {
+		offsets[i + 1l] = offsets[i] + counts[i]; 
+		counts[i] = offsets[i]; /* recycled as the fill position */ 
+	} 
+	double *gathered = (double *) malloc ((offsets[num_groups] > 0l ? 
+		offsets[num_groups] : 1l) * sizeof(double)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (groups[i] != -1l && dfvalid(df, i, column)) {
+			gathered[counts[groups[i]]++] = dfvalue(df, i, column); 
+		} else {} 
+	} 
+
+	/* 
+	 * Groups can hold very different numbers of values, so they're handed 
+	 * out to threads dynamically. Each thread keeps its own scratch space 
+	 * for the quantile selection. Groups above SELECT_PARALLEL_CUTOFF are 
+	 * left for afterwards, where the selection partitions them in parallel. 
+	 */ 
+	#pragma omp parallel 
+	{
+		long j; 
+		long *ranks = (long *) malloc ((num_stats + 1) * sizeof(long)); 
+		double *selected = (double *) malloc ((num_stats + 1) * 
+			sizeof(double)); 
+		#pragma omp for schedule(dynamic) 
+		for (j = 0l; j < num_groups; j++) {
+			if (offsets[j + 1l] - offsets[j] > SELECT_PARALLEL_CUTOFF) continue; 
+			bin_statistics(gathered + offsets[j], offsets[j + 1l] - offsets[j], 
+				stats, fractions, num_stats, ranks, selected, 
+				results + j * num_stats); 
+		} 
+		free(ranks); 
+		free(selected); 
+	} 
+	long *ranks = (long *) malloc ((num_stats + 1) * sizeof(long)); 
+	double *selected = (double *) malloc ((num_stats + 1) * sizeof(double)); 
+	for (i = 0l; i < num_groups; i++) {
+		if (offsets[i + 1l] - offsets[i] <= SELECT_PARALLEL_CUTOFF) continue; 
+		bin_statistics(gathered + offsets[i], offsets[i + 1l] - offsets[i], 
+			stats, fractions, num_stats, ranks, selected, 
+			results + i * num_stats); 
+	} 
+	free(ranks); 
+	free(selected); 
+
+	free(gathered); 
+	free(offsets); 
+	free(counts); 
+	return 0; 
+
+} 
+
+/* 
+ * Determine the bin number of the value in each row of a given column. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number to bin based on 
+ * b: 			The binspace 
+ * 
+ * Returns 
+ * ======= 
+ * The bin number of each row; -1l for rows outside the binspace or missing 
+ * a value 
+ */ 
+static long *bin_numbers(DATAFRAME df, int column, BINSPACE *b) {
+
+	long i, *bins = (long *) malloc (df.num_rows * sizeof(long)); 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < df.num_rows; i++) {
+		bins[i] = dfvalid(df, i, column) ? 
+			binspace_lookup(b, dfvalue(df, i, column)) : -1l; 
+	} 
+	return bins; 
+
+} 
+
+/* 
+ * Determine the requested statistics of the values in a single bin. The 
+ * median and all of the quantiles are taken in one selection pass. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 		The values in the bin. These are rearranged in place. 
+ * length: 		The number of values in the bin 
+ * stats: 		The statistics to take 
+ * fractions: 	The quantile to take for each BINNED_QUANTILE statistic 
+ * num_stats: 	The number of statistics requested 
+ * ranks: 		Scratch space for num_stats + 1 rank orders 
+ * selected: 	Scratch space for num_stats + 1 selected values 
+ * results: 	A pointer to put the num_stats statistics into. Empty bins 
+ * 				have a count and sum of 0, and NaN for everything else. 
+ */ 
+static void bin_statistics(double *arr, long length, int *stats, 
+	double *fractions, int num_stats, long *ranks, double *selected, 
+	double *results) {
+
+	int s, num_ranks = 0, has_median = 0; 
+	long i; 
+	double sum = 0, mean, var = 0; 
+	if (length == 0l) {
+		for (s = 0; s < num_stats; s++) {
+			results[s] = (stats[s] == BINNED_COUNT || stats[s] == BINNED_SUM) ? 
+				0 : NAN; 
+		} 
+		return; 
+	} else {
+		for (i = 0l; i < length; i++) {
+			sum += arr[i]; 
+		} 
+		mean = sum / length; 
+		for (i = 0l; i < length; i++) {
+			var += (arr[i] - mean) * (arr[i] - mean); 
+		} 
+	} 
+
+	/* 
+	 * Gather the rank orders for the median and quantiles. These follow 
+	 * ptr_median and ptr_quantiles: the median of an even number of values 
+	 * is the mean of the two middle values. 
+	 */ 
+	for (s = 0; s < num_stats; s++) {
+		if (stats[s] == BINNED_MEDIAN) {
+			ranks[num_ranks++] = (length - 1l) / 2l; 
+			ranks[num_ranks++] = length / 2l; 
+			has_median = 1; 
+			break; 
+		} else {
+			continue; 
+		} 
+	} 
+	for (s = 0; s < num_stats; s++) {
+		if (stats[s] == BINNED_QUANTILE) {
+			ranks[num_ranks++] = min((long) (fractions[s] * length), 
+				length - 1l); 
+		} else {
+			continue; 
+		} 
+	} 
+	if (num_ranks) ptr_select_ranks(arr, length, ranks, num_ranks, selected); 
+
+	int q = has_median ? 2 : 0; /* the index of the next quantile */ 
+	for (s = 0; s < num_stats; s++) {
+		switch (stats[s]) {
+
+			case BINNED_COUNT: 
+				results[s] = length; 
+				break; 
+
+			case BINNED_SUM: 
+				results[s] = sum; 
+				break; 
+
+			case BINNED_MEAN: 
+				results[s] = mean; 
+				break; 
+
+			case BINNED_STD: 
+				results[s] = sqrt(var / length); 
+				break; 
+
+			case BINNED_MIN: 
+				results[s] = ptr_min(arr, length); 
+				break; 
+
+			case BINNED_MAX: 
+				results[s] = ptr_max(arr, length); 
+				break; 
+
+			case BINNED_MEDIAN: 
+				results[s] = (selected[0] + selected[1]) / 2; 
+				break; 
+
+			case BINNED_QUANTILE: 
+				results[s] = selected[q++]; 
+				break; 
+
+		} 
+	} 
+
+} 
+
+/* 
+ * The number of copies of the partial statistics of every group that 
+ * partial_statistics keeps: one per thread. 
+ */ 
+static int partial_copies(void) {
+
+	#ifdef _OPENMP 
+	return omp_get_max_threads(); 
+	#else 
+	return 1; 
+	#endif /* _OPENMP */ 
+
+} 
+
+/* 
+ * Determine statistics of the values in each group which can be merged 
+ * across partitions of the rows: the count, sum, mean, standard deviation, 
+ * minimum, and maximum. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * groups: 		The group number of each row; -1 for rows in no group 
+ * num_groups: 	The number of groups 
+ * column: 		The column number to take the statistics of 
+ * stats: 		The statistics to take, none of them order statistics 
+ * num_stats: 	The number of statistics requested 
+ * results: 	A pointer to put the statistics into, as in group_statistic. 
+ * 				Empty groups have a count and sum of 0, and NaN for 
+ * 				everything else. 
+ */ 
+static void partial_statistics(DATAFRAME df, long *groups, long num_groups, 
+	int column, int *stats, int num_stats, double *results) {
+
+	/* 
+	 * Each thread keeps the count, sum, mean, sum of squared deviations from 
+	 * the mean (Welford 1962), minimum, and maximum of each group over its 
+	 * own rows. These are merged pairwise (Chan, Golub & LeVeque 1979). 
+	 */ 
+	int s, t, nthreads = partial_copies(); 
+	long g; 
+	double *partials = (double *) malloc ((nthreads * num_groups > 0l ? 
+		nthreads * num_groups : 1l) * 6 * sizeof(double)); 
+	for (g = 0l; g < nthreads * num_groups; g++) {
+		double *p = partials + 6l * g; 
+		p[0] = p[1] = p[2] = p[3] = 0; 
+		p[4] = INFINITY; 
+		p[5] = -INFINITY; 
+	} 
+	#pragma omp parallel num_threads(nthreads) 
+	{
+		long i; 
+		double *local = partials; 
+		#ifdef _OPENMP 
+		local += 6l * num_groups * omp_get_thread_num(); 
+		#endif /* _OPENMP */ 
+		#pragma omp for schedule(static) 
+		for (i = 0l; i < df.num_rows; i++) {
+			if (groups[i] == -1l || !dfvalid(df, i, column)) continue; 
+			double x = dfvalue(df, i, column), *p = local + 6l * groups[i]; 
+			double delta = x - p[2]; 
+			p[0]++; 
+			p[1] += x; 
+			p[2] += delta / p[0]; 
+			p[3] += delta * (x - p[2]); 
+			if (x < p[4]) p[4] = x; 
+			if (x > p[5]) p[5] = x; 
+		} 
+	} 
+	for (g = 0l; g < num_groups; g++) {
+		double *p = partials + 6l * g; 
+		for (t = 1; t < nthreads; t++) {
+			double *q = partials + 6l * (t * num_groups + g); 
+			if (q[0] == 0) continue; 
+			double n = p[0] + q[0], delta = q[2] - p[2]; 
+			p[3] += q[3] + delta * delta * p[0] * q[0] / n; 
+			p[2] += delta * q[0] / n; 
+			p[0] = n; 
+			p[1] += q[1]; 
+			if (q[4] < p[4]) p[4] = q[4]; 
+			if (q[5] > p[5]) p[5] = q[5]; 
+		} 
+		for (s = 0; s < num_stats; s++) {
+			double *r = results + g * num_stats + s; 
+			if (p[0] == 0) {
+				*r = (stats[s] == BINNED_COUNT || stats[s] == BINNED_SUM) ? 
+					0 : NAN; 
+				continue; 
+			} else {} 
+			switch (stats[s]) {
+
+				case BINNED_COUNT: 
+					*r = p[0]; 
+					break; 
+
+				case BINNED_SUM: 
+					*r = p[1]; 
+					break; 
+
+				case BINNED_MEAN: 
+					*r = p[1] / p[0]; 
+					break; 
+
+				case BINNED_STD: 
+					*r = sqrt(p[3] / p[0]); 
+					break; 
+
+				case BINNED_MIN: 
+					*r = p[4]; 
+					break; 
+
+				case BINNED_MAX: 
+					*r = p[5]; 
+					break; 
+
+			} 
+		} 
+	} 
+	free(partials); 
+
+} 
@@ -0,0 +1,302 @@
+/* 
+ * This file scripts the file stream: reading an ASCII table in chunks of 
+ * rows, each handed out as a dataframe, so that computations over the file 
+ * run in a fixed amount of memory. While one chunk is being used the next 
+ * is parsed on a separate thread, and the column buffers of chunks which 
+ * are no longer referenced are refilled rather than reallocated. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <pthread.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static void stream_prepare(FILE_STREAM *s, int set); 
+static void stream_start(FILE_STREAM *s); 
+static void stream_wait(FILE_STREAM *s); 
+static void *stream_reader(void *arg); 
+static void stream_fill(FILE_STREAM *s); 
+
+/* 
+ * Opens a file for reading in chunks and starts parsing the first chunk. 
+ * 
+ * Parameters 
+ * ========== 
+ * file: 		The name of the file 
+ * comment: 	Lines beginning with this character are skipped 
+ * columns: 	The column numbers in the file to read 
+ * num_cols: 	The number of columns 
+ * types: 		The type to store each column as, as the COLUMN_* codes; 
+ * 				NULL to store them all as doubles 
+ * chunksize: 	The number of rows in each chunk 
+ * 
+ * Returns 
+ * ======= 
+ * The stream; NULL if the file can't be opened or the arguments are 
+ * invalid 
+ * 
+ * header: dataframe.h 
+ */ 
+extern FILE_STREAM *stream_initialize(char *file, char comment, 
+	int *columns, int num_cols, int *types, long chunksize) {
+
+	int i, j; 
+	if (num_cols < 1 || chunksize < 1l) return NULL; 
+	for (j = 0; j < num_cols; j++) {
+		if (columns[j] < 0) return NULL; 
+		if (types != NULL && !column_type_size(types[j])) return NULL; 
+	} 
+	FILE *in = fopen(file, "r"); 
+	if (in == NULL) return NULL; 
+
+	FILE_STREAM *s = (FILE_STREAM *) malloc (sizeof(FILE_STREAM)); 
+	s -> in = in; 
+	s -> comment = comment; 
+	s -> num_cols = num_cols; 
+	s -> chunksize = chunksize; 
+	s -> columns = (int *) malloc (num_cols * sizeof(int)); 
+	s -> types = (int *) malloc (num_cols * sizeof(int)); 
+	s -> maxcol = 0; 
+	for (j = 0; j < num_cols; j++) {
+		s -> columns[j] = columns[j]; 
+		s -> types[j] = types != NULL ? types[j] : COLUMN_FLOAT64; 
+		s -> maxcol = max((*s).maxcol, columns[j]); 
+	} 
+	for (i = 0; i < STREAM_BUFFERS; i++) {
+		s -> chunks[i] = (COLUMN_BUFFER **) calloc (num_cols, 
+			sizeof(COLUMN_BUFFER *)); 
+		s -> lengths[i] = 0l; 
+	} 
+	s -> filling = 0; 
+	s -> status = 0; 
+	s -> eof = 0; 
+	s -> num_read = 0l; 
+	s -> reader = NULL; 
+	stream_start(s); 
+	return s; 
+
+} 
+
+/* 
+ * Frees the memory stored in a file stream and closes the file. Chunks 
+ * already handed out keep their column buffers. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void free_stream(FILE_STREAM *s) {
+
+	int i, j; 
+	if (s == NULL) return; 
+	stream_wait(s); 
+	for (i = 0; i < STREAM_BUFFERS; i++) {
+		for (j = 0; j < (*s).num_cols; j++) {
+			column_buffer_release(s -> chunks[i][j]); 
+		} 
+		free(s -> chunks[i]); 
+	} 
+	fclose(s -> in); 
+	free(s -> columns); 
+	free(s -> types); 
+	free(s); 
+
+} 
+
+/* 
+ * Takes the next chunk of a file stream as a dataframe and starts parsing 
+ * the one after it. 
+ * 
+ * Parameters 
+ * ========== 
+ * s: 			The stream 
+ * dest: 		The dataframe to put the chunk into, which views the column 
+ * 				buffers of the stream. It is left with no rows or columns 
+ * 				once the file is exhausted. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 if a line of the file has too few columns 
+ * 
+ * Notes 
+ * ===== 
+ * The stream cycles through STREAM_BUFFERS sets of column buffers: one 
+ * being parsed, one handed out by this call, and one handed out by the 
+ * call before, which is usually still referenced by the caller when this 
+ * one is made. A set still referenced by the time it comes around again 
+ * (e.g. a chunk the caller kept, or exported to NumPy) is left to its 
+ * referents, and the stream allocates a new set in its place. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int stream_next(FILE_STREAM *s, DATAFRAME *dest) {
+
+	int j, ready; 
+	stream_wait(s); 
+	if ((*s).status) return 1; 
+	ready = (*s).filling; 
+	if ((*s).lengths[ready] == 0l) {
+		/* The file is exhausted */ 
+		dest -> num_rows = 0l; 
+		return 0; 
+	} else {} 
+	dataframe_reserve_columns(dest, (*s).num_cols); 
+	for (j = 0; j < (*s).num_cols; j++) {
+		column_buffer_retain(s -> chunks[ready][j]); 
+		dest -> columns[j] = (*s).chunks[ready][j]; 
+	} 
+	dest -> num_cols = (*s).num_cols; 
+	dest -> num_rows = (*s).lengths[ready]; 
+	dest -> offset = 0l; 
+	dest -> index = NULL; 
+	dest -> version = 0ul; 
+	s -> num_read+= (*s).lengths[ready]; 
+
+	/* Parse ahead, unless this chunk was the last one */ 
+	s -> filling = (ready + 1) % STREAM_BUFFERS; 
+	if ((*s).eof) {
+		s -> lengths[(*s).filling] = 0l; 
+	} else {
+		stream_start(s); 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Makes sure a set of column buffers of a stream is free to be filled, 
+ * allocating a new buffer in place of any which is still referenced 
+ * elsewhere or has been encoded or marked invalid since it was handed out. 
+ */ 
+static void stream_prepare(FILE_STREAM *s, int set) {
+
+	int j; 
+	for (j = 0; j < (*s).num_cols; j++) {
+		COLUMN_BUFFER *buffer = (*s).chunks[set][j]; 
+		if (buffer == NULL || (*buffer).refcount > 1 || 
+			(*buffer).encoding != NULL || (*buffer).validity != NULL) {
+			column_buffer_release(buffer); 
+			s -> chunks[set][j] = column_buffer_initialize((*s).chunksize, 
+				(*s).types[j]); 
+		} else {} 
+	} 
+
+} 
+
+/* 
+ * Starts filling the set of column buffers the stream is on, on a separate 
+ * thread if one can be created, else right away. 
+ */ 
+static void stream_start(FILE_STREAM *s) {
+
+	stream_prepare(s, (*s).filling); 
+	pthread_t *reader = (pthread_t *) malloc (sizeof(pthread_t)); 
+	if (pthread_create(reader, NULL, stream_reader, s)) {
+		free(reader); 
+		stream_fill(s); 
+	} else {
+		s -> reader = reader; 
+	} 
+
+} 
+
+/* Waits for the thread filling a set of column buffers, if any */ 
+static void stream_wait(FILE_STREAM *s) {
+
+	if ((*s).reader != NULL) {
+		pthread_join(*((pthread_t *) (*s).reader), NULL); 
+		free(s -> reader); 
+		s -> reader = NULL; 
+	} else {} 
+
+} 
+
+/* The entry point of the thread filling a set of column buffers */ 
+static void *stream_reader(void *arg) {
+
+	stream_fill((FILE_STREAM *) arg); 
+	return NULL; 
+
+} 
+
+/* 
+ * Parses up to a chunk's worth of rows from a stream's file into the set of 
+ * column buffers it is on. Integer columns are parsed as integers, so IDs 
+ * are read exactly. 
+ */ 
+static void stream_fill(FILE_STREAM *s) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * chunk: 		The column buffers being filled 
+	 * starts: 		The start of each value on the current line 
+	 * values: 		The values on the current line, as doubles 
+	 * n: 			The number of rows parsed so far 
+	 */ 
+	int j; 
+	long n = 0l; 
+	COLUMN_BUFFER **chunk = (*s).chunks[(*s).filling]; 
+	char *line = (char *) malloc (LINESIZE * sizeof(char)); 
+	char **starts = (char **) malloc (((*s).maxcol + 1) * sizeof(char *)); 
+	double *values = (double *) malloc (((*s).maxcol + 1) * 
+		sizeof(double)); 
+
+	while (n < (*s).chunksize) {
+		if (fgets(line, LINESIZE, (*s).in) == NULL) {
+			s -> eof = 1; 
+			break; 
+		} else if (line[0] == (*s).comment) {
+			continue; 
+		} else {} 
+		char *pos = line, *end; 
+		for (j = 0; j <= (*s).maxcol; j++) {
+			values[j] = strtod(pos, &end); 
+			if (end == pos) break; 
+			starts[j] = pos; 
+			pos = end; 
+		} 
+		if (j == 0) {
+			continue; /* a blank line */ 
+		} else if (j <= (*s).maxcol) {
+			s -> status = 1; 
+			break; 
+		} else {} 
+		for (j = 0; j < (*s).num_cols; j++) {
+			int c = (*s).columns[j]; 
+			switch ((*chunk[j]).type) {
+
+				case COLUMN_FLOAT64: 
+					((double *) chunk[j] -> values)[n] = values[c]; 
+					break; 
+
+				case COLUMN_FLOAT32: 
+					((float *) chunk[j] -> values)[n] = values[c]; 
+					break; 
+
+				case COLUMN_INT64: 
+					((long long *) chunk[j] -> values)[n] = strtoll( 
+						starts[c], NULL, 10); 
+					break; 
+
+				case COLUMN_INT32: 
+					((int *) chunk[j] -> values)[n] = strtoll(starts[c], 
+						NULL, 10); 
+					break; 
+
+			} 
+		} 
+		n++; 
+	} 
+	for (j = 0; j < (*s).num_cols; j++) {
+		chunk[j] -> length = n; 
+		chunk[j] -> version = version_stamp(); 
+	} 
+	s -> lengths[(*s).filling] = n; 
+	free(line); 
+	free(starts); 
+	free(values); 
+
+} 
+
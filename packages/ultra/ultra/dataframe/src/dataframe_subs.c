@@ -37,7 +37,7 @@ extern double *dfcolumn(DATAFRAME df, int column) {
 			/* 
 			 * Copy the column'th element from each row and return the pointer 
 			 */ 
-			arr[i] = df.data[i][column]; 
+			arr[i] = dfvalue(df, i, column); 
 		} 
 		return arr; 
 	}
@@ -45,7 +45,71 @@ extern double *dfcolumn(DATAFRAME df, int column) {
 } 
 
 /* 
- * Adds a new column to the dataframe. 
+ * Copies a column of the data into an array. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe to take the column from 
+ * column: 		The column number to take 
+ * ptr: 		A pointer to put the num_rows values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_get(DATAFRAME df, int column, double *ptr) {
+
+	if (column < 0 || column >= df.num_cols) {
+		return 1; 
+	} else if (dftype(df, column) == COLUMN_FLOAT64) {
+		/* Already doubles, so there's nothing to convert */ 
+		return dfcolumn_gather(df, column, ptr); 
+	} else {
+		long i; 
+		for (i = 0l; i < df.num_rows; i++) {
+			ptr[i] = dfvalue(df, i, column); 
+		} 
+		return 0; 
+	} 
+
+} 
+
+/* 
+ * Copies a row of the data into an array. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe to take the row from 
+ * row: 		The row number to take 
+ * ptr: 		A pointer to put the num_cols values into. Missing values are 
+ * 				NaN. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfrow_get(DATAFRAME df, long row, double *ptr) {
+
+	if (row < 0l || row >= df.num_rows) {
+		return 1; 
+	} else {
+		int j; 
+		for (j = 0; j < df.num_cols; j++) {
+			ptr[j] = dfvalid(df, row, j) ? dfvalue(df, row, j) : NAN; 
+		} 
+		return 0; 
+	} 
+
+} 
+
+/* 
+ * Adds a new column to the dataframe. If the dataframe is a view of only 
+ * some of the rows of its column buffers, it's first given its own compact 
+ * copy of them so that all of its columns stay the same length. 
  * 
  * Parameters 
  * ========== 
@@ -54,25 +118,114 @@ extern double *dfcolumn(DATAFRAME df, int column) {
  * 
  * Returns 
  * ======= 
- * 0 always; anything else is a SystemError 
+ * 0 on success, 1 on failure 
  * 
  * header: dataframe.h 
  */ 
 extern int dfcolumn_new(DATAFRAME *df, double *arr) {
 
-	long i; 
-	for (i = 0l; i < (*df).num_rows; i++) {
-		df -> data[i] = (double *) realloc (df -> data[i], 
-			((*df).num_cols + 1) * sizeof(double *)); 
-		df -> data[i][(*df).num_cols] = arr[i]; 
+	return dfcolumns_new(df, arr, 1); 
+
+} 
+
+/* 
+ * Adds several new columns to the dataframe at once. The new columns are 
+ * carved from a single arena and filled in parallel. Only the new data are 
+ * copied: the existing columns are untouched unless the dataframe is a view 
+ * of only some of the rows of its column buffers, in which case it's first 
+ * given its own compact copy of them. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe to put the new columns into 
+ * arr: 		A pointer to the values of the new columns, one column after 
+ * 				another (i.e. num_new * num_rows values) 
+ * num_new: 	The number of new columns 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumns_new(DATAFRAME *df, double *arr, int num_new) {
+
+	int j; 
+	if (num_new < 1) return 1; 
+	if ((*df).num_cols > 0 && ((*df).index != NULL || (*df).offset != 0l || 
+		(*df).columns[0] -> length != (*df).num_rows)) {
+		if (dataframe_materialize(df)) return 1; 
+	} else {} 
+	dataframe_reserve_columns(df, (*df).num_cols + num_new); 
+	ARENA *a = num_new > 1 ? arena_initialize(num_new * 
+		column_buffer_footprint((*df).num_rows, COLUMN_FLOAT64)) : NULL; 
+	#pragma omp parallel for schedule(dynamic) 
+	for (j = 0; j < num_new; j++) {
+		COLUMN_BUFFER *buffer = column_buffer_from_arena(a, (*df).num_rows, 
+			COLUMN_FLOAT64); 
+		memcpy(buffer -> values, arr + j * (*df).num_rows, 
+			(*df).num_rows * sizeof(double)); 
+		df -> columns[(*df).num_cols + j] = buffer; 
+	} 
+	if (a != NULL) arena_release(a); 
+	df -> num_cols += num_new; 
+	return 0; 
+
+} 
+
+/* 
+ * Puts a column buffer into the dataframe, either replacing a column or 
+ * adding a new one, without copying it. An empty dataframe takes its number 
+ * of rows from the buffer. A view of only some of the rows of its column 
+ * buffers is first given its own compact copy of them. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe 
+ * buffer: 		The buffer. The dataframe takes over the caller's reference to 
+ * 				it on success. 
+ * column: 		The column number to replace; num_cols to add a new column 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure (the column number is out of range, or the 
+ * buffer's length is not the number of rows) 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_adopt(DATAFRAME *df, COLUMN_BUFFER *buffer, int column) {
+
+	if (column < 0 || column > (*df).num_cols) {
+		return 1; 
+	} else if ((*df).num_cols == 0) {
+		/* An empty dataframe takes the shape of its first column */ 
+		if ((*df).index != NULL) free(df -> index); 
+		df -> index = NULL; 
+		df -> offset = 0l; 
+		df -> num_rows = (*buffer).length; 
+	} else if ((*buffer).length != (*df).num_rows) {
+		return 1; 
+	} else if ((*df).index != NULL || (*df).offset != 0l || 
+		(*df).columns[0] -> length != (*df).num_rows) {
+		if (dataframe_materialize(df)) return 1; 
+	} else {} 
+
+	if (column == (*df).num_cols) {
+		dataframe_reserve_columns(df, (*df).num_cols + 1); 
+		df -> num_cols++; 
+	} else {
+		column_buffer_release(df -> columns[column]); 
 	} 
-	df -> num_cols++; 
+	df -> columns[column] = buffer; 
 	return 0; 
 
 } 
 
 /* 
- * Modify a column of the dataframe. 
+ * Modify a column of the dataframe. If the column's buffer is shared with 
+ * other dataframes, the dataframe is first given its own copy of it, so the 
+ * others are unaffected. The new values are doubles, so a column of any other 
+ * type becomes a float64 column, and an encoded column is decoded. 
  * 
  * Parameters 
  * ========== 
@@ -83,16 +236,31 @@ extern int dfcolumn_new(DATAFRAME *df, double *arr) {
  * 
  * Returns 
  * ======= 
- * 0 always; anything else is a SystemError 
+ * 0 on success, 1 on failure 
  * 
  * header: dataframe.h 
  */ 
 extern int dfcolumn_modify(DATAFRAME *df, double *arr, int column) {
 
 	long i; 
+	if (dfcolumn_detach(df, column)) return 1; 
+	COLUMN_BUFFER *buffer = (*df).columns[column]; 
+	if ((*buffer).type != COLUMN_FLOAT64 || (*buffer).encoding != NULL) {
+		/* Convert or decode the whole buffer so the view of it is unchanged */ 
+		COLUMN_BUFFER *converted = column_buffer_initialize((*buffer).length, 
+			COLUMN_FLOAT64); 
+		for (i = 0l; i < (*buffer).length; i++) {
+			((double *) converted -> values)[i] = column_value(buffer, i); 
+		} 
+		converted -> validity = (*buffer).validity; 
+		buffer -> validity = NULL; /* detached, so no one else has it */ 
+		column_buffer_release(buffer); 
+		df -> columns[column] = buffer = converted; 
+	} else {} 
 	for (i = 0l; i < (*df).num_rows; i++) {
-		df -> data[i][column] = arr[i]; 
+		((double *) buffer -> values)[dfrow_index(*df, i)] = arr[i]; 
 	} 
+	buffer -> version = version_stamp(); 
 	return 0; 
 
 }
@@ -117,8 +285,17 @@ extern int dfcolumn_min(DATAFRAME df, int column, double *ptr) {
 	if (column < 0 || column >= df.num_cols) {
 		return 1; /* return 1 on failure */ 
 	} else { 
-		double *col = dfcolumn(df, column); 
-		*ptr = ptr_min(col, df.num_rows); 
+		long n; 
+		if (dfcolumn_runs(df, column) && df.num_rows > 0l) {
+			/* Run-length encoded: one term per run */ 
+			double sum, minimum, maximum; 
+			rle_summary(df.columns[column], df.offset, df.offset + 
+				df.num_rows, &sum, &minimum, &maximum); 
+			*ptr = minimum; 
+			return 0; 
+		} else {} 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		*ptr = ptr_min(col, n); 
 		free(col); 
 		return 0; 
 	}
@@ -145,8 +322,17 @@ extern int dfcolumn_max(DATAFRAME df, int column, double *ptr) {
 	if (column < 0 || column >= df.num_cols) {
 		return 1; /* return 1 on failure */ 
 	} else { 
-		double *col = dfcolumn(df, column); 
-		*ptr = ptr_max(col, df.num_rows); 
+		long n; 
+		if (dfcolumn_runs(df, column) && df.num_rows > 0l) {
+			/* Run-length encoded: one term per run */ 
+			double sum, minimum, maximum; 
+			rle_summary(df.columns[column], df.offset, df.offset + 
+				df.num_rows, &sum, &minimum, &maximum); 
+			*ptr = maximum; 
+			return 0; 
+		} else {} 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		*ptr = ptr_max(col, n); 
 		free(col); 
 		return 0; 
 	} 
@@ -173,8 +359,17 @@ extern int dfcolumn_sum(DATAFRAME df, int column, double *ptr) {
 	if (column < 0 || column >= df.num_cols) {
 		return 1; /* return 1 on failure */ 
 	} else { 
-		double *col = dfcolumn(df, column); 
-		*ptr = ptr_sum(col, df.num_rows); 
+		long n; 
+		if (dfcolumn_runs(df, column) && df.num_rows > 0l) {
+			/* Run-length encoded: one term per run */ 
+			double sum, minimum, maximum; 
+			rle_summary(df.columns[column], df.offset, df.offset + 
+				df.num_rows, &sum, &minimum, &maximum); 
+			*ptr = sum; 
+			return 0; 
+		} else {} 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		*ptr = ptr_sum(col, n); 
 		free(col); 
 		return 0; 
 	}
@@ -202,8 +397,17 @@ extern int dfcolumn_mean(DATAFRAME df, int column, double *ptr) {
 	if (column < 0 || column >= df.num_cols) { 
 		return 1; /* return 1 on failure */ 
 	} else { 
-		double *col = dfcolumn(df, column); 
-		*ptr = ptr_mean(col, df.num_rows); 
+		long n; 
+		if (dfcolumn_runs(df, column) && df.num_rows > 0l) {
+			/* Run-length encoded: one term per run */ 
+			double sum, minimum, maximum; 
+			rle_summary(df.columns[column], df.offset, df.offset + 
+				df.num_rows, &sum, &minimum, &maximum); 
+			*ptr = sum / df.num_rows; 
+			return 0; 
+		} else {} 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		*ptr = ptr_mean(col, n); 
 		free(col); 
 		return 0; 
 	} 
@@ -231,8 +435,9 @@ extern int dfcolumn_median(DATAFRAME df, int column, double *ptr) {
 		return 1; /* return 1 on failure */ 
 	} else { 
 		/* Pull the column and send it to ptr_median in dataframe_utils.c */ 
-		double *col = dfcolumn(df, column); 
-		*ptr = ptr_median(col, df.num_rows); 
+		long n; 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		*ptr = ptr_median(col, n); 
 		free(col); 
 		return 0; 
 	}
@@ -260,18 +465,18 @@ extern int dfcolumn_std(DATAFRAME df, int column, double *ptr) {
 		return 1; /* return 1 on failure */ 
 	} else { 
 		/* Find the squared difference between each data point and the mean */ 
-		long i; 
-		double *col = dfcolumn(df, column); 
-		double *diff = (double *) malloc (df.num_rows * sizeof(double)); 
-		double mean = ptr_mean(col, df.num_rows); 
-		for (i = 0l; i < df.num_rows; i++) {
-			diff[i] = pow(df.data[i][column] - mean, 2); 
+		long i, n; 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		double *diff = (double *) malloc (n * sizeof(double)); 
+		double mean = ptr_mean(col, n); 
+		for (i = 0l; i < n; i++) {
+			diff[i] = pow(col[i] - mean, 2); 
 		} 
 		/* 
 		 * Recast the mean as the mean squared difference, take the sqrt, and 
 		 * return. Free up the memory, then return 0 for success. 
 		 */ 
-		mean = ptr_mean(diff, df.num_rows); 
+		mean = ptr_mean(diff, n); 
 		free(diff); 
 		free(col); 
 		*ptr = sqrt(mean); 
@@ -306,17 +511,48 @@ extern int dfcolumn_scatter(DATAFRAME df, int column, double fraction,
 		return 1; /* return 1 on failure */ 
 	} else { 
 		/* Pull the column and pass to ptr_scatter */ 
-		double *col = dfcolumn(df, column); 
-		ptr_scatter(col, df.num_rows, fraction, ptr); 
+		long n; 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		ptr_scatter(col, n, fraction, ptr); 
 		free(col); 
 		return 0; 
 	}
 
 }
 
+/* 
+ * Determine several quantiles of a given column of the data in a single 
+ * selection pass. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				The dataframe itself 
+ * column: 			The column to find the quantiles of 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * ptr: 			A pointer to put the num_fractions values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_quantiles(DATAFRAME df, int column, double *fractions, 
+	int num_fractions, double *ptr) {
 
+	if (column < 0 || column >= df.num_cols) {
+		return 1; /* return 1 on failure */ 
+	} else { 
+		/* Pull the column and pass to ptr_quantiles */ 
+		int status; 
+		long n; 
+		double *col = dfcolumn_valid_values(df, column, &n); 
+		status = ptr_quantiles(col, n, fractions, num_fractions, 
+			ptr); 
+		free(col); 
+		return status; 
+	} 
 
-
-
-
+} 
 
@@ -15,8 +15,15 @@ static void swap(double *a, double *b);
  */ 
 extern DATAFRAME *dataframe_initialize(void) {
 
-	/* Allocate memory and return the pointer */ 
+	/* Allocate memory for an empty dataframe and return the pointer */ 
 	DATAFRAME *df = (DATAFRAME *) malloc (sizeof(DATAFRAME)); 
+	df -> columns = NULL; 
+	df -> index = NULL; 
+	df -> offset = 0l; 
+	df -> num_rows = 0l; 
+	df -> num_cols = 0; 
+	df -> max_cols = 0; 
+	df -> version = 0ul; 
 	return df; 
 
 } 
@@ -35,21 +42,21 @@ extern DATAFRAME **dataframe_array_initialize(int n) {
 	long i; 
 	DATAFRAME **df = (DATAFRAME **) malloc (n * sizeof(DATAFRAME *)); 
 	for (i = 0l; i < n; i++) {
-		df[i] = (DATAFRAME *) malloc (sizeof(DATAFRAME)); 
+		df[i] = dataframe_initialize(); 
 	} 
 	return df; 
 
 }
 
 /* 
- * Frees the memory storing both the data attribute and the dataframe struct 
- * itself. 
+ * Releases the dataframe's references to its column buffers and frees the 
+ * dataframe struct itself. 
  * 
  * header: dataframe.h 
  */ 
 extern void free_dataframe(DATAFRAME *df) {
 
-	free(df -> data); 
+	dataframe_release(df); 
 	free(df); 
 
 } 
@@ -68,8 +75,7 @@ extern void free_dataframe_array(DATAFRAME **df, int n) {
 
 	int i; 
 	for (i = 0; i < n; i++) {
-		free(df[i] -> data); 
-		free(df[i]); 
+		free_dataframe(df[i]); 
 	}
 	free(df); 
 
@@ -341,15 +347,22 @@ extern double ptr_mean(double *arr, long length) {
  */ 
 extern double ptr_median(double *arr, long length) {
 
-	if (length % 2l == 0l) {
+	if (length <= 0l) {
+		return 0; /* Return 0 if there isn't any data */ 
+	} else if (length % 2l == 0l) {
 		/* 
 		 * If there are an even number of elements, the median is the mean of 
-		 * the two in the middle. 
+		 * the two in the middle. Both are found in the same selection pass. 
 		 */ 
-		return (ptr_quickselect(arr, 0, length - 1l, length / 2l - 1l) + 
-			ptr_quickselect(arr, 0, length - 1l, length / 2l)) / 2; 
+		double values[2]; 
+		long ranks[2] = {length / 2l - 1l, length / 2l}; 
+		ptr_select_ranks(arr, length, ranks, 2, values); 
+		return (values[0] + values[1]) / 2; 
 	} else {
-		return ptr_quickselect(arr, 0, length - 1l, length / 2l); 
+		double value; 
+		long rank = length / 2l; 
+		ptr_select_ranks(arr, length, &rank, 1, &value); 
+		return value; 
 	}
 
 } 
@@ -377,18 +390,21 @@ extern double ptr_median(double *arr, long length) {
 extern void ptr_scatter(double *arr, long length, double fraction, 
 	double *ptr) {
 
-	/* First we need to sort the data in ascending order */ 
-	ptr_quicksort(arr, 0, length - 1l); 
-
-	if (fraction < 1) {
+	if (length <= 0l) {
+		ptr[0] = 0; 
+		ptr[1] = 0; 
+	} else if (fraction < 1) {
 		/* 
 		 * lower is the element half of the fraction between the median and the 
 		 * first element of the data. upper is the element half of the fraction 
-		 * between the median and the final element of the data. Take elements 
-		 * at the proper indeces accordingly. 
+		 * between the median and the final element of the data. Select both 
+		 * in the same partitioning pass rather than sorting the data. 
 		 */ 
-		ptr[0] = arr[(long)( 0.5 * length * (1 - fraction) )]; 
-		ptr[1] = arr[(long)( 0.5 * length * (1 + fraction) )]; 
+		long ranks[2] = {
+			(long)( 0.5 * length * (1 - fraction) ), 
+			min((long)( 0.5 * length * (1 + fraction) ), length - 1l) 
+		}; 
+		ptr_select_ranks(arr, length, ranks, 2, ptr); 
 	} else {
 		/* 
 		 * If the fraction is equal to 1, return the min and max values. All 
@@ -419,33 +435,14 @@ extern void ptr_scatter(double *arr, long length, double fraction,
  */ 
 extern double ptr_quickselect(double *arr, long low, long high, long k) {
 
-	if (low == high) {
-		/* The list contains only one element, return that */ 
-		return arr[low]; 
-	} else { 
-		/* 
-		 * Start by moving the final element into proper position as in the 
-		 * traditional quicksort algorithm. Then sort only above or below the 
-		 * partition as needed. 
-		 */ 
-		long p = partition(arr, low, high); 
-		if (k == p) { 
-			/* arr[k] is the proper value, return */ 
-			return arr[k]; 
-		} else if (k < p) { 
-			/* 
-			 * arr[k] lies below arr[p]. Sort the values less than arr[p] by 
-			 * recursively calling this function. 
-			 */ 
-			return ptr_quickselect(arr, low, p - 1l, k); 
-		} else { 
-			/* 
-			 * arr[k] lies above arr[p]. Sort the values greather than arr[p] 
-			 * by recursively calling this function. 
-			 */ 
-			return ptr_quickselect(arr, p + 1l, high, k); 
-		} 
-	} 
+	/* 
+	 * Hand off to the multi-quantile selection engine in 
+	 * dataframe_quantiles.c, which does not degrade on sorted data. 
+	 */ 
+	double value; 
+	long rank = k - low; 
+	ptr_select_ranks(arr + low, high - low + 1l, &rank, 1, &value); 
+	return value; 
 
 }
 
@@ -0,0 +1,233 @@
+/* 
+ * This file scripts the validity of the values in a column, which lets a 
+ * column hold missing values. Halo catalogs mark these with sentinels (e.g. 
+ * pid = -1 for host halos, or -99 for quantities that weren't measured), 
+ * which would otherwise flow into every statistic. Each column buffer may 
+ * carry a bitmap with one bit per value; the kernels skip the values whose 
+ * bit is clear, so no sieve, which would build a new selection, is needed to 
+ * drop them first. A buffer without a bitmap is entirely valid and costs 
+ * nothing extra. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include <math.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static int is_sentinel(double value, double *sentinels, int num_sentinels); 
+
+/* 
+ * Marks the values in a column of a dataframe equal to any of a set of 
+ * sentinels as missing. Only the rows the dataframe views are marked, and 
+ * the dataframe is first given its own copy of the column if it's shared. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 				A pointer to the dataframe 
+ * column: 			The column number 
+ * sentinels: 		The values which mean missing. A NaN marks NaNs missing. 
+ * num_sentinels: 	The number of sentinels 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_mark_invalid(DATAFRAME *df, int column, double *sentinels, 
+	int num_sentinels) {
+
+	long i; 
+	if (num_sentinels < 0 || dfcolumn_detach(df, column)) return 1; 
+	COLUMN_BUFFER *buffer = (*df).columns[column]; 
+	if ((*buffer).validity == NULL) {
+		/* Every value starts out valid */ 
+		buffer -> validity = (unsigned char *) malloc ( 
+			validity_bytes((*buffer).length > 0l ? (*buffer).length : 1l)); 
+		memset(buffer -> validity, 0xff, validity_bytes((*buffer).length)); 
+	} else {} 
+	/* 
+	 * Rows of a selection may share a byte of the bitmap, so only a slice is 
+	 * marked in parallel, and then only whole bytes per thread. 
+	 */ 
+	if ((*df).index == NULL) {
+		long first = (*df).offset, last = (*df).offset + (*df).num_rows; 
+		long byte; 
+		#pragma omp parallel for schedule(static) 
+		for (byte = first >> 3; byte < validity_bytes(last); byte++) {
+			long j; 
+			for (j = byte << 3; j < (byte << 3) + 8l && j < last; j++) {
+				if (j >= first && is_sentinel(column_value(buffer, j), 
+					sentinels, num_sentinels)) {
+					buffer -> validity[j >> 3] &= ~(1 << (j & 7)); 
+				} else {} 
+			} 
+		} 
+	} else {
+		for (i = 0l; i < (*df).num_rows; i++) {
+			long j = (*df).index[i]; 
+			if (is_sentinel(column_value(buffer, j), sentinels, 
+				num_sentinels)) {
+				buffer -> validity[j >> 3] &= ~(1 << (j & 7)); 
+			} else {} 
+		} 
+	} 
+	buffer -> version = version_stamp(); 
+	return 0; 
+
+} 
+
+/* 
+ * Determine which rows of a column of a dataframe are valid. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number 
+ * ptr: 		A pointer to put 1s at the valid rows and 0s at the missing ones 
+ * 				into, with df.num_rows elements 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_validity(DATAFRAME df, int column, int *ptr) {
+
+	long i; 
+	if (column < 0 || column >= df.num_cols) return 1; 
+	#pragma omp parallel for schedule(static) 
+	for (i = 0l; i < df.num_rows; i++) {
+		ptr[i] = dfvalid(df, i, column); 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Determine the number of valid values in a column of a dataframe. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number 
+ * ptr: 		A pointer to put the number of valid values into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_count_valid(DATAFRAME df, int column, long *ptr) {
+
+	long i, n = 0l; 
+	if (column < 0 || column >= df.num_cols) return 1; 
+	if (df.columns[column] -> validity == NULL) {
+		*ptr = df.num_rows; 
+		return 0; 
+	} else {} 
+	#pragma omp parallel for schedule(static) reduction(+:n) 
+	for (i = 0l; i < df.num_rows; i++) {
+		n += dfvalid(df, i, column); 
+	} 
+	*ptr = n; 
+	return 0; 
+
+} 
+
+/* 
+ * Takes the valid values of a column as doubles, skipping the missing ones. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number, which must be in range 
+ * length: 		A pointer to put the number of valid values into 
+ * 
+ * Returns 
+ * ======= 
+ * Type *double :: The valid values, in row order 
+ * 
+ * header: dataframe.h 
+ */ 
+extern double *dfcolumn_valid_values(DATAFRAME df, int column, long *length) {
+
+	long i, n = 0l; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	if ((*buffer).validity == NULL) {
+		*length = df.num_rows; 
+		return dfcolumn(df, column); 
+	} else {} 
+	double *arr = (double *) malloc ((df.num_rows > 0l ? df.num_rows : 1l) * 
+		sizeof(double)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		long j = dfrow_index(df, i); 
+		if (column_valid(buffer, j)) arr[n++] = column_value(buffer, j); 
+	} 
+	*length = n; 
+	return arr; 
+
+} 
+
+/* 
+ * Copies the validity of the rows of a column of a dataframe that it views 
+ * into the validity bitmap of another column buffer, row for row. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number 
+ * dest: 		The buffer to give the validity to, with df.num_rows values. 
+ * 				Its bitmap is left NULL if every value is valid. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void dfcolumn_gather_validity(DATAFRAME df, int column, 
+	COLUMN_BUFFER *dest) {
+
+	long i; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	if ((*buffer).validity == NULL) return; 
+	dest -> validity = (unsigned char *) calloc ( 
+		validity_bytes(df.num_rows > 0l ? df.num_rows : 1l), 
+		sizeof(unsigned char)); 
+	for (i = 0l; i < df.num_rows; i++) {
+		if (column_valid(buffer, dfrow_index(df, i))) {
+			dest -> validity[i >> 3] |= 1 << (i & 7); 
+		} else {} 
+	} 
+
+} 
+
+/* 
+ * Determine whether or not a value is one of a set of sentinels. 
+ * 
+ * Parameters 
+ * ========== 
+ * value: 			The value 
+ * sentinels: 		The sentinels; a NaN matches NaNs 
+ * num_sentinels: 	The number of sentinels 
+ * 
+ * Returns 
+ * ======= 
+ * 1 if it is, 0 if it isn't 
+ */ 
+static int is_sentinel(double value, double *sentinels, int num_sentinels) {
+
+	int k; 
+	for (k = 0; k < num_sentinels; k++) {
+		if (value == sentinels[k] || (isnan(value) && isnan(sentinels[k]))) {
+			return 1; 
+		} else {
+			continue; 
+		} 
+	} 
+	return 0; 
+
+} 
+
@@ -0,0 +1,566 @@
+/* 
+ * This file scripts the reference-counted column buffers and the views of 
+ * them that dataframes are. Taking a slice or a selection of the rows of a 
+ * dataframe adds references to its column buffers rather than copying them, 
+ * and a buffer is only copied when a dataframe sharing it is about to write 
+ * to it. The reference counts are only touched outside of parallel regions. 
+ */ 
+
+#include <stdlib.h> 
+#include <string.h> 
+#include <stdio.h> 
+#include "dataframe.h" 
+#include "utils.h" 
+
+/* ---------- Static routine comment headers not duplicated here  ---------- */ 
+static void share_columns(DATAFRAME source, DATAFRAME *dest); 
+
+/* 
+ * Allocates memory for a column buffer holding one reference and returns the 
+ * pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * length: 		The number of values in the buffer 
+ * type: 		The type of the values, as the COLUMN_* codes in dataframe.h 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_BUFFER *column_buffer_initialize(long length, int type) {
+
+	COLUMN_BUFFER *buffer = (COLUMN_BUFFER *) malloc (sizeof(COLUMN_BUFFER)); 
+	buffer -> values = malloc ((length > 0l ? length : 1l) * 
+		column_type_size(type)); 
+	buffer -> length = length; 
+	buffer -> type = type; 
+	buffer -> refcount = 1; 
+	buffer -> arena = NULL; 
+	buffer -> destructor = NULL; 
+	buffer -> context = NULL; 
+	buffer -> validity = NULL; 
+	buffer -> encoding = NULL; 
+	buffer -> version = version_stamp(); 
+	buffer -> writers = 0; 
+	return buffer; 
+
+} 
+
+/* 
+ * The number of bytes taken by one value of a given type. 
+ * 
+ * Parameters 
+ * ========== 
+ * type: 		The type, as the COLUMN_* codes in dataframe.h 
+ * 
+ * Returns 
+ * ======= 
+ * The size of the C type; 0 if the type is not recognized 
+ * 
+ * header: dataframe.h 
+ */ 
+extern unsigned long column_type_size(int type) {
+
+	switch (type) {
+
+		case COLUMN_FLOAT64: 
+			return sizeof(double); 
+
+		case COLUMN_FLOAT32: 
+			return sizeof(float); 
+
+		case COLUMN_INT64: 
+			return sizeof(long long); 
+
+		case COLUMN_INT32: 
+			return sizeof(int); 
+
+		default: 
+			return 0ul; 
+
+	} 
+
+} 
+
+/* 
+ * Allocates memory for a column buffer wrapping values owned by someone 
+ * else, without copying them, and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * values: 		The values to wrap 
+ * length: 		The number of values 
+ * type: 		The type of the values, as the COLUMN_* codes in dataframe.h 
+ * destructor: 	The function to call with context when the buffer is freed, 
+ * 				e.g. to let the owner know the values are no longer in use 
+ * context: 	The argument to the destructor 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_BUFFER *column_buffer_wrap(void *values, long length, 
+	int type, void (*destructor)(void *), void *context) {
+
+	COLUMN_BUFFER *buffer = (COLUMN_BUFFER *) malloc (sizeof(COLUMN_BUFFER)); 
+	buffer -> values = values; 
+	buffer -> length = length; 
+	buffer -> type = type; 
+	buffer -> refcount = 1; 
+	buffer -> arena = NULL; 
+	buffer -> destructor = destructor; 
+	buffer -> context = context; 
+	buffer -> validity = NULL; 
+	buffer -> encoding = NULL; 
+	buffer -> version = version_stamp(); 
+	buffer -> writers = 0; 
+	return buffer; 
+
+} 
+
+/* 
+ * Allocates memory for a column buffer holding a contiguous copy of an array 
+ * of a given type, with a given stride between elements. The buffer keeps 
+ * the type of the array. 
+ * 
+ * Parameters 
+ * ========== 
+ * data: 		The start of the array 
+ * length: 		The number of elements 
+ * stride: 		The number of bytes between consecutive elements 
+ * type: 		The type of the elements, as the COLUMN_* codes in dataframe.h 
+ * 
+ * Returns 
+ * ======= 
+ * The buffer; NULL if the type is not recognized 
+ * 
+ * header: dataframe.h 
+ */ 
+extern COLUMN_BUFFER *column_buffer_convert(void *data, long length, 
+	long stride, int type) {
+
+	long i; 
+	char *start = (char *) data; 
+	unsigned long size = column_type_size(type); 
+	if (!size) return NULL; 
+	COLUMN_BUFFER *buffer = column_buffer_initialize(length, type); 
+	if (stride == (long) size) {
+		memcpy(buffer -> values, data, length * size); 
+	} else {
+		char *values = (char *) (*buffer).values; 
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < length; i++) {
+			memcpy(values + i * size, start + i * stride, size); 
+		} 
+	} 
+	return buffer; 
+
+} 
+
+/* 
+ * Adds a reference to a column buffer. This is safe to call from several 
+ * threads at once, as dataframes sharing a buffer may be used from different 
+ * threads. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void column_buffer_retain(COLUMN_BUFFER *buffer) {
+
+	#pragma omp atomic 
+	buffer -> refcount++; 
+
+} 
+
+/* 
+ * Determine a number no previous call has returned, to mark a column buffer 
+ * or dataframe as changed. This is safe to call from parallel regions. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern unsigned long version_stamp(void) {
+
+	static unsigned long counter = 0ul; 
+	unsigned long stamp; 
+	#pragma omp atomic capture 
+	stamp = ++counter; 
+	return stamp; 
+
+} 
+
+/* 
+ * Removes a reference from a column buffer, freeing it if that was the last 
+ * one. A buffer carved from an arena instead releases its reference to the 
+ * arena, which frees everything carved from it at once. This is safe to call 
+ * from several threads at once. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void column_buffer_release(COLUMN_BUFFER *buffer) {
+
+	int remaining; 
+	if (buffer == NULL) return; 
+	#pragma omp atomic capture 
+	remaining = --(buffer -> refcount); 
+	if (remaining > 0) return; 
+	if ((*buffer).validity != NULL) free(buffer -> validity); 
+	column_encoding_free(buffer -> encoding); 
+	if ((*buffer).destructor != NULL) {
+		/* The values belong to someone else */ 
+		(*buffer).destructor((*buffer).context); 
+		free(buffer); 
+	} else if ((*buffer).arena != NULL) {
+		arena_release(buffer -> arena); 
+	} else {
+		free(buffer -> values); 
+		free(buffer); 
+	} 
+
+} 
+
+/* 
+ * Releases a dataframe's references to its column buffers and frees its 
+ * selection, leaving it empty. The dataframe struct itself is not freed. 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void dataframe_release(DATAFRAME *df) {
+
+	int j; 
+	if ((*df).columns != NULL) {
+		for (j = 0; j < (*df).num_cols; j++) {
+			column_buffer_release(df -> columns[j]); 
+		} 
+		free(df -> columns); 
+	} else {} 
+	if ((*df).index != NULL) free(df -> index); 
+	df -> columns = NULL; 
+	df -> index = NULL; 
+	df -> offset = 0l; 
+	df -> num_rows = 0l; 
+	df -> num_cols = 0; 
+	df -> max_cols = 0; 
+	df -> version = 0ul; 
+
+} 
+
+/* 
+ * Makes a dataframe a view of a contiguous range of the rows of another. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * start: 		The first row of the source in the view 
+ * stop: 		One past the last row of the source in the view 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_slice(DATAFRAME source, DATAFRAME *dest, long start, 
+	long stop) {
+
+	if (start < 0l || stop < start || stop > source.num_rows) return 1; 
+	share_columns(source, dest); 
+	dest -> num_rows = stop - start; 
+	if (source.index == NULL) {
+		/* A slice of a slice is still a slice */ 
+		dest -> index = NULL; 
+		dest -> offset = source.offset + start; 
+	} else {
+		long i; 
+		dest -> index = (long *) malloc (((*dest).num_rows > 0l ? 
+			(*dest).num_rows : 1l) * sizeof(long)); 
+		for (i = 0l; i < (*dest).num_rows; i++) {
+			dest -> index[i] = source.index[start + i]; 
+		} 
+		dest -> offset = 0l; 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Makes a dataframe a view of an arbitrary selection of the rows of another. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * rows: 		The rows of the source in the view, in the order they should 
+ * 				appear in it 
+ * num_rows: 	The number of rows in the view 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_select(DATAFRAME source, DATAFRAME *dest, long *rows, 
+	long num_rows) {
+
+	long i; 
+	if (num_rows < 0l) return 1; 
+	for (i = 0l; i < num_rows; i++) {
+		if (rows[i] < 0l || rows[i] >= source.num_rows) return 1; 
+	} 
+	share_columns(source, dest); 
+	dest -> num_rows = num_rows; 
+	dest -> offset = 0l; 
+	/* The selection is made of rows of the buffers, not rows of the source */ 
+	dest -> index = (long *) malloc ((num_rows > 0l ? num_rows : 1l) * 
+		sizeof(long)); 
+	for (i = 0l; i < num_rows; i++) {
+		dest -> index[i] = dfrow_index(source, rows[i]); 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Makes a dataframe a view of the rows of another which pass a test. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 		The dataframe to view 
+ * dest: 		A pointer to the dataframe to make the view 
+ * test: 		1s at the rows of the source to include, 0s elsewhere 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_select_mask(DATAFRAME source, DATAFRAME *dest, 
+	int *test) {
+
+	long i, n = 0l, num_rows = 0l; 
+	for (i = 0l; i < source.num_rows; i++) {
+		num_rows += test[i] != 0; 
+	} 
+	share_columns(source, dest); 
+	dest -> num_rows = num_rows; 
+	dest -> offset = 0l; 
+	dest -> index = (long *) malloc ((num_rows > 0l ? num_rows : 1l) * 
+		sizeof(long)); 
+	for (i = 0l; i < source.num_rows; i++) {
+		if (test[i]) {
+			dest -> index[n++] = dfrow_index(source, i); 
+		} else {
+			continue; 
+		} 
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Ensures that a dataframe has room for at least a given number of columns 
+ * without reallocating its columns array. The room is at least doubled when 
+ * it grows, so adding columns one at a time takes amortized constant time. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe 
+ * num_cols: 	The number of columns to make room for 
+ * 
+ * header: dataframe.h 
+ */ 
+extern void dataframe_reserve_columns(DATAFRAME *df, int num_cols) {
+
+	if (num_cols <= (*df).max_cols) return; 
+	df -> max_cols = max(num_cols, 2 * (*df).max_cols); 
+	df -> columns = (COLUMN_BUFFER **) realloc (df -> columns, 
+		(*df).max_cols * sizeof(COLUMN_BUFFER *)); 
+
+} 
+
+/* 
+ * Gives a dataframe its own compact copy of the rows of its column buffers 
+ * that it views, releasing its references to the shared ones. 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dataframe_materialize(DATAFRAME *df) {
+
+	/* 
+	 * Each thread carves and fills the buffers of its own columns out of one 
+	 * arena holding them all. 
+	 */ 
+	int j; 
+	unsigned long capacity = 0ul; 
+	COLUMN_BUFFER **copies = (COLUMN_BUFFER **) malloc (((*df).num_cols > 0 ? 
+		(*df).num_cols : 1) * sizeof(COLUMN_BUFFER *)); 
+	for (j = 0; j < (*df).num_cols; j++) {
+		capacity += column_buffer_footprint((*df).num_rows, dftype(*df, j)); 
+	} 
+	ARENA *a = arena_initialize(capacity); 
+	#pragma omp parallel for schedule(dynamic) 
+	for (j = 0; j < (*df).num_cols; j++) {
+		copies[j] = column_buffer_from_arena(a, (*df).num_rows, 
+			dftype(*df, j)); 
+		dfcolumn_gather(*df, j, copies[j] -> values); 
+		dfcolumn_gather_validity(*df, j, copies[j]); 
+	} 
+	arena_release(a); 
+	for (j = 0; j < (*df).num_cols; j++) {
+		column_buffer_release(df -> columns[j]); 
+		df -> columns[j] = copies[j]; 
+	} 
+	free(copies); 
+	if ((*df).index != NULL) free(df -> index); 
+	df -> index = NULL; 
+	df -> offset = 0l; 
+	return 0; 
+
+} 
+
+/* 
+ * Copies the rows of a column of a dataframe that it views into a contiguous 
+ * array of the column's own type, without converting them. Encoded columns 
+ * are decoded. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			The dataframe itself 
+ * column: 		The column number 
+ * dest: 		The array to copy into, with df.num_rows elements of the type 
+ * 				of the column 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_gather(DATAFRAME df, int column, void *dest) {
+
+	long i; 
+	if (column < 0 || column >= df.num_cols) return 1; 
+	COLUMN_BUFFER *buffer = df.columns[column]; 
+	unsigned long size = column_type_size((*buffer).type); 
+	if ((*buffer).encoding != NULL) {
+		#pragma omp parallel for schedule(static) 
+		for (i = 0l; i < df.num_rows; i++) {
+			column_encoded_get(buffer, dfrow_index(df, i), 
+				(char *) dest + i * size); 
+		} 
+		return 0; 
+	} else if (df.index == NULL) {
+		memcpy(dest, (char *) (*buffer).values + df.offset * size, 
+			df.num_rows * size); 
+		return 0; 
+	} else {} 
+	switch ((*buffer).type) {
+
+		case COLUMN_FLOAT64: 
+			for (i = 0l; i < df.num_rows; i++) {
+				((double *) dest)[i] = ((double *) (*buffer).values)[df.index[i]]; 
+			} 
+			break; 
+
+		case COLUMN_FLOAT32: 
+			for (i = 0l; i < df.num_rows; i++) {
+				((float *) dest)[i] = ((float *) (*buffer).values)[df.index[i]]; 
+			} 
+			break; 
+
+		case COLUMN_INT64: 
+			for (i = 0l; i < df.num_rows; i++) {
+				((long long *) dest)[i] = 
+					((long long *) (*buffer).values)[df.index[i]]; 
+			} 
+			break; 
+
+		case COLUMN_INT32: 
+			for (i = 0l; i < df.num_rows; i++) {
+				((int *) dest)[i] = ((int *) (*buffer).values)[df.index[i]]; 
+			} 
+			break; 
+
+		default: 
+			return 1; 
+
+	} 
+	return 0; 
+
+} 
+
+/* 
+ * Ensures that a dataframe holds the only reference to the buffer of a given 
+ * column, copying the buffer if it's shared (i.e. copy-on-write) or if its 
+ * values belong to someone else. The whole buffer is copied so that the 
+ * dataframe's view of it is unchanged. 
+ * 
+ * Parameters 
+ * ========== 
+ * df: 			A pointer to the dataframe about to write to the column 
+ * column: 		The column number 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * header: dataframe.h 
+ */ 
+extern int dfcolumn_detach(DATAFRAME *df, int column) {
+
+	if (column < 0 || column >= (*df).num_cols) return 1; 
+	COLUMN_BUFFER *shared = (*df).columns[column]; 
+	if ((*shared).refcount > 1 || (*shared).destructor != NULL) {
+		COLUMN_BUFFER *own; 
+		if ((*shared).encoding != NULL) {
+			/* Copied still encoded; writers decode it themselves */ 
+			own = column_buffer_initialize(0l, (*shared).type); 
+			free(own -> values); 
+			own -> values = NULL; 
+			own -> length = (*shared).length; 
+			own -> encoding = column_encoding_copy((*shared).encoding); 
+		} else {
+			own = column_buffer_initialize((*shared).length, (*shared).type); 
+			memcpy(own -> values, (*shared).values, 
+				(*shared).length * column_type_size((*shared).type)); 
+		} 
+		if ((*shared).validity != NULL) {
+			own -> validity = (unsigned char *) malloc (validity_bytes( 
+				(*shared).length > 0l ? (*shared).length : 1l)); 
+			memcpy(own -> validity, (*shared).validity, 
+				validity_bytes((*shared).length)); 
+		} else {} 
+		column_buffer_release(shared); 
+		df -> columns[column] = own; 
+	} else {} 
+	return 0; 
+
+} 
+
+/* 
+ * Gives a dataframe references to all of the column buffers of another. Its 
+ * rows are a new arrangement of them, so it also gets a new version: an 
+ * index built on whatever it held before can't be current. 
+ * 
+ * Parameters 
+ * ========== 
+ * source: 		The dataframe holding the column buffers 
+ * dest: 		A pointer to the dataframe to give them to 
+ */ 
+static void share_columns(DATAFRAME source, DATAFRAME *dest) {
+
+	int j; 
+	dest -> num_cols = source.num_cols; 
+	dest -> max_cols = source.num_cols > 0 ? source.num_cols : 1; 
+	dest -> columns = (COLUMN_BUFFER **) malloc ((*dest).max_cols * 
+		sizeof(COLUMN_BUFFER *)); 
+	for (j = 0; j < source.num_cols; j++) {
+		column_buffer_retain(source.columns[j]); 
+		dest -> columns[j] = source.columns[j]; 
+	} 
+	dest -> version = version_stamp(); 
+
+} 
+
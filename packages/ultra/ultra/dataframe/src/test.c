@@ -2,26 +2,1089 @@
 #include <stdlib.h> 
 #include <string.h> 
 #include <stdio.h> 
+#include <math.h> 
 #include <time.h> 
+#include <unistd.h> 
+#ifdef _OPENMP 
+#include <omp.h> 
+#endif /* _OPENMP */ 
 #include "dataframe.h" 
 #include "utils.h" 
 
+/* Larger than the size at which the selection partitions in parallel */ 
+#define LARGE_LENGTH 3000000l 
+
+/* The rows handed to a sink by the external sort, row-major */ 
+typedef struct collected_rows {
+
+	double *rows; 
+	long n; 
+
+} COLLECTED_ROWS; 
+
+static int test_nested_selection(void); 
+static int test_large_bins(void); 
+static int test_large_groups(void); 
+static int test_index(void); 
+static int test_external_sort(void); 
+static int test_join(void); 
+static int test_groupby(void); 
+static int test_argsort(void); 
+static int test_stream(void); 
+static int test_top_and_sample(void); 
+static int test_resampling(void); 
+static int test_kendall(void); 
+static int test_conditional_percentile(void); 
+static int collect_rows(double *rows, long n, int num_cols, void *state); 
+static int same_rows(DATAFRAME a, DATAFRAME b, int column); 
+static int compare_rows(DATAFRAME df, int column, long p, long q, 
+	int descending); 
+static int check(int passed, const char *test, const char *what); 
+static int compare_doubles(const void *a, const void *b); 
+static DATAFRAME *columns_dataframe(double *arr, long length, int num_cols); 
+static DATAFRAME *halves_dataframe(long length); 
+static double *shuffled_range(long length); 
+
 /* 
- * Currently running tests on quicksort. 
+ * Regression tests, run with make test.o && ./test.o 
  */ 
 int main(void) { 
 
 	srand(time(NULL)); 
-	long i; 
-	double *arr = (double *) malloc (10 * sizeof(double)); 
+	int failures = 0; 
+	failures += test_nested_selection(); 
+	failures += test_large_bins(); 
+	failures += test_large_groups(); 
+	failures += test_index(); 
+	failures += test_external_sort(); 
+	failures += test_join(); 
+	failures += test_groupby(); 
+	failures += test_argsort(); 
+	failures += test_stream(); 
+	failures += test_top_and_sample(); 
+	failures += test_resampling(); 
+	failures += test_kendall(); 
+	failures += test_conditional_percentile(); 
+	printf("%d failure(s)\n", failures); 
+	return failures != 0; 
+
+} 
+
+/* 
+ * Selection on arrays large enough to be partitioned in parallel, called 
+ * from within a parallel region, must give the same ranks as when called 
+ * serially. 
+ */ 
+static int test_nested_selection(void) {
+
+	int failures = 0; 
+	#pragma omp parallel num_threads(2) reduction(+:failures) 
+	{
+		long ranks[3] = {LARGE_LENGTH / 2l, 0l, LARGE_LENGTH - 1l}; 
+		double values[3]; 
+		double *arr = shuffled_range(LARGE_LENGTH); 
+		if (ptr_select_ranks(arr, LARGE_LENGTH, ranks, 3, values) || 
+			values[0] != ranks[0] || values[1] != ranks[1] || 
+			values[2] != ranks[2]) {
+			printf("test_nested_selection: got %g %g %g\n", values[0], 
+				values[1], values[2]); 
+			failures++; 
+		} else {} 
+		free(arr); 
+	} 
+	return failures; 
+
+} 
+
+/* 
+ * The median and quantiles of bins too large to select from within the 
+ * per-bin parallel loop must match those of the values in each. 
+ */ 
+static int test_large_bins(void) {
+
+	int s, failures = 0; 
+	double binspace[3] = {0, 1, 2}, fractions[2] = {0, 0.9}, results[4]; 
+	int stats[2] = {BINNED_MEDIAN, BINNED_QUANTILE}; 
+	long half = LARGE_LENGTH / 2l; 
+	double expected[4] = {
+		(half / 2l - 1l + half / 2l) / 2.0, (double) (long) (0.9 * half), 
+		half + (half / 2l - 1l + half / 2l) / 2.0, 
+		half + (double) (long) (0.9 * half) 
+	}; 
+	DATAFRAME *df = halves_dataframe(LARGE_LENGTH); 
+	if (binned_statistic(*df, 0, 1, binspace, 2l, stats, fractions, 2, 
+		results)) {
+		printf("test_large_bins: binned_statistic failed\n"); 
+		failures++; 
+	} else {
+		for (s = 0; s < 4; s++) {
+			if (results[s] != expected[s]) {
+				printf("test_large_bins: got %g, expected %g\n", results[s], 
+					expected[s]); 
+				failures++; 
+			} else {} 
+		} 
+	} 
+	free_dataframe(df); 
+	return failures; 
+
+} 
+
+/* 
+ * The medians of groups of very different sizes, some too large to select 
+ * from within the per-group parallel loop, must match those found by 
+ * sorting the values in each. 
+ */ 
+static int test_large_groups(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * groups: 		The group of each row: 0 for the lower half of the values 
+	 * 				(less every 7th, in no group), 2 for every 100th of the 
+	 * 				upper half, and 1 for the rest of it 
+	 * values: 		The values of each group, sorted for the expected medians 
+	 */ 
+	int j, failures = 0, stats[2] = {BINNED_COUNT, BINNED_MEDIAN}; 
+	long i, half = LARGE_LENGTH / 2l, counts[3] = {0l, 0l, 0l}; 
+	double results[6]; 
+	DATAFRAME *df = halves_dataframe(LARGE_LENGTH); 
+	long *groups = (long *) malloc (LARGE_LENGTH * sizeof(long)); 
+	double *values[3]; 
+	for (j = 0; j < 3; j++) {
+		values[j] = (double *) malloc (LARGE_LENGTH * sizeof(double)); 
+	} 
+	for (i = 0l; i < LARGE_LENGTH; i++) {
+		long y = (long) dfvalue(*df, i, 1); 
+		if (y < half) {
+			groups[i] = y % 7l ? 0l : -1l; 
+		} else {
+			groups[i] = y % 100l ? 1l : 2l; 
+		} 
+		if (groups[i] != -1l) values[groups[i]][counts[groups[i]]++] = y; 
+	} 
+	if (group_statistic(*df, groups, 3l, 1, stats, NULL, 2, results)) {
+		printf("test_large_groups: group_statistic failed\n"); 
+		failures++; 
+	} else {
+		for (j = 0; j < 3; j++) {
+			long n = counts[j]; 
+			qsort(values[j], n, sizeof(double), compare_doubles); 
+			double median = (values[j][(n - 1l) / 2l] + values[j][n / 2l]) / 2; 
+			if (results[2 * j] != n || results[2 * j + 1] != median) {
+				printf("test_large_groups: group %d got %g %g, ", j, 
+					results[2 * j], results[2 * j + 1]); 
+				printf("expected %ld %g\n", n, median); 
+				failures++; 
+			} else {} 
+		} 
+	} 
+	for (j = 0; j < 3; j++) free(values[j]); 
+	free(groups); 
+	free_dataframe(df); 
+	return failures; 
+
+} 
+
+/* 
+ * Range, bin and rank queries of an indexed column must match scans of it, 
+ * and the index must stop being current once the column is written to, the 
+ * rows are reordered, or the dataframe holding it is reused for another 
+ * view of the same length. 
+ */ 
+static int test_index(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		10000 rows of two columns: the values 0 through 99 one 
+	 * 				hundred times each in a random order, and the row number 
+	 * indexed: 	The view from a query using the index 
+	 * scanned: 	The view from the same query scanning the column 
+	 */ 
+	const char *test = "test_index"; 
+	int failures = 0; 
+	long i, counts[3], length = 10000l; 
+	double bin[2] = {20, 29}; 
+	double *shuffled = shuffled_range(length); 
+	double *arr = (double *) malloc (2l * length * sizeof(double)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = (long) shuffled[i] % 100l; 
+		arr[length + i] = i; 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 2); 
+	DATAFRAME *indexed = dataframe_initialize(); 
+	DATAFRAME *scanned = dataframe_initialize(); 
+	COLUMN_INDEX *idx = column_index_initialize(*df, 0); 
+	failures += check(column_index_current(*df, 0, idx), test, 
+		"new index not current"); 
+
+	dfcolumn_rank(*df, 0, idx, 37, counts); 
+	failures += check(counts[0] == 3700l && counts[1] == 3800l && 
+		counts[2] == length, test, "rank of a present value"); 
+	dfcolumn_rank(*df, 0, idx, 37.5, counts); 
+	failures += check(counts[0] == 3800l && counts[1] == 3800l, test, 
+		"rank of an absent value"); 
+	indexed_sieve(*df, indexed, 0, idx, 10, NULL, 1); 
+	sieve(*df, scanned, 0, 10, 1); 
+	failures += check((*indexed).num_rows == 1000l && 
+		same_rows(*indexed, *scanned, 1), test, "range query"); 
+	dataframe_release(indexed); 
+	dataframe_release(scanned); 
+	indexed_bin(*df, indexed, 0, idx, bin); 
+	dfcolumn_bin(*df, scanned, 0, bin); 
+	failures += check((*indexed).num_rows == 1000l && 
+		same_rows(*indexed, *scanned, 1), test, "bin query"); 
+	dataframe_release(indexed); 
+	dataframe_release(scanned); 
+
+	/* Writes and reorders put the index out of date */ 
+	for (i = 0l; i < length; i++) arr[i] = -arr[i]; 
+	dfcolumn_modify(df, arr, 0); 
+	failures += check(!column_index_current(*df, 0, idx), test, 
+		"index current after a write"); 
+	dfcolumn_rank(*df, 0, idx, 0, counts); 
+	failures += check(counts[0] == 9900l, test, "rank after a write"); 
+	free_column_index(idx); 
+	idx = column_index_initialize(*df, 0); 
+	dfcolumn_order(df, 1); 
+	failures += check(!column_index_current(*df, 0, idx), test, 
+		"index current after a reorder"); 
+	free_column_index(idx); 
+
+	/* A dataframe reused for another view of the same length */ 
+	dataframe_slice(*df, indexed, 0l, length / 2l); 
+	idx = column_index_initialize(*indexed, 0); 
+	dataframe_release(indexed); 
+	dataframe_slice(*df, indexed, length / 2l, length); 
+	failures += check(!column_index_current(*indexed, 0, idx), test, 
+		"index current on a reused view"); 
+
+	free_column_index(idx); 
+	free_dataframe(indexed); 
+	free_dataframe(scanned); 
+	free_dataframe(df); 
+	free(shuffled); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * The external sort of several files, in chunks small enough to need many 
+ * runs and several merge passes, must give the rows in the same order as 
+ * the in-memory sort of all of them, by a double column with ties, signed 
+ * zeros and NaNs and by an integer column too large for a double, in 
+ * either direction, carrying the integers through exactly. 
+ */ 
+static int test_external_sort(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * ids: 		The first column of the files, integers above 2^53 
+	 * values: 		The second, a tenth of an integer from -5 to 5, or NaN 
+	 * paths: 		The names of the files 
+	 * memory: 		The values, the place of each row among those of every 
+	 * 				file, and the ids as an int64 column 
+	 * order: 		The order of the rows from the in-memory sort 
+	 */ 
+	const char *test = "test_external_sort"; 
+	int f, key, descending, failures = 0, num_files = 3; 
+	int columns[3] = {0, 1, 2}, integers[3] = {1, 0, 0}; 
+	long i, per_file = 2000l, length = num_files * per_file; 
+	long long *ids = (long long *) malloc (length * sizeof(long long)); 
+	double *arr = (double *) malloc (2l * length * sizeof(double)); 
+	char *paths[3]; 
+	for (i = 0l; i < length; i++) {
+		ids[i] = (1ll << 60) + ((long long) rand() << 8) + i % 7l; 
+		arr[i] = i % 97l ? (double) (rand() % 101 - 50) / 10 : NAN; 
+		if (i % 89l == 0l) arr[i] = i % 2l ? -0.0 : 0.0; 
+		arr[length + i] = i; 
+	} 
+	for (f = 0; f < num_files; f++) {
+		paths[f] = (char *) malloc (32 * sizeof(char)); 
+		sprintf(paths[f], "/tmp/ultra-test-XXXXXX"); 
+		FILE *out = fdopen(mkstemp(paths[f]), "w"); 
+		fprintf(out, "# id value row\n"); 
+		for (i = f * per_file; i < (f + 1) * per_file; i++) {
+			if (i == f * per_file + per_file / 2l) fprintf(out, "#\n"); 
+			fprintf(out, "%lld %.17g %ld\n", ids[i], arr[i], i); 
+		} 
+		fclose(out); 
+	} 
+
+	/* The in-memory dataframe, holding the ids as integers */ 
+	DATAFRAME *memory = columns_dataframe(arr, length, 2); 
+	COLUMN_BUFFER *buffer = column_buffer_initialize(length, COLUMN_INT64); 
+	memcpy(buffer -> values, ids, length * sizeof(long long)); 
+	dfcolumn_adopt(memory, buffer, 2); 
+	long *order = (long *) malloc (length * sizeof(long)); 
+	for (key = 0; key < 2; key++) {
+		for (descending = 0; descending < 2; descending++) {
+			COLLECTED_ROWS sorted = {NULL, 0l}; 
+			long num_rows; 
+			int memory_column = key ? 0 : 2; 
+			dfcolumns_argsort(*memory, &memory_column, &descending, 1, order); 
+			if (external_sort_rows(paths, num_files, '#', columns, 3, 
+				integers, key, descending, 4096ul, NULL, collect_rows, 
+				&sorted, &num_rows) || num_rows != length || 
+				sorted.n != length) {
+				failures += check(0, test, "sort failed"); 
+				free(sorted.rows); 
+				continue; 
+			} else {} 
+			for (i = 0l; i < length; i++) {
+				long long id; 
+				memcpy(&id, sorted.rows + 3l * i, sizeof(double)); 
+				if ((long) sorted.rows[3l * i + 2l] != order[i] || 
+					id != ids[order[i]]) break; 
+			} 
+			failures += check(i == length, test, key ? 
+				"order by a double column" : "order by an integer column"); 
+			free(sorted.rows); 
+		} 
+	} 
+
+	for (f = 0; f < num_files; f++) {
+		remove(paths[f]); 
+		free(paths[f]); 
+	} 
+	free_dataframe(memory); 
+	free(order); 
+	free(ids); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * Inner and left joins on keys repeated on both sides, missing from one, 
+ * or NaN must give the pairs found by comparing every row with every 
+ * other, in order of the left row then the right, whether hashed into 
+ * several partitions or merged. 
+ */ 
+static int test_join(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		The keys of the left dataframe, each of 0 through 999 three 
+	 * 				times in order, then those of the right, each multiple of 
+	 * 				3 twice; every 13th on the left and 17th on the right NaN 
+	 * expected: 	The row of the left and right dataframe in each pair 
+	 * lrows: 		The row of the left dataframe in each pair of a join 
+	 * rrows: 		The row of the right dataframe in each pair of a join 
+	 */ 
+	const char *test = "test_join"; 
+	int how, strategy, failures = 0; 
+	long i, j, k, n, nleft = 3000l, nright = 6000l; 
+	double *arr = (double *) malloc ((nleft + nright) * sizeof(double)); 
+	for (i = 0l; i < nleft; i++) arr[i] = i % 13l ? i / 3l : NAN; 
+	for (j = 0l; j < nright; j++) {
+		arr[nleft + j] = j % 17l ? (j / 2l) * 3l : NAN; 
+	} 
+	DATAFRAME *left = columns_dataframe(arr, nleft, 1); 
+	DATAFRAME *right = columns_dataframe(arr + nleft, nright, 1); 
+	long *expected = (long *) malloc (2l * (nleft + 2l * nright) * 
+		sizeof(long)); 
+
+	for (how = JOIN_INNER; how <= JOIN_LEFT; how++) {
+		n = 0l; 
+		for (i = 0l; i < nleft; i++) {
+			long matches = 0l; 
+			for (j = 0l; j < nright; j++) {
+				if (arr[i] == arr[nleft + j]) {
+					expected[2l * n] = i; 
+					expected[2l * n++ + 1l] = j; 
+					matches++; 
+				} else {} 
+			} 
+			if (how == JOIN_LEFT && !matches) {
+				expected[2l * n] = i; 
+				expected[2l * n++ + 1l] = -1l; 
+			} else {} 
+		} 
+		for (strategy = JOIN_HASH; strategy <= JOIN_MERGE; strategy++) {
+			COLUMN_BUFFER *lrows, *rrows; 
+			const char *what = how == JOIN_INNER ? (strategy == JOIN_HASH ? 
+				"hashed inner join" : "merged inner join") : (strategy == 
+				JOIN_HASH ? "hashed left join" : "merged left join"); 
+			if (dfjoin_rows(*left, 0, *right, 0, how, strategy, &lrows, 
+				&rrows)) {
+				failures += check(0, test, what); 
+				continue; 
+			} else {} 
+			long long *l = (long long *) (*lrows).values; 
+			long long *r = (long long *) (*rrows).values; 
+			for (k = 0l; k < n && k < (*lrows).length; k++) {
+				if (l[k] != expected[2l * k] || 
+					r[k] != expected[2l * k + 1l]) break; 
+			} 
+			failures += check((*lrows).length == n && 
+				(*rrows).length == n && k == n, test, what); 
+			column_buffer_release(lrows); 
+			column_buffer_release(rrows); 
+		} 
+	} 
+
+	free_dataframe(left); 
+	free_dataframe(right); 
+	free(expected); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * Grouping rows on two key columns, by hashing or by sorting, must number 
+ * the groups in order of their keys, leave rows with a NaN key out, and 
+ * give the count and sum of a column in each group that adding them up 
+ * row by row does. 
+ */ 
+static int test_groupby(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		Three columns: the keys i % 5 (NaN every 23rd row) and 
+	 * 				(i / 7) % 3, whose group is 3 times the first plus the 
+	 * 				second, and the row number i to sum 
+	 * expected: 	The count and sum of each group, row by row 
+	 * first: 		The first row of each group of a grouping 
+	 */ 
+	const char *test = "test_groupby"; 
+	int g, strategy, failures = 0, columns[2] = {0, 1}; 
+	int stats[2] = {BINNED_COUNT, BINNED_SUM}; 
+	long i, num_groups, length = 20000l; 
+	double expected[30], results[30]; 
+	double *arr = (double *) malloc (3l * length * sizeof(double)); 
+	long *groups = (long *) malloc (length * sizeof(long)); 
+	long *first; 
+	for (g = 0; g < 30; g++) expected[g] = 0; 
+	for (i = 0l; i < length; i++) {
+		arr[i] = i % 23l ? i % 5l : NAN; 
+		arr[length + i] = (i / 7l) % 3l; 
+		arr[2l * length + i] = i; 
+		if (i % 23l) {
+			g = 3 * (i % 5l) + (i / 7l) % 3l; 
+			expected[2 * g]++; 
+			expected[2 * g + 1] += i; 
+		} else {} 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 3); 
+
+	for (strategy = GROUPBY_HASH; strategy <= GROUPBY_SORT; strategy++) {
+		if (dfgroup(*df, columns, 2, strategy, groups, &num_groups, 
+			&first) || num_groups != 15l) {
+			failures += check(0, test, "grouping failed"); 
+			continue; 
+		} else {} 
+		for (i = 0l; i < length; i++) {
+			long group = i % 23l ? 3l * (i % 5l) + (i / 7l) % 3l : -1l; 
+			if (groups[i] != group || (group >= 0l && 
+				first[group] > i)) break; 
+		} 
+		failures += check(i == length, test, strategy == GROUPBY_HASH ? 
+			"hashed group numbers" : "sorted group numbers"); 
+		if (group_statistic(*df, groups, num_groups, 2, stats, NULL, 2, 
+			results)) {
+			failures += check(0, test, "group_statistic failed"); 
+		} else {
+			for (g = 0; g < 30; g++) {
+				if (results[g] != expected[g]) break; 
+			} 
+			failures += check(g == 30, test, strategy == GROUPBY_HASH ? 
+				"hashed counts and sums" : "sorted counts and sums"); 
+		} 
+		free(first); 
+	} 
+
+	free_dataframe(df); 
+	free(groups); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * Sorting on two columns with many ties, one holding NaNs and the other 
+ * missing values, must give a permutation of the rows in which each is 
+ * before the next in the first column, or tied there and before it in the 
+ * second, or tied in both and before it in the dataframe, with the NaNs 
+ * and missing values after the others tied with them in either direction. 
+ */ 
+static int test_argsort(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		Two columns: i % 4, NaN every 11th row, and (7 * i) % 5, 
+	 * 				marked missing every 13th 
+	 * seen: 		Whether or not each row is in the order yet 
+	 */ 
+	const char *test = "test_argsort"; 
+	int k, failures = 0, columns[2] = {0, 1}, descending[2]; 
+	long i, length = 10000l; 
+	double sentinel = -1; 
+	double *arr = (double *) malloc (2l * length * sizeof(double)); 
+	long *order = (long *) malloc (length * sizeof(long)); 
+	char *seen = (char *) malloc (length * sizeof(char)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = i % 11l ? i % 4l : NAN; 
+		arr[length + i] = i % 13l ? (7l * i) % 5l : sentinel; 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 2); 
+	dfcolumn_mark_invalid(df, 1, &sentinel, 1); 
+
+	for (k = 0; k < 2; k++) {
+		descending[0] = k; 
+		descending[1] = !k; 
+		if (dfcolumns_argsort(*df, columns, descending, 2, order)) {
+			failures += check(0, test, "argsort failed"); 
+			continue; 
+		} else {} 
+		memset(seen, 0, length * sizeof(char)); 
+		for (i = 0l; i < length; i++) {
+			if (order[i] < 0l || order[i] >= length || seen[order[i]]) break; 
+			seen[order[i]] = 1; 
+		} 
+		failures += check(i == length, test, "not a permutation"); 
+		for (i = 1l; i < length; i++) {
+			long p = order[i - 1l], q = order[i]; 
+			int c = compare_rows(*df, 0, p, q, descending[0]); 
+			if (!c) c = compare_rows(*df, 1, p, q, descending[1]); 
+			if (c > 0 || (!c && p > q)) break; 
+		} 
+		failures += check(i == length, test, k ? 
+			"descending then ascending" : "ascending then descending"); 
+	} 
+
+	free_dataframe(df); 
+	free(order); 
+	free(seen); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * Streaming a file in chunks must give every row once, in order, with 
+ * comment lines (including ones falling on the boundary between chunks) 
+ * and blank lines skipped and not counted toward the chunk size, a short 
+ * last chunk, and integers above 2^53 read exactly. A line with too few 
+ * columns must be reported. 
+ */ 
+static int test_stream(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * path: 		The name of the file, whose rows are the row number i, 
+	 * 				i / 2, and 2^60 + i, with a comment line before every 
+	 * 				37th and every chunksize-th row and a blank line before 
+	 * 				every 50th 
+	 * chunk: 		The dataframe each chunk is put into, holding the third 
+	 * 				and second columns of the file 
+	 * row: 		The number of rows streamed so far 
+	 */ 
+	const char *test = "test_stream"; 
+	int status = 0, failures = 0, columns[2] = {2, 1}; 
+	int types[2]= {COLUMN_INT64, COLUMN_FLOAT64}; 
+	long i, row = 0l, length = 1000l, chunksize = 64l; 
+	char path[32] = "/tmp/ultra-test-XXXXXX"; 
+	FILE *out = fdopen(mkstemp(path), "w"); 
+	for (i = 0l; i < length; i++) {
+		if (i % 37l == 0l || i % chunksize == 0l) fprintf(out, "# %ld\n", i); 
+		if (i % 50l == 0l) fprintf(out, "\n"); 
+		fprintf(out, "%ld %g %lld\n", i, i / 2.0, (1ll << 60) + i); 
+	} 
+	fclose(out); 
+
+	FILE_STREAM *s = stream_initialize(path, '#', columns, 2, types, 
+		chunksize); 
+	DATAFRAME *chunk = dataframe_initialize(); 
+	while (s != NULL && !(status = stream_next(s, chunk)) && 
+		(*chunk).num_rows) {
+		long n = (*chunk).num_rows; 
+		long long *ids = (long long *) (*(*chunk).columns[0]).values; 
+		if (n != min(length - row, chunksize)) break; 
+		for (i = 0l; i < n; i++) {
+			if (ids[i] != (1ll << 60) + row + i || 
+				dfvalue(*chunk, i, 1) != (row + i) / 2.0) break; 
+		} 
+		if (i != n) break; 
+		row += n; 
+		dataframe_release(chunk); 
+	} 
+	failures += check(s != NULL && !status && row == length, test, 
+		"rows streamed"); 
+	free_stream(s); 
+	dataframe_release(chunk); 
+
+	/* A line missing the third column, in the second chunk */ 
+	out = fopen(path, "w"); 
+	for (i = 0l; i < 100l; i++) {
+		if (i == 70l) {
+			fprintf(out, "%ld %g\n", i, i / 2.0); 
+		} else {
+			fprintf(out, "%ld %g %lld\n", i, i / 2.0, (1ll << 60) + i); 
+		} 
+	} 
+	fclose(out); 
+	s = stream_initialize(path, '#', columns, 2, types, chunksize); 
+	status = s == NULL || stream_next(s, chunk); 
+	dataframe_release(chunk); 
+	failures += check(!status && stream_next(s, chunk), test, 
+		"short line not reported"); 
+	free_stream(s); 
+
+	remove(path); 
+	free_dataframe(chunk); 
+	return failures; 
 
-	for (i = 0l; i < 10l; i++) {
-		arr[i] = 100 * (double) rand() / (double) RAND_MAX;  
+} 
+
+/* 
+ * The top k rows of a column with ties and NaNs must be those found by 
+ * picking the best remaining row k times, ties going to the earlier row, 
+ * whether found at once or by a reservoir offered the rows in chunks. A 
+ * sample reservoir offered the rows in chunks must draw the same rows as 
+ * sampling all of them at once with the same seed, and never a row with 
+ * a weight of zero. 
+ */ 
+static int test_top_and_sample(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		Three columns: (7919 i) % 500, NaN every 17th row, the row 
+	 * 				number, and a weight of 1 every 3rd row and 0 otherwise 
+	 * rows: 		The rows found at once 
+	 * expected: 	The best k rows, picked one at a time 
+	 * kept: 		The rows kept by a reservoir 
+	 */ 
+	const char *test = "test_top_and_sample"; 
+	int largest, weights, failures = 0; 
+	int types[3] = {COLUMN_FLOAT64, COLUMN_FLOAT64, COLUMN_FLOAT64}; 
+	long i, t, n, length = 5000l, k = 40l, chunksize = 300l; 
+	long rows[40], expected[40]; 
+	double *arr = (double *) malloc (3l * length * sizeof(double)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = i % 17l ? (7919l * i) % 500l : NAN; 
+		arr[length + i] = i; 
+		arr[2l * length + i] = i % 3l == 0l; 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 3); 
+	DATAFRAME *chunk = dataframe_initialize(); 
+	DATAFRAME *kept = dataframe_initialize(); 
+
+	for (largest = 0; largest < 2; largest++) {
+		for (t = 0l; t < k; t++) {
+			long best = -1l; 
+			for (i = 0l; i < length; i++) {
+				int taken = 0; 
+				long s; 
+				for (s = 0l; s < t; s++) taken |= expected[s] == i; 
+				if (taken || isnan(arr[i])) continue; 
+				if (best == -1l || (largest ? arr[i] > arr[best] : 
+					arr[i] < arr[best])) best = i; 
+			} 
+			expected[t] = best; 
+		} 
+		dfcolumn_top(*df, 0, k, largest, rows, &n); 
+		for (t = 0l; t < n && t < k; t++) {
+			if (rows[t] != expected[t]) break; 
+		} 
+		failures += check(n == k && t == k, test, largest ? 
+			"largest values" : "smallest values"); 
+
+		RESERVOIR *r = top_reservoir_initialize(k, 3, types, 0, largest); 
+		for (i = 0l; i < length; i += chunksize) {
+			dataframe_slice(*df, chunk, i, min(i + chunksize, length)); 
+			reservoir_update(r, *chunk); 
+			dataframe_release(chunk); 
+		} 
+		reservoir_rows(r, kept); 
+		for (t = 0l; t < (*kept).num_rows && t < k; t++) {
+			if (dfvalue(*kept, t, 1) != expected[t]) break; 
+		} 
+		failures += check((*kept).num_rows == k && t == k, test, largest ? 
+			"largest values by reservoir" : "smallest values by reservoir"); 
+		dataframe_release(kept); 
+		free_reservoir(r); 
+	} 
+
+	for (weights = -1; weights <= 2; weights += 3) {
+		dataframe_sample(*df, k, weights, 12345ul, rows, &n); 
+		RESERVOIR *r = sample_reservoir_initialize(k, 3, types, weights, 
+			12345ul); 
+		for (i = 0l; i < length; i += chunksize) {
+			dataframe_slice(*df, chunk, i, min(i + chunksize, length)); 
+			reservoir_update(r, *chunk); 
+			dataframe_release(chunk); 
+		} 
+		reservoir_rows(r, kept); 
+		for (t = 0l; t < n && t < (*kept).num_rows; t++) {
+			if (dfvalue(*kept, t, 1) != rows[t] || (t && rows[t] <= 
+				rows[t - 1l]) || (weights == 2 && rows[t] % 3l)) break; 
+		} 
+		failures += check(n == k && (*kept).num_rows == k && t == k, test, 
+			weights == -1 ? "unweighted sample" : "weighted sample"); 
+		dataframe_release(kept); 
+		free_reservoir(r); 
+	} 
+
+	free_dataframe(df); 
+	free_dataframe(chunk); 
+	free_dataframe(kept); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * The jackknife of a mean, deleting one value at a time, must give each 
+ * replicate as the mean of the other values and the standard error of the 
+ * mean, s / sqrt(n), exactly, with NaN for an empty group. The bootstrap 
+ * of a mean must give the mean itself, the same replicates when run again 
+ * with the same seed, and an error close to s / sqrt(n). 
+ */ 
+static int test_resampling(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		The values (37 i) % 101 
+	 * groups: 		Each row in a group of its own, leaving the last empty 
+	 * sum: 		The sum of the values 
+	 * sd: 			Their standard deviation, about their mean 
+	 */ 
+	const char *test = "test_resampling"; 
+	int failures = 0, stats[1] = {BINNED_MEAN}; 
+	long i, length = 1000l, num_resamples = 1000l; 
+	double estimate, error, again, sum = 0, sd = 0; 
+	double *arr = (double *) malloc (length * sizeof(double)); 
+	long *groups = (long *) malloc (length * sizeof(long)); 
+	double *replicates = (double *) malloc ((length + 1l) * sizeof(double)); 
+	double *repeated = (double *) malloc (num_resamples * sizeof(double)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = (37l * i) % 101l; 
+		groups[i] = i; 
+		sum += arr[i]; 
+	} 
+	for (i = 0l; i < length; i++) {
+		sd += (arr[i] - sum / length) * (arr[i] - sum / length); 
+	} 
+	sd = sqrt(sd / (length - 1l)); 
+	DATAFRAME *df = columns_dataframe(arr, length, 1); 
+
+	if (dfcolumn_jackknife(*df, 0, groups, length + 1l, stats, NULL, 1, 
+		replicates, &estimate, &error)) {
+		failures += check(0, test, "jackknife failed"); 
+	} else {
+		for (i = 0l; i < length; i++) {
+			if (fabs(replicates[i] - (sum - arr[i]) / (length - 1l)) > 
+				1e-12 * sum / length) break; 
+		} 
+		failures += check(i == length && isnan(replicates[length]), test, 
+			"jackknife replicates"); 
+		failures += check(fabs(estimate - sum / length) < 1e-12 * sum / 
+			length && fabs(error - sd / sqrt(length)) < 1e-9 * error, test, 
+			"jackknife error of the mean"); 
+	} 
+
+	if (dfcolumn_bootstrap(*df, 0, stats, NULL, 1, num_resamples, 99ul, 
+		replicates, &estimate, &error) || dfcolumn_bootstrap(*df, 0, stats, 
+		NULL, 1, num_resamples, 99ul, repeated, &again, &again)) {
+		failures += check(0, test, "bootstrap failed"); 
+	} else {
+		failures += check(!memcmp(replicates, repeated, num_resamples * 
+			sizeof(double)), test, "bootstrap not repeatable"); 
+		failures += check(fabs(estimate - sum / length) < 1e-12 * sum / 
+			length && fabs(error - sd / sqrt(length)) < 0.1 * error, test, 
+			"bootstrap error of the mean"); 
+	} 
+
+	free_dataframe(df); 
+	free(replicates); 
+	free(repeated); 
+	free(groups); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * Kendall's tau-b of columns with many ties must match the count over 
+ * every pair of rows, leaving out rows with a NaN, and be -1 for a column 
+ * and its negative. 
+ */ 
+static int test_kendall(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		Three columns: x = i % 10, y = x + (31 i) % 7 (NaN every 
+	 * 				19th row), and -x 
+	 * pairs: 		The number of pairs of rows used 
+	 * xties: 		The number of pairs tied in x 
+	 * yties: 		The number of pairs tied in y 
+	 * net: 		The number of concordant less discordant pairs 
+	 */ 
+	const char *test = "test_kendall"; 
+	int failures = 0, columns[3] = {0, 1, 2}, method = CORRELATION_KENDALL; 
+	long i, j, used, length = 2000l; 
+	long pairs = 0l, xties = 0l, yties = 0l, net = 0l; 
+	double results[9]; 
+	double *arr = (double *) malloc (3l * length * sizeof(double)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = i % 10l; 
+		arr[length + i] = i % 19l ? arr[i] + (31l * i) % 7l : NAN; 
+		arr[2l * length + i] = -arr[i]; 
+	} 
+	for (i = 0l; i < length; i++) {
+		for (j = i + 1l; j < length; j++) {
+			double dx = arr[i] - arr[j]; 
+			double dy = arr[length + i] - arr[length + j]; 
+			if (isnan(dy)) continue; 
+			pairs++; 
+			xties += dx == 0; 
+			yties += dy == 0; 
+			net += (dx * dy > 0) - (dx * dy < 0); 
+		} 
+	} 
+	double tau = net / sqrt((double) (pairs - xties) * (pairs - yties)); 
+	DATAFRAME *df = columns_dataframe(arr, length, 3); 
+
+	if (dataframe_correlations(*df, columns, 3, &method, 1, 0l, 0ul, 
+		results, NULL, &used)) {
+		failures += check(0, test, "correlations failed"); 
+	} else {
+		failures += check(used == length - (length + 18l) / 19l, test, 
+			"rows used"); 
+		failures += check(fabs(results[1] - tau) < 1e-12 && 
+			results[3] == results[1], test, "tau-b with ties"); 
+		failures += check(fabs(results[0] - 1) < 1e-12 && 
+			fabs(results[2] + 1) < 1e-12, test, 
+			"tau-b of a column with itself or its negative"); 
+	} 
+
+	free_dataframe(df); 
+	free(arr); 
+	return failures; 
+
+} 
+
+/* 
+ * The percentile of each row's value among its neighbours, in bins or in 
+ * a window of the rows nearest in rank (odd or even in size, and so off 
+ * center at either end), must be 100 (l + e / 2) / m found by counting 
+ * the neighbours, with NaN for rows holding a NaN or outside the bins. 
+ */ 
+static int test_conditional_percentile(void) {
+
+	/* 
+	 * Bookkeeping 
+	 * =========== 
+	 * arr: 		Two columns: x = (7919 i) % 3000, a permutation of 0 
+	 * 				through 2999, and y = (13 i) % 17, with many ties, NaN 
+	 * 				every 23rd row 
+	 * place: 		The place of each row in ascending order of x among those 
+	 * 				holding a value of y; -1 for the others 
+	 * row: 		The row at each place 
+	 */ 
+	const char *test = "test_conditional_percentile"; 
+	int failures = 0; 
+	long i, j, n = 0l, length = 3000l, windows[2] = {100l, 101l}; 
+	double edges[4] = {-0.5, 699.5, 1499.5, 2499.5}; 
+	double *arr = (double *) malloc (2l * length * sizeof(double)); 
+	double *results = (double *) malloc (length * sizeof(double)); 
+	long *place = (long *) malloc (length * sizeof(long)); 
+	long *row = (long *) malloc (length * sizeof(long)); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = (7919l * i) % length; 
+		arr[length + i] = i % 23l ? (13l * i) % 17l : NAN; 
+	} 
+	for (i = 0l; i < length; i++) {
+		place[i] = isnan(arr[length + i]) ? -1l : 0l; 
+		for (j = 0l; j < length && place[i] != -1l; j++) {
+			place[i] += !isnan(arr[length + j]) && arr[j] < arr[i]; 
+		} 
+		if (place[i] != -1l) {
+			row[place[i]] = i; 
+			n++; 
+		} else {} 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 2); 
+
+	dfcolumn_conditional_percentile(*df, 0, 1, edges, 3l, 0l, results); 
+	for (i = 0l; i < length; i++) {
+		long below = 0l, equal = 0l, m = 0l; 
+		int bin = (arr[i] > edges[1]) + (arr[i] > edges[2]); 
+		if (place[i] == -1l || arr[i] > edges[3]) {
+			if (!isnan(results[i])) break; 
+			continue; 
+		} else {} 
+		for (j = 0l; j < length; j++) {
+			if (place[j] == -1l || arr[j] > edges[3] || 
+				(arr[j] > edges[1]) + (arr[j] > edges[2]) != bin) continue; 
+			m++; 
+			below += arr[length + j] < arr[length + i]; 
+			equal += arr[length + j] == arr[length + i]; 
+		} 
+		double expected = 100.0 * (below + 0.5 * equal) / m; 
+		if (fabs(results[i] - expected) > 1e-9) break; 
+	} 
+	failures += check(i == length, test, "binned percentiles"); 
+
+	for (j = 0l; j < 2l; j++) {
+		long w = windows[j]; 
+		dfcolumn_conditional_percentile(*df, 0, 1, NULL, 0l, w, results); 
+		for (i = 0l; i < length; i++) {
+			long k, start, below = 0l, equal = 0l; 
+			if (place[i] == -1l) {
+				if (!isnan(results[i])) break; 
+				continue; 
+			} else {} 
+			start = min(max(place[i] - w / 2l, 0l), n - w); 
+			for (k = start; k < start + w; k++) {
+				below += arr[length + row[k]] < arr[length + i]; 
+				equal += arr[length + row[k]] == arr[length + i]; 
+			} 
+			double expected = 100.0 * (below + 0.5 * equal) / w; 
+			if (fabs(results[i] - expected) > 1e-9) break; 
+		} 
+		failures += check(i == length, test, w % 2l ? 
+			"percentiles in an odd window" : "percentiles in an even window"); 
 	} 
-	
+
+	free_dataframe(df); 
+	free(results); 
+	free(place); 
+	free(row); 
 	free(arr); 
+	return failures; 
+
+} 
+
+/* A sink for the external sort appending rows to a COLLECTED_ROWS */ 
+static int collect_rows(double *rows, long n, int num_cols, void *state) {
+
+	COLLECTED_ROWS *sorted = (COLLECTED_ROWS *) state; 
+	sorted -> rows = (double *) realloc ((*sorted).rows, ((*sorted).n + n) * 
+		num_cols * sizeof(double)); 
+	memcpy((*sorted).rows + (*sorted).n * num_cols, rows, n * num_cols * 
+		sizeof(double)); 
+	sorted -> n += n; 
 	return 0; 
 
-}
+} 
+
+/* 
+ * Whether or not two dataframes hold the same values of a column in the 
+ * same order. 
+ */ 
+static int same_rows(DATAFRAME a, DATAFRAME b, int column) {
+
+	long i; 
+	if (a.num_rows != b.num_rows) return 0; 
+	for (i = 0l; i < a.num_rows; i++) {
+		if (dfvalue(a, i, column) != dfvalue(b, i, column)) return 0; 
+	} 
+	return 1; 
+
+} 
+
+/* 
+ * Compares two rows in a column of a dataframe in the order of a sort, 
+ * with missing values and NaNs after the others in either direction. 
+ * 
+ * Returns 
+ * ======= 
+ * Negative if the first row goes first, positive if the second does, and 0 
+ * if they tie 
+ */ 
+static int compare_rows(DATAFRAME df, int column, long p, long q, 
+	int descending) {
+
+	double x = dfvalue(df, p, column), y = dfvalue(df, q, column); 
+	int xmissing = !column_valid(df.columns[column], p) || isnan(x); 
+	int ymissing = !column_valid(df.columns[column], q) || isnan(y); 
+	if (xmissing || ymissing) return xmissing - ymissing; 
+	return descending ? (x < y) - (x > y) : (x > y) - (x < y); 
+
+} 
+
+/* 
+ * Reports a failed check, returning 1 if it failed and 0 if it passed. 
+ */ 
+static int check(int passed, const char *test, const char *what) {
+
+	if (!passed) printf("%s: %s\n", test, what); 
+	return !passed; 
+
+} 
+
+/* 
+ * A dataframe of several columns, given one after another (as dfcolumns_new 
+ * takes them). 
+ */ 
+static DATAFRAME *columns_dataframe(double *arr, long length, int num_cols) {
+
+	DATAFRAME *df = dataframe_initialize(); 
+	df -> num_rows = length; 
+	dfcolumns_new(df, arr, num_cols); 
+	return df; 
+
+} 
+
+/* 
+ * A dataframe of two columns: the values 0 through length - 1 in a random 
+ * order in the second, and in the first 0.5 for those in the lower half of 
+ * them and 1.5 for those in the upper half. 
+ */ 
+static DATAFRAME *halves_dataframe(long length) {
+
+	long i; 
+	double *arr = (double *) malloc (2l * length * sizeof(double)); 
+	double *y = shuffled_range(length); 
+	for (i = 0l; i < length; i++) {
+		arr[i] = y[i] < length / 2l ? 0.5 : 1.5; 
+		arr[length + i] = y[i]; 
+	} 
+	DATAFRAME *df = columns_dataframe(arr, length, 2); 
+	free(arr); 
+	free(y); 
+	return df; 
+
+} 
+
+/* 
+ * The values 0 through length - 1 in a random order, such that the value 
+ * of rank r is r. 
+ */ 
+static double *shuffled_range(long length) {
+
+	long i; 
+	double *arr = (double *) malloc (length * sizeof(double)); 
+	for (i = 0l; i < length; i++) arr[i] = i; 
+	for (i = length - 1l; i > 0l; i--) {
+		long j = (long) (((double) rand() / RAND_MAX) * i); 
+		double x = arr[i]; 
+		arr[i] = arr[j]; 
+		arr[j] = x; 
+	} 
+	return arr; 
+
+} 
+
+/* 
+ * Orders doubles in ascending order for qsort. 
+ */ 
+static int compare_doubles(const void *a, const void *b) {
 
+	double x = *((const double *) a), y = *((const double *) b); 
+	return (x > y) - (x < y); 
 
+} 
@@ -22,6 +22,46 @@
 #define LINESIZE 100000l 
 #endif /* LINESIZE */ 
 
+/* 
+ * Pieces above this size are partitioned in parallel by ptr_select_ranks 
+ * when it isn't called from within a parallel region 
+ */ 
+#ifndef SELECT_PARALLEL_CUTOFF 
+#define SELECT_PARALLEL_CUTOFF 1048576l 
+#endif /* SELECT_PARALLEL_CUTOFF */ 
+
+/* The ways in which bins may be laid out in a binspace */ 
+#define BINSPACE_ARBITRARY 0 
+#define BINSPACE_LINEAR 1 
+#define BINSPACE_LOGARITHMIC 2 
+
+/* 
+ * The binspace struct. This stores a set of bin edges along with what is 
+ * needed to compute bin numbers quickly when the bins are uniform. 
+ * 
+ * Fields 
+ * ====== 
+ * edges: 		The bin edges in ascending order (num_bins + 1 of them) 
+ * num_bins: 	The number of bins 
+ * mode: 		BINSPACE_LINEAR or BINSPACE_LOGARITHMIC if the bins are uniform 
+ * 				in linear or logarithmic space, else BINSPACE_ARBITRARY 
+ * lower: 		The lowest bin edge 
+ * upper: 		The highest bin edge 
+ * origin: 		The lowest bin edge (its log for logarithmic bins) 
+ * scale: 		The inverse bin width (in log for logarithmic bins) 
+ */ 
+typedef struct binspace {
+
+	double *edges; 
+	long num_bins; 
+	int mode; 
+	double lower; 
+	double upper; 
+	double origin; 
+	double scale; 
+
+} BINSPACE; 
+
 /* 
  * Determines the sum of an array of longs. 
  * 
@@ -207,6 +247,52 @@ extern double ptr_median(double *arr, long length);
 extern void ptr_scatter(double *arr, long length, double fraction, 
 	double *ptr); 
 
+/* 
+ * Determine the values at several rank orders of an array of unsorted values 
+ * in a single partitioning pass. The array is rearranged in place. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 			A pointer to the array of unsorted values 
+ * length: 			The number of elements in the array 
+ * ranks: 			The rank orders to take, in any order. Each must lie 
+ * 					between 0 and length - 1. 
+ * num_ranks: 		The number of rank orders requested 
+ * values: 			A pointer to put the values into, in the same order as 
+ * 					ranks 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_quantiles.c 
+ */ 
+extern int ptr_select_ranks(double *arr, long length, long *ranks, 
+	int num_ranks, double *values); 
+
+/* 
+ * Determine several quantiles of an array of unsorted values in a single 
+ * partitioning pass. The quantile q is taken as the element of rank 
+ * (long) (q * length), capped at length - 1. The array is rearranged in 
+ * place. 
+ * 
+ * Parameters 
+ * ========== 
+ * arr: 			A pointer to the array of unsorted values 
+ * length: 			The number of elements in the array 
+ * fractions: 		The quantiles to take, each between 0 and 1 
+ * num_fractions: 	The number of quantiles requested 
+ * values: 			A pointer to put the quantiles into 
+ * 
+ * Returns 
+ * ======= 
+ * 0 on success, 1 on failure 
+ * 
+ * source: dataframe_quantiles.c 
+ */ 
+extern int ptr_quantiles(double *arr, long length, double *fractions, 
+	int num_fractions, double *values); 
+
 /* 
  * A classic quickselect function: determine the kth smallest element in an 
  * array of unsorted values. 
@@ -239,6 +325,51 @@ extern double ptr_quickselect(double *arr, long low, long high, long k);
  */ 
 extern void ptr_quicksort(double *arr, long low, long high); 
 
+/* 
+ * Allocates memory for a binspace, determines whether or not its bins are 
+ * uniform in linear or logarithmic space, and returns the pointer. 
+ * 
+ * Parameters 
+ * ========== 
+ * edges: 		The bin edges, in ascending order. These are not copied, and 
+ * 				must outlive the binspace. 
+ * num_bins: 	The number of bins. This should be one less than the number of 
+ * 				values in the edges array. 
+ * 
+ * Returns 
+ * ======= 
+ * The binspace; NULL if num_bins < 1 
+ * 
+ * source: dataframe_binning.c 
+ */ 
+extern BINSPACE *binspace_initialize(double *edges, long num_bins); 
+
+/* 
+ * Frees the memory stored by a binspace. The bin edges themselves are not 
+ * freed. 
+ * 
+ * source: dataframe_binning.c 
+ */ 
+extern void binspace_free(BINSPACE *b); 
+
+/* 
+ * Determines the bin number of a given value within a binspace. The bins are 
+ * closed on both sides; a value on the edge between two bins falls in the 
+ * lower of the two. 
+ * 
+ * Parameters 
+ * ========== 
+ * b: 			The binspace 
+ * value: 		The value to get the bin number for 
+ * 
+ * Returns 
+ * ======= 
+ * Type long :: The bin number; -1l if the value is not within the binspace 
+ * 
+ * source: dataframe_binning.c 
+ */ 
+extern long binspace_lookup(BINSPACE *b, double value); 
+
 #endif /* UTILS_H */ 
 
 